@@ -209,8 +209,8 @@ throw (UMSVishnuException, FMSVishnuException,
   // Check that the file path doesn't contain characters subject to security issues
   vishnu::validatePath(dest);
 
-  if ((options.getTrCommand() < 0) || options.getTrCommand() > 2) {
-    throw UserException(ERRCODE_INVALID_PARAM, "Invalid transfer command type: its value must be 0 (scp) or 1 (rsync)");
+  if ((options.getTrCommand() < 0) || options.getTrCommand() > 3) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Invalid transfer command type: its value must be 0 (scp), 1 (rsync) or 3 (parallel)");
   }
   FMSVishnuException e(ERRCODE_RUNTIME_ERROR, "Unknown copy error");
 
@@ -246,8 +246,8 @@ throw (UMSVishnuException, FMSVishnuException,
   // Check that the file path doesn't contain characters subject to security issues
   vishnu::validatePath(dest);
 
-  if ((options.getTrCommand() < 0) || options.getTrCommand() > 2) {
-    throw UserException(ERRCODE_INVALID_PARAM, "Invalid transfer commad type: its value must be 0 (scp) or 1 (rsync)");
+  if ((options.getTrCommand() < 0) || options.getTrCommand() > 3) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Invalid transfer commad type: its value must be 0 (scp), 1 (rsync) or 3 (parallel)");
   }
   FileTransferProxy fileTransferProxy(sessionKey, src, dest);
   int result = fileTransferProxy.addCpAsyncThread(options);
@@ -383,8 +383,8 @@ throw (UMSVishnuException, FMSVishnuException,
   // Check that the file path doesn't contain characters subject to security issues
   vishnu::validatePath(dest);
 
-  if ((options.getTrCommand() < 0) || options.getTrCommand() > 2) {
-    throw UserException(ERRCODE_INVALID_PARAM, "Invalid transfer commad type: its value must be 0 (scp) or 1 (rsync)");
+  if ((options.getTrCommand() < 0) || options.getTrCommand() > 3) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Invalid transfer commad type: its value must be 0 (scp), 1 (rsync) or 3 (parallel)");
   }
   int result = 0;
   FMSVishnuException e(ERRCODE_RUNTIME_ERROR, "Unknwon move error");
@@ -418,8 +418,8 @@ throw (UMSVishnuException, FMSVishnuException,
   // Check that the file path doesn't contain characters subject to security issues
   vishnu::validatePath(dest);
 
-  if ((options.getTrCommand() < 0) || options.getTrCommand() > 2) {
-    throw UserException(ERRCODE_INVALID_PARAM, "Invalid transfer commad type: its value must be 0 (scp) or 1 (rsync)");
+  if ((options.getTrCommand() < 0) || options.getTrCommand() > 3) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Invalid transfer commad type: its value must be 0 (scp), 1 (rsync) or 3 (parallel)");
   }
 
   FileTransferProxy fileTransferProxy(sessionKey, src, dest);
@@ -457,6 +457,42 @@ throw (UMSVishnuException, FMSVishnuException,
   return 0;
 }
 
+/**
+ * \brief get a range of the content of a file
+ * \param sessionKey the session key
+ * \param path    the file path using host:path format
+ * \param offset  the position of the first byte
+ * \param length  the maximum number of bytes
+ * \param chunk   the bytes read
+ * \param fileSize  the current size of the file
+ * \return 0 if everything is OK, another value otherwise
+ */
+int
+vishnu::readFile(const string& sessionKey, const string& path,
+                 long long offset, long long length,
+                 string& chunk, long long& fileSize)
+throw (UMSVishnuException, FMSVishnuException,
+       UserException, SystemException) {
+
+  // Check that the file path doesn't contain characters subject to security issues
+  vishnu::validatePath(path);
+
+  //To check the remote path
+  vishnu::checkRemotePath(path);
+
+  if (offset < 0 || length < 0) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Invalid range of the file");
+  }
+
+  SessionProxy sessionProxy(sessionKey);
+
+  boost::scoped_ptr<FileProxy> f(FileProxyFactory::getFileProxy(sessionProxy,path));
+
+  chunk = f->read(offset, length, fileSize);
+
+  return 0;
+}
+
 /**
  * \brief  obtain informations about a file
  * \param sessionKey the session key
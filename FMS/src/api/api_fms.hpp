@@ -191,6 +191,23 @@ int acp(const std::string& sessionKey,const std::string& src, const std::string&
            const FMS_Data::TailOfFileOptions& options = FMS_Data::TailOfFileOptions())
     throw (UMSVishnuException, FMSVishnuException, UserException, SystemException);
 
+  /**
+   * \brief get a range of the content of a file, a large file is read
+   * chunk by chunk
+   * \param sessionKey the session key
+   * \param path    the file path using host:path format
+   * \param offset  the position of the first byte
+   * \param length  the maximum number of bytes, a server returns at most
+   * maxFileReadChunkSize bytes
+   * \param chunk   the bytes read, fewer than length at the end of the file
+   * \param fileSize  the current size of the file
+   * \return 0 if everything is OK, another value otherwise
+   */
+  int readFile(const std::string& sessionKey,const std::string& path,
+               long long offset, long long length,
+               std::string& chunk, long long& fileSize)
+    throw (UMSVishnuException, FMSVishnuException, UserException, SystemException);
+
   /**
    * \brief  obtain informations about a file
    * \param sessionKey the session key
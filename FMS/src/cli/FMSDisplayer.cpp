@@ -151,6 +151,9 @@ std::string ConvertFileTransferCommandToString(const int& trCmd){
     case 1:
       result="RSYNC";
       break;
+    case 3:
+      result="PARALLEL";
+      break;
     default:
       result= "UNDEFINED";
       break;
@@ -375,6 +378,7 @@ operator<<(std::ostream& os, FMS_Data::FileTransfer& fileTransfer) {
   os << std::setw(maxSize) << std::left << "sourceFilePath: " << fileTransfer.getSourceFilePath()   << std::endl;
   os << std::setw(maxSize) << std::left << "destinationFilePath: " << fileTransfer.getDestinationFilePath()   << std::endl;
   os << std::setw(maxSize) << std::left << "size: " << fileTransfer.getSize()   << std::endl;
+  os << std::setw(maxSize) << std::left << "bytesDone: " << fileTransfer.getBytesDone()   << std::endl;
   if(fileTransfer.getStartTime() > 0) {
     boost::posix_time::ptime pt =  boost::posix_time::from_time_t(fileTransfer.getStartTime());
     os << std::setw(maxSize) << std::left << "start_time: " <<  boost::posix_time::to_simple_string(pt)  << std::endl;
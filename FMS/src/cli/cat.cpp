@@ -11,6 +11,7 @@
 #include "api_ums.hpp"
 #include "api_fms.hpp"
 #include "FMS_Data.hpp"
+#include "FMSConstants.hpp"
 #include "sessionUtils.hpp"
 #include <boost/bind.hpp>
 #include "GenericCli.hpp"
@@ -29,10 +30,18 @@ struct ContentOfFileFunc {
   ContentOfFileFunc(const std::string& path):mpath(path){}
 
   int operator()(std::string sessionKey) {
-    string mfileContent;
+    string chunk;
+    long long offset = 0;
+    long long fileSize = 0;
+    int res;
 
-    int res = cat(sessionKey, mpath, mfileContent);
-    cout << mfileContent;
+    // the file is printed chunk by chunk until its end
+    do {
+      res = readFile(sessionKey, mpath, offset, maxFileReadChunkSize, chunk, fileSize);
+      cout.write(chunk.data(), chunk.size());
+      offset += chunk.size();
+    } while (res == 0 && ! chunk.empty() && offset < fileSize);
+    cout.flush();
     return res;
   }
 };
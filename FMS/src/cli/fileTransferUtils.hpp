@@ -55,7 +55,8 @@ makeTransferCommandOptions(std::string pgName,
   opt->add("trCommand,t",
            "The command to use to perform file transfer. The different values  are:\n"
            "O or scp: for SCP transfer\n"
-           "1 or rsync: for RSYNC transfer\n",
+           "1 or rsync: for RSYNC transfer\n"
+           "3 or parallel: for large files sent by chunks over parallel streams\n",
            ENV,
            trCmdStr);
 
@@ -128,6 +129,8 @@ copyParseOptions (int argc, char* argv[],std::string& configFile,
         trCmd = 0;
       } else if (trCmdStr.compare("rsync") == 0 || trCmdStr.compare("RSYNC") == 0){
         trCmd = 1;
+      } else if (trCmdStr.compare("parallel") == 0 || trCmdStr.compare("PARALLEL") == 0){
+        trCmd = 3;
       } else {
 
         errorUsage (argv[0],
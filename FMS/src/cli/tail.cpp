@@ -11,11 +11,14 @@
 #include "api_ums.hpp"
 #include "api_fms.hpp"
 #include "FMS_Data.hpp"
+#include "FMSConstants.hpp"
 #include "sessionUtils.hpp"
 #include <boost/bind.hpp>
 #include "GenericCli.hpp"
 #include "cmdArgs.hpp"
 #include "remoteCommandUtils.hpp"
+#include <unistd.h>
+#include <algorithm>
 
 namespace po = boost::program_options;
 
@@ -23,19 +26,134 @@ using namespace std;
 using namespace vishnu;
 using namespace FMS_Data;
 
+/**
+ * \brief The time in seconds between two reads of a followed file
+ */
+static const unsigned int FOLLOW_POLL_DELAY = 1;
+
+/**
+ * \brief The longest time in seconds between two reads after failures
+ */
+static const unsigned int FOLLOW_MAX_DELAY = 30;
+
+/**
+ * \brief The number of reads failing in a row which stops a follow
+ */
+static const int FOLLOW_MAX_FAILURES = 10;
+
+/**
+ * \brief The number of chunks read backwards to find the last lines, a
+ * file with longer lines is printed from there
+ */
+static const int FOLLOW_MAX_BACKWARD_READS = 4;
+
 struct TailOfFileFunc {
 
   std::string mpath;
   TailOfFileOptions mtofOptions;
-  TailOfFileFunc(const std::string& path,const TailOfFileOptions& tofOptions):mpath(path),mtofOptions(tofOptions){}
+  bool mfollow;
+  TailOfFileFunc(const std::string& path,const TailOfFileOptions& tofOptions, bool follow):mpath(path),mtofOptions(tofOptions),mfollow(follow){}
 
   int operator()(std::string sessionKey) {
+    if (mfollow) {
+      return follow(sessionKey);
+    }
     string contentOfTailOfFile;
 
     int res = tail(sessionKey, mpath, contentOfTailOfFile, mtofOptions);
     cout << contentOfTailOfFile;
     return res;
   }
+
+  /**
+   * \brief Print the last lines of the file, then the data appended to it
+   * until the command is interrupted
+   * \param sessionKey The session key
+   * \return an error code
+   */
+  int follow(const std::string& sessionKey) {
+    string chunk;
+    long long fileSize = 0;
+    long long currentSize = 0;
+    readFile(sessionKey, mpath, 0, 0, chunk, fileSize);
+
+    // the last lines are read backwards from the end of the file, so the
+    // follow starts exactly where they end
+    int nline = mtofOptions.getNline();
+    string lastLines;
+    long long start = fileSize;
+    for (int reads = 0;
+         reads < FOLLOW_MAX_BACKWARD_READS && start > 0 && countSeparators(lastLines) < nline;
+         ++reads) {
+      long long length = std::min(start, maxFileReadChunkSize);
+      readFile(sessionKey, mpath, start - length, length, chunk, currentSize);
+      lastLines.insert(0, chunk);
+      start -= length;
+    }
+    size_t pos = lastLines.size();
+    if (pos > 0 && lastLines[pos - 1] == '\n') {
+      --pos;
+    }
+    for (int i = 0; i < nline && pos != string::npos; ++i) {
+      pos = (pos == 0) ? string::npos : lastLines.rfind('\n', pos - 1);
+    }
+    if (nline <= 0) {
+      lastLines.clear();
+    } else if (pos != string::npos) {
+      lastLines.erase(0, pos + 1);
+    } else if (start > 0) {
+      // the budget is spent, the line cut by the first read is left out
+      lastLines.erase(0, lastLines.find('\n') + 1);
+    }
+    cout.write(lastLines.data(), lastLines.size());
+    cout.flush();
+
+    long long offset = fileSize;
+    unsigned int delay = FOLLOW_POLL_DELAY;
+    int failures = 0;
+    while (true) {
+      // a failing read is tried again later, with a growing delay
+      try {
+        readFile(sessionKey, mpath, offset, maxFileReadChunkSize, chunk, fileSize);
+      } catch (VishnuException& ex) {
+        if (++failures >= FOLLOW_MAX_FAILURES) {
+          throw;
+        }
+        cerr << mpath << ": " << ex.what() << endl;
+        sleep(delay);
+        delay = std::min(2 * delay, FOLLOW_MAX_DELAY);
+        continue;
+      }
+      failures = 0;
+      delay = FOLLOW_POLL_DELAY;
+      if (fileSize < offset) {
+        cerr << mpath << ": file truncated" << endl;
+        offset = 0;
+        continue;
+      }
+      if (chunk.empty()) {
+        sleep(FOLLOW_POLL_DELAY);
+        continue;
+      }
+      cout.write(chunk.data(), chunk.size());
+      cout.flush();
+      offset += chunk.size();
+    }
+    return 0;
+  }
+
+  /**
+   * \brief Count the line separators, the final newline of the data excepted
+   * \param data The data
+   * \return the number of separators
+   */
+  static int countSeparators(const string& data) {
+    int count = std::count(data.begin(), data.end(), '\n');
+    if (! data.empty() && data[data.size() - 1] == '\n') {
+      --count;
+    }
+    return count;
+  }
 };
 
 
@@ -59,9 +177,13 @@ main (int ac, char* av[]) {
       CONFIG,
       fNline);
 
+  opt->add("follow,f",
+      "Output the data appended as the file grows",
+      CONFIG);
+
   bool isEmpty;
   GenericCli().processListOpt( opt, isEmpty,ac,av);
-  TailOfFileFunc apiFunc(path,tofOptions);
+  TailOfFileFunc apiFunc(path,tofOptions,opt->count("follow") != 0);
   return GenericCli().run(apiFunc, configFile, ac, av);
 
 }
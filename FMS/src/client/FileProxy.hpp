@@ -144,6 +144,16 @@ public:
   virtual std::string
   getContent() = 0;
 
+  /**
+   * \brief To get a range of the content of the file
+   * \param offset the position of the first byte
+   * \param length the maximum number of bytes
+   * \param fileSize the current size of the file
+   * \return the bytes read, fewer than length at the end of the file
+   */
+  virtual std::string
+  read(long long offset, long long length, long long& fileSize) = 0;
+
   /**
    * \brief To create a new file
    * \param mode the access permission of the file
@@ -105,6 +105,14 @@ class LocalFileProxy : public FileProxy {
      * \return the content of the file
      */
     virtual std::string getContent() { return std::string("");}
+    /**
+     * \brief To get a range of the content of the file
+     * \param offset the position of the first byte
+     * \param length the maximum number of bytes
+     * \param fileSize the current size of the file
+     * \return the bytes read, fewer than length at the end of the file
+     */
+    virtual std::string read(long long offset, long long length, long long& fileSize) { fileSize = 0; return std::string("");}
     /**
      * \brief To create a new file
      * \param mode the access permission of the file
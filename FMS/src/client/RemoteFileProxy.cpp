@@ -186,6 +186,36 @@ RemoteFileProxy::getContent() {
   return fileContent;
 }
 
+/* Call the file read Vishnu server.
+ * If something goes wrong, throw a raiseCommunicationMsgException containing
+ * the error message.
+ */
+std::string
+RemoteFileProxy::read(long long offset, long long length, long long& fileSize) {
+
+  //IN Parameters
+  diet_profile_t* profile = diet_profile_alloc(SERVICES_FMS[FILEREAD], 5);
+  diet_string_set(profile, 0, this->getSession().getSessionKey());
+  diet_string_set(profile, 1, getPath());
+  diet_string_set(profile, 2, getHost());
+  diet_string_set(profile, 3, vishnu::convertToString(offset));
+  diet_string_set(profile, 4, vishnu::convertToString(length));
+
+  if (diet_call(profile)) {
+    raiseCommunicationMsgException("RPC call failed");
+  }
+  raiseExceptionOnErrorResult(profile);
+
+  std::string encodedChunk;
+  std::string fileSizeInString;
+  diet_string_get(profile, 1, encodedChunk);
+  diet_string_get(profile, 2, fileSizeInString);
+  fileSize = vishnu::convertToLong(fileSizeInString);
+
+  diet_profile_free(profile);
+  return vishnu::decodeBase64(encodedChunk);
+}
+
 /* Call the mkfile Vishnu server.
  * If something goes wrong, throw a raiseCommunicationMsgException containing
  * the error message.
@@ -95,6 +95,14 @@ public:
      * \return the content of the file
      */
   virtual std::string getContent();
+  /**
+     * \brief To get a range of the content of the file
+     * \param offset the position of the first byte
+     * \param length the maximum number of bytes
+     * \param fileSize the current size of the file
+     * \return the bytes read, fewer than length at the end of the file
+     */
+  virtual std::string read(long long offset, long long length, long long& fileSize);
   /**
      * \brief To create a new file
      * \param mode the access permission of the file
@@ -0,0 +1,111 @@
+/**
+ * \file FileStatCache.cpp
+ * \brief This file implements the cache of the remote file information
+ */
+
+#include "FileStatCache.hpp"
+
+#include <boost/format.hpp>
+
+using boost::posix_time::microsec_clock;
+using boost::posix_time::ptime;
+
+
+FileStatCache&
+FileStatCache::getInstance() {
+  static FileStatCache instance;
+  return instance;
+}
+
+
+FileStatCache::FileStatCache() : mgeneration(0) {
+}
+
+
+FileStatCache::StatResult
+FileStatCache::get(const std::string& key, const StatFunction& statFunction) {
+  unsigned long generation;
+  {
+    boost::unique_lock<boost::mutex> lock(mmutex);
+    std::map<std::string, Entry>::iterator it = mentries.find(key);
+    // another lookup is running the command, its result is shared
+    while (it != mentries.end() && it->second.loading) {
+      mloaded.wait(lock);
+      it = mentries.find(key);
+    }
+    ptime now = microsec_clock::universal_time();
+    if (it != mentries.end() && now < it->second.expiry) {
+      return it->second.result;
+    }
+    if (it == mentries.end() && mentries.size() >= FILE_STAT_CACHE_MAX_ENTRIES) {
+      purge(now);
+    }
+    Entry& entry = mentries[key];
+    entry.loading = true;
+    entry.generation = ++mgeneration;
+    generation = entry.generation;
+  }
+
+  StatResult result;
+  try {
+    result = statFunction();
+  } catch (...) {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    std::map<std::string, Entry>::iterator it = mentries.find(key);
+    if (it != mentries.end() && it->second.generation == generation) {
+      mentries.erase(it);
+    }
+    mloaded.notify_all();
+    throw;
+  }
+
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  std::map<std::string, Entry>::iterator it = mentries.find(key);
+  // the file may have changed while the command was running
+  if (it != mentries.end() && it->second.generation == generation) {
+    it->second.result = result;
+    it->second.expiry = microsec_clock::universal_time()
+                        + boost::posix_time::milliseconds(FILE_STAT_CACHE_TTL);
+    it->second.loading = false;
+  }
+  mloaded.notify_all();
+  return result;
+}
+
+
+void
+FileStatCache::invalidate(const std::string& key) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  mentries.erase(key);
+  // the files below it sort between key/ and key0, the root ends with a slash
+  std::string prefix = (! key.empty() && key[key.size() - 1] == '/') ? key.substr(0, key.size() - 1) : key;
+  mentries.erase(mentries.lower_bound(prefix + "/"), mentries.lower_bound(prefix + "0"));
+  mloaded.notify_all();
+}
+
+
+std::string
+FileStatCache::getKey(const std::string& user,
+                      const std::string& host,
+                      unsigned int port,
+                      const std::string& path) {
+  std::string name = path;
+  // the same directory may be named with a trailing slash
+  while (name.size() > 1 && name[name.size() - 1] == '/') {
+    name.erase(name.size() - 1);
+  }
+  return boost::str(boost::format("%1%@%2%:%3%:%4%") % user % host % port % name);
+}
+
+
+void
+FileStatCache::purge(const ptime& now) {
+  std::map<std::string, Entry>::iterator it = mentries.begin();
+  while (it != mentries.end()) {
+    if (! it->second.loading && it->second.expiry <= now) {
+      mentries.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
@@ -0,0 +1,141 @@
+/**
+ * \file FileStatCache.hpp
+ * \brief This file declares the cache of the remote file information
+ */
+
+#ifndef _FILESTATCACHE_HPP_
+#define _FILESTATCACHE_HPP_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+/**
+ * \brief The time in milliseconds a file information is kept
+ */
+const int FILE_STAT_CACHE_TTL = 2000;
+
+/**
+ * \brief The number of entries above which the expired ones are dropped
+ */
+const size_t FILE_STAT_CACHE_MAX_ENTRIES = 4096;
+
+/**
+ * \class FileStatCache
+ * \brief Keeps the output of the remote stat commands for a short time, so
+ * the file objects built for the same file by a request share a single
+ * remote command. The lookups of a file already running wait for its result
+ * instead of running their own. The commands changing a file drop its entry
+ * and the entries of the files below it.
+ */
+class FileStatCache : public boost::noncopyable {
+public:
+  /**
+   * \brief The output and the error of a stat command
+   */
+  typedef std::pair<std::string, std::string> StatResult;
+
+  /**
+   * \brief The function running the stat command
+   */
+  typedef boost::function0<StatResult> StatFunction;
+
+  /**
+   * \brief Get the cache of the process
+   * \return the cache
+   */
+  static FileStatCache&
+  getInstance();
+
+  /**
+   * \brief Get the information of a file, the command is run if it is not
+   * cached
+   * \param key the user, host and path of the file
+   * \param statFunction the function running the stat command
+   * \return the output and the error of the command
+   */
+  StatResult
+  get(const std::string& key, const StatFunction& statFunction);
+
+  /**
+   * \brief Drop the information of a file and of the files below it
+   * \param key the user, host and path of the file
+   */
+  void
+  invalidate(const std::string& key);
+
+  /**
+   * \brief Get the key of a file
+   * \param user the login reaching the host
+   * \param host the machine of the file
+   * \param port the ssh port of the machine
+   * \param path the path of the file
+   * \return the key, the same for a directory named with a trailing slash
+   */
+  static std::string
+  getKey(const std::string& user,
+         const std::string& host,
+         unsigned int port,
+         const std::string& path);
+
+private:
+  /**
+   * \brief Constructor
+   */
+  FileStatCache();
+
+  /**
+   * \brief Drop the expired entries, the mutex must be held
+   * \param now the current time
+   */
+  void
+  purge(const boost::posix_time::ptime& now);
+
+  /**
+   * \struct Entry
+   * \brief The information of a file
+   */
+  struct Entry {
+    /**
+     * \brief The output and the error of the command
+     */
+    StatResult result;
+    /**
+     * \brief The date after which the information is run again
+     */
+    boost::posix_time::ptime expiry;
+    /**
+     * \brief Whether the command is running
+     */
+    bool loading;
+    /**
+     * \brief The lookup running the command, its result is dropped if the
+     * entry was invalidated meanwhile
+     */
+    unsigned long generation;
+  };
+
+  /**
+   * \brief The entries, by user, host and path
+   */
+  std::map<std::string, Entry> mentries;
+  /**
+   * \brief The number of lookups which ran the command
+   */
+  unsigned long mgeneration;
+  /**
+   * \brief mutex protecting the entries
+   */
+  boost::mutex mmutex;
+  /**
+   * \brief Signaled when a command ends or an entry is dropped
+   */
+  boost::condition_variable mloaded;
+};
+
+#endif // _FILESTATCACHE_HPP_
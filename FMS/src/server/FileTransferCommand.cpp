@@ -47,6 +47,16 @@ FileTransferCommand::getTransferManager(const FMS_Data::CpFileOptions& options,
                                               "",
                                               timeout);
     break;
+  case vishnu::PARALLEL_TRANSFER:
+    // the chunks are sent by the server, scp copies the small files and
+    // the directories
+    transferManager = new FileTransferCommand("parallel",
+                                              "/usr/bin/scp",
+                                              options.isIsRecursive(),
+                                              compress,
+                                              "",
+                                              timeout);
+    break;
   case vishnu::SCP_TRANSFER:
   default:
     transferManager = new FileTransferCommand("scp",
@@ -21,6 +21,10 @@
 #include "fmsUtils.hpp"
 #include "utilServer.hpp"
 #include "Logger.hpp"
+#include "SSHSessionPool.hpp"
+#include "TransferScheduler.hpp"
+#include "ParallelTransfer.hpp"
+#include "FileStatCache.hpp"
 
 namespace ba = boost::algorithm;
 
@@ -81,6 +85,7 @@ FileTransferServer::FileTransferServer(const SessionServer& sessionServer,
                                        const int& vishnuId):
   mvishnuId(vishnuId),
   mtransferType(File::undefined),
+  msynchronous(false),
   msessionServer(sessionServer) {
 
 }
@@ -94,6 +99,7 @@ FileTransferServer::FileTransferServer(const SessionServer& sessionServer,
                                        const int& vishnuId):
   mvishnuId(vishnuId),
   mtransferType(File::undefined),
+  msynchronous(false),
   msessionServer(sessionServer) {
   mfileTransfer.setSourceMachineId(srcHost);
   mfileTransfer.setDestinationMachineId(destHost);
@@ -150,6 +156,11 @@ FileTransferServer::updateDatabaseRecord()
   sqlUpdate+="trCommand=" + vishnu::convertToString(mfileTransfer.getTrCommand()) + ",";
   sqlUpdate+="processid=" + vishnu::convertToString(-1) + ",";
   sqlUpdate+="errorMsg='" + getDatabaseInstance()->escapeData(mfileTransfer.getErrorMsg()) + "',";
+  sqlUpdate+="transferType=" + vishnu::convertToString(mtransferType == File::move ? File::move : File::copy) + ",";
+  sqlUpdate+="transferCmd='" + db->escapeData(mtransferCommand) + "',";
+  sqlUpdate+="bytesDone=0,";
+  sqlUpdate+="serverUri='" + db->escapeData(TransferScheduler::getInstance().getServerUri()) + "',";
+  sqlUpdate+="sourceUser='" + db->escapeData(msrcUser) + "',";
   sqlUpdate+="startTime=CURRENT_TIMESTAMP ";
   sqlUpdate+="WHERE transferid='" + FileTransferServer::getDatabaseInstance()->escapeData(mfileTransfer.getTransferId()) + "';";
   db->process(sqlUpdate);
@@ -182,6 +193,7 @@ FileTransferServer::addTransferThread(const std::string& srcUser,
                                       const FMS_Data::CpFileOptions& options)
 {
   updateData(); // update datas and get the vishnu transfer id
+  msrcUser = srcUser;
   int direction;
   if (vishnu::ifLocalTransferInvolved(srcMachineName, destMachineName, direction)) {
     mfileTransfer.setStatus(vishnu::TRANSFER_WAITING_CLIENT_RESPONSE);
@@ -261,19 +273,27 @@ FileTransferServer::addTransferThread(const std::string& srcUser,
                             mfileTransfer.getDestinationFilePath(),
                             mfileTransfer.getTransferId());
 
+  // the command is kept with the transfer, so it runs again after a restart
+  mtransferCommand = transferManager->getCommand();
   updateDatabaseRecord();
 
-  // create the thread to perform the copy
-  if (mtransferType == File::copy) {
-    mthread = boost::thread(&FileTransferServer::copy,
-                            this,
-                            transferExec,
-                            transferManager->getCommand());
-  } else if (mtransferType == File::move) {
-    mthread = boost::thread(&FileTransferServer::move,
-                            this,
-                            transferExec,
-                            transferManager->getCommand());
+  if (msynchronous) {
+    // the client waits for the answer, the transfer does not wait behind
+    // the asynchronous ones
+    TransferScheduler::getInstance().run(transferExec,
+                                         mtransferCommand,
+                                         mfileTransfer.getTrCommand(),
+                                         mtransferType,
+                                         mfileTransfer.getUserId(),
+                                         mfileTransfer.getSize());
+  } else {
+    // the transfer waits for a free worker of the scheduler
+    TransferScheduler::getInstance().submit(transferExec,
+                                            mtransferCommand,
+                                            mfileTransfer.getTrCommand(),
+                                            mtransferType,
+                                            mfileTransfer.getUserId(),
+                                            mfileTransfer.getSize());
   }
 
   return 0;
@@ -281,29 +301,60 @@ FileTransferServer::addTransferThread(const std::string& srcUser,
 
 
 
+// To get the path receiving the data of a transfer
+std::string
+FileTransferServer::getTargetPath(const TransferExec& transferExec) {
+  SSHExec destExec(getSSHCommand(), "",
+                   transferExec.getDestMachineName(),
+                   getSSHPort(),
+                   transferExec.getDestUser(), "", "", "");
+  std::string target = transferExec.getDestPath();
+  if (destExec.exec("test -d " + target + " && echo directory").first.find("directory") != std::string::npos) {
+    std::string srcPath = transferExec.getSrcPath();
+    srcPath.erase(srcPath.find_last_not_of('/') + 1);
+    target += "/" + srcPath.substr(srcPath.find_last_of('/') + 1);
+  }
+  return target;
+}
+
+
 // To perform a file copy
 void
 FileTransferServer::copy(const TransferExec& transferExec,
-                         const std::string& trCmd) {
-  //build the destination complete path
-  std::ostringstream destCompletePath;
-
-  destCompletePath << transferExec.getDestUser() << "@"<< transferExec.getDestMachineName() <<":"<< transferExec.getDestPath();
+                         const std::string& trCmd,
+                         int trManager) {
   std::pair<std::string,std::string> trResult;
 
-  trResult = transferExec.exec(trCmd + " " +transferExec.getSrcPath()+" "+destCompletePath.str() );
+  if (trManager == vishnu::PARALLEL_TRANSFER) {
+    ParallelTransfer parallelTransfer(transferExec, trCmd);
+    trResult = parallelTransfer.run();
+  } else {
+    //build the destination complete path
+    std::ostringstream destCompletePath;
+
+    destCompletePath << transferExec.getDestUser() << "@"<< transferExec.getDestMachineName() <<":"<< transferExec.getDestPath();
+
+    trResult = transferExec.exec(trCmd + " " +transferExec.getSrcPath()+" "+destCompletePath.str() );
 
-  if (trResult.second.find("Warning") != std::string::npos
-      || trResult.first.find("Warning")!=std::string::npos) {
-    trResult = transferExec.exec(trCmd + " " +transferExec.getSrcPath()+" "+destCompletePath.str());
+    if (trResult.second.find("Warning") != std::string::npos
+        || trResult.first.find("Warning")!=std::string::npos) {
+      trResult = transferExec.exec(trCmd + " " +transferExec.getSrcPath()+" "+destCompletePath.str());
+    }
   }
 
+  // even a failed transfer may have changed the destination
+  FileStatCache::getInstance().invalidate(FileStatCache::getKey(transferExec.getDestUser(),
+                                                                transferExec.getDestMachineName(),
+                                                                getSSHPort(),
+                                                                transferExec.getDestPath()));
+
   // Clean the output message
   std::string allOutputMsg (FileTransferServer::cleanOutputMsg(trResult.first+trResult.second));
 
   if (allOutputMsg.length() != 0) {
     updateStatus(vishnu::TRANSFER_FAILED, transferExec.getTransferId(), allOutputMsg);
-
+    // a move keeps its source
+    transferExec.setLastExecStatus(1);
   } else {
     updateStatus(vishnu::TRANSFER_COMPLETED,transferExec.getTransferId(),"");
   }
@@ -312,9 +363,10 @@ FileTransferServer::copy(const TransferExec& transferExec,
 
 void
 FileTransferServer::move(const TransferExec& transferExec,
-                         const std::string& trCmd) {
+                         const std::string& trCmd,
+                         int trManager) {
   // perform the copy
-  copy(transferExec,trCmd);
+  copy(transferExec,trCmd,trManager);
   int lastExecStatus=transferExec.getLastExecStatus();
 
   if (lastExecStatus == 0) {
@@ -332,6 +384,10 @@ FileTransferServer::move(const TransferExec& transferExec,
       updateStatus(vishnu::TRANSFER_FAILED,transferExec.getTransferId(),err.what());
       transferExec.setLastExecStatus(1);
     }
+    FileStatCache::getInstance().invalidate(FileStatCache::getKey(transferExec.getSrcUser(),
+                                                                  transferExec.getSrcMachineName(),
+                                                                  getSSHPort(),
+                                                                  transferExec.getSrcPath()));
   }
 }
 
@@ -385,6 +441,7 @@ FileTransferServer::addCpThread(const std::string& srcUser,
                                 const std::string& destMachineName,
                                 const FMS_Data::CpFileOptions& options) {
   mtransferType=File::copy;
+  msynchronous=true;
   addTransferThread(srcUser,srcMachineName,srcUserKey, destUser, destMachineName, options);
   waitThread();
 
@@ -406,6 +463,7 @@ FileTransferServer::addCpAsyncThread(const std::string& srcUser,
                                      const std::string& destMachineName,
                                      const FMS_Data::CpFileOptions& options) {
   mtransferType=File::copy;
+  msynchronous=false;
   addTransferThread(srcUser,srcMachineName,srcUserKey, destUser, destMachineName, options);
   return 0;
 }
@@ -420,6 +478,7 @@ FileTransferServer::addMvThread(const std::string& srcUser,
                                 const std::string& destMachineName,
                                 const FMS_Data::CpFileOptions& options) {
   mtransferType=File::move;
+  msynchronous=true;
   FMS_Data::CpFileOptions mvOptions(options);
   mvOptions.setIsRecursive(true);
   addTransferThread(srcUser,srcMachineName,srcUserKey, destUser, destMachineName,mvOptions);
@@ -444,16 +503,17 @@ FileTransferServer::addMvAsyncThread(const std::string& srcUser,
                                      const std::string& destMachineName,
                                      const FMS_Data::CpFileOptions& options) {
   mtransferType=File::move;
+  msynchronous=false;
   FMS_Data::CpFileOptions mvOptions(options);
   mvOptions.setIsRecursive(true);
   addTransferThread(srcUser,srcMachineName,srcUserKey, destUser, destMachineName,mvOptions);
   return 0;
 }
 
-// Wait until a thread terminates
+// Wait until a transfer terminates
 void
 FileTransferServer::waitThread() {
-  mthread.join();
+  TransferScheduler::getInstance().wait(mfileTransfer.getTransferId());
 }
 
 
@@ -567,27 +627,33 @@ int
 FileTransferServer::stopThread(const std::string& transferid,const int& pid) {
   int result=0;
 
-  if (pid != -1) {
+  if (pid == -1) {
+    // a transfer of the scheduler is only stopped while it is queued
+    if (! TransferScheduler::getInstance().cancel(transferid)) {
+      throw FMSVishnuException(ERRCODE_RUNTIME_ERROR,
+                               "The file transfer "+transferid+" is already running and cannot be stopped yet");
+    }
+  } else {
     result = kill(pid, SIGKILL);
 
     if (result) {
       updateStatus(vishnu::TRANSFER_FAILED, transferid, strerror(errno));
       throw FMSVishnuException(ERRCODE_RUNTIME_ERROR,strerror(errno));
     }
+  }
 
-    // get the user responsible for the stop request
+  // get the user responsible for the stop request
 
-    std::string sessionId = msessionServer.getAttribut("where sessionkey='"+FileTransferServer::getDatabaseInstance()->escapeData((msessionServer.getData()).getSessionKey())+"'", "vsessionid");
-    std::string sqlCommand="SELECT userid,vsessionid "
-                           " FROM users,vsession "
-                           " WHERE vsession.users_numuserid=users.numuserid"
-                           " AND vsessionid='"+ FileTransferServer::getDatabaseInstance()->escapeData(sessionId)+"'";
+  std::string sessionId = msessionServer.getAttribut("where sessionkey='"+FileTransferServer::getDatabaseInstance()->escapeData((msessionServer.getData()).getSessionKey())+"'", "vsessionid");
+  std::string sqlCommand="SELECT userid,vsessionid "
+                         " FROM users,vsession "
+                         " WHERE vsession.users_numuserid=users.numuserid"
+                         " AND vsessionid='"+ FileTransferServer::getDatabaseInstance()->escapeData(sessionId)+"'";
 
-    boost::scoped_ptr<DatabaseResult> dbResult(FileTransferServer::getDatabaseInstance()->getResult(sqlCommand));
-    std::string logMsg= "by: "+ dbResult->getFirstElement();
+  boost::scoped_ptr<DatabaseResult> dbResult(FileTransferServer::getDatabaseInstance()->getResult(sqlCommand));
+  std::string logMsg= "by: "+ dbResult->getFirstElement();
 
-    updateStatus(vishnu::TRANSFER_CANCELLED, transferid, logMsg);
-  }
+  updateStatus(vishnu::TRANSFER_CANCELLED, transferid, logMsg);
   return result;
 }
 
@@ -633,16 +699,21 @@ TransferExec::updatePid(const int& pid) const {
 std::pair<std::string, std::string>
 TransferExec::exec(const std::string& cmd) const
 {
+  std::string sessionOptions = SSHSessionPool::getInstance().getSessionOptions(FileTransferServer::getSSHCommand(),
+                                                                               getSrcUser(),
+                                                                               getSrcMachineName(),
+                                                                               FileTransferServer::getSSHPort());
   std::string command = boost::str(boost::format("%1% -l %2% -C -o BatchMode=yes "
                                                  " -o StrictHostKeyChecking=no"
-                                                 " -o ForwardAgent=yes"
+                                                 " -o ForwardAgent=yes%6%"
                                                  " -p %3% %4% %5%"
                                                  )
                                    % FileTransferServer::getSSHCommand()
                                    % getSrcUser()
                                    % FileTransferServer::getSSHPort()
                                    % getSrcMachineName()
-                                   % cmd);
+                                   % cmd
+                                   % sessionOptions);
 
   std::string output;
   std::pair<std::string, std::string> result;
@@ -325,6 +325,45 @@ public:
   void
   setFileTransfer( const FMS_Data::FileTransfer& fileTransfer) const {mfileTransfer=fileTransfer;}
 
+  /**
+   * \brief To perform a copy transfer
+   * \param transferExec the information about the transfer
+   * \param trCmd the transfer command
+   * \param trManager the transfer manager type (scp, rsync or parallel)
+   */
+  static void
+  copy(const TransferExec& transferExec,
+       const std::string& trCmd,
+       int trManager);
+  /**
+   * \brief To perform a move transfer
+   * \param transferExec the information about the transfer
+   * \param trCmd the transfer command
+   * \param trManager the transfer manager type (scp, rsync or parallel)
+   */
+  static void
+  move(const TransferExec& transferExec,
+       const std::string& trCmd,
+       int trManager);
+  /**
+   * \brief Get the path receiving the data of a transfer, the copy goes
+   * below the destination when it is an existing directory
+   * \param transferExec the information about the transfer
+   * \return the path on the destination machine
+   */
+  static std::string
+  getTargetPath(const TransferExec& transferExec);
+  /**
+   * \brief To Update file transfer data in database
+   * \param status the last execution status
+   * \param transferId the transfer identifier
+   * \param errorMsg the eventual file transfer execution error message
+   */
+  static void
+  updateStatus(const FMS_Data::Status& status,
+               const std::string& transferId,
+               const std::string& errorMsg);
+
 private:
   /**
    * \brief The vishnu instance identifier
@@ -335,9 +374,17 @@ private:
    */
   File::TransferType mtransferType;
   /**
-   * \brief The file transfer execution thread
+   * \brief Whether the client waits for the end of the transfer
    */
-  boost::thread mthread;
+  bool msynchronous;
+  /**
+   * \brief The transfer command
+   */
+  std::string mtransferCommand;
+  /**
+   * \brief The login reaching the source machine
+   */
+  std::string msrcUser;
   /**
    * \brief The session server object
    */
@@ -388,20 +435,6 @@ private:
                     const std::string& destUser,
                     const std::string& destMachineName,
                     const FMS_Data::CpFileOptions& options);
-  /**
-   * \brief To perform a copy transfer
-   * \param transferExec the information about the transfer
-   * \param trCmd the transfer command
-   */
-  void
-  copy(const TransferExec& transferExec, const std::string& trCmd);
-  /**
-   * \brief To perform a move transfer
-   * \param transferExec the information about the transfer
-   * \param trCmd the transfer command
-   */
-  void
-  move(const TransferExec& transferExec, const std::string& trCmd);
   /**
    * \brief To stop a  transfer
    * \param transferid the transfer identifier
@@ -423,16 +456,6 @@ private:
    */
   void
   updateData();
-  /**
-   * \brief To Update file transfer data in database
-   * \param status the last execution status
-   * \param transferId the transfer identifier
-   * \param errorMsg the eventual file transfer execution error message
-   */
-  void
-  updateStatus(const FMS_Data::Status& status,
-               const std::string& transferId,
-               const std::string& errorMsg);
 
   /**
    * \brief A helper function to clean output message from verbosity
@@ -103,7 +103,7 @@ public:
 
     std::string sqlListOfFiles = "SELECT transferId, filetransfer.status, userId, clientMachineId, "
                                  "   sourceMachineId, destinationMachineId, sourceFilePath,"
-                                 "   destinationFilePath, fileSize, startTime,errorMsg, trCommand "
+                                 "   destinationFilePath, fileSize, startTime,errorMsg, trCommand, bytesDone "
                                  " FROM filetransfer, vsession "
                                  " WHERE vsession.numsessionid=filetransfer.vsession_numsessionid";
 
@@ -156,7 +156,8 @@ public:
         // Check the transfer Command enum value
         int trCommand=vishnu::convertToInt(*(++iter));
 
-        filetransfer->setTrCommand( (trCommand >=0&& trCommand<3 ? trCommand:2) );
+        filetransfer->setTrCommand( (trCommand >=0&& trCommand<4 ? trCommand:2) );
+        filetransfer->setBytesDone(boost::lexical_cast<file_size_t>(*(++iter)));
         mlistObject->getFileTransfers().push_back(filetransfer);
       }
     }
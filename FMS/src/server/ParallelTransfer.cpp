@@ -0,0 +1,187 @@
+/**
+ * \file ParallelTransfer.cpp
+ * \brief This file implements the transfer of a large file by chunks sent
+ * over parallel streams
+ */
+
+#include "ParallelTransfer.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <boost/thread.hpp>
+
+#include "Logger.hpp"
+#include "VishnuException.hpp"
+
+
+ParallelTransfer::ParallelTransfer(const TransferExec& transferExec,
+                                   const std::string& trCmd)
+  : mtransferExec(transferExec),
+    mtrCmd(trCmd),
+    mdestExec(FileTransferServer::getSSHCommand(), "",
+              transferExec.getDestMachineName(),
+              FileTransferServer::getSSHPort(),
+              transferExec.getDestUser(), "", "", ""),
+    mfileSize(0),
+    mchunkCount(0),
+    mnextChunk(0) {
+}
+
+
+std::pair<std::string, std::string>
+ParallelTransfer::run() {
+  const std::string& srcPath = mtransferExec.getSrcPath();
+
+  // only the large regular files are split
+  std::istringstream sizeOutput(mtransferExec.exec("'test -f " + srcPath + " && wc -c < " + srcPath + "'").first);
+  if (! (sizeOutput >> mfileSize) || mfileSize < PARALLEL_TRANSFER_MIN_SIZE) {
+    std::ostringstream destCompletePath;
+    destCompletePath << mtransferExec.getDestUser() << "@" << mtransferExec.getDestMachineName()
+                     << ":" << mtransferExec.getDestPath();
+    return mtransferExec.exec(mtrCmd + " " + srcPath + " " + destCompletePath.str());
+  }
+
+  // the chunks are written aside, the destination is replaced once complete
+  std::string target = FileTransferServer::getTargetPath(mtransferExec);
+  mpartPath = getPartPath(target, mtransferExec.getTransferId());
+  mdestExec.exec("rm -f " + mpartPath);
+  mchunkCount = getChunkCount(mfileSize);
+  mnextChunk = 0;
+  merror.clear();
+
+  boost::thread_group streams;
+  int streamCount = getStreamCount(mfileSize);
+  for (int i = 0; i < streamCount; ++i) {
+    streams.create_thread(boost::bind(&ParallelTransfer::runStream, this));
+  }
+  streams.join_all();
+
+  std::pair<std::string, std::string> result;
+  if (merror.empty()) {
+    result = mdestExec.exec("mv -f " + mpartPath + " " + target + " 2>&1");
+    if (result.first.empty() && result.second.empty()) {
+      return result;
+    }
+    merror = "cannot replace the destination: " + result.first + result.second;
+  }
+
+  mdestExec.exec("rm -f " + mpartPath);
+  return std::make_pair(std::string(), merror);
+}
+
+
+void
+ParallelTransfer::runStream() {
+  for (;;) {
+    file_size_t index;
+    {
+      boost::lock_guard<boost::mutex> lock(mmutex);
+      if (! merror.empty() || mnextChunk >= mchunkCount) {
+        return;
+      }
+      index = mnextChunk++;
+    }
+
+    // only the chunk which failed is sent again
+    std::string error;
+    bool sent = false;
+    for (int attempt = 1; attempt <= PARALLEL_TRANSFER_CHUNK_ATTEMPTS && ! sent; ++attempt) {
+      try {
+        sent = sendChunk(index, error);
+      } catch (VishnuException& ex) {
+        error = ex.what();
+      } catch (std::exception& ex) {
+        error = ex.what();
+      }
+      if (! sent) {
+        LOG(boost::str(boost::format("[WARNING] chunk %1% of transfer %2% failed (attempt %3%): %4%")
+                       % index % mtransferExec.getTransferId() % attempt % error), LogWarning);
+      }
+    }
+
+    if (! sent) {
+      boost::lock_guard<boost::mutex> lock(mmutex);
+      if (merror.empty()) {
+        merror = boost::str(boost::format("the chunk %1% cannot be sent: %2%") % index % error);
+      }
+      return;
+    }
+  }
+}
+
+
+bool
+ParallelTransfer::sendChunk(file_size_t index, std::string& error) {
+  const std::string& srcPath = mtransferExec.getSrcPath();
+
+  // the source machine sends the chunk straight to the destination
+  std::string writeCommand = boost::str(boost::format("dd of=%1% bs=%2% seek=%3% conv=notrunc 2>/dev/null")
+                                        % mpartPath % PARALLEL_TRANSFER_CHUNK_SIZE % index);
+  std::pair<std::string, std::string> sendResult =
+      mtransferExec.exec(boost::str(boost::format("'%1% | ssh -q"
+                                                  " -o UserKnownHostsFile=/dev/null"
+                                                  " -o StrictHostKeyChecking=no"
+                                                  " -o PasswordAuthentication=no"
+                                                  " -o BatchMode=yes"
+                                                  " %2%@%3% \"%4%\" 2>&1'")
+                                    % getReadChunkCommand(srcPath, index)
+                                    % mtransferExec.getDestUser()
+                                    % mtransferExec.getDestMachineName()
+                                    % writeCommand));
+  if (! sendResult.first.empty() || ! sendResult.second.empty()) {
+    error = sendResult.first + sendResult.second;
+    return false;
+  }
+
+  // cksum prints the checksum and the size of the chunk
+  std::string srcSum = mtransferExec.exec("'" + getReadChunkCommand(srcPath, index) + " | cksum'").first;
+  std::string destSum = mdestExec.exec(getReadChunkCommand(mpartPath, index) + " | cksum").first;
+  file_size_t expectedSize = std::min(PARALLEL_TRANSFER_CHUNK_SIZE,
+                                      mfileSize - index * PARALLEL_TRANSFER_CHUNK_SIZE);
+  std::istringstream srcOutput(srcSum);
+  std::istringstream destOutput(destSum);
+  unsigned long srcChecksum;
+  unsigned long destChecksum;
+  file_size_t srcSize;
+  file_size_t destSize;
+  if (! (srcOutput >> srcChecksum >> srcSize) || srcSize != expectedSize) {
+    error = "cannot read the chunk on the source machine";
+    return false;
+  }
+  if (! (destOutput >> destChecksum >> destSize) || destChecksum != srcChecksum || destSize != srcSize) {
+    error = "the chunk differs on the destination machine";
+    return false;
+  }
+  return true;
+}
+
+
+std::string
+ParallelTransfer::getPartPath(const std::string& target, const std::string& transferId) {
+  return target + ".vishnu-part-" + transferId;
+}
+
+
+file_size_t
+ParallelTransfer::getChunkCount(file_size_t fileSize) {
+  return (fileSize + PARALLEL_TRANSFER_CHUNK_SIZE - 1) / PARALLEL_TRANSFER_CHUNK_SIZE;
+}
+
+
+int
+ParallelTransfer::getStreamCount(file_size_t fileSize) {
+  if (fileSize < PARALLEL_TRANSFER_MIN_SIZE) {
+    return 1;
+  }
+  return static_cast<int>(std::min(static_cast<file_size_t>(PARALLEL_TRANSFER_STREAMS),
+                                   getChunkCount(fileSize)));
+}
+
+
+std::string
+ParallelTransfer::getReadChunkCommand(const std::string& path, file_size_t index) {
+  return boost::str(boost::format("dd if=%1% bs=%2% skip=%3% count=1 2>/dev/null")
+                    % path % PARALLEL_TRANSFER_CHUNK_SIZE % index);
+}
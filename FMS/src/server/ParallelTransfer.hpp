@@ -0,0 +1,153 @@
+/**
+ * \file ParallelTransfer.hpp
+ * \brief This file declares the transfer of a large file by chunks sent
+ * over parallel streams
+ */
+
+#ifndef _PARALLELTRANSFER_HPP_
+#define _PARALLELTRANSFER_HPP_
+
+#include <string>
+#include <utility>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "FileTransferServer.hpp"
+
+/**
+ * \brief The number of streams sending the chunks of a file at once
+ */
+const int PARALLEL_TRANSFER_STREAMS = 4;
+
+/**
+ * \brief The size in bytes of a chunk
+ */
+const file_size_t PARALLEL_TRANSFER_CHUNK_SIZE = 64 * 1024 * 1024;
+
+/**
+ * \brief The size in bytes below which a file is sent by a single stream
+ */
+const file_size_t PARALLEL_TRANSFER_MIN_SIZE = 4 * PARALLEL_TRANSFER_CHUNK_SIZE;
+
+/**
+ * \brief The number of times a chunk is sent before the transfer fails
+ */
+const int PARALLEL_TRANSFER_CHUNK_ATTEMPTS = 3;
+
+/**
+ * \class ParallelTransfer
+ * \brief Copies a large regular file by chunks, so a link with a high
+ * latency is filled by several TCP streams instead of one. Each chunk is
+ * read at its offset on the source machine and written at the same offset
+ * of a partial file on the destination machine. The checksum and the size
+ * of the chunk are then compared on both machines, and a chunk which differs
+ * is sent again. The partial file replaces the destination once all its
+ * chunks are checked. The directories and the small files are sent by the
+ * single stream command.
+ */
+class ParallelTransfer : public boost::noncopyable {
+public:
+  /**
+   * \brief Constructor
+   * \param transferExec the information about the transfer
+   * \param trCmd the command sending a file by a single stream
+   */
+  ParallelTransfer(const TransferExec& transferExec, const std::string& trCmd);
+
+  /**
+   * \brief Perform the transfer
+   * \return The output and the error of the transfer, both empty on success
+   */
+  std::pair<std::string, std::string>
+  run();
+
+  /**
+   * \brief Get the path of the partial file receiving the chunks
+   * \param target the path receiving the data
+   * \param transferId the transfer identifier
+   * \return the path of the partial file on the destination machine
+   */
+  static std::string
+  getPartPath(const std::string& target, const std::string& transferId);
+
+  /**
+   * \brief Get the number of chunks of a file
+   * \param fileSize the size of the file
+   * \return the number of chunks, the last one may be shorter
+   */
+  static file_size_t
+  getChunkCount(file_size_t fileSize);
+
+  /**
+   * \brief Get the number of streams sending a file
+   * \param fileSize the size of the file
+   * \return the number of streams, 1 for the files sent by the single
+   * stream command
+   */
+  static int
+  getStreamCount(file_size_t fileSize);
+
+private:
+  /**
+   * \brief The loop of a stream, it sends the chunks not taken yet
+   */
+  void
+  runStream();
+
+  /**
+   * \brief Send a chunk and check it at the destination
+   * \param index the index of the chunk in the file
+   * \param error OUT, the reason of a failure
+   * \return true if the chunk is identical on both machines
+   */
+  bool
+  sendChunk(file_size_t index, std::string& error);
+
+  /**
+   * \brief Get the command reading a chunk of a file
+   * \param path the file path
+   * \param index the index of the chunk in the file
+   * \return the command printing the chunk
+   */
+  static std::string
+  getReadChunkCommand(const std::string& path, file_size_t index);
+
+  /**
+   * \brief The information about the transfer
+   */
+  const TransferExec& mtransferExec;
+  /**
+   * \brief The command sending a file by a single stream
+   */
+  std::string mtrCmd;
+  /**
+   * \brief The runner of the commands on the destination machine
+   */
+  SSHExec mdestExec;
+  /**
+   * \brief The path of the partial file on the destination machine
+   */
+  std::string mpartPath;
+  /**
+   * \brief The size of the source file
+   */
+  file_size_t mfileSize;
+  /**
+   * \brief The number of chunks of the file
+   */
+  file_size_t mchunkCount;
+  /**
+   * \brief The next chunk to send
+   */
+  file_size_t mnextChunk;
+  /**
+   * \brief The reason of the failure, the streams stop when it is set
+   */
+  std::string merror;
+  /**
+   * \brief mutex protecting the next chunk and the failure
+   */
+  boost::mutex mmutex;
+};
+
+#endif // _PARALLELTRANSFER_HPP_
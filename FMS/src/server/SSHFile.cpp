@@ -7,6 +7,7 @@
 #include <iterator>
 #include <iostream>
 #include <boost/regex.hpp>
+#include <boost/bind.hpp>
 
 #include <unistd.h>
 #include <sys/wait.h>
@@ -20,6 +21,8 @@
 #include "utilServer.hpp"
 #include "FileTransferCommand.hpp"
 #include "FileTypes.hpp"
+#include "SSHSessionPool.hpp"
+#include "FileStatCache.hpp"
 #include <boost/date_time/time_zone_base.hpp>
 #include <boost/scoped_ptr.hpp>
 
@@ -100,18 +103,24 @@ SSHFile::isUpToDate() const {
   return upToDate;
 }
 
-/* Get the file information through ssh. */
+/* Get the key of the file in the cache of the file information. */
+std::string
+SSHFile::getStatKey() const {
+  return FileStatCache::getKey(sshUser, sshHost, sshPort, getPath());
+}
+
+/* Drop the cached information of the file. */
 void
-SSHFile::getInfos() const {
+SSHFile::invalidateInfos() const {
+  FileStatCache::getInstance().invalidate(getStatKey());
+}
+
+/* Run the stat command through ssh. */
+std::pair<std::string, std::string>
+SSHFile::statRemoteFile() const {
   SSHExec ssh(sshCommand, scpCommand, sshHost, sshPort, sshUser, sshPassword,
               sshPublicKey, sshPrivateKey);
   std::pair<std::string, std::string> fileStat;
-  std::string owner, group, fileType;
-  mode_t perms;
-  uid_t uid;
-  gid_t gid;
-  file_size_t size;
-  time_t atime, mtime, ctime;
 
   fileStat = ssh.exec(STATCMD_DEFAULT + getPath());
 
@@ -123,7 +132,23 @@ SSHFile::getInfos() const {
       fileStat = ssh.exec(STATCMD_BSD + getPath());
     }
   }
+  return fileStat;
+}
+
+/* Get the file information through ssh, a single command runs for the
+ * lookups of the same file made meanwhile. */
+void
+SSHFile::getInfos() const {
+  std::pair<std::string, std::string> fileStat;
+  std::string owner, group, fileType;
+  mode_t perms;
+  uid_t uid;
+  gid_t gid;
+  file_size_t size;
+  time_t atime, mtime, ctime;
 
+  fileStat = FileStatCache::getInstance().get(getStatKey(),
+                                              boost::bind(&SSHFile::statRemoteFile, this));
 
   if (fileStat.second.length() != 0) {
 
@@ -190,6 +215,7 @@ SSHFile::chgrp(const std::string& group) {
     throw FMSVishnuException(ERRCODE_INVALID_PATH, getErrorMsg());
   }
   chgrpResult = ssh.exec(CHGRPCMD + group + " " + getPath());
+  invalidateInfos();
   if (chgrpResult.second.length() != 0) {
     throw FMSVishnuException(ERRCODE_INVALID_PATH,
                              "Error changing file group: " + chgrpResult.second);
@@ -212,6 +238,7 @@ SSHFile::chmod(const mode_t mode) {
   }
   os << mode;
   chmodResult = ssh.exec(CHMODCMD+os.str()+" "+getPath());
+  invalidateInfos();
 
   if (chmodResult.second.length() != 0) {
     throw FMSVishnuException(ERRCODE_INVALID_PATH,
@@ -268,6 +295,41 @@ SSHFile::getContent() {
 
   return catResult.first;
 }
+
+/* Get a range of the file content through ssh, the size is read by the same
+ * command so a reader knows where the file ends. */
+std::string
+SSHFile::read(file_size_t offset, file_size_t length, file_size_t& fileSize) {
+  SSHExec ssh(sshCommand, scpCommand, sshHost, sshPort, sshUser, sshPassword,
+              sshPublicKey, sshPrivateKey);
+  std::pair<std::string,std::string> readResult;
+
+  if (offset < 0 || length < 0) {
+    throw FMSVishnuException(ERRCODE_INVALID_PARAM, "Invalid range of the file");
+  }
+  length = std::min(length, static_cast<file_size_t>(maxFileReadChunkSize));
+
+  std::string command = SIZECMD + getPath();
+  if (length > 0) {
+    command += boost::str(boost::format(" && %1%%2% %3% | %4%%5%")
+                          % SKIPCMD % (offset + 1) % getPath() % TAKECMD % length);
+  }
+  readResult = ssh.exec(command);
+
+  size_t pos = readResult.first.find('\n');
+  if (readResult.second.length() != 0 || pos == std::string::npos) {
+    // the file is looked up only to report why it cannot be read
+    if (!exists()) {
+      throw FMSVishnuException(ERRCODE_INVALID_PATH, getErrorMsg());
+    }
+    throw FMSVishnuException(ERRCODE_RUNTIME_ERROR,
+                             "Error reading the file: " + readResult.second);
+  }
+
+  std::istringstream is(readResult.first.substr(0, pos));
+  is >> fileSize;
+  return readResult.first.substr(pos + 1);
+}
 /* Create a file through ssh. */
 int
 SSHFile::mkfile(const mode_t mode) {
@@ -281,6 +343,7 @@ SSHFile::mkfile(const mode_t mode) {
   }
 
   mkfileResult = ssh.exec(MKFILECMD + getPath());
+  invalidateInfos();
   if (mkfileResult.second.length() != 0) {
     throw FMSVishnuException(ERRCODE_RUNTIME_ERROR,
                              "Error creating " + getPath() + ": " + mkfileResult.second);
@@ -309,6 +372,7 @@ SSHFile::mkdir(const FMS_Data::CreateDirOptions& options) {
   }
 
   mkdirResult = ssh.exec(MKDIRCMD + os.str() + " " + getPath());
+  invalidateInfos();
   if (mkdirResult.second.length() != 0) {
     throw FMSVishnuException(ERRCODE_RUNTIME_ERROR,
                              "Error creating " + getPath() + ": " + mkdirResult.second);
@@ -335,6 +399,7 @@ SSHFile::rm(const FMS_Data::RmFileOptions& options) {
   } else {
     rmResult = ssh.exec(RMCMD + getPath());
   }
+  invalidateInfos();
 
   if (rmResult.second.length() != 0) {
     throw FMSVishnuException(ERRCODE_RUNTIME_ERROR,
@@ -358,6 +423,7 @@ SSHFile::rmdir() {
   }
 
   rmdirResult = ssh.exec(RMDIRCMD + getPath());
+  invalidateInfos();
 
   if (rmdirResult.second.length() != 0) {
     throw FMSVishnuException(ERRCODE_RUNTIME_ERROR,
@@ -569,11 +635,14 @@ SSHExec::exec(const std::string& cmd) const {
 
   const std::string BEGIN_MARKER = "beginVishnuCommand";
 
+  // the command runs over the shared connection to the host when there is one
+  std::string sessionOptions = SSHSessionPool::getInstance().getSessionOptions(sshCommand, userName, server, sshPort);
   std::string command = boost::str(boost::format("%1% -l %2% -C -o BatchMode=yes "
                                                  " -o StrictHostKeyChecking=no"
-                                                 " -o ForwardAgent=yes"
+                                                 " -o ForwardAgent=yes%7%"
                                                  " -p %3% %4% echo %5% && %6%"
-                                                 )% sshCommand % userName % sshPort % server % BEGIN_MARKER % cmd);
+                                                 )% sshCommand % userName % sshPort % server % BEGIN_MARKER % cmd
+                                                  % sessionOptions);
 
   std::string output;
   std::pair<std::string, std::string> result;
@@ -35,6 +35,18 @@
  * \brief An alias of head command
  */
 #define CATCMD  "cat "
+/**
+ * \brief An alias of the command giving the size of a file
+ */
+#define SIZECMD  "wc -c < "
+/**
+ * \brief An alias of the command skipping the start of a file
+ */
+#define SKIPCMD  "tail -c +"
+/**
+ * \brief An alias of the command keeping the start of a stream
+ */
+#define TAKECMD  "head -c "
 /**
  * \brief An alias of ls command
  */
@@ -141,6 +153,23 @@ class SSHFile : public File {
      * \brief the last error during file properties manipulation
      */
     mutable std::string merror;
+
+    /**
+     * \brief To get the key of the file in the cache of the file information
+     * \return the user, host, port and path of the file
+     */
+    std::string getStatKey() const;
+
+    /**
+     * \brief To run the stat command through ssh
+     * \return the output and the error of the command
+     */
+    std::pair<std::string, std::string> statRemoteFile() const;
+
+    /**
+     * \brief To drop the cached information of the file, after a change
+     */
+    void invalidateInfos() const;
   public:
 
     /*ù
@@ -240,6 +269,14 @@ class SSHFile : public File {
      * \return the content of the file
      */
     virtual std::string getContent();
+    /**
+     * \brief To get a range of the content of the file
+     * \param offset the position of the first byte
+     * \param length the maximum number of bytes
+     * \param fileSize the current size of the file
+     * \return the bytes read, fewer than length at the end of the file
+     */
+    virtual std::string read(file_size_t offset, file_size_t length, file_size_t& fileSize);
     /**
      * \brief To create a new file
      * \param mode the access permission of the file
@@ -0,0 +1,145 @@
+/**
+ * \file SSHSessionPool.cpp
+ * \brief This file implements the pool of shared ssh connections used by the
+ * file commands
+ */
+
+#include "SSHSessionPool.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
+
+#include "Logger.hpp"
+#include "utilVishnu.hpp"
+
+
+SSHSessionPool&
+SSHSessionPool::getInstance() {
+  static SSHSessionPool instance;
+  return instance;
+}
+
+
+SSHSessionPool::SSHSessionPool() {
+  // the control sockets give access to the connections, the directory is
+  // private to the user running the server
+  std::string dir = boost::str(boost::format("/tmp/vishnu-ssh-%1%") % geteuid());
+  if (::mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) {
+    LOG(boost::str(boost::format("[WARNING] cannot create %1%, the ssh connections are not shared: %2%")
+                   % dir % strerror(errno)), LogWarning);
+    return;
+  }
+  struct stat st;
+  if (lstat(dir.c_str(), &st) != 0
+      || ! S_ISDIR(st.st_mode)
+      || st.st_uid != geteuid()
+      || (st.st_mode & (S_IRWXG | S_IRWXO)) != 0) {
+    LOG(boost::str(boost::format("[WARNING] %1% is not a private directory, the ssh connections are not shared")
+                   % dir), LogWarning);
+    return;
+  }
+  mcontrolDir = dir;
+}
+
+
+std::string
+SSHSessionPool::getSessionOptions(const std::string& sshCommand,
+                                  const std::string& user,
+                                  const std::string& host,
+                                  unsigned int port) {
+  if (mcontrolDir.empty()) {
+    return "";
+  }
+
+  // the path of a unix socket is short, the connection is named by a hash
+  std::string connection = boost::str(boost::format("%1% %2%@%3%:%4%")
+                                      % sshCommand % user % host % port);
+  std::string controlPath = boost::str(boost::format("%1%/%2$x")
+                                       % mcontrolDir
+                                       % boost::hash<std::string>()(connection));
+
+  boost::shared_ptr<Connection> entry;
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    boost::shared_ptr<Connection>& current = mconnections[connection];
+    if (! current) {
+      current.reset(new Connection);
+      current->retryDate = 0;
+    }
+    entry = current;
+  }
+
+  boost::lock_guard<boost::mutex> lock(entry->mutex);
+  if (! isMasterAlive(controlPath)) {
+    // a host which cannot be reached does not cost two connections per command
+    if (time(NULL) < entry->retryDate) {
+      return "";
+    }
+    if (! startMaster(sshCommand, user, host, port, controlPath)) {
+      entry->retryDate = time(NULL) + SSH_SESSION_RETRY_DELAY;
+      return "";
+    }
+  }
+  // a master which stopped meanwhile makes ssh open its own connection
+  return " -o ControlMaster=no -o ControlPath="+ controlPath;
+}
+
+
+bool
+SSHSessionPool::isMasterAlive(const std::string& controlPath) {
+  struct sockaddr_un address;
+  if (controlPath.size() >= sizeof(address.sun_path)) {
+    return false;
+  }
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, controlPath.c_str(), sizeof(address.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return false;
+  }
+  bool alive = (connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == 0);
+  int error = errno;
+  close(fd);
+  if (! alive && error == ECONNREFUSED) {
+    unlink(controlPath.c_str());
+  }
+  return alive;
+}
+
+
+bool
+SSHSessionPool::startMaster(const std::string& sshCommand,
+                            const std::string& user,
+                            const std::string& host,
+                            unsigned int port,
+                            const std::string& controlPath) {
+  // ssh goes in the background once authenticated
+  std::string command = boost::str(boost::format("%1% -l %2% -C -o BatchMode=yes "
+                                                 " -o StrictHostKeyChecking=no"
+                                                 " -o ForwardAgent=yes"
+                                                 " -o ControlMaster=yes"
+                                                 " -o ControlPath=%3%"
+                                                 " -o ControlPersist=%4%"
+                                                 " -N -f -p %5% %6%"
+                                                 " </dev/null >/dev/null 2>&1")
+                                   % sshCommand % user % controlPath
+                                   % SSH_SESSION_IDLE_TIME % port % host);
+  std::string output;
+  vishnu::execSystemCommand(command, output);
+
+  if (! isMasterAlive(controlPath)) {
+    LOG(boost::str(boost::format("[WARNING] cannot open a shared ssh connection to %1%@%2%:%3%")
+                   % user % host % port), LogWarning);
+    return false;
+  }
+  return true;
+}
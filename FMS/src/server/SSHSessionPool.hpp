@@ -0,0 +1,121 @@
+/**
+ * \file SSHSessionPool.hpp
+ * \brief This file declares the pool of shared ssh connections used by the
+ * file commands
+ */
+
+#ifndef _SSHSESSIONPOOL_HPP_
+#define _SSHSESSIONPOOL_HPP_
+
+#include <map>
+#include <string>
+#include <ctime>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+/**
+ * \brief The time in seconds after which an idle connection is closed
+ */
+const int SSH_SESSION_IDLE_TIME = 300;
+
+/**
+ * \brief The time in seconds during which a master is not started again
+ * after a failure
+ */
+const int SSH_SESSION_RETRY_DELAY = 60;
+
+/**
+ * \class SSHSessionPool
+ * \brief Keeps a master ssh connection per user, host and port, so the
+ * commands run as channels of a connection already authenticated instead of
+ * opening their own. The masters are ssh processes listening on a control
+ * socket, they stop by themselves once idle. A command falls back to its own
+ * connection when no master can be started.
+ */
+class SSHSessionPool : public boost::noncopyable {
+public:
+  /**
+   * \brief Get the pool of the process
+   * \return the pool
+   */
+  static SSHSessionPool&
+  getInstance();
+
+  /**
+   * \brief Get the ssh options running a command over the shared connection,
+   * the connection is opened if needed
+   * \param sshCommand the ssh command path
+   * \param user the ssh user
+   * \param host the ssh host
+   * \param port the ssh port
+   * \return the options to add to the ssh command, empty if the command must
+   * open its own connection
+   */
+  std::string
+  getSessionOptions(const std::string& sshCommand,
+                    const std::string& user,
+                    const std::string& host,
+                    unsigned int port);
+
+private:
+  /**
+   * \brief Constructor
+   */
+  SSHSessionPool();
+
+  /**
+   * \struct Connection
+   * \brief The state of a shared connection
+   */
+  struct Connection {
+    /**
+     * \brief mutex serializing the starts of the master
+     */
+    boost::mutex mutex;
+    /**
+     * \brief The date before which the master is not started again
+     */
+    time_t retryDate;
+  };
+
+  /**
+   * \brief Check whether a master listens on a control socket, a socket left
+   * by a master which died is removed
+   * \param controlPath the path of the control socket
+   * \return true if the master is alive
+   */
+  bool
+  isMasterAlive(const std::string& controlPath);
+
+  /**
+   * \brief Start a master connection in the background
+   * \param sshCommand the ssh command path
+   * \param user the ssh user
+   * \param host the ssh host
+   * \param port the ssh port
+   * \param controlPath the path of the control socket
+   * \return true if the master is listening
+   */
+  bool
+  startMaster(const std::string& sshCommand,
+              const std::string& user,
+              const std::string& host,
+              unsigned int port,
+              const std::string& controlPath);
+
+  /**
+   * \brief The directory holding the control sockets, empty if it cannot be used
+   */
+  std::string mcontrolDir;
+  /**
+   * \brief The connections, by ssh command, user, host and port
+   */
+  std::map<std::string, boost::shared_ptr<Connection> > mconnections;
+  /**
+   * \brief mutex protecting the connections
+   */
+  boost::mutex mmutex;
+};
+
+#endif // _SSHSESSIONPOOL_HPP_
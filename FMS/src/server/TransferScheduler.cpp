@@ -0,0 +1,549 @@
+/**
+ * \file TransferScheduler.cpp
+ * \brief This file implements the scheduler of the file transfers run by the
+ * server
+ */
+
+#include "TransferScheduler.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "FMSVishnuException.hpp"
+#include "Logger.hpp"
+#include "ParallelTransfer.hpp"
+#include "utilVishnu.hpp"
+
+
+TransferScheduler&
+TransferScheduler::getInstance() {
+  static TransferScheduler instance;
+  return instance;
+}
+
+
+TransferScheduler::TransferScheduler()
+  : mstarted(false), mtransfersLimit(DEFAULT_TRANSFERS_LIMIT), mwaiting(0),
+    mqueue(DEFAULT_TRANSFERS_PER_HOST_LIMIT) {
+}
+
+
+void
+TransferScheduler::start(int transfersLimit,
+                         int transfersPerHostLimit,
+                         const std::string& serverUri) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  if (mstarted) {
+    return;
+  }
+  mstarted = true;
+  mtransfersLimit = std::max(1, transfersLimit);
+  mqueue.setHostLimit(transfersPerHostLimit);
+  mserverUri = serverUri;
+
+  resume();
+
+  for (size_t i = 0; i < mtransfersLimit; ++i) {
+    mworkers.create_thread(boost::bind(&TransferScheduler::runWorker, this));
+  }
+  mworkers.create_thread(boost::bind(&TransferScheduler::runProgress, this));
+}
+
+
+void
+TransferScheduler::submit(const TransferExec& transferExec,
+                          const std::string& trCmd,
+                          int trManager,
+                          File::TransferType transferType,
+                          const std::string& userId,
+                          file_size_t fileSize) {
+  boost::shared_ptr<Transfer> transfer(new Transfer(transferExec));
+  transfer->command = trCmd;
+  transfer->manager = trManager;
+  transfer->type = transferType;
+  transfer->userId = userId;
+  transfer->fileSize = fileSize;
+
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  if (! mstarted) {
+    throw FMSVishnuException(ERRCODE_RUNTIME_ERROR, "The file transfers are not scheduled by this server");
+  }
+  enqueue(transfer);
+}
+
+
+void
+TransferScheduler::run(const TransferExec& transferExec,
+                       const std::string& trCmd,
+                       int trManager,
+                       File::TransferType transferType,
+                       const std::string& userId,
+                       file_size_t fileSize) {
+  boost::shared_ptr<Transfer> transfer(new Transfer(transferExec));
+  transfer->command = trCmd;
+  transfer->manager = trManager;
+  transfer->type = transferType;
+  transfer->userId = userId;
+  transfer->fileSize = fileSize;
+
+  {
+    boost::unique_lock<boost::mutex> lock(mmutex);
+    if (! mstarted) {
+      throw FMSVishnuException(ERRCODE_RUNTIME_ERROR, "The file transfers are not scheduled by this server");
+    }
+    mtransfers[transferExec.getTransferId()] = transfer;
+    // the slot and the streams are kept from the queued transfers while it waits
+    ++mwaiting;
+    mqueue.countWaiting(*transfer, 1);
+    while (mrunning.size() >= mtransfersLimit || ! mqueue.tryStart(*transfer)) {
+      mchanged.wait(lock);
+    }
+    mqueue.countWaiting(*transfer, -1);
+    --mwaiting;
+    mrunning.push_back(transfer);
+  }
+
+  perform(transfer);
+  finish(transfer);
+}
+
+
+void
+TransferScheduler::wait(const std::string& transferId) {
+  boost::unique_lock<boost::mutex> lock(mmutex);
+  while (mtransfers.find(transferId) != mtransfers.end()) {
+    mchanged.wait(lock);
+  }
+}
+
+
+bool
+TransferScheduler::cancel(const std::string& transferId) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  std::map<std::string, boost::shared_ptr<Transfer> >::iterator it = mtransfers.find(transferId);
+  if (it == mtransfers.end()) {
+    return false;
+  }
+  if (! mqueue.remove(it->second)) {
+    // already taken by a worker
+    return false;
+  }
+  mtransfers.erase(it);
+  mchanged.notify_all();
+  return true;
+}
+
+
+void
+TransferScheduler::runWorker() {
+  for (;;) {
+    boost::shared_ptr<Transfer> transfer;
+    {
+      boost::unique_lock<boost::mutex> lock(mmutex);
+      while (! (transfer = pickTransfer())) {
+        mchanged.wait(lock);
+      }
+    }
+
+    perform(transfer);
+    finish(transfer);
+  }
+}
+
+
+void
+TransferScheduler::finish(const boost::shared_ptr<Transfer>& transfer) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  mqueue.countRunning(*transfer, -1);
+  mrunning.remove(transfer);
+  mtransfers.erase(transfer->exec.getTransferId());
+  mchanged.notify_all();
+}
+
+
+void
+TransferScheduler::perform(const boost::shared_ptr<Transfer>& transfer) {
+  const TransferExec& transferExec = transfer->exec;
+  try {
+    std::string target = FileTransferServer::getTargetPath(transferExec);
+    {
+      boost::lock_guard<boost::mutex> lock(mmutex);
+      transfer->target = target;
+    }
+
+    if (transfer->type == File::move) {
+      FileTransferServer::move(transferExec, transfer->command, transfer->manager);
+    } else {
+      FileTransferServer::copy(transferExec, transfer->command, transfer->manager);
+    }
+
+    std::string sqlUpdate = boost::str(boost::format("UPDATE filetransfer SET bytesdone=filesize"
+                                                     " WHERE transferid='%1%' AND status=%2%")
+                                       % FileTransferServer::getDatabaseInstance()->escapeData(transferExec.getTransferId())
+                                       % vishnu::TRANSFER_COMPLETED);
+    FileTransferServer::getDatabaseInstance()->process(sqlUpdate);
+  } catch (VishnuException& ex) {
+    LOG(boost::str(boost::format("[ERROR] transfer %1% failed: %2%")
+                   % transferExec.getTransferId() % ex.what()), LogErr);
+    try {
+      FileTransferServer::updateStatus(vishnu::TRANSFER_FAILED, transferExec.getTransferId(), ex.what());
+    } catch (VishnuException&) {
+    }
+  } catch (std::exception& ex) {
+    LOG(boost::str(boost::format("[ERROR] transfer %1% failed: %2%")
+                   % transferExec.getTransferId() % ex.what()), LogErr);
+  }
+}
+
+
+void
+TransferScheduler::runProgress() {
+  for (;;) {
+    boost::this_thread::sleep(boost::posix_time::seconds(TRANSFER_PROGRESS_PERIOD));
+
+    std::vector<std::pair<boost::shared_ptr<Transfer>, std::string> > running;
+    {
+      boost::lock_guard<boost::mutex> lock(mmutex);
+      for (std::list<boost::shared_ptr<Transfer> >::const_iterator it = mrunning.begin();
+           it != mrunning.end(); ++it) {
+        if (! (*it)->target.empty()) {
+          running.push_back(std::make_pair(*it, (*it)->target));
+        }
+      }
+    }
+
+    for (size_t i = 0; i < running.size(); ++i) {
+      const Transfer& transfer = *running[i].first;
+      try {
+        SSHExec destExec(FileTransferServer::getSSHCommand(), "",
+                         transfer.exec.getDestMachineName(),
+                         FileTransferServer::getSSHPort(),
+                         transfer.exec.getDestUser(), "", "", "");
+        // the chunks of a parallel transfer are written aside, the blocks
+        // allocated are counted as they are written at their offset
+        std::string command = "du -sb " + running[i].second;
+        if (mqueue.getStreamCount(transfer) > 1) {
+          command = "du -s --block-size=1 "
+                    + ParallelTransfer::getPartPath(running[i].second, transfer.exec.getTransferId());
+        }
+        std::istringstream output(destExec.exec(command).first);
+        file_size_t bytesDone = 0;
+        if (! (output >> bytesDone)) {
+          continue;
+        }
+        if (transfer.fileSize > 0) {
+          bytesDone = std::min(bytesDone, transfer.fileSize);
+        }
+        std::string sqlUpdate = boost::str(boost::format("UPDATE filetransfer SET bytesdone=%1%"
+                                                         " WHERE transferid='%2%' AND status=%3%")
+                                           % bytesDone
+                                           % FileTransferServer::getDatabaseInstance()->escapeData(transfer.exec.getTransferId())
+                                           % vishnu::TRANSFER_INPROGRESS);
+        FileTransferServer::getDatabaseInstance()->process(sqlUpdate);
+      } catch (VishnuException& ex) {
+        LOG(boost::str(boost::format("[WARNING] cannot measure the progress of the transfer %1%: %2%")
+                       % transfer.exec.getTransferId() % ex.what()), LogWarning);
+      }
+    }
+  }
+}
+
+
+boost::shared_ptr<TransferScheduler::Transfer>
+TransferScheduler::pickTransfer() {
+  if (mrunning.size() + mwaiting >= mtransfersLimit) {
+    return boost::shared_ptr<Transfer>();
+  }
+  boost::shared_ptr<Transfer> transfer = mqueue.pick();
+  if (transfer) {
+    mrunning.push_back(transfer);
+  }
+  return transfer;
+}
+
+
+void
+TransferScheduler::enqueue(const boost::shared_ptr<Transfer>& transfer) {
+  mqueue.push(transfer);
+  mtransfers[transfer->exec.getTransferId()] = transfer;
+  mchanged.notify_all();
+}
+
+
+void
+TransferScheduler::resume() {
+  std::vector<boost::shared_ptr<Transfer> > transfers;
+  loadUnfinished(mserverUri, transfers);
+  for (size_t i = 0; i < transfers.size(); ++i) {
+    enqueue(transfers[i]);
+  }
+
+  if (! transfers.empty()) {
+    LOG(boost::str(boost::format("[INFO] %1% file transfers resumed") % transfers.size()), LogInfo);
+  }
+}
+
+
+void
+TransferScheduler::loadUnfinished(const std::string& serverUri,
+                                  std::vector<boost::shared_ptr<Transfer> >& transfers) {
+  try {
+    Database* db = FileTransferServer::getDatabaseInstance();
+    std::string sqlRequest = boost::str(boost::format("SELECT transferid, userid, sourcemachineid, destinationmachineid,"
+                                                      "   sourcefilepath, destinationfilepath, transfercmd, transfertype,"
+                                                      "   filesize, sessionkey, trcommand, sourceuser"
+                                                      " FROM filetransfer, vsession"
+                                                      " WHERE vsession.numsessionid=filetransfer.vsession_numsessionid"
+                                                      "  AND filetransfer.status=%1%"
+                                                      "  AND filetransfer.serveruri='%2%'"
+                                                      " ORDER BY numfiletransferid")
+                                        % vishnu::TRANSFER_INPROGRESS
+                                        % db->escapeData(serverUri));
+    boost::scoped_ptr<DatabaseResult> result(db->getResult(sqlRequest));
+
+    for (size_t i = 0; i < result->getNbTuples(); ++i) {
+      std::vector<std::string> row = result->get(i);
+      const std::string& transferId = row[0];
+      const std::string& userId = row[1];
+      std::string srcUser;
+      std::string srcMachineName;
+      std::string destUser;
+      std::string destMachineName;
+      bool hasSource = getAccount(userId, row[2], srcUser, srcMachineName);
+      // a source which is not a VISHNU machine is a client host, it is
+      // reached with the login given by the request
+      if (! hasSource && ! row[11].empty() && ! isMachine(row[2])) {
+        srcUser = row[11];
+        srcMachineName = row[2];
+        hasSource = true;
+      }
+      if (row[6].empty()
+          || ! hasSource
+          || ! getAccount(userId, row[3], destUser, destMachineName)) {
+        FileTransferServer::updateStatus(vishnu::TRANSFER_FAILED, transferId,
+                                         "the transfer cannot be resumed after the restart of the server");
+        continue;
+      }
+
+      TransferExec transferExec(SessionServer(row[9]),
+                                srcUser,
+                                srcMachineName,
+                                row[4],
+                                "",
+                                destUser,
+                                destMachineName,
+                                row[5],
+                                transferId);
+      boost::shared_ptr<Transfer> transfer(new Transfer(transferExec));
+      transfer->command = row[6];
+      transfer->manager = vishnu::convertToInt(row[10]);
+      transfer->type = (vishnu::convertToInt(row[7]) == File::move) ? File::move : File::copy;
+      transfer->userId = userId;
+      transfer->fileSize = vishnu::convertToLong(row[8]);
+      transfers.push_back(transfer);
+    }
+  } catch (VishnuException& ex) {
+    LOG(boost::str(boost::format("[WARNING] cannot resume the file transfers: %1%") % ex.what()), LogWarning);
+  }
+}
+
+
+bool
+TransferScheduler::getAccount(const std::string& userId,
+                              const std::string& machineId,
+                              std::string& login,
+                              std::string& machineName) {
+  Database* db = FileTransferServer::getDatabaseInstance();
+  std::string sqlRequest = boost::str(boost::format("SELECT aclogin, machine.name"
+                                                    " FROM account, machine, users"
+                                                    " WHERE account.machine_nummachineid=machine.nummachineid"
+                                                    "  AND account.users_numuserid=users.numuserid"
+                                                    "  AND machine.machineid='%1%'"
+                                                    "  AND users.userid='%2%'"
+                                                    "  AND account.status=%3%"
+                                                    "  AND machine.status=%3%"
+                                                    "  AND users.status=%3%")
+                                      % db->escapeData(machineId)
+                                      % db->escapeData(userId)
+                                      % vishnu::STATUS_ACTIVE);
+  boost::scoped_ptr<DatabaseResult> result(db->getResult(sqlRequest));
+  if (result->getNbTuples() == 0) {
+    return false;
+  }
+  std::vector<std::string> row = result->get(0);
+  login = row[0];
+  machineName = row[1];
+  return ! login.empty();
+}
+
+
+bool
+TransferScheduler::isMachine(const std::string& machineId) {
+  Database* db = FileTransferServer::getDatabaseInstance();
+  std::string sqlRequest = boost::str(boost::format("SELECT nummachineid FROM machine WHERE machineid='%1%'")
+                                      % db->escapeData(machineId));
+  boost::scoped_ptr<DatabaseResult> result(db->getResult(sqlRequest));
+  return result->getNbTuples() != 0;
+}
+
+
+TransferScheduler::Queue::Queue(int transfersPerHostLimit)
+  : mtransfersPerHostLimit(std::max(1, transfersPerHostLimit)) {
+}
+
+
+void
+TransferScheduler::Queue::setHostLimit(int transfersPerHostLimit) {
+  mtransfersPerHostLimit = std::max(1, transfersPerHostLimit);
+}
+
+
+void
+TransferScheduler::Queue::push(const boost::shared_ptr<Transfer>& transfer) {
+  std::deque<boost::shared_ptr<Transfer> >& queue = mqueues[transfer->userId];
+  if (queue.empty()) {
+    musers.push_back(transfer->userId);
+  }
+  queue.push_back(transfer);
+}
+
+
+bool
+TransferScheduler::Queue::remove(const boost::shared_ptr<Transfer>& transfer) {
+  std::map<std::string, std::deque<boost::shared_ptr<Transfer> > >::iterator queue = mqueues.find(transfer->userId);
+  if (queue == mqueues.end()) {
+    return false;
+  }
+  std::deque<boost::shared_ptr<Transfer> >::iterator queued = std::find(queue->second.begin(),
+                                                                        queue->second.end(),
+                                                                        transfer);
+  if (queued == queue->second.end()) {
+    return false;
+  }
+  queue->second.erase(queued);
+  if (queue->second.empty()) {
+    mqueues.erase(queue);
+    musers.remove(transfer->userId);
+  }
+  return true;
+}
+
+
+boost::shared_ptr<TransferScheduler::Transfer>
+TransferScheduler::Queue::pick() {
+  // the user with the fewest running transfers, the first of the list on ties
+  std::list<std::string>::iterator chosenUser = musers.end();
+  std::deque<boost::shared_ptr<Transfer> >::iterator chosen;
+  int fewest = 0;
+  for (std::list<std::string>::iterator user = musers.begin(); user != musers.end(); ++user) {
+    std::map<std::string, int>::const_iterator count = mrunningByUser.find(*user);
+    int running = (count != mrunningByUser.end()) ? count->second : 0;
+    if (chosenUser != musers.end() && running >= fewest) {
+      continue;
+    }
+    // a transfer of the user whose machines are not busy
+    std::deque<boost::shared_ptr<Transfer> >& queue = mqueues[*user];
+    for (std::deque<boost::shared_ptr<Transfer> >::iterator it = queue.begin(); it != queue.end(); ++it) {
+      const std::string& srcHost = (*it)->exec.getSrcMachineName();
+      const std::string& destHost = (*it)->exec.getDestMachineName();
+      int streams = getStreamCount(**it);
+      if (isHostAvailable(srcHost, streams + getWaitingStreams(srcHost))
+          && isHostAvailable(destHost, streams + getWaitingStreams(destHost))) {
+        chosenUser = user;
+        chosen = it;
+        fewest = running;
+        break;
+      }
+    }
+  }
+  if (chosenUser == musers.end()) {
+    return boost::shared_ptr<Transfer>();
+  }
+
+  boost::shared_ptr<Transfer> transfer = *chosen;
+  std::string userId = *chosenUser;
+  std::deque<boost::shared_ptr<Transfer> >& queue = mqueues[userId];
+  queue.erase(chosen);
+  // the user goes behind the others
+  musers.erase(chosenUser);
+  if (queue.empty()) {
+    mqueues.erase(userId);
+  } else {
+    musers.push_back(userId);
+  }
+
+  countRunning(*transfer, 1);
+  return transfer;
+}
+
+
+bool
+TransferScheduler::Queue::isHostAvailable(const std::string& host, int streams) const {
+  std::map<std::string, int>::const_iterator count = mrunningByHost.find(host);
+  int running = (count != mrunningByHost.end()) ? count->second : 0;
+  return running + streams <= mtransfersPerHostLimit;
+}
+
+
+bool
+TransferScheduler::Queue::tryStart(const Transfer& transfer) {
+  int streams = getStreamCount(transfer);
+  if (! isHostAvailable(transfer.exec.getSrcMachineName(), streams)
+      || ! isHostAvailable(transfer.exec.getDestMachineName(), streams)) {
+    return false;
+  }
+  countRunning(transfer, 1);
+  return true;
+}
+
+
+int
+TransferScheduler::Queue::getWaitingStreams(const std::string& host) const {
+  std::map<std::string, int>::const_iterator count = mwaitingByHost.find(host);
+  return (count != mwaitingByHost.end()) ? count->second : 0;
+}
+
+
+void
+TransferScheduler::Queue::countWaiting(const Transfer& transfer, int delta) {
+  const std::string& srcHost = transfer.exec.getSrcMachineName();
+  const std::string& destHost = transfer.exec.getDestMachineName();
+  int streams = delta * getStreamCount(transfer);
+  if ((mwaitingByHost[srcHost] += streams) == 0) {
+    mwaitingByHost.erase(srcHost);
+  }
+  if (destHost != srcHost && (mwaitingByHost[destHost] += streams) == 0) {
+    mwaitingByHost.erase(destHost);
+  }
+}
+
+
+int
+TransferScheduler::Queue::getStreamCount(const Transfer& transfer) const {
+  if (transfer.manager != vishnu::PARALLEL_TRANSFER) {
+    return 1;
+  }
+  // a transfer opening more streams than the limit still runs alone
+  return std::min(ParallelTransfer::getStreamCount(transfer.fileSize), mtransfersPerHostLimit);
+}
+
+
+void
+TransferScheduler::Queue::countRunning(const Transfer& transfer, int delta) {
+  const std::string& srcHost = transfer.exec.getSrcMachineName();
+  const std::string& destHost = transfer.exec.getDestMachineName();
+  int streams = delta * getStreamCount(transfer);
+  if ((mrunningByHost[srcHost] += streams) == 0) {
+    mrunningByHost.erase(srcHost);
+  }
+  if (destHost != srcHost && (mrunningByHost[destHost] += streams) == 0) {
+    mrunningByHost.erase(destHost);
+  }
+  if ((mrunningByUser[transfer.userId] += delta) == 0) {
+    mrunningByUser.erase(transfer.userId);
+  }
+}
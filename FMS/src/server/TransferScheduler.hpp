@@ -0,0 +1,424 @@
+/**
+ * \file TransferScheduler.hpp
+ * \brief This file declares the scheduler of the file transfers run by the
+ * server
+ */
+
+#ifndef _TRANSFERSCHEDULER_HPP_
+#define _TRANSFERSCHEDULER_HPP_
+
+#include <deque>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include "FileTransferServer.hpp"
+
+/**
+ * \brief The number of transfers run at once when it is not configured
+ */
+const int DEFAULT_TRANSFERS_LIMIT = 16;
+
+/**
+ * \brief The number of transfers run at once from or to a machine when it
+ * is not configured
+ */
+const int DEFAULT_TRANSFERS_PER_HOST_LIMIT = 4;
+
+/**
+ * \brief The time in seconds between two measures of the bytes copied
+ */
+const int TRANSFER_PROGRESS_PERIOD = 10;
+
+/**
+ * \class TransferScheduler
+ * \brief Runs the remote file transfers of the server with a bounded number
+ * of workers, instead of a thread and a copy process per request. A transfer
+ * waits in the queue until a worker is free and its source and destination
+ * machines run less streams than their limit, a parallel transfer counting
+ * all its streams. The users with the fewest
+ * transfers running are served first, so a burst of copies from one user
+ * does not delay the others. The transfers a client waits for are run in
+ * the thread of its request, ahead of the queued ones. The queue is kept in the table filetransfer:
+ * the transfers a server did not end are run again when it restarts. The
+ * bytes copied are measured at the destination while the transfer runs.
+ */
+class TransferScheduler : public boost::noncopyable {
+public:
+  /**
+   * \struct Transfer
+   * \brief A queued or running transfer
+   */
+  struct Transfer {
+    /**
+     * \brief Constructor
+     * \param transferExec the information about the transfer
+     */
+    explicit Transfer(const TransferExec& transferExec) : exec(transferExec) {}
+    /**
+     * \brief The information about the transfer
+     */
+    TransferExec exec;
+    /**
+     * \brief The transfer command
+     */
+    std::string command;
+    /**
+     * \brief The transfer manager type (scp, rsync or parallel)
+     */
+    int manager;
+    /**
+     * \brief The type of transfer (copy or move)
+     */
+    File::TransferType type;
+    /**
+     * \brief The user requesting the transfer
+     */
+    std::string userId;
+    /**
+     * \brief The size of the source file
+     */
+    file_size_t fileSize;
+    /**
+     * \brief The path receiving the data, empty until it is known
+     */
+    std::string target;
+  };
+
+  /**
+   * \class Queue
+   * \brief The queued transfers and the counters of the running ones. The
+   * next transfer is taken from the user with the fewest transfers running,
+   * among the transfers whose machines run less streams than their limit.
+   * It is not thread safe, the scheduler holds its mutex.
+   */
+  class Queue {
+  public:
+    /**
+     * \brief Constructor
+     * \param transfersPerHostLimit the number of streams run at once from
+     * or to a machine
+     */
+    explicit Queue(int transfersPerHostLimit);
+
+    /**
+     * \brief Set the number of streams run at once from or to a machine
+     * \param transfersPerHostLimit the limit, at least 1
+     */
+    void
+    setHostLimit(int transfersPerHostLimit);
+
+    /**
+     * \brief Add a transfer to the queue of its user
+     * \param transfer the transfer
+     */
+    void
+    push(const boost::shared_ptr<Transfer>& transfer);
+
+    /**
+     * \brief Remove a queued transfer
+     * \param transfer the transfer
+     * \return false if the transfer is not queued
+     */
+    bool
+    remove(const boost::shared_ptr<Transfer>& transfer);
+
+    /**
+     * \brief Take the next transfer allowed to run, it is counted as running
+     * \return the transfer, empty if none can run now
+     */
+    boost::shared_ptr<Transfer>
+    pick();
+
+    /**
+     * \brief Update the streams kept for the transfers waiting to run in the
+     * thread of their request, the queued transfers do not take them
+     * \param transfer the transfer starting or ending its wait
+     * \param delta 1 when it starts waiting, -1 when it ends
+     */
+    void
+    countWaiting(const Transfer& transfer, int delta);
+
+    /**
+     * \brief Count a transfer as running if its machines run less streams
+     * than their limit, the streams kept for the waiting transfers are not
+     * counted
+     * \param transfer the transfer
+     * \return false if the transfer cannot run now
+     */
+    bool
+    tryStart(const Transfer& transfer);
+
+    /**
+     * \brief Update the counters of running transfers
+     * \param transfer the transfer starting or ending
+     * \param delta 1 when it starts, -1 when it ends
+     */
+    void
+    countRunning(const Transfer& transfer, int delta);
+
+    /**
+     * \brief Get the number of streams a transfer counts against the limit
+     * of its machines
+     * \param transfer the transfer
+     * \return the number of streams, at most the limit of a machine
+     */
+    int
+    getStreamCount(const Transfer& transfer) const;
+
+  private:
+    /**
+     * \brief Check whether a machine can open more streams without going
+     * above its limit
+     * \param host the machine name
+     * \param streams the number of streams of the transfer
+     * \return true if the transfer can start on it
+     */
+    bool
+    isHostAvailable(const std::string& host, int streams) const;
+
+    /**
+     * \brief Get the streams kept on a machine for the waiting transfers
+     * \param host the machine name
+     * \return the number of streams
+     */
+    int
+    getWaitingStreams(const std::string& host) const;
+
+    /**
+     * \brief The number of streams run at once from or to a machine
+     */
+    int mtransfersPerHostLimit;
+    /**
+     * \brief The queued transfers, by user
+     */
+    std::map<std::string, std::deque<boost::shared_ptr<Transfer> > > mqueues;
+    /**
+     * \brief The users having queued transfers, the next served first on ties
+     */
+    std::list<std::string> musers;
+    /**
+     * \brief The number of streams of the running transfers, by machine
+     */
+    std::map<std::string, int> mrunningByHost;
+    /**
+     * \brief The number of streams kept for the waiting transfers, by machine
+     */
+    std::map<std::string, int> mwaitingByHost;
+    /**
+     * \brief The number of running transfers, by user
+     */
+    std::map<std::string, int> mrunningByUser;
+  };
+
+  /**
+   * \brief Get the scheduler of the process
+   * \return the scheduler
+   */
+  static TransferScheduler&
+  getInstance();
+
+  /**
+   * \brief Start the workers and queue the transfers left by the previous
+   * run of the server
+   * \param transfersLimit the number of transfers run at once
+   * \param transfersPerHostLimit the number of transfers run at once from or
+   * to a machine
+   * \param serverUri the address of the server, it identifies its transfers
+   */
+  void
+  start(int transfersLimit,
+        int transfersPerHostLimit,
+        const std::string& serverUri);
+
+  /**
+   * \brief Get the address of the server owning the queue
+   * \return the address, empty if the scheduler is not started
+   */
+  const std::string&
+  getServerUri() const {return mserverUri;}
+
+  /**
+   * \brief Queue a transfer already recorded in the database
+   * \param transferExec the information about the transfer
+   * \param trCmd the transfer command
+   * \param trManager the transfer manager type (scp, rsync or parallel)
+   * \param transferType the type of transfer (copy or move)
+   * \param userId the user requesting the transfer
+   * \param fileSize the size of the source file
+   */
+  void
+  submit(const TransferExec& transferExec,
+         const std::string& trCmd,
+         int trManager,
+         File::TransferType transferType,
+         const std::string& userId,
+         file_size_t fileSize);
+
+  /**
+   * \brief Perform a transfer already recorded in the database in the
+   * calling thread, without waiting for a worker. It waits until the
+   * number of transfers and the streams of its machines are below their
+   * limits, the queued transfers are not started while it waits.
+   * \param transferExec the information about the transfer
+   * \param trCmd the transfer command
+   * \param trManager the transfer manager type (scp, rsync or parallel)
+   * \param transferType the type of transfer (copy or move)
+   * \param userId the user requesting the transfer
+   * \param fileSize the size of the source file
+   */
+  void
+  run(const TransferExec& transferExec,
+      const std::string& trCmd,
+      int trManager,
+      File::TransferType transferType,
+      const std::string& userId,
+      file_size_t fileSize);
+
+  /**
+   * \brief Wait until a transfer ends
+   * \param transferId the transfer identifier
+   */
+  void
+  wait(const std::string& transferId);
+
+  /**
+   * \brief Remove a transfer from the queue
+   * \param transferId the transfer identifier
+   * \return false if the transfer is not queued, it may be running
+   */
+  bool
+  cancel(const std::string& transferId);
+
+  /**
+   * \brief Get the transfers of a server which did not end, the ones which
+   * cannot be resumed are marked failed
+   * \param serverUri the address of the server
+   * \param transfers OUT, the transfers to queue again
+   */
+  static void
+  loadUnfinished(const std::string& serverUri,
+                 std::vector<boost::shared_ptr<Transfer> >& transfers);
+
+private:
+  /**
+   * \brief Constructor
+   */
+  TransferScheduler();
+
+  /**
+   * \brief The loop of a worker
+   */
+  void
+  runWorker();
+
+  /**
+   * \brief The loop measuring the bytes copied by the running transfers
+   */
+  void
+  runProgress();
+
+  /**
+   * \brief Perform a transfer
+   * \param transfer the transfer
+   */
+  void
+  perform(const boost::shared_ptr<Transfer>& transfer);
+
+  /**
+   * \brief Remove a transfer which ended from the running ones
+   * \param transfer the transfer
+   */
+  void
+  finish(const boost::shared_ptr<Transfer>& transfer);
+
+  /**
+   * \brief Take the next transfer allowed to run, the mutex must be held
+   * \return the transfer, empty if none can run now
+   */
+  boost::shared_ptr<Transfer>
+  pickTransfer();
+
+  /**
+   * \brief Add a transfer to the queue of its user, the mutex must be held
+   * \param transfer the transfer
+   */
+  void
+  enqueue(const boost::shared_ptr<Transfer>& transfer);
+
+  /**
+   * \brief Queue the transfers of this server which did not end
+   */
+  void
+  resume();
+
+  /**
+   * \brief Get the account of a user on a machine, without session
+   * \param userId the user identifier
+   * \param machineId the machine identifier
+   * \param login OUT, the login of the user
+   * \param machineName OUT, the name of the machine
+   * \return false if the user has no active account on the machine
+   */
+  static bool
+  getAccount(const std::string& userId,
+             const std::string& machineId,
+             std::string& login,
+             std::string& machineName);
+
+  /**
+   * \brief Check whether a machine is registered in VISHNU
+   * \param machineId the machine identifier
+   * \return false for the client hosts
+   */
+  static bool
+  isMachine(const std::string& machineId);
+
+  /**
+   * \brief Whether the workers are started
+   */
+  bool mstarted;
+  /**
+   * \brief The address of the server
+   */
+  std::string mserverUri;
+  /**
+   * \brief The number of transfers run at once
+   */
+  size_t mtransfersLimit;
+  /**
+   * \brief The number of transfers waiting to run in the thread of their
+   * request
+   */
+  size_t mwaiting;
+  /**
+   * \brief The queued transfers and the counters of the running ones
+   */
+  Queue mqueue;
+  /**
+   * \brief The queued and running transfers, by identifier
+   */
+  std::map<std::string, boost::shared_ptr<Transfer> > mtransfers;
+  /**
+   * \brief The running transfers
+   */
+  std::list<boost::shared_ptr<Transfer> > mrunning;
+  /**
+   * \brief The workers
+   */
+  boost::thread_group mworkers;
+  /**
+   * \brief mutex protecting the queue and the counters
+   */
+  boost::mutex mmutex;
+  /**
+   * \brief Signaled when a transfer is queued or a running one ends
+   */
+  boost::condition_variable mchanged;
+};
+
+#endif // _TRANSFERSCHEDULER_HPP_
@@ -0,0 +1,158 @@
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <string>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include "FileStatCache.hpp"
+
+// anonymous namespace
+namespace {
+  /**
+   * \brief A stat command counting its runs
+   */
+  struct CountingStat {
+    CountingStat() : runs(0), started(false), released(true) {}
+
+    FileStatCache::StatResult
+    run(const std::string& output) {
+      boost::unique_lock<boost::mutex> lock(mutex);
+      ++runs;
+      started = true;
+      changed.notify_all();
+      while (! released) {
+        changed.wait(lock);
+      }
+      return FileStatCache::StatResult(output, "");
+    }
+
+    FileStatCache::StatResult
+    fail() {
+      boost::lock_guard<boost::mutex> lock(mutex);
+      ++runs;
+      throw std::runtime_error("connection lost");
+    }
+
+    void
+    waitStarted() {
+      boost::unique_lock<boost::mutex> lock(mutex);
+      while (! started) {
+        changed.wait(lock);
+      }
+    }
+
+    void
+    release() {
+      boost::lock_guard<boost::mutex> lock(mutex);
+      released = true;
+      changed.notify_all();
+    }
+
+    int runs;
+    bool started;
+    bool released;
+    boost::mutex mutex;
+    boost::condition_variable changed;
+  };
+
+  void
+  lookup(const std::string& key, CountingStat* stat, std::string* output) {
+    *output = FileStatCache::getInstance().get(key, boost::bind(&CountingStat::run, stat, "size 42")).first;
+  }
+}
+
+
+BOOST_AUTO_TEST_SUITE( FileStatCache_unit_tests )
+
+
+BOOST_AUTO_TEST_CASE( test_get_cached_n )
+{
+  // The command runs once while the information is kept
+  FileStatCache& cache = FileStatCache::getInstance();
+  CountingStat stat;
+  std::string key = FileStatCache::getKey("alice", "host-a", 22, "/data/cached");
+  BOOST_REQUIRE_EQUAL(cache.get(key, boost::bind(&CountingStat::run, &stat, "size 1")).first, "size 1");
+  BOOST_REQUIRE_EQUAL(cache.get(key, boost::bind(&CountingStat::run, &stat, "size 2")).first, "size 1");
+  BOOST_REQUIRE_EQUAL(stat.runs, 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_get_expired_n )
+{
+  // The command runs again once the information expires
+  FileStatCache& cache = FileStatCache::getInstance();
+  CountingStat stat;
+  std::string key = FileStatCache::getKey("alice", "host-a", 22, "/data/expired");
+  cache.get(key, boost::bind(&CountingStat::run, &stat, "size 1"));
+  boost::this_thread::sleep(boost::posix_time::milliseconds(FILE_STAT_CACHE_TTL + 200));
+  BOOST_REQUIRE_EQUAL(cache.get(key, boost::bind(&CountingStat::run, &stat, "size 2")).first, "size 2");
+  BOOST_REQUIRE_EQUAL(stat.runs, 2);
+}
+
+BOOST_AUTO_TEST_CASE( test_get_coalesced_n )
+{
+  // The lookups of a file already running share its command
+  CountingStat stat;
+  stat.released = false;
+  std::string key = FileStatCache::getKey("alice", "host-a", 22, "/data/coalesced");
+  std::string outputs[4];
+  boost::thread_group lookups;
+  lookups.create_thread(boost::bind(&lookup, key, &stat, &outputs[0]));
+  stat.waitStarted();
+  for (int i = 1; i < 4; ++i) {
+    lookups.create_thread(boost::bind(&lookup, key, &stat, &outputs[i]));
+  }
+  boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+  stat.release();
+  lookups.join_all();
+
+  BOOST_REQUIRE_EQUAL(stat.runs, 1);
+  for (int i = 0; i < 4; ++i) {
+    BOOST_REQUIRE_EQUAL(outputs[i], "size 42");
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_get_failed_b )
+{
+  // A failed command is not kept, the next lookup runs it again
+  FileStatCache& cache = FileStatCache::getInstance();
+  CountingStat stat;
+  std::string key = FileStatCache::getKey("alice", "host-a", 22, "/data/failed");
+  BOOST_REQUIRE_THROW(cache.get(key, boost::bind(&CountingStat::fail, &stat)), std::runtime_error);
+  BOOST_REQUIRE_EQUAL(cache.get(key, boost::bind(&CountingStat::run, &stat, "size 1")).first, "size 1");
+  BOOST_REQUIRE_EQUAL(stat.runs, 2);
+}
+
+BOOST_AUTO_TEST_CASE( test_invalidate_prefix_n )
+{
+  // A directory is dropped with the files below it, not with its siblings
+  FileStatCache& cache = FileStatCache::getInstance();
+  CountingStat stat;
+  std::string dir = FileStatCache::getKey("alice", "host-a", 22, "/data/dir");
+  std::string child = FileStatCache::getKey("alice", "host-a", 22, "/data/dir/file");
+  std::string sibling = FileStatCache::getKey("alice", "host-a", 22, "/data/dir2");
+  cache.get(dir, boost::bind(&CountingStat::run, &stat, "old"));
+  cache.get(child, boost::bind(&CountingStat::run, &stat, "old"));
+  cache.get(sibling, boost::bind(&CountingStat::run, &stat, "old"));
+
+  cache.invalidate(dir);
+
+  BOOST_REQUIRE_EQUAL(cache.get(dir, boost::bind(&CountingStat::run, &stat, "new")).first, "new");
+  BOOST_REQUIRE_EQUAL(cache.get(child, boost::bind(&CountingStat::run, &stat, "new")).first, "new");
+  BOOST_REQUIRE_EQUAL(cache.get(sibling, boost::bind(&CountingStat::run, &stat, "new")).first, "old");
+  BOOST_REQUIRE_EQUAL(stat.runs, 5);
+}
+
+BOOST_AUTO_TEST_CASE( test_getKey_n )
+{
+  // A directory named with trailing slashes has the same key, the root keeps its slash
+  BOOST_REQUIRE_EQUAL(FileStatCache::getKey("alice", "host-a", 22, "/data/dir"), "alice@host-a:22:/data/dir");
+  BOOST_REQUIRE_EQUAL(FileStatCache::getKey("alice", "host-a", 22, "/data/dir//"), "alice@host-a:22:/data/dir");
+  BOOST_REQUIRE_EQUAL(FileStatCache::getKey("alice", "host-a", 22, "/"), "alice@host-a:22:/");
+  BOOST_REQUIRE(FileStatCache::getKey("alice", "host-a", 22, "/data")
+                != FileStatCache::getKey("alice", "host-a", 2222, "/data"));
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// THE END
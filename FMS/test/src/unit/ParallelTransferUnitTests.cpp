@@ -0,0 +1,46 @@
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+#include "ParallelTransfer.hpp"
+
+
+BOOST_AUTO_TEST_SUITE( ParallelTransfer_unit_tests )
+
+
+BOOST_AUTO_TEST_CASE( test_getChunkCount_n )
+{
+  // The last chunk of a file may be shorter than the others
+  BOOST_REQUIRE_EQUAL(ParallelTransfer::getChunkCount(0), 0);
+  BOOST_REQUIRE_EQUAL(ParallelTransfer::getChunkCount(1), 1);
+  BOOST_REQUIRE_EQUAL(ParallelTransfer::getChunkCount(PARALLEL_TRANSFER_CHUNK_SIZE), 1);
+  BOOST_REQUIRE_EQUAL(ParallelTransfer::getChunkCount(PARALLEL_TRANSFER_CHUNK_SIZE + 1), 2);
+  BOOST_REQUIRE_EQUAL(ParallelTransfer::getChunkCount(10 * PARALLEL_TRANSFER_CHUNK_SIZE), 10);
+}
+
+BOOST_AUTO_TEST_CASE( test_getStreamCount_n )
+{
+  // The large files are sent by all the streams
+  BOOST_REQUIRE_EQUAL(ParallelTransfer::getStreamCount(PARALLEL_TRANSFER_MIN_SIZE), PARALLEL_TRANSFER_STREAMS);
+  BOOST_REQUIRE_EQUAL(ParallelTransfer::getStreamCount(100 * PARALLEL_TRANSFER_CHUNK_SIZE), PARALLEL_TRANSFER_STREAMS);
+}
+
+BOOST_AUTO_TEST_CASE( test_getStreamCount_b )
+{
+  // The small files are sent by a single stream
+  BOOST_REQUIRE_EQUAL(ParallelTransfer::getStreamCount(0), 1);
+  BOOST_REQUIRE_EQUAL(ParallelTransfer::getStreamCount(PARALLEL_TRANSFER_MIN_SIZE - 1), 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_getPartPath_n )
+{
+  // The partial file sits beside the target, named after the transfer
+  BOOST_REQUIRE_EQUAL(ParallelTransfer::getPartPath("/scratch/alice/data.bin", "FT_1"),
+                      "/scratch/alice/data.bin.vishnu-part-FT_1");
+  BOOST_REQUIRE(ParallelTransfer::getPartPath("/scratch/alice/data.bin", "FT_1")
+                != ParallelTransfer::getPartPath("/scratch/alice/data.bin", "FT_2"));
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// THE END
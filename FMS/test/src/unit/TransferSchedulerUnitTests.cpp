@@ -0,0 +1,309 @@
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+
+#include "TransferScheduler.hpp"
+#include "ParallelTransfer.hpp"
+#include "DbFactory.hpp"
+#include "MockDatabase.hpp"
+
+// anonymous namespace
+namespace {
+  /**
+   * \brief Creates the mock database and drops the rows of the previous test
+   */
+  struct MockDatabaseFixture {
+    MockDatabaseFixture() {
+      DbFactory factory;
+      if (factory.getDatabaseInstance() == NULL) {
+        ExecConfiguration execConfig;
+        DbConfiguration dbConfig(execConfig);
+        factory.createDatabaseInstance(dbConfig);
+      }
+      MockDatabase::reset();
+    }
+
+    ~MockDatabaseFixture() {
+      MockDatabase::reset();
+    }
+  };
+
+  /**
+   * \brief A transfer left in progress by the server
+   */
+  std::vector<std::string>
+  unfinishedRow(const std::string& transferId,
+                const std::string& sourceMachineId,
+                const std::string& sourceUser) {
+    std::vector<std::string> row;
+    row.push_back(transferId);
+    row.push_back("user_1");
+    row.push_back(sourceMachineId);
+    row.push_back("MA_2");
+    row.push_back("/home/alice/data.bin");
+    row.push_back("/scratch/alice/");
+    row.push_back("scp -q -o BatchMode=yes");
+    row.push_back("1");
+    row.push_back("1048576");
+    row.push_back("sessionkey_1");
+    row.push_back("3");
+    row.push_back(sourceUser);
+    return row;
+  }
+
+  std::vector<std::vector<std::string> >
+  rows(const std::vector<std::string>& row) {
+    return std::vector<std::vector<std::string> >(1, row);
+  }
+
+  std::vector<std::string>
+  accountRow(const std::string& login, const std::string& machineName) {
+    std::vector<std::string> row;
+    row.push_back(login);
+    row.push_back(machineName);
+    return row;
+  }
+
+  bool
+  isMarkedFailed(const std::string& transferId) {
+    const std::vector<std::string>& requests = MockDatabase::getProcessedRequests();
+    for (size_t i = 0; i < requests.size(); ++i) {
+      if (requests[i].find("UPDATE filetransfer") != std::string::npos
+          && requests[i].find("transferid='" + transferId + "'") != std::string::npos) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * \brief A queued transfer of a user between two machines
+   */
+  boost::shared_ptr<TransferScheduler::Transfer>
+  makeTransfer(const std::string& transferId,
+               const std::string& userId,
+               const std::string& srcHost,
+               const std::string& destHost,
+               int manager = vishnu::SCP_TRANSFER,
+               file_size_t fileSize = 1024) {
+    TransferExec transferExec(SessionServer("sessionkey_1"), "login", srcHost, "/data/in",
+                              "", "login", destHost, "/data/out", transferId);
+    boost::shared_ptr<TransferScheduler::Transfer> transfer(new TransferScheduler::Transfer(transferExec));
+    transfer->manager = manager;
+    transfer->type = File::copy;
+    transfer->userId = userId;
+    transfer->fileSize = fileSize;
+    return transfer;
+  }
+
+  std::string
+  pickId(TransferScheduler::Queue& queue) {
+    boost::shared_ptr<TransferScheduler::Transfer> transfer = queue.pick();
+    return transfer ? transfer->exec.getTransferId() : "";
+  }
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( TransferScheduler_unit_tests, MockDatabaseFixture )
+
+
+BOOST_AUTO_TEST_CASE( test_resume_remote_transfer_n )
+{
+// The machines are reached by their names, not by their identifiers
+  MockDatabase::setResult("serveruri='tcp://fms:5555'", rows(unfinishedRow("FT_1", "MA_1", "alice")));
+  MockDatabase::setResult("machine.machineid='MA_1'", rows(accountRow("alice", "host-a.example.com")));
+  MockDatabase::setResult("machine.machineid='MA_2'", rows(accountRow("alice2", "host-b.example.com")));
+
+  std::vector<boost::shared_ptr<TransferScheduler::Transfer> > transfers;
+  TransferScheduler::loadUnfinished("tcp://fms:5555", transfers);
+
+  BOOST_REQUIRE_EQUAL(transfers.size(), 1);
+  const TransferScheduler::Transfer& transfer = *transfers[0];
+  BOOST_REQUIRE_EQUAL(transfer.exec.getTransferId(), "FT_1");
+  BOOST_REQUIRE_EQUAL(transfer.exec.getSrcUser(), "alice");
+  BOOST_REQUIRE_EQUAL(transfer.exec.getSrcMachineName(), "host-a.example.com");
+  BOOST_REQUIRE_EQUAL(transfer.exec.getSrcPath(), "/home/alice/data.bin");
+  BOOST_REQUIRE_EQUAL(transfer.exec.getDestUser(), "alice2");
+  BOOST_REQUIRE_EQUAL(transfer.exec.getDestMachineName(), "host-b.example.com");
+  BOOST_REQUIRE_EQUAL(transfer.exec.getDestPath(), "/scratch/alice/");
+  BOOST_REQUIRE_EQUAL(transfer.command, "scp -q -o BatchMode=yes");
+  BOOST_REQUIRE_EQUAL(transfer.manager, 3);
+  BOOST_REQUIRE_EQUAL(transfer.type, File::move);
+  BOOST_REQUIRE_EQUAL(transfer.userId, "user_1");
+  BOOST_REQUIRE_EQUAL(transfer.fileSize, 1048576);
+  BOOST_REQUIRE(! isMarkedFailed("FT_1"));
+}
+
+BOOST_AUTO_TEST_CASE( test_resume_client_host_source_n )
+{
+// A client host is not a VISHNU machine, the login of the request is used
+  MockDatabase::setResult("serveruri='tcp://fms:5555'",
+                          rows(unfinishedRow("FT_2", "client.example.com", "bob")));
+  MockDatabase::setResult("machine.machineid='MA_2'", rows(accountRow("bob2", "host-b.example.com")));
+
+  std::vector<boost::shared_ptr<TransferScheduler::Transfer> > transfers;
+  TransferScheduler::loadUnfinished("tcp://fms:5555", transfers);
+
+  BOOST_REQUIRE_EQUAL(transfers.size(), 1);
+  BOOST_REQUIRE_EQUAL(transfers[0]->exec.getSrcUser(), "bob");
+  BOOST_REQUIRE_EQUAL(transfers[0]->exec.getSrcMachineName(), "client.example.com");
+  BOOST_REQUIRE_EQUAL(transfers[0]->exec.getDestMachineName(), "host-b.example.com");
+}
+
+BOOST_AUTO_TEST_CASE( test_resume_closed_account_b )
+{
+// A VISHNU machine without an active account is not reached with the
+// recorded login, the transfer is marked failed
+  MockDatabase::setResult("serveruri='tcp://fms:5555'", rows(unfinishedRow("FT_3", "MA_1", "alice")));
+  MockDatabase::setResult("FROM machine WHERE machineid='MA_1'", rows(std::vector<std::string>(1, "1")));
+  MockDatabase::setResult("machine.machineid='MA_2'", rows(accountRow("alice2", "host-b.example.com")));
+
+  std::vector<boost::shared_ptr<TransferScheduler::Transfer> > transfers;
+  TransferScheduler::loadUnfinished("tcp://fms:5555", transfers);
+
+  BOOST_REQUIRE(transfers.empty());
+  BOOST_REQUIRE(isMarkedFailed("FT_3"));
+}
+
+BOOST_AUTO_TEST_CASE( test_resume_other_server_n )
+{
+// The transfers of the other servers are left to them
+  MockDatabase::setResult("serveruri='tcp://other:5555'", rows(unfinishedRow("FT_4", "MA_1", "alice")));
+
+  std::vector<boost::shared_ptr<TransferScheduler::Transfer> > transfers;
+  TransferScheduler::loadUnfinished("tcp://fms:5555", transfers);
+
+  BOOST_REQUIRE(transfers.empty());
+}
+BOOST_AUTO_TEST_CASE( test_pick_fair_share_n )
+{
+  // The user with the fewest running transfers is served first
+  TransferScheduler::Queue queue(DEFAULT_TRANSFERS_PER_HOST_LIMIT);
+  queue.push(makeTransfer("FT_A1", "alice", "host-a1", "host-b1"));
+  queue.push(makeTransfer("FT_A2", "alice", "host-a2", "host-b2"));
+  queue.push(makeTransfer("FT_A3", "alice", "host-a3", "host-b3"));
+  queue.push(makeTransfer("FT_B1", "bob", "host-a4", "host-b4"));
+
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_A1");
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_B1");
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_A2");
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_A3");
+  BOOST_REQUIRE_EQUAL(pickId(queue), "");
+}
+
+BOOST_AUTO_TEST_CASE( test_pick_host_limit_n )
+{
+  // A machine runs at most its limit of transfers, the others wait
+  TransferScheduler::Queue queue(2);
+  boost::shared_ptr<TransferScheduler::Transfer> first = makeTransfer("FT_1", "alice", "host-a", "host-b");
+  queue.push(first);
+  queue.push(makeTransfer("FT_2", "bob", "host-c", "host-b"));
+  queue.push(makeTransfer("FT_3", "carol", "host-b", "host-d"));
+
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_1");
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_2");
+  BOOST_REQUIRE_EQUAL(pickId(queue), "");
+
+  queue.countRunning(*first, -1);
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_3");
+}
+
+BOOST_AUTO_TEST_CASE( test_pick_busy_host_skipped_n )
+{
+  // A transfer whose machines are busy does not hold the next ones of its user
+  TransferScheduler::Queue queue(1);
+  queue.push(makeTransfer("FT_1", "alice", "host-a", "host-b"));
+  queue.push(makeTransfer("FT_2", "alice", "host-a", "host-c"));
+  queue.push(makeTransfer("FT_3", "alice", "host-d", "host-e"));
+
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_1");
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_3");
+  BOOST_REQUIRE_EQUAL(pickId(queue), "");
+}
+
+BOOST_AUTO_TEST_CASE( test_pick_parallel_streams_n )
+{
+  // A parallel transfer counts all its streams against the limit of its machines
+  TransferScheduler::Queue queue(PARALLEL_TRANSFER_STREAMS);
+  boost::shared_ptr<TransferScheduler::Transfer> parallel =
+      makeTransfer("FT_1", "alice", "host-a", "host-b",
+                   vishnu::PARALLEL_TRANSFER, PARALLEL_TRANSFER_MIN_SIZE);
+  BOOST_REQUIRE_EQUAL(queue.getStreamCount(*parallel), PARALLEL_TRANSFER_STREAMS);
+  queue.push(parallel);
+  queue.push(makeTransfer("FT_2", "bob", "host-a", "host-c"));
+
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_1");
+  BOOST_REQUIRE_EQUAL(pickId(queue), "");
+  queue.countRunning(*parallel, -1);
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_2");
+}
+
+BOOST_AUTO_TEST_CASE( test_pick_parallel_streams_b )
+{
+  // A parallel transfer opening more streams than the limit still runs alone,
+  // a small file or another manager uses a single stream
+  TransferScheduler::Queue queue(2);
+  BOOST_REQUIRE_EQUAL(queue.getStreamCount(*makeTransfer("FT_1", "alice", "host-a", "host-b",
+                                                         vishnu::PARALLEL_TRANSFER,
+                                                         PARALLEL_TRANSFER_MIN_SIZE)), 2);
+  BOOST_REQUIRE_EQUAL(queue.getStreamCount(*makeTransfer("FT_2", "alice", "host-a", "host-b",
+                                                         vishnu::PARALLEL_TRANSFER, 1024)), 1);
+  BOOST_REQUIRE_EQUAL(queue.getStreamCount(*makeTransfer("FT_3", "alice", "host-a", "host-b",
+                                                         vishnu::SCP_TRANSFER,
+                                                         PARALLEL_TRANSFER_MIN_SIZE)), 1);
+  queue.push(makeTransfer("FT_4", "alice", "host-a", "host-b",
+                          vishnu::PARALLEL_TRANSFER, PARALLEL_TRANSFER_MIN_SIZE));
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_4");
+}
+
+BOOST_AUTO_TEST_CASE( test_remove_n )
+{
+  // A removed transfer is never picked, a picked one cannot be removed
+  TransferScheduler::Queue queue(DEFAULT_TRANSFERS_PER_HOST_LIMIT);
+  boost::shared_ptr<TransferScheduler::Transfer> first = makeTransfer("FT_1", "alice", "host-a", "host-b");
+  boost::shared_ptr<TransferScheduler::Transfer> second = makeTransfer("FT_2", "alice", "host-a", "host-b");
+  queue.push(first);
+  queue.push(second);
+
+  BOOST_REQUIRE(queue.remove(second));
+  BOOST_REQUIRE(! queue.remove(second));
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_1");
+  BOOST_REQUIRE(! queue.remove(first));
+  BOOST_REQUIRE_EQUAL(pickId(queue), "");
+}
+
+BOOST_AUTO_TEST_CASE( test_tryStart_waiting_n )
+{
+  // A transfer waiting in the thread of its request keeps its streams from
+  // the queued transfers, not from the other waiting transfers
+  TransferScheduler::Queue queue(1);
+  boost::shared_ptr<TransferScheduler::Transfer> waiting = makeTransfer("FT_1", "alice", "host-a", "host-b");
+  queue.countWaiting(*waiting, 1);
+  queue.push(makeTransfer("FT_2", "bob", "host-a", "host-c"));
+  queue.push(makeTransfer("FT_3", "bob", "host-d", "host-e"));
+
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_3");
+  BOOST_REQUIRE_EQUAL(pickId(queue), "");
+  BOOST_REQUIRE(queue.tryStart(*waiting));
+  queue.countWaiting(*waiting, -1);
+  BOOST_REQUIRE_EQUAL(pickId(queue), "");
+  queue.countRunning(*waiting, -1);
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_2");
+}
+
+BOOST_AUTO_TEST_CASE( test_tryStart_busy_b )
+{
+  // A waiting transfer does not start while its machines are at their limit
+  TransferScheduler::Queue queue(1);
+  queue.push(makeTransfer("FT_1", "alice", "host-a", "host-b"));
+  BOOST_REQUIRE_EQUAL(pickId(queue), "FT_1");
+  boost::shared_ptr<TransferScheduler::Transfer> waiting = makeTransfer("FT_2", "bob", "host-c", "host-b");
+  BOOST_REQUIRE(! queue.tryStart(*waiting));
+  queue.countRunning(*makeTransfer("FT_1", "alice", "host-a", "host-b"), -1);
+  BOOST_REQUIRE(queue.tryStart(*waiting));
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// THE END
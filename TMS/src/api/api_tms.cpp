@@ -78,6 +78,46 @@ throw (UMSVishnuException, TMSVishnuException, UserException, SystemException) {
   return ret;
 }
 
+/**
+ * \brief The submitJobs function submits a set of jobs built from a single script
+ * \param sessionKey : The session key
+ * \param scriptFilePath : The path to the file containing the script shared by the jobs
+ * \param jobParams : The parameters of each job, in the form PARAM1=value1 PARAM2=value2
+ * \param jobs : The list of the jobs submitted
+ * \param options : The options shared by the jobs
+ * \return int : an error code
+ */
+int
+vishnu::submitJobs(const std::string& sessionKey,
+                   const std::string& scriptFilePath,
+                   const std::vector<std::string>& jobParams,
+                   ListJobs& jobs,
+                   const SubmitOptions& options)
+throw (UMSVishnuException, TMSVishnuException, UserException, SystemException) {
+// Dirty cast to modify a const object because the loadcriterion field may not be allocated -> allocating him
+  const void * tmp = &options;
+  SubmitOptions* optionstmp = (SubmitOptions*)tmp;
+  TMS_Data::LoadCriterion_ptr loadCriterion =  new TMS_Data::LoadCriterion();
+
+  checkEmptyString(sessionKey, "The session key");
+  checkJobNbNodesAndNbCpuPerNode(optionstmp->getNbNodesAndCpuPerNode());
+  if (jobParams.empty()) {
+    throw UserException(ERRCODE_INVALID_PARAM, "No job to submit");
+  }
+  if (optionstmp->getCriterion()){
+    loadCriterion->setLoadType(optionstmp->getCriterion()->getLoadType());
+  }
+  optionstmp->setCriterion(loadCriterion);
+
+  boost::filesystem::path completePath(scriptFilePath);
+  std::string scriptFileCompletePath = (boost::filesystem::path(boost::filesystem::system_complete(completePath))).string();
+
+  JobProxy jobProxy(sessionKey, optionstmp->getMachine());
+
+  std::string scriptContent = vishnu::get_file_content(scriptFilePath);
+  return jobProxy.submitJobs(scriptFileCompletePath, scriptContent, *optionstmp, jobParams, jobs);
+}
+
 /**
  * \brief The cancelJob function cancels a job from its id
  * \param session : The session information
@@ -155,7 +195,8 @@ throw (UMSVishnuException, TMSVishnuException, UserException, SystemException) {
  * \brief The listJobs function gets a list of all submitted jobs
  * \param sessionKey : The session key
  * \param listOfJobs : The constructed object list of jobs
- * \param options : Additional options for jobs listing
+ * \param options : Additional options for jobs listing. With a page size, a
+ * single page is listed and the next token of the list resumes the listing
  * \return int : an error code
  */
 int
@@ -175,7 +216,7 @@ throw (UMSVishnuException, TMSVishnuException, UserException, SystemException) {
   listOfJobs.setNbJobs(0);
   listOfJobs.setNbRunningJobs(0);
   listOfJobs.setNbWaitingJobs(0);
-
+  listOfJobs.setNextToken("");
 
   std::string serviceName = (boost::format("%1%") % SERVICES_TMS[GETLISTOFJOBS_ALL]).str();
   SessionProxy sessionProxy(sessionKey);
@@ -203,6 +244,7 @@ throw (UMSVishnuException, TMSVishnuException, UserException, SystemException) {
     listOfJobs.setNbJobs(listOfJobs.getNbJobs()+listJobs_ptr->getJobs().size());
     listOfJobs.setNbRunningJobs(listOfJobs.getNbRunningJobs()+listJobs_ptr->getNbRunningJobs());
     listOfJobs.setNbWaitingJobs(listOfJobs.getNbWaitingJobs()+listJobs_ptr->getNbWaitingJobs());
+    listOfJobs.setNextToken(listJobs_ptr->getNextToken());
     delete listJobs_ptr;
   }
   return 0;
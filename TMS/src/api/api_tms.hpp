@@ -10,6 +10,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "UserException.hpp"
 #include "SystemException.hpp"
@@ -35,6 +36,23 @@ namespace vishnu {
             const TMS_Data::SubmitOptions& options = TMS_Data::SubmitOptions())
   throw (UMSVishnuException, TMSVishnuException, UserException, SystemException);
 
+  /**
+  * \brief The submitJobs function submits a set of jobs built from a single script, each job substituting its own parameters in the script.
+  * \param sessionKey : The session key
+  * \param scriptFilePath : The path to the file containing the script shared by the jobs
+  * \param jobParams : The parameters of each job, in the form PARAM1=value1 PARAM2=value2, replacing $PARAM1 and $PARAM2 in the script
+  * \param jobs : The list of the jobs submitted, a job which failed to be submitted holds its submission error
+  * \param options : The options shared by the jobs, as for submitJob
+  * \return int : an error code
+  */
+  int
+  submitJobs(const std::string& sessionKey,
+             const std::string& scriptFilePath,
+             const std::vector<std::string>& jobParams,
+             TMS_Data::ListJobs& jobs,
+             const TMS_Data::SubmitOptions& options = TMS_Data::SubmitOptions())
+  throw (UMSVishnuException, TMSVishnuException, UserException, SystemException);
+
 
   /**
   * \brief Add a work
@@ -81,7 +99,8 @@ namespace vishnu {
   * \brief The listJobs function gets a list of all submitted jobs
   * \param sessionKey : The session key
   * \param listOfJobs : The constructed object list of jobs
-  * \param options : Additional options for jobs listing
+  * \param options : Additional options for jobs listing. With a page size, a
+  * single page is listed and the next token of the list resumes the listing
   * \return int : an error code
   */
   int
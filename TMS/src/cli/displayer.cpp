@@ -392,13 +392,13 @@ operator<<(std::ostream& os, ListQueues& lsQueues) {
 }
 
 /**
- * \brief Helper function to display a list of jobs
- * \param os: The output stream in which the list will be printed
- * \param listJobs: The list to display
- * \return The output stream in which the list of users has been printed
+ * \brief Helper function to display a page of a list of jobs, without the summary
+ * \param os: The output stream in which the page will be printed
+ * \param listJobs: The page to display
+ * \param showHeader: Whether the header of the columns is printed
  */
-std::ostream&
-operator<<(std::ostream& os, ListJobs& listJobs) {
+void
+displayJobsPage(std::ostream& os, ListJobs& listJobs, bool showHeader) {
 
   std::string jobId;
   std::string jobName;
@@ -456,22 +456,24 @@ operator<<(std::ostream& os, ListJobs& listJobs) {
     maxMachineIdSize = std::max(maxMachineIdSize, machineId.size());
   }
 
-  os << setw(maxJobIdSize+2) << left << jobIdHead << setw(maxJobNameSize+2) << left << jobNameHead
-     << setw(maxWorkIdSize+2) << left << workIdHead << setw(maxOwnerSize+2) << left << ownerHead
-     << setw(maxStatusSize+2) << statusHead << setw(maxQueueSize+2) << left << queueHead
-     << setw(maxPrioritySize+2) << left << priorityHead
-     << setw(maxMachineIdSize+2) << left << machineIdHead << endl;
-
-
-  setFill(maxJobIdSize, os);
-  setFill(maxJobNameSize, os);
-  setFill(maxWorkIdSize, os);
-  setFill(maxOwnerSize, os);
-  setFill(maxStatusSize, os);
-  setFill(maxQueueSize, os);
-  setFill(maxPrioritySize, os);
-  setFill(maxMachineIdSize, os);
-  os << endl;
+  if (showHeader) {
+    os << setw(maxJobIdSize+2) << left << jobIdHead << setw(maxJobNameSize+2) << left << jobNameHead
+       << setw(maxWorkIdSize+2) << left << workIdHead << setw(maxOwnerSize+2) << left << ownerHead
+       << setw(maxStatusSize+2) << statusHead << setw(maxQueueSize+2) << left << queueHead
+       << setw(maxPrioritySize+2) << left << priorityHead
+       << setw(maxMachineIdSize+2) << left << machineIdHead << endl;
+
+
+    setFill(maxJobIdSize, os);
+    setFill(maxJobNameSize, os);
+    setFill(maxWorkIdSize, os);
+    setFill(maxOwnerSize, os);
+    setFill(maxStatusSize, os);
+    setFill(maxQueueSize, os);
+    setFill(maxPrioritySize, os);
+    setFill(maxMachineIdSize, os);
+    os << endl;
+  }
 
   for(size_t i = 0; i < listJobs.getJobs().size(); i++) {
 
@@ -498,10 +500,32 @@ operator<<(std::ostream& os, ListJobs& listJobs) {
     os << endl;
 
   }
+}
 
+/**
+ * \brief Helper function to display the summary of a list of jobs
+ * \param os: The output stream in which the summary will be printed
+ * \param nbJobs: The number of jobs
+ * \param nbRunningJobs: The number of running jobs
+ * \param nbWaitingJobs: The number of waiting jobs
+ */
+void
+displayJobsSummary(std::ostream& os, long nbJobs, long nbRunningJobs, long nbWaitingJobs) {
   os << endl;
-  os << listJobs.getNbJobs() << " jobs, " << listJobs.getNbRunningJobs() << " running, ";
-  os << listJobs.getNbWaitingJobs() << " waiting" << std::endl;
+  os << nbJobs << " jobs, " << nbRunningJobs << " running, ";
+  os << nbWaitingJobs << " waiting" << std::endl;
+}
+
+/**
+ * \brief Helper function to display a list of jobs
+ * \param os: The output stream in which the list will be printed
+ * \param listJobs: The list to display
+ * \return The output stream in which the list of users has been printed
+ */
+std::ostream&
+operator<<(std::ostream& os, ListJobs& listJobs) {
+  displayJobsPage(os, listJobs, true);
+  displayJobsSummary(os, listJobs.getNbJobs(), listJobs.getNbRunningJobs(), listJobs.getNbWaitingJobs());
   return os;
 }
 
@@ -88,6 +88,25 @@ std::string convertJobPriorityToString(const int& prio);
 std::ostream&
 operator<<(std::ostream& os, TMS_Data::ListQueues& lsQueues);
 
+/**
+ * \brief Helper function to display a page of a list of jobs, without the summary
+ * \param os: The output stream in which the page will be printed
+ * \param listJobs: The page to display
+ * \param showHeader: Whether the header of the columns is printed
+ */
+void
+displayJobsPage(std::ostream& os, TMS_Data::ListJobs& listJobs, bool showHeader);
+
+/**
+ * \brief Helper function to display the summary of a list of jobs
+ * \param os: The output stream in which the summary will be printed
+ * \param nbJobs: The number of jobs
+ * \param nbRunningJobs: The number of running jobs
+ * \param nbWaitingJobs: The number of waiting jobs
+ */
+void
+displayJobsSummary(std::ostream& os, long nbJobs, long nbRunningJobs, long nbWaitingJobs);
+
 /**
  * \brief Helper function to display a list of jobs
  * \param os: The output stream in which the list will be printed
@@ -23,6 +23,11 @@ namespace po = boost::program_options;
 using namespace std;
 using namespace vishnu;
 
+/**
+ * \brief The number of jobs requested at once, the jobs are printed page by page
+ */
+static const int LIST_JOBS_PAGE_SIZE = 1000;
+
 /**
  * \brief To build options for the VISHNU submit job command
  * \param pgName : The name of the command
@@ -36,6 +41,7 @@ using namespace vishnu;
  * \param setQueueFct : Function to set the queue where the job where submitted
  * \param setMutipleStatusesFct : lists the jobs with the specified status (combination of multiple status)
  * \param setWorkIdFct: Function to set the job work id
+ * \param setPageSizeFct: Function to set the number of jobs requested at once
  * \param configFile: Represents the VISHNU config file
  * \return The description of all options allowed by the command
  */
@@ -52,6 +58,7 @@ makeListJobOp(string pgName,
               boost::function1<void, string>& setQueueFct,
               boost::function1<void, string>& setMutipleStatusesFct,
               boost::function1<void, long long>& setWorkIdFct,
+              boost::function1<void, int>& setPageSizeFct,
               string& configFile) {
   boost::shared_ptr<Options> opt(new Options(pgName));
 
@@ -119,6 +126,11 @@ makeListJobOp(string pgName,
            "Allows to gather information about jobs related to a given Work.",
            CONFIG,
            setWorkIdFct);
+  opt->add("pageSize,n",
+           "The number of jobs requested at once, the jobs are printed as the "
+           "pages arrive. 0 requests all the jobs at once",
+           CONFIG,
+           setPageSizeFct);
 
   return opt;
 }
@@ -146,6 +158,7 @@ main (int argc, char* argv[]) {
   boost::function1<void,string> setQueueFct(boost::bind(&TMS_Data::ListJobsOptions::setQueue,boost::ref(jobOp),_1));
   boost::function1<void,string> setMultipleStatusesFct(boost::bind(&TMS_Data::ListJobsOptions::setMultipleStatus,boost::ref(jobOp),_1));
   boost::function1<void,long long> setWorkIdFct(boost::bind(&TMS_Data::ListJobsOptions::setWorkId,boost::ref(jobOp),_1));
+  boost::function1<void,int> setPageSizeFct(boost::bind(&TMS_Data::ListJobsOptions::setPageSize,boost::ref(jobOp),_1));
 
   /*********** Out parameters *********************/
   TMS_Data::ListJobs jobs;
@@ -163,12 +176,15 @@ main (int argc, char* argv[]) {
       setQueueFct,
       setMultipleStatusesFct,
       setWorkIdFct,
+      setPageSizeFct,
       configFile);
 
   opt->add("isListAll,l",
            "allows to list all information",
            CONFIG);
 
+  jobOp.setPageSize(LIST_JOBS_PAGE_SIZE);
+
   // pre-process options
   bool isEmpty;
   GenericCli().processListOpt(opt, isEmpty, argc, argv);
@@ -236,17 +252,37 @@ main (int argc, char* argv[]) {
       return  CLI_ERROR_COMMUNICATION ;
     }
 
-    // Process list job
-    listJobs(getLastSessionKey(getppid()), jobs, jobOp);
-    if (jobOp.getJobId().empty()
-        && jobOp.getNbCpu() <= 0
-        && jobOp.getFromSubmitDate() <= 0
-        && jobOp.getToSubmitDate() <= 0
-        && !jobOp.isListAll())
-    {
-      std::cout << jobs << "\n";
-    } else {
-      displayListJobs(jobs);
+    bool tableView = (jobOp.getJobId().empty()
+                      && jobOp.getNbCpu() <= 0
+                      && jobOp.getFromSubmitDate() <= 0
+                      && jobOp.getToSubmitDate() <= 0
+                      && !jobOp.isListAll());
+
+    // Process list job, page by page
+    std::string sessionKey = getLastSessionKey(getppid());
+    long nbJobs = 0;
+    long nbRunningJobs = 0;
+    long nbWaitingJobs = 0;
+    bool firstPage = true;
+    do {
+      listJobs(sessionKey, jobs, jobOp);
+      if (tableView) {
+        displayJobsPage(std::cout, jobs, firstPage);
+      } else {
+        displayListJobs(jobs);
+      }
+      std::cout.flush();
+      nbJobs += jobs.getNbJobs();
+      nbRunningJobs += jobs.getNbRunningJobs();
+      nbWaitingJobs += jobs.getNbWaitingJobs();
+      jobOp.setResumeToken(jobs.getNextToken());
+      jobs.getJobs().clear();
+      firstPage = false;
+    } while (! jobOp.getResumeToken().empty());
+
+    if (tableView) {
+      displayJobsSummary(std::cout, nbJobs, nbRunningJobs, nbWaitingJobs);
+      std::cout << "\n";
     }
   } catch(VishnuException& e) {// catch all Vishnu runtime error
     std::string  msg = e.getMsg();
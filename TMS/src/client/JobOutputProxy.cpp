@@ -176,10 +176,10 @@ JobOutputProxy::getCompletedJobsOutput(const TMS_Data::JobOutputOptions& options
                                               % boost::filesystem::unique_path("vishnu-%%%%%%.dinfo").string());
     vishnu::genericFileCopier(sessionKey, mmachineId, remoteOutputInfo, "", downloadInfoFile, copts);
     istringstream downloadInfoStream (vishnu::get_file_content(downloadInfoFile, false));
-    int numJob = 0;
     string line;
     ListStrings lineVec;
-    string missingFiles;
+    std::vector<ListStrings> jobFiles;
+    std::vector<std::string> targetDirs;
     while (getline(downloadInfoStream, line)) {
       if (line.empty()) continue;
       boost::trim(line);
@@ -189,10 +189,17 @@ JobOutputProxy::getCompletedJobsOutput(const TMS_Data::JobOutputOptions& options
                                          % baseDir
                                          % vishnu::generatedUniquePatternFromCurTime(lineVec[0]));
       vishnu::createOutputDir(targetDir);
-      vishnu::copyFiles(sessionKey, mmachineId, lineVec, targetDir, copts, missingFiles, 1);
-      listJobResults_ptr->getResults().get(numJob++)->setOutputDir(targetDir);
-      if (!missingFiles.empty()) {
-        vishnu::saveInFile(targetDir+"/MISSINGFILES", missingFiles);
+      jobFiles.push_back(lineVec);
+      targetDirs.push_back(targetDir);
+    }
+
+    // the files of all the jobs are copied together, several at once
+    std::vector<std::string> missingFiles;
+    vishnu::copyJobOutputs(sessionKey, mmachineId, jobFiles, targetDirs, copts, missingFiles, 1);
+    for (size_t numJob = 0; numJob < targetDirs.size(); ++numJob) {
+      listJobResults_ptr->getResults().get(numJob)->setOutputDir(targetDirs[numJob]);
+      if (!missingFiles[numJob].empty()) {
+        vishnu::saveInFile(targetDirs[numJob]+"/MISSINGFILES", missingFiles[numJob]);
       }
     }
   } catch (FMSVishnuException &ex) {
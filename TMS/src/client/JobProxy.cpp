@@ -89,6 +89,81 @@ JobProxy::submitJob(const std::string& scriptPath,
   return 0;
 }
 
+/**
+ * \brief Function to submit a set of jobs built from a single script
+ * \param scriptPath the local path of the script
+ * \param scriptContent the content of the script
+ * \param options the options shared by the jobs
+ * \param jobParams the parameters of each job, in the form PARAM1=value1 PARAM2=value2
+ * \param jobs OUT, the jobs submitted
+ * \return raises an exception on error
+ */
+int
+JobProxy::submitJobs(const std::string& scriptPath,
+                     const std::string& scriptContent,
+                     const TMS_Data::SubmitOptions& options,
+                     const std::vector<std::string>& jobParams,
+                     TMS_Data::ListJobs& jobs) {
+
+  JsonObject optionsData(options);
+
+  // select a machine if not machine set
+  if (mmachineId.empty() || mmachineId == AUTOM_KEYWORD) {
+    TMS_Data::LoadCriterion loadCriterion;
+    int criterion = optionsData.getIntProperty("criterion");
+    if (criterion < 0 ) {
+      loadCriterion.setLoadType(criterion);
+    } else {
+      loadCriterion.setLoadType(NBWAITINGJOBS);
+    }
+    mmachineId = vishnu::findMachine(msessionKey, loadCriterion);
+  }
+
+  string serviceName = boost::str(boost::format("%1%@%2%")% SERVICES_TMS[JOBSUBMITMANY] % mmachineId);
+
+  // Send input files, they are shared by the jobs
+  FMS_Data::CpFileOptions copts;
+  copts.setIsRecursive(true) ;
+  copts.setTrCommand(0);
+  string inputFiles = vishnu::sendInputFiles(msessionKey,
+                                             options.getFileParams(),
+                                             mmachineId,
+                                             copts);
+  optionsData.setProperty("fileparams", inputFiles);
+  optionsData.setProperty("scriptpath", scriptPath);
+
+  JsonObject paramsData;
+  paramsData.setArrayProperty("params");
+  for (std::vector<std::string>::const_iterator it = jobParams.begin(); it != jobParams.end(); ++it) {
+    paramsData.addItemToLastArray(*it);
+  }
+
+  // Set RPC pameters
+  diet_profile_t* profile = diet_profile_alloc(serviceName, 5);
+  diet_string_set(profile,0, msessionKey);
+  diet_string_set(profile,1, mmachineId);
+  diet_string_set(profile,2, scriptContent);
+  diet_string_set(profile,3, optionsData.encode());
+  diet_string_set(profile,4, paramsData.encode());
+
+  if (diet_call(profile)) {
+    raiseCommunicationMsgException("RPC call failed");
+  }
+  raiseExceptionOnErrorResult(profile);
+
+  std::string jobsSerialized;
+  diet_string_get(profile,1, jobsSerialized);
+  diet_profile_free(profile);
+
+  TMS_Data::ListJobs_ptr jobs_ptr = NULL;
+  parseEmfObject(jobsSerialized, jobs_ptr, "Error by receiving List object serialized");
+  for (unsigned int i = 0; i < jobs_ptr->getJobs().size(); ++i) {
+    jobs.getJobs().push_back(new TMS_Data::Job(*jobs_ptr->getJobs().get(i)));
+  }
+  delete jobs_ptr;
+  return 0;
+}
+
 /**
  * \brief Function to cancel job
  * \param options An object containing options
@@ -41,6 +41,22 @@ public:
             const std::string& scriptContent,
             const TMS_Data::SubmitOptions& options);
 
+  /**
+  * \brief Function to submit a set of jobs built from a single script
+  * \param scriptPath the local path of the script
+  * \param scriptContent the content of the script
+  * \param options the options shared by the jobs
+  * \param jobParams the parameters of each job, in the form PARAM1=value1 PARAM2=value2
+  * \param jobs OUT, the jobs submitted
+  * \return raises an exception on error
+  */
+  int
+  submitJobs(const std::string& scriptPath,
+             const std::string& scriptContent,
+             const TMS_Data::SubmitOptions& options,
+             const std::vector<std::string>& jobParams,
+             TMS_Data::ListJobs& jobs);
+
   
   /**
   * \brief Function to cancel job
@@ -35,7 +35,7 @@ set(POSIX_ALL_INCLUDE_DIR "")
 set(POSIX_ALL_LIB_DIR "")
 
 if (pbs)
-  set(PBSPROSERVER server/PbsProServer.cpp utils_pbs/pbs_sub.c)
+  set(PBSPROSERVER server/PbsProServer.cpp server/PbsConnectionPool.cpp utils_pbs/pbs_sub.c)
   set(PBSPRO_ALL_INCLUDE_DIR ${PBSPRO_INCLUDE_DIR}  ${UTILS_PBSPRO_DIR})
   set(PBSPRO_ALL_LIB_DIR ${PBSPRO_LIB})
   configure_file(
@@ -44,7 +44,7 @@ if (pbs)
 endif(pbs)
 
 if (torque)
-  set(TORQUESERVER server/TorqueServer.cpp utils_torque/pbs_sub.c)
+  set(TORQUESERVER server/TorqueServer.cpp server/PbsConnectionPool.cpp utils_torque/pbs_sub.c)
   set(TORQUE_ALL_INCLUDE_DIR ${TORQUE_INCLUDE_DIR}  ${UTILS_TORQUE_DIR})
   set(TORQUE_ALL_LIB_DIR ${TORQUE_LIB})
   configure_file(
@@ -6,50 +6,287 @@
  */
 
 #include "BatchFactory.hpp"
+#include <map>
 #include <string>
+#include <vector>
 #include <boost/format.hpp>
+#include <boost/thread/mutex.hpp>
 #include <iostream>
+#include <unistd.h>
 #include "tmsUtils.hpp"
+#include "Logger.hpp"
 #include "SharedLibrary.hh"
 
 
-static int created = 0;
+namespace {
 
 /**
- * \brief Constructor
+ * \brief A backend library loaded in the process and its instances
+ */
+struct BatchBackend {
+  /**
+   * \brief The library, never unloaded
+   */
+  dadi::SharedLibrary* library;
+  /**
+   * \brief The function creating the instances
+   */
+  factory_function create;
+  /**
+   * \brief How the instances are shared
+   */
+  BatchConcurrencyPolicy policy;
+  /**
+   * \brief The instances not in use
+   */
+  std::vector<BatchServer*> idle;
+  /**
+   * \brief The instance of a serialized backend
+   */
+  BatchServer* single;
+  /**
+   * \brief Held while the instance of a serialized backend is in use
+   */
+  boost::mutex inUse;
+};
+
+/**
+ * \class BatchPluginRegistry
+ * \brief The backend libraries loaded by the process. The registry lives
+ * until the end of the process so that the libraries are never unloaded
+ * under an instance still in use.
  */
-BatchFactory::BatchFactory() : mbatchServer(NULL) {
+class BatchPluginRegistry {
+public:
+  static BatchPluginRegistry&
+  getInstance() {
+    static BatchPluginRegistry* instance = new BatchPluginRegistry();
+    return *instance;
+  }
+
+  BatchPluginRegistry() : mowner(getpid()) {}
+
+  boost::shared_ptr<BatchServer>
+  acquire(const std::string& libname, BatchConcurrencyPolicy policy);
+
+  void
+  release(BatchBackend* backend, BatchServer* instance);
+
+private:
+  /**
+   * \class Release
+   * \brief Gives an instance back to its backend
+   */
+  class Release {
+  public:
+    explicit Release(BatchBackend* backend) : mbackend(backend) {}
+
+    void
+    operator()(BatchServer* instance) {
+      BatchPluginRegistry::getInstance().release(mbackend, instance);
+    }
+
+  private:
+    BatchBackend* mbackend;
+  };
+
+  BatchServer*
+  create(BatchBackend* backend);
+
+  BatchServer*
+  createUnshared(const std::string& libname);
+
+  bool
+  isOwner() const;
+
+  /**
+   * \brief The backends loaded, by library name
+   */
+  std::map<std::string, BatchBackend*> mbackends;
+  /**
+   * \brief mutex protecting mbackends and the idle instances
+   */
+  boost::mutex mmutex;
+  /**
+   * \brief The process which created the registry
+   */
+  pid_t mowner;
+};
+
+
+boost::shared_ptr<BatchServer>
+BatchPluginRegistry::acquire(const std::string& libname, BatchConcurrencyPolicy policy) {
+  if (! isOwner()) {
+    BatchServer* instance = createUnshared(libname);
+    if (! instance) {
+      return boost::shared_ptr<BatchServer>();
+    }
+    return boost::shared_ptr<BatchServer>(instance);
+  }
+
+  BatchBackend* backend = NULL;
+  BatchServer* instance = NULL;
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    std::map<std::string, BatchBackend*>::iterator it = mbackends.find(libname);
+    if (it != mbackends.end()) {
+      backend = it->second;
+    } else {
+      std::string filename = boost::str(boost::format("%1%%2%%3%")
+                                        % dadi::SharedLibrary::prefix()
+                                        % libname
+                                        % dadi::SharedLibrary::suffix());
+      dadi::SharedLibrary* library = new dadi::SharedLibrary(filename);
+      void* factory = library->isLoaded() ? library->symbol("create_plugin_instance") : NULL;
+      if (! factory) {
+        // not cached, the backend may be installed later
+        LOG(boost::str(boost::format("[ERROR] cannot load the batch plugin %1%") % filename), LogErr);
+        delete library;
+        return boost::shared_ptr<BatchServer>();
+      }
+      backend = new BatchBackend();
+      backend->library = library;
+      backend->create = reinterpret_cast<factory_function>(factory);
+      backend->policy = policy;
+      backend->single = NULL;
+      mbackends[libname] = backend;
+    }
+
+    if (backend->policy == BATCH_POOLED && ! backend->idle.empty()) {
+      instance = backend->idle.back();
+      backend->idle.pop_back();
+    }
+  }
+
+  switch (backend->policy) {
+    case BATCH_SERIALIZED:
+      // released by Release
+      backend->inUse.lock();
+      if (! backend->single) {
+        backend->single = create(backend);
+        if (! backend->single) {
+          backend->inUse.unlock();
+          return boost::shared_ptr<BatchServer>();
+        }
+      }
+      instance = backend->single;
+      break;
+    case BATCH_POOLED:
+    case BATCH_NOT_CACHED:
+    default:
+      if (! instance) {
+        instance = create(backend);
+      }
+      if (! instance) {
+        return boost::shared_ptr<BatchServer>();
+      }
+      break;
+  }
+  return boost::shared_ptr<BatchServer>(instance, Release(backend));
 }
 
 
 BatchServer*
-loadPluginBatch(const char *name) {
-  dadi::SharedLibrary *plugin(NULL);
-  BatchServer *instance(NULL);
-
-  std::string libname = boost::str(boost::format("%1%%2%%3%")
-                                   % dadi::SharedLibrary::prefix()
-                                   % name
-                                   % dadi::SharedLibrary::suffix());
-
-  plugin = new dadi::SharedLibrary(libname);
-  if (plugin->isLoaded()) {
-    void *factory = plugin->symbol("create_plugin_instance");
-    reinterpret_cast<factory_function>(factory)(reinterpret_cast<void**>(&instance));
+BatchPluginRegistry::create(BatchBackend* backend) {
+  BatchServer* instance = NULL;
+  backend->create(reinterpret_cast<void**>(&instance));
+  return instance;
+}
+
+
+BatchServer*
+BatchPluginRegistry::createUnshared(const std::string& libname) {
+  std::string filename = boost::str(boost::format("%1%%2%%3%")
+                                    % dadi::SharedLibrary::prefix()
+                                    % libname
+                                    % dadi::SharedLibrary::suffix());
+  // never unloaded, the library is most likely loaded by the parent anyway
+  dadi::SharedLibrary* library = new dadi::SharedLibrary(filename);
+  void* factory = library->isLoaded() ? library->symbol("create_plugin_instance") : NULL;
+  if (! factory) {
+    LOG(boost::str(boost::format("[ERROR] cannot load the batch plugin %1%") % filename), LogErr);
+    delete library;
+    return NULL;
   }
+  BatchServer* instance = NULL;
+  reinterpret_cast<factory_function>(factory)(reinterpret_cast<void**>(&instance));
   return instance;
 }
 
+
+bool
+BatchPluginRegistry::isOwner() const {
+  // a forked process may hold a copy of a locked mutex, it must not
+  // touch the backends
+  return getpid() == mowner;
+}
+
+
+void
+BatchPluginRegistry::release(BatchBackend* backend, BatchServer* instance) {
+  if (! isOwner()) {
+    // the instance belongs to the parent process
+    return;
+  }
+  switch (backend->policy) {
+    case BATCH_SERIALIZED:
+      backend->inUse.unlock();
+      break;
+    case BATCH_POOLED: {
+      boost::lock_guard<boost::mutex> lock(mmutex);
+      backend->idle.push_back(instance);
+      break;
+    }
+    case BATCH_NOT_CACHED:
+    default:
+      delete instance;
+      break;
+  }
+}
+
+} // namespace
+
+
+/**
+ * \brief Constructor
+ */
+BatchFactory::BatchFactory() {
+}
+
+
+/**
+ * \brief Function to get the concurrency policy of a backend
+ * \param batchType The type of batchServer
+ * \return the policy of the backend
+ */
+BatchConcurrencyPolicy
+BatchFactory::getConcurrencyPolicy(int batchType) {
+  switch(batchType){
+  case SGE:          // DRMAA has a single session per process
+  case LSF:          // lsb_openjobinfo keeps a global cursor
+  case LOADLEVELER:
+    return BATCH_SERIALIZED;
+  case DELTACLOUD:   // the cloud parameters are read when the instance is created
+  case OPENNEBULA:   // and overridden by the specific parameters of the request
+    return BATCH_NOT_CACHED;
+  case TORQUE:
+  case SLURM:
+  case PBSPRO:
+  case POSIX:
+  default:
+    return BATCH_POOLED;
+  }
+}
+
 /**
- * \brief Function to create a batchServer.
+ * \brief Function to get a batchServer.
  * \param batchType The type of batchServer to create
  * \param batchVersion The version of batchServer to create
- * \return an instance of BatchServer, or NULL
+ * \return an instance of BatchServer, or an empty pointer
  */
-BatchServer*
+boost::shared_ptr<BatchServer>
 BatchFactory::getBatchServerInstance(int batchType,
                                      const std::string &batchVersion) {
-  BatchServer *instance(NULL);
   std::string libname = "vishnu-tms-";
   // batchVersion is set to n/a when not applicable but MUST be not be taken into account when loading the lib
   std::string realBatchVersion = (batchVersion!="n/a")? batchVersion : "";
@@ -89,18 +326,10 @@ BatchFactory::getBatchServerInstance(int batchType,
   }
 
   libname += realBatchVersion;
-  instance = loadPluginBatch(libname.c_str());
-  return static_cast<BatchServer *>(instance);
+  return BatchPluginRegistry::getInstance().acquire(libname, getConcurrencyPolicy(batchType));
 }
 
 
-/**
- * \brief Function to delete a batchServer.
- */
-void
-BatchFactory::deleteBatchServerInstance() {
-  delete mbatchServer;
-}
 /**
  * \brief Destructor
  */
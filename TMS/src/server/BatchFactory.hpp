@@ -9,14 +9,38 @@
 #define TMS_BATCH_FACTORY_H
 
 #include <string>
+#include <boost/shared_ptr.hpp>
 #include "utilVishnu.hpp"
 #include "TMSVishnuException.hpp"
 #include "UMSVishnuException.hpp"
 #include "BatchServer.hpp"
 
+/**
+ * \brief How the instances of a batch backend are shared between the
+ * requests of a process
+ */
+typedef enum {
+  /**
+   * \brief A single instance, used by one request at a time. For the
+   * backends whose library keeps a global state (DRMAA, LSF, LoadLeveler)
+   */
+  BATCH_SERIALIZED,
+  /**
+   * \brief The instances are reused, each by one request at a time
+   */
+  BATCH_POOLED,
+  /**
+   * \brief A new instance for each request, for the backends which keep
+   * the parameters of the request in the instance
+   */
+  BATCH_NOT_CACHED
+} BatchConcurrencyPolicy;
+
 /**
  * \class BatchFactory
- * \brief A factory class to manage the life of BatchServer instance
+ * \brief A factory class to manage the life of BatchServer instance. The
+ * backend libraries are loaded once per process and their instances are
+ * reused according to the concurrency policy of the backend.
  */
 class BatchFactory
 {
@@ -33,27 +57,25 @@ class BatchFactory
     ~BatchFactory();
 
     /**
-     * \brief Function to create a batchServer.
+     * \brief Function to get a batchServer. The instance is given back to
+     * the factory when the last copy of the pointer is released, it must
+     * not be kept beyond the request.
      * \param BatchType The type of batchServer to create
      * \param batchVersion The version of batchServer to create
-     * \return an instance of BatchServer, or NULL
+     * \return an instance of BatchServer, or an empty pointer if the backend
+     * cannot be loaded
      */
-    BatchServer*
+    boost::shared_ptr<BatchServer>
     getBatchServerInstance(int BatchType,
                            const std::string &batchVersion);
 
     /**
-     * \brief Function to delete a batchServer.
-     */
-    void deleteBatchServerInstance();
-
-  private :
-
-    /**
-     * \brief an instance of the batchServer
+     * \brief Function to get the concurrency policy of a backend
+     * \param batchType The type of batchServer
+     * \return the policy of the backend
      */
-    BatchServer* mbatchServer;
-
+    static BatchConcurrencyPolicy
+    getConcurrencyPolicy(int batchType);
 };
 
 #endif
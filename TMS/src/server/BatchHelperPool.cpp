@@ -0,0 +1,648 @@
+/**
+ * \file BatchHelperPool.cpp
+ * \brief This file implements the pool of privileged processes running the
+ * native batch actions on behalf of the users
+ */
+
+#include "BatchHelperPool.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <fcntl.h>
+#include <grp.h>
+#include <poll.h>
+#include <pwd.h>
+#include <stdint.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <boost/format.hpp>
+
+#include "Logger.hpp"
+
+namespace {
+
+/**
+ * \brief The period in seconds of the launcher checks for idle helpers
+ */
+const int HELPER_CHECK_PERIOD = 10;
+
+/**
+ * \brief The kinds of frames
+ */
+const char FRAME_REQUEST = 'Q';
+const char FRAME_RESPONSE = 'R';
+const char FRAME_ERROR = 'E';
+
+/**
+ * \brief The size of a frame header: the size of the payload in network
+ * order followed by the kind of the frame
+ */
+const size_t FRAME_HEADER_SIZE = 5;
+
+
+/**
+ * \brief Send a message along with a descriptor
+ * \param sock the socket
+ * \param fd the descriptor
+ * \param data the message
+ * \param size the size of the message
+ * \return 0 on success, -1 with errno set otherwise
+ */
+int
+sendDescriptor(int sock, int fd, const void* data, size_t size) {
+  struct iovec iov;
+  iov.iov_base = const_cast<void*>(data);
+  iov.iov_len = size;
+
+  union {
+    struct cmsghdr align;
+    char buffer[CMSG_SPACE(sizeof(int))];
+  } control;
+  memset(&control, 0, sizeof(control));
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buffer;
+  msg.msg_controllen = sizeof(control.buffer);
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+  ssize_t rc;
+  do {
+    rc = sendmsg(sock, &msg, MSG_NOSIGNAL);
+  } while (rc < 0 && errno == EINTR);
+  return (rc == static_cast<ssize_t>(size)) ? 0 : -1;
+}
+
+
+/**
+ * \brief Receive a message along with a descriptor
+ * \param sock the socket
+ * \param data OUT, the message
+ * \param size the size of the message
+ * \param fd OUT, the descriptor, -1 if none was sent
+ * \return the size received, 0 if the peer is gone, -1 on error
+ */
+ssize_t
+receiveDescriptor(int sock, void* data, size_t size, int& fd) {
+  struct iovec iov;
+  iov.iov_base = data;
+  iov.iov_len = size;
+
+  union {
+    struct cmsghdr align;
+    char buffer[CMSG_SPACE(sizeof(int))];
+  } control;
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buffer;
+  msg.msg_controllen = sizeof(control.buffer);
+
+  fd = -1;
+  ssize_t rc = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+  if (rc > 0) {
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+        memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+      }
+    }
+  }
+  return rc;
+}
+
+
+/**
+ * \brief Write a whole buffer to a stream socket
+ * \param fd the socket
+ * \param data the buffer
+ * \param size the size of the buffer
+ * \return true on success
+ */
+bool
+writeAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t rc = send(fd, data, size, MSG_NOSIGNAL);
+    if (rc < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += rc;
+    size -= rc;
+  }
+  return true;
+}
+
+
+/**
+ * \brief Read a whole buffer from a stream socket
+ * \param fd the socket
+ * \param data OUT, the buffer
+ * \param size the size to read
+ * \return true on success, false on error or if the peer is gone
+ */
+bool
+readAll(int fd, char* data, size_t size) {
+  while (size > 0) {
+    ssize_t rc = recv(fd, data, size, 0);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      return false;
+    }
+    data += rc;
+    size -= rc;
+  }
+  return true;
+}
+
+
+/**
+ * \brief Bound the time spent waiting on a socket
+ * \param fd the socket
+ * \param seconds the time in seconds a read or a write may wait
+ */
+void
+setTimeout(int fd, int seconds) {
+  struct timeval timeout;
+  timeout.tv_sec = seconds;
+  timeout.tv_usec = 0;
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+
+/**
+ * \brief Take the credentials of a user, for good
+ * \param uid the user
+ * \return an empty string on success, the error otherwise
+ */
+std::string
+switchUser(uid_t uid) {
+  if (uid == getuid()) {
+    return "";
+  }
+  struct passwd* info = getpwuid(uid);
+  if (info == NULL) {
+    return boost::str(boost::format("unknown user id %1%") % uid);
+  }
+  if (setgid(info->pw_gid) != 0
+      || initgroups(info->pw_name, info->pw_gid) != 0
+      || setuid(uid) != 0) {
+    return std::string(strerror(errno));
+  }
+  return "";
+}
+
+
+/**
+ * \brief Serve the requests handed over by the launcher until it stops the
+ * helper
+ * \param control the socket to the launcher
+ * \param handler the function run for each request
+ * \param failure if not empty, the error returned to every request
+ */
+void
+runHelper(int control, BatchHelperPool::RequestHandler handler, const std::string& failure) {
+  for (;;) {
+    char tag;
+    int request;
+    ssize_t size = receiveDescriptor(control, &tag, sizeof(tag), request);
+    if (size < 0 && errno == EINTR) {
+      continue;
+    }
+    if (size <= 0) {
+      break;
+    }
+    if (request < 0) {
+      continue;
+    }
+
+    // a stalled server thread does not hold the helper of the user
+    setTimeout(request, BATCH_HELPER_IO_TIMEOUT);
+    char kind;
+    std::string payload;
+    if (BatchHelperPool::readFrame(request, kind, payload)) {
+      std::string response;
+      char responseKind = FRAME_RESPONSE;
+      if (! failure.empty()) {
+        responseKind = FRAME_ERROR;
+        response = failure;
+      } else {
+        try {
+          response = handler(payload);
+        } catch (const std::exception& ex) {
+          responseKind = FRAME_ERROR;
+          response = ex.what();
+        }
+      }
+      if (response.size() > BATCH_HELPER_MAX_FRAME_SIZE) {
+        responseKind = FRAME_ERROR;
+        response = boost::str(boost::format("the response of the batch helper is too large (%1% bytes)")
+                              % response.size());
+      }
+      if (! BatchHelperPool::writeFrame(request, responseKind, response)) {
+        LOG(boost::str(boost::format("[WARNING] the batch helper cannot send its response: %1%")
+                       % strerror(errno)), LogWarning);
+      }
+    } else {
+      LOG(boost::str(boost::format("[WARNING] the batch helper did not get a complete request: %1%")
+                     % strerror(errno)), LogWarning);
+    }
+    close(request);
+  }
+  close(control);
+}
+
+
+/**
+ * \class HelperLauncher
+ * \brief The root process forking the helpers and handing the requests
+ * over to them
+ */
+class HelperLauncher {
+public:
+  HelperLauncher(int control, BatchHelperPool::RequestHandler handler)
+    : mcontrol(control), mhandler(handler) {}
+
+  /**
+   * \brief Dispatch the requests until the server is gone
+   */
+  void
+  run();
+
+private:
+  /**
+   * \brief A helper process
+   */
+  struct Helper {
+    /**
+     * \brief The process
+     */
+    pid_t pid;
+    /**
+     * \brief The socket the requests are handed over on
+     */
+    int control;
+    /**
+     * \brief The date of the last request
+     */
+    time_t lastUsed;
+  };
+
+  typedef std::map<uid_t, Helper> HelperMap;
+
+  void
+  dispatch(uid_t uid, int request);
+
+  bool
+  spawn(uid_t uid, Helper& helper);
+
+  void
+  stop(HelperMap::iterator it);
+
+  void
+  stopIdleHelpers();
+
+  void
+  reap();
+
+  /**
+   * \brief The socket to the server
+   */
+  int mcontrol;
+  /**
+   * \brief The function run by the helpers
+   */
+  BatchHelperPool::RequestHandler mhandler;
+  /**
+   * \brief The helpers, by user
+   */
+  HelperMap mhelpers;
+};
+
+
+void
+HelperLauncher::run() {
+  for (;;) {
+    struct pollfd item;
+    item.fd = mcontrol;
+    item.events = POLLIN;
+    item.revents = 0;
+    int rc = poll(&item, 1, 1000 * HELPER_CHECK_PERIOD);
+
+    reap();
+    stopIdleHelpers();
+    if (rc < 0 && errno != EINTR) {
+      break;
+    }
+    if (rc <= 0) {
+      continue;
+    }
+
+    uint32_t uid;
+    int request;
+    ssize_t size = receiveDescriptor(mcontrol, &uid, sizeof(uid), request);
+    if (size < 0 && (errno == EINTR || errno == EAGAIN)) {
+      continue;
+    }
+    if (size <= 0) {
+      // the server is gone
+      break;
+    }
+    if (request < 0) {
+      continue;
+    }
+    if (size == sizeof(uid)) {
+      dispatch(static_cast<uid_t>(uid), request);
+    }
+    close(request);
+  }
+
+  // the helpers stop once their pending requests are served
+  while (! mhelpers.empty()) {
+    stop(mhelpers.begin());
+  }
+}
+
+
+void
+HelperLauncher::dispatch(uid_t uid, int request) {
+  HelperMap::iterator it = mhelpers.find(uid);
+  // a helper which exited refuses the request, another one is started once
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    if (it == mhelpers.end()) {
+      if (mhelpers.size() >= static_cast<size_t>(BATCH_HELPER_MAX_HELPERS)) {
+        HelperMap::iterator oldest = mhelpers.begin();
+        for (HelperMap::iterator current = mhelpers.begin(); current != mhelpers.end(); ++current) {
+          if (current->second.lastUsed < oldest->second.lastUsed) {
+            oldest = current;
+          }
+        }
+        stop(oldest);
+      }
+      Helper helper;
+      if (! spawn(uid, helper)) {
+        return;
+      }
+      it = mhelpers.insert(std::make_pair(uid, helper)).first;
+    }
+
+    if (sendDescriptor(it->second.control, request, &FRAME_REQUEST, sizeof(FRAME_REQUEST)) == 0) {
+      it->second.lastUsed = time(NULL);
+      return;
+    }
+    stop(it);
+    it = mhelpers.end();
+  }
+  LOG(boost::str(boost::format("[ERROR] cannot hand a request over to the batch helper of uid %1%")
+                 % uid), LogErr);
+}
+
+
+bool
+HelperLauncher::spawn(uid_t uid, Helper& helper) {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) != 0) {
+    LOG(boost::str(boost::format("[ERROR] cannot create the socket of a batch helper: %1%")
+                   % strerror(errno)), LogErr);
+    return false;
+  }
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    LOG(boost::str(boost::format("[ERROR] cannot fork a batch helper: %1%")
+                   % strerror(errno)), LogErr);
+    close(fds[0]);
+    close(fds[1]);
+    return false;
+  }
+
+  if (pid == 0) {
+    // the helper only keeps its own socket, so that it sees when it is stopped
+    close(fds[0]);
+    close(mcontrol);
+    for (HelperMap::iterator it = mhelpers.begin(); it != mhelpers.end(); ++it) {
+      close(it->second.control);
+    }
+    std::string failure = switchUser(uid);
+    if (! failure.empty()) {
+      LOG(boost::str(boost::format("[ERROR] the batch helper cannot switch to uid %1%: %2%")
+                     % uid % failure), LogErr);
+    }
+    runHelper(fds[1], mhandler, failure);
+    exit(0);
+  }
+
+  close(fds[1]);
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  helper.pid = pid;
+  helper.control = fds[0];
+  helper.lastUsed = time(NULL);
+  LOG(boost::str(boost::format("[INFO] batch helper %1% started for uid %2%, %3% running")
+                 % pid % uid % (mhelpers.size() + 1)), LogInfo);
+  return true;
+}
+
+
+void
+HelperLauncher::stop(HelperMap::iterator it) {
+  close(it->second.control);
+  mhelpers.erase(it);
+}
+
+
+void
+HelperLauncher::stopIdleHelpers() {
+  time_t now = time(NULL);
+  HelperMap::iterator it = mhelpers.begin();
+  while (it != mhelpers.end()) {
+    HelperMap::iterator current = it++;
+    if (now - current->second.lastUsed > BATCH_HELPER_IDLE_TIME) {
+      stop(current);
+    }
+  }
+}
+
+
+void
+HelperLauncher::reap() {
+  pid_t pid;
+  while ((pid = waitpid(-1, NULL, WNOHANG)) > 0) {
+    for (HelperMap::iterator it = mhelpers.begin(); it != mhelpers.end(); ++it) {
+      if (it->second.pid == pid) {
+        stop(it);
+        break;
+      }
+    }
+  }
+}
+
+} // namespace
+
+
+BatchHelperPool&
+BatchHelperPool::getInstance() {
+  static BatchHelperPool instance;
+  return instance;
+}
+
+
+BatchHelperPool::BatchHelperPool() : mlauncher(-1) {
+}
+
+
+BatchHelperPool::~BatchHelperPool() {
+  if (mlauncher != -1) {
+    close(mlauncher);
+  }
+}
+
+
+bool
+BatchHelperPool::start(RequestHandler handler) {
+  if (isStarted()) {
+    return true;
+  }
+  // a sequenced socket keeps the requests apart and shows when a peer is gone
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) != 0) {
+    LOG(boost::str(boost::format("[WARNING] cannot create the socket of the batch helpers: %1%")
+                   % strerror(errno)), LogWarning);
+    return false;
+  }
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    LOG(boost::str(boost::format("[WARNING] cannot fork the batch helper launcher: %1%")
+                   % strerror(errno)), LogWarning);
+    close(fds[0]);
+    close(fds[1]);
+    return false;
+  }
+
+  if (pid == 0) {
+    close(fds[0]);
+    // the launcher reaps its helpers itself
+    signal(SIGCHLD, SIG_DFL);
+    HelperLauncher launcher(fds[1], handler);
+    launcher.run();
+    exit(0);
+  }
+
+  close(fds[1]);
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  mlauncher = fds[0];
+  return true;
+}
+
+
+bool
+BatchHelperPool::isStarted() const {
+  return mlauncher != -1;
+}
+
+
+BatchHelperPool::ExecuteStatus
+BatchHelperPool::execute(uid_t uid, const std::string& request, std::string& response) {
+  if (! isStarted()) {
+    response = "the batch helpers are not started";
+    return HELPER_UNAVAILABLE;
+  }
+  if (request.size() > BATCH_HELPER_MAX_FRAME_SIZE) {
+    response = boost::str(boost::format("the request is too large for the batch helpers (%1% bytes)")
+                          % request.size());
+    LOG("[ERROR] " + response, LogErr);
+    return HELPER_UNAVAILABLE;
+  }
+
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    response = std::string(strerror(errno));
+    return HELPER_UNAVAILABLE;
+  }
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+  // a message on the sequenced socket is atomic, the threads share it
+  uint32_t id = static_cast<uint32_t>(uid);
+  int rc = sendDescriptor(mlauncher, fds[1], &id, sizeof(id));
+  int error = errno;
+  close(fds[1]);
+  if (rc != 0) {
+    close(fds[0]);
+    response = boost::str(boost::format("cannot reach the batch helpers: %1%") % strerror(error));
+    return HELPER_UNAVAILABLE;
+  }
+
+  // the helper only acts on a complete request
+  if (! writeFrame(fds[0], FRAME_REQUEST, request)) {
+    close(fds[0]);
+    response = "the batch helper did not take the request";
+    return HELPER_UNAVAILABLE;
+  }
+
+  char kind;
+  if (! readFrame(fds[0], kind, response)) {
+    kind = FRAME_ERROR;
+    response = "the batch helper stopped before answering";
+  }
+  close(fds[0]);
+  return (kind == FRAME_RESPONSE) ? HELPER_SUCCESS : HELPER_FAILED;
+}
+
+
+bool
+BatchHelperPool::writeFrame(int fd, char kind, const std::string& payload) {
+  if (payload.size() > BATCH_HELPER_MAX_FRAME_SIZE) {
+    LOG(boost::str(boost::format("[ERROR] batch helper frame of %1% bytes above the limit of %2% bytes")
+                   % payload.size() % BATCH_HELPER_MAX_FRAME_SIZE), LogErr);
+    errno = EMSGSIZE;
+    return false;
+  }
+  char header[FRAME_HEADER_SIZE];
+  uint32_t size = htonl(static_cast<uint32_t>(payload.size()));
+  memcpy(header, &size, sizeof(size));
+  header[4] = kind;
+  return writeAll(fd, header, FRAME_HEADER_SIZE)
+    && writeAll(fd, payload.data(), payload.size());
+}
+
+
+bool
+BatchHelperPool::readFrame(int fd, char& kind, std::string& payload) {
+  char header[FRAME_HEADER_SIZE];
+  if (! readAll(fd, header, FRAME_HEADER_SIZE)) {
+    return false;
+  }
+  uint32_t size;
+  memcpy(&size, header, sizeof(size));
+  size = ntohl(size);
+  if (size > BATCH_HELPER_MAX_FRAME_SIZE) {
+    LOG(boost::str(boost::format("[ERROR] batch helper frame of %1% bytes above the limit of %2% bytes")
+                   % size % BATCH_HELPER_MAX_FRAME_SIZE), LogErr);
+    errno = EMSGSIZE;
+    return false;
+  }
+  kind = header[4];
+  payload.resize(size);
+  return size == 0 || readAll(fd, &payload[0], size);
+}
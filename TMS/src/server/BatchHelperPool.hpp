@@ -0,0 +1,136 @@
+/**
+ * \file BatchHelperPool.hpp
+ * \brief This file defines the pool of privileged processes running the
+ * native batch actions on behalf of the users
+ */
+
+#ifndef _BATCHHELPERPOOL_HPP_
+#define _BATCHHELPERPOOL_HPP_
+
+#include <string>
+#include <sys/types.h>
+#include <boost/noncopyable.hpp>
+
+/**
+ * \brief The number of helpers alive at once, the least recently used one
+ * is stopped to start another
+ */
+const int BATCH_HELPER_MAX_HELPERS = 32;
+
+/**
+ * \brief The time in seconds after which an idle helper is stopped
+ */
+const int BATCH_HELPER_IDLE_TIME = 300;
+
+/**
+ * \brief The maximum size in bytes of a request or a response
+ */
+const size_t BATCH_HELPER_MAX_FRAME_SIZE = 16 * 1024 * 1024;
+
+/**
+ * \brief The time in seconds a helper waits for a request or for the server
+ * to take its response
+ */
+const int BATCH_HELPER_IO_TIMEOUT = 30;
+
+/**
+ * \class BatchHelperPool
+ * \brief Long-lived helper processes, one per user, running the native batch
+ * actions with the credentials of the user. The pool must be started before
+ * the server creates its threads: it forks a single-threaded launcher which
+ * keeps the root privileges and forks the helpers on demand. A request is
+ * sent on a fresh socketpair handed over to the helper of the user, as
+ * length-prefixed frames, so the helpers serve the requests one at a time
+ * and keep the batch plugins loaded between them.
+ */
+class BatchHelperPool : public boost::noncopyable {
+public:
+  /**
+   * \brief The function run by the helpers for each request
+   * \param request the request
+   * \return the response, it must not throw
+   */
+  typedef std::string (*RequestHandler)(const std::string& request);
+
+  /**
+   * \brief The results of execute
+   */
+  typedef enum {
+    HELPER_SUCCESS = 0,
+    HELPER_FAILED = 1,
+    HELPER_UNAVAILABLE = -1
+  } ExecuteStatus;
+
+  /**
+   * \brief Get the pool of the process
+   * \return the pool
+   */
+  static BatchHelperPool&
+  getInstance();
+
+  /**
+   * \brief Fork the launcher, before any thread is created
+   * \param handler the function run by the helpers
+   * \return true on success
+   */
+  bool
+  start(RequestHandler handler);
+
+  /**
+   * \brief Whether the launcher has been forked
+   * \return true if started
+   */
+  bool
+  isStarted() const;
+
+  /**
+   * \brief Run a request in the helper of a user
+   * \param uid the user running the request
+   * \param request the request
+   * \param response OUT, the response of the handler, or the error message
+   * \return HELPER_SUCCESS, HELPER_FAILED if the request may have been
+   * started, HELPER_UNAVAILABLE if it has not been sent
+   */
+  ExecuteStatus
+  execute(uid_t uid, const std::string& request, std::string& response);
+
+  /**
+   * \brief Write a frame: the size of the payload in network order, the
+   * kind of the frame, then the payload
+   * \param fd the socket
+   * \param kind the kind of the frame
+   * \param payload the payload, at most BATCH_HELPER_MAX_FRAME_SIZE bytes
+   * \return true on success
+   */
+  static bool
+  writeFrame(int fd, char kind, const std::string& payload);
+
+  /**
+   * \brief Read a frame
+   * \param fd the socket
+   * \param kind OUT, the kind of the frame
+   * \param payload OUT, the payload
+   * \return true on success, false on error, on timeout, if the peer is
+   * gone or if the frame is too large
+   */
+  static bool
+  readFrame(int fd, char& kind, std::string& payload);
+
+  /**
+   * \brief Destructor, the launcher stops with the server
+   */
+  ~BatchHelperPool();
+
+private:
+  /**
+   * \brief Constructor
+   */
+  BatchHelperPool();
+
+  /**
+   * \brief The socket to the launcher
+   */
+  int mlauncher;
+};
+
+#endif // _BATCHHELPERPOOL_HPP_
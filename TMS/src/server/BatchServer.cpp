@@ -7,12 +7,58 @@
 
 #include "BatchServer.hpp"
 
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
+#include "VishnuException.hpp"
+#include "Logger.hpp"
+
 /**
  * \brief Constructor
  */
 BatchServer::BatchServer() {
 }
 
+/**
+ * \brief Function to get the status of several jobs at once
+ * \param jobIds the identifiers of the jobs
+ * \return the status of the jobs, by identifier
+ */
+std::map<std::string, int>
+BatchServer::getJobStates(const std::vector<std::string>& jobIds) {
+  std::map<std::string, int> states;
+  BOOST_FOREACH(const std::string& jobId, jobIds) {
+    try {
+      // the state is got first, so a failure leaves the job missing
+      int state = getJobState(jobId);
+      states[jobId] = state;
+    } catch (VishnuException& ex) {
+      LOG(boost::str(boost::format("[WARNING] cannot get the state of the job %1%: %2%")
+                     % jobId % ex.what()), LogWarning);
+    }
+  }
+  return states;
+}
+
+/**
+ * \brief Function to give the jobs the status reported by a server
+ * \param jobIds the identifiers of the jobs
+ * \param serverStates the status reported by the server, by sequence number
+ * \param missingState the status of the jobs the server does not report
+ * \return the status of all the jobs, by identifier
+ */
+std::map<std::string, int>
+BatchServer::matchJobStates(const std::vector<std::string>& jobIds,
+                            const std::map<std::string, int>& serverStates,
+                            int missingState) {
+  std::map<std::string, int> states;
+  BOOST_FOREACH(const std::string& jobId, jobIds) {
+    // the server name may be written differently, the sequence number is not
+    std::map<std::string, int>::const_iterator found = serverStates.find(jobId.substr(0, jobId.find('.')));
+    states[jobId] = (found != serverStates.end()) ? found->second : missingState;
+  }
+  return states;
+}
+
 /**
  * \brief Destructor
  */
@@ -8,7 +8,9 @@
 #ifndef TMS_BATCH_SERVER_H
 #define TMS_BATCH_SERVER_H
 
+#include <map>
 #include <string>
+#include <vector>
 #include <iostream>
 
 //EMF
@@ -72,6 +74,29 @@ public:
   virtual int
   getJobState(const std::string& jobId)=0;
 
+  /**
+   * \brief Function to get the status of several jobs at once. The
+   * default implementation asks the jobs one by one.
+   * \param jobIds the identifiers of the jobs
+   * \return the status of the jobs, by identifier, as given by getJobState.
+   * The jobs whose status could not be got are missing.
+   */
+  virtual std::map<std::string, int>
+  getJobStates(const std::vector<std::string>& jobIds);
+
+  /**
+   * \brief Function to give the jobs the status reported by a server which
+   * names them by their sequence number followed by any server name
+   * \param jobIds the identifiers of the jobs
+   * \param serverStates the status reported by the server, by sequence number
+   * \param missingState the status of the jobs the server does not report
+   * \return the status of all the jobs, by identifier
+   */
+  static std::map<std::string, int>
+  matchJobStates(const std::vector<std::string>& jobIds,
+                 const std::map<std::string, int>& serverStates,
+                 int missingState);
+
   /**
    * \brief Function to get the start time of the job
    * \param jobId the identifier of the job
@@ -0,0 +1,129 @@
+/**
+ * \file JobEventChannel.cpp
+ * \brief This file implements the channel notifying the monitor of the job
+ * submissions and cancellations
+ */
+#include "JobEventChannel.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <boost/format.hpp>
+
+#include "Logger.hpp"
+
+/**
+ * \brief The maximum size of an event, the job identifiers are far shorter
+ */
+static const size_t JOB_EVENT_MAX_SIZE = 512;
+
+
+JobEventChannel&
+JobEventChannel::getInstance() {
+  static JobEventChannel instance;
+  return instance;
+}
+
+
+JobEventChannel::JobEventChannel() : mwriter(-1), mreader(-1) {
+}
+
+
+JobEventChannel::~JobEventChannel() {
+  if (mwriter != -1) {
+    close(mwriter);
+  }
+  if (mreader != -1) {
+    close(mreader);
+  }
+}
+
+
+bool
+JobEventChannel::open() {
+  if (isOpen()) {
+    return true;
+  }
+  // datagrams keep the events apart, and unix sockets do not lose them
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_DGRAM, 0, fds) != 0) {
+    LOG(boost::str(boost::format("[WARNING] cannot create the job event channel: %1%")
+                   % strerror(errno)), LogWarning);
+    return false;
+  }
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+  mwriter = fds[0];
+  mreader = fds[1];
+  return true;
+}
+
+
+bool
+JobEventChannel::isOpen() const {
+  return mwriter != -1;
+}
+
+
+void
+JobEventChannel::notifySubmitted(const std::string& jobId) {
+  notify(JOB_SUBMITTED, jobId);
+}
+
+
+void
+JobEventChannel::notifyCancelled(const std::string& jobId) {
+  notify(JOB_CANCELLED, jobId);
+}
+
+
+void
+JobEventChannel::notify(EventType type, const std::string& jobId) {
+  if (! isOpen() || jobId.size() >= JOB_EVENT_MAX_SIZE) {
+    return;
+  }
+  std::string message = static_cast<char>(type) + jobId;
+  if (send(mwriter, message.data(), message.size(), MSG_DONTWAIT | MSG_NOSIGNAL) < 0) {
+    LOG(boost::str(boost::format("[DEBUG] job event dropped for %1%: %2%")
+                   % jobId % strerror(errno)), LogDebug);
+  }
+}
+
+
+bool
+JobEventChannel::wait(int timeout) {
+  if (! isOpen()) {
+    if (timeout > 0) {
+      usleep(timeout * 1000);
+    }
+    return false;
+  }
+  struct pollfd item;
+  item.fd = mreader;
+  item.events = POLLIN;
+  item.revents = 0;
+  int rc = poll(&item, 1, timeout);
+  return rc > 0 && (item.revents & POLLIN);
+}
+
+
+void
+JobEventChannel::receive(std::vector<Event>& events) {
+  if (! isOpen()) {
+    return;
+  }
+  char buffer[JOB_EVENT_MAX_SIZE];
+  ssize_t size;
+  while ((size = recv(mreader, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+    if (buffer[0] != JOB_SUBMITTED && buffer[0] != JOB_CANCELLED) {
+      continue;
+    }
+    Event event;
+    event.type = static_cast<EventType>(buffer[0]);
+    event.jobId.assign(buffer + 1, size - 1);
+    events.push_back(event);
+  }
+}
@@ -0,0 +1,129 @@
+/**
+ * \file JobEventChannel.hpp
+ * \brief This file defines the channel notifying the monitor of the job
+ * submissions and cancellations
+ */
+
+#ifndef _JOBEVENTCHANNEL_HPP_
+#define _JOBEVENTCHANNEL_HPP_
+
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+/**
+ * \class JobEventChannel
+ * \brief Datagram channel between the job servers and the monitor. It must
+ * be opened before the monitor is forked, the servers then notify the jobs
+ * they submit or cancel and the monitor waits for these events between its
+ * polls. A notification never blocks the server: it is dropped if the
+ * monitor does not keep up, the monitor resynchronizes with the database
+ * from time to time.
+ */
+class JobEventChannel : public boost::noncopyable {
+public:
+  /**
+   * \brief The kinds of events
+   */
+  typedef enum {
+    JOB_SUBMITTED = 'S',
+    JOB_CANCELLED = 'C'
+  } EventType;
+
+  /**
+   * \struct Event
+   * \brief An event received by the monitor
+   */
+  struct Event {
+    /**
+     * \brief The kind of the event
+     */
+    EventType type;
+    /**
+     * \brief The vishnu identifier of the job
+     */
+    std::string jobId;
+  };
+
+  /**
+   * \brief Get the channel of the process
+   * \return the channel
+   */
+  static JobEventChannel&
+  getInstance();
+
+  /**
+   * \brief Create the channel, before forking the monitor
+   * \return true on success
+   */
+  bool
+  open();
+
+  /**
+   * \brief Whether the channel has been opened
+   * \return true if opened
+   */
+  bool
+  isOpen() const;
+
+  /**
+   * \brief Notify the submission of a job, does nothing if the channel is
+   * not opened
+   * \param jobId the vishnu identifier of the job
+   */
+  void
+  notifySubmitted(const std::string& jobId);
+
+  /**
+   * \brief Notify the cancellation of a job, does nothing if the channel is
+   * not opened
+   * \param jobId the vishnu identifier of the job
+   */
+  void
+  notifyCancelled(const std::string& jobId);
+
+  /**
+   * \brief Wait for events
+   * \param timeout the maximum time to wait, in milliseconds
+   * \return true if events are pending
+   */
+  bool
+  wait(int timeout);
+
+  /**
+   * \brief Get the pending events without waiting
+   * \param events OUT, the events received are appended
+   */
+  void
+  receive(std::vector<Event>& events);
+
+  /**
+   * \brief Destructor, closes the channel
+   */
+  ~JobEventChannel();
+
+private:
+  /**
+   * \brief Constructor
+   */
+  JobEventChannel();
+
+  /**
+   * \brief Send an event
+   * \param type the kind of the event
+   * \param jobId the vishnu identifier of the job
+   */
+  void
+  notify(EventType type, const std::string& jobId);
+
+  /**
+   * \brief The socket the servers write to
+   */
+  int mwriter;
+  /**
+   * \brief The socket the monitor reads from
+   */
+  int mreader;
+};
+
+#endif // _JOBEVENTCHANNEL_HPP_
@@ -181,11 +181,11 @@ JobOutputServer::getCompletedJobsOutput(JsonObject* options) {
     mlistJobsResult->getResults().push_back(curResult);
 
     // Mark the job as downloaded, so it will be ignored at the subsequent calls
-    std::string query = (boost::format("UPDATE job SET status=%1% "
-                                       " WHERE jobId='%2%';"
-                                       ) % vishnu::convertToString(vishnu::STATE_DOWNLOADED)
-                         % mdatabaseInstance->escapeData(jobId)).str();
-    mdatabaseInstance->process(query);
+    SqlParameters params;
+    params.add(vishnu::STATE_DOWNLOADED).add(jobId);
+    mdatabaseInstance->processPrepared("update_job_status",
+                                       "UPDATE job SET status=$1 WHERE jobId=$2",
+                                       params);
     LOG(boost::str(boost::format("[INFO] request to job ouput: %1%. aclogin: %2%")
                    % jobId
                    % muserSessionInfo.user_aclogin), LogInfo);
@@ -24,6 +24,8 @@
 #include "api_fms.hpp"
 #include "utils.hpp"
 #include "BatchFactory.hpp"
+#include "JobEventChannel.hpp"
+#include "BatchHelperPool.hpp"
 #include <pwd.h>
 #include <cstdlib>
 #include "Logger.hpp"
@@ -146,6 +148,159 @@ JobServer::submitJob(std::string& scriptContent,
   return JOB_ID;
 }
 
+/**
+ * \brief Function to submit a set of jobs built from a single script
+ * \param scriptContent the content of the script template
+ * \param options a json object describing the options shared by the jobs
+ * \param jobParams the parameters of each job, in the form PARAM1=value1 PARAM2=value2
+ * \param vishnuId The VISHNU identifier
+ * \param defaultBatchOption The default batch options
+ * \param jobs OUT, the jobs submitted, a failed submission holds its error
+ */
+void
+JobServer::submitJobs(std::string& scriptContent,
+                      JsonObject* options,
+                      const std::vector<std::string>& jobParams,
+                      int vishnuId,
+                      const std::vector<std::string>& defaultBatchOption,
+                      TMS_Data::ListJobs& jobs)
+{
+  LOG(boost::str(boost::format("[INFO] Request to submit %1% jobs") % jobParams.size()), LogInfo);
+
+  if (scriptContent.empty()) {
+    throw UserException(ERRCODE_INVALID_PARAM, "Empty script content");
+  }
+  checkJobCount(jobParams.size());
+
+  int usePosix = options->getIntProperty("posix");
+  if (usePosix != JsonObject::UNDEFINED_PROPERTY && usePosix != 0) {
+    mbatchType = POSIX;
+  }
+
+  // the identifiers are reserved in a single transaction
+  const size_t nbJobs = jobParams.size();
+  std::vector<std::string> jobIds;
+  vishnu::getObjectIds(vishnuId, "formatidjob", vishnu::JOB, mmachineId, nbJobs, jobIds);
+
+  // the script is converted once, only the parameters differ between the jobs
+  std::string convertedScript = processScript(scriptContent,
+                                              options,
+                                              defaultBatchOption,
+                                              muserSessionInfo.machine_name);
+
+  std::vector<TMS_Data::Job> jobInfos(nbJobs);
+  std::vector<boost::shared_ptr<JsonObject> > jobOptions(nbJobs);
+  std::vector<std::string> steps(nbJobs);
+  std::vector<std::string> errors(nbJobs);
+  for (size_t job = 0; job < nbJobs; ++job) {
+    TMS_Data::Job& jobInfo = jobInfos[job];
+    jobInfo.setJobId(jobIds[job]);
+    jobInfo.setWorkId(options->getIntProperty("workid", 0));
+    jobInfo.setSubmitMachineId(mmachineId);
+    jobInfo.setStatus(vishnu::STATE_UNDEFINED);
+
+    // the way of setting job owner varies from classical batch scheduler to cloud backend
+    switch (mbatchType) {
+      case OPENNEBULA:
+      case DELTACLOUD:
+        jobInfo.setOwner( vishnu::getVar(vishnu::CLOUD_ENV_VARS[vishnu::CLOUD_VM_USER], true, "root") );
+        break;
+      default:
+        jobInfo.setOwner(muserSessionInfo.user_aclogin);
+        break;
+    }
+
+    jobOptions[job].reset(new JsonObject(options->encode()));
+    try {
+      std::string content = convertedScript;
+      setRealFilePaths(content, jobOptions[job].get(), jobInfo);
+      if (! jobParams[job].empty()) {
+        vishnu::setParams(content, jobParams[job]);
+      }
+      saveJobScript(jobOptions[job]->getStringProperty("scriptpath"), content);
+    } catch (VishnuException& ex) {
+      errors[job] = ex.what();
+    }
+  }
+
+  if (mstandaloneSed != 0 && submitManyWithHelper(jobInfos, jobOptions, steps, errors)) {
+    // the results are saved in a single transaction, the monitor is notified
+    // once they are committed
+    int transacId = mdatabaseInstance->startTransaction();
+    std::vector<boost::shared_ptr<TMS_Data::ListJobs> > jobSteps(nbJobs);
+    try {
+      for (size_t job = 0; job < nbJobs; ++job) {
+        TMS_Data::ListJobs_ptr parsedSteps = NULL;
+        if (errors[job].empty() && ! vishnu::parseEmfObject(steps[job], parsedSteps)) {
+          errors[job] = "Invalid job steps returned by the batch helper";
+        }
+        if (errors[job].empty()) {
+          jobSteps[job].reset(parsedSteps);
+          updateAndSaveJobSteps(*jobSteps[job], jobInfos[job], transacId);
+        } else {
+          jobInfos[job].setSubmitError(errors[job]);
+          jobInfos[job].setErrorPath("");
+          jobInfos[job].setOutputPath("");
+          jobInfos[job].setOutputDir("");
+          jobInfos[job].setStatus(vishnu::STATE_FAILED);
+          updateJobRecordIntoDatabase(SubmitBatchAction, jobInfos[job], transacId);
+        }
+      }
+      mdatabaseInstance->endTransaction(transacId);
+    } catch (...) {
+      mdatabaseInstance->cancelTransaction(transacId);
+      throw;
+    }
+
+    for (size_t job = 0; job < nbJobs; ++job) {
+      if (! jobSteps[job]) {
+        jobs.getJobs().push_back(new TMS_Data::Job(jobInfos[job]));
+        continue;
+      }
+      for (unsigned int step = 0; step < jobSteps[job]->getJobs().size(); ++step) {
+        TMS_Data::Job_ptr stepInfo = jobSteps[job]->getJobs().get(step);
+        JobEventChannel::getInstance().notifySubmitted(stepInfo->getJobId());
+        jobs.getJobs().push_back(new TMS_Data::Job(*stepInfo));
+      }
+    }
+  } else {
+    // without the batch helpers the jobs are submitted one at a time
+    for (size_t job = 0; job < nbJobs; ++job) {
+      TMS_Data::Job& jobInfo = jobInfos[job];
+      try {
+        if (! errors[job].empty()) {
+          throw TMSVishnuException(ERRCODE_RUNTIME_ERROR, errors[job]);
+        }
+        exportJobEnvironments(jobInfo);
+        if (mstandaloneSed != 0) {
+          handleNativeBatchExec(SubmitBatchAction,
+                                jobOptions[job]->getStringProperty("scriptpath"),
+                                jobOptions[job].get(),
+                                jobInfo,
+                                mbatchType,
+                                mbatchVersion);
+        } else {
+          handleSshBatchExec(SubmitBatchAction,
+                             jobOptions[job]->getStringProperty("scriptpath"),
+                             jobOptions[job].get(),
+                             jobInfo,
+                             mbatchType,
+                             mbatchVersion);
+        }
+        jobs.getJobs().push_back(new TMS_Data::Job(getJobInfo(jobInfo.getJobId())));
+      } catch (VishnuException& ex) {
+        jobInfo.setSubmitError(ex.what());
+        jobInfo.setErrorPath("");
+        jobInfo.setOutputPath("");
+        jobInfo.setOutputDir("");
+        jobInfo.setStatus(vishnu::STATE_FAILED);
+        updateJobRecordIntoDatabase(SubmitBatchAction, jobInfo);
+        jobs.getJobs().push_back(new TMS_Data::Job(jobInfo));
+      }
+    }
+  }
+}
+
 /**
  * @brief Submit job using ssh mechanism
  * @param action action The type of action (cancel, submit...)
@@ -211,8 +366,431 @@ JobServer::handleNativeBatchExec(int action,
                                  TMS_Data::Job& jobInfo,
                                  int batchType,
                                  const std::string& batchVersion) {
+  BatchHelperPool& helpers = BatchHelperPool::getInstance();
+  if (! helpers.isStarted()) {
+    forkNativeBatchExec(action, scriptPath, options, jobInfo, batchType, batchVersion);
+    return;
+  }
+
+  // if not cloud-mode submission, the request runs with the user credentials
+  uid_t uid = getuid();
+  if (mbatchType != OPENNEBULA && mbatchType != DELTACLOUD) {
+    uid = getSystemUid(muserSessionInfo.user_aclogin);
+  }
+
+  JsonObject request;
+  request.setProperty("action", action);
+  request.setProperty("batchtype", batchType);
+  request.setProperty("batchversion", batchVersion);
+  request.setProperty("scriptpath", scriptPath);
+  request.setProperty("job", JsonObject::serialize(jobInfo));
+  request.setProperty("options", options->encode());
+
+  std::string response;
+  switch (helpers.execute(uid, request.encode(), response)) {
+    case BatchHelperPool::HELPER_SUCCESS:
+      break;
+    case BatchHelperPool::HELPER_UNAVAILABLE:
+      LOG(boost::str(boost::format("[WARNING] %1%, forking a job worker process") % response), LogWarning);
+      forkNativeBatchExec(action, scriptPath, options, jobInfo, batchType, batchVersion);
+      return;
+    case BatchHelperPool::HELPER_FAILED:
+    default:
+      throw TMSVishnuException(ERRCODE_RUNTIME_ERROR,
+                               boost::str(boost::format("Batch helper failed, message: %1%") % response));
+  }
+
+  JsonObject result(response);
+  std::string errorMsg = result.getStringProperty("message");
+  if (errorMsg != "SUCCESS") {
+    throw TMSVishnuException(ERRCODE_RUNTIME_ERROR,
+                             boost::str(boost::format("Job worker process exited with status %1%, message: %2%")
+                                        % result.getIntProperty("status")
+                                        % errorMsg));
+  }
+
+  switch(action) {
+    case SubmitBatchAction: {
+      TMS_Data::ListJobs_ptr jobSteps = NULL;
+      if (! vishnu::parseEmfObject(result.getStringProperty("jobs"), jobSteps)) {
+        throw TMSVishnuException(ERRCODE_RUNTIME_ERROR, "Invalid job steps returned by the batch helper");
+      }
+      boost::scoped_ptr<TMS_Data::ListJobs> jobStepsGuard(jobSteps);
+      updateAndSaveJobSteps(*jobSteps, jobInfo);
+    }
+      break;
+    case CancelBatchAction:
+      jobInfo.setStatus(vishnu::STATE_CANCELLED);
+      updateJobRecordIntoDatabase(action, jobInfo);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Submit a set of prepared jobs to the batch helper of the user, by
+ * requests fitting in a helper frame
+ * @param jobs The jobs, with their script path and output directory set
+ * @param jobOptions The options of each job
+ * @param steps OUT, the job steps of each job, empty if it failed
+ * @param errors OUT, the error of each job, empty if it succeeded
+ * @return false if the helpers could not take the request, nothing was submitted
+ */
+bool
+JobServer::submitManyWithHelper(std::vector<TMS_Data::Job>& jobs,
+                                std::vector<boost::shared_ptr<JsonObject> >& jobOptions,
+                                std::vector<std::string>& steps,
+                                std::vector<std::string>& errors)
+{
+  BatchHelperPool& helpers = BatchHelperPool::getInstance();
+  if (! helpers.isStarted()) {
+    return false;
+  }
+
+  // if not cloud-mode submission, the request runs with the user credentials
+  uid_t uid = getuid();
+  if (mbatchType != OPENNEBULA && mbatchType != DELTACLOUD) {
+    uid = getSystemUid(muserSessionInfo.user_aclogin);
+  }
+
+  // the jobs which failed to be prepared are not sent
+  std::vector<std::string> scripts(jobs.size());
+  std::vector<std::string> serializedJobs(jobs.size());
+  std::vector<std::string> encodedOptions(jobs.size());
+  std::vector<size_t> jobSizes(jobs.size(), 0);
+  for (size_t job = 0; job < jobs.size(); ++job) {
+    if (errors[job].empty()) {
+      scripts[job] = jobOptions[job]->getStringProperty("scriptpath");
+      serializedJobs[job] = JsonObject::serialize(jobs[job]);
+      encodedOptions[job] = jobOptions[job]->encode();
+      jobSizes[job] = scripts[job].size() + serializedJobs[job].size() + encodedOptions[job].size();
+    }
+  }
+
+  // the requests are kept well below the frame size, the json encoding
+  // escapes the serialized jobs
+  std::vector<std::vector<size_t> > requests;
+  splitHelperRequests(jobSizes, errors, BATCH_HELPER_MAX_FRAME_SIZE / 4, requests);
+
+  bool submitted = false;
+  for (size_t request = 0; request < requests.size(); ++request) {
+    const std::vector<size_t>& sent = requests[request];
+    std::vector<std::string> sentScripts;
+    std::vector<std::string> sentJobs;
+    std::vector<std::string> sentOptions;
+    for (size_t index = 0; index < sent.size(); ++index) {
+      sentScripts.push_back(scripts[sent[index]]);
+      sentJobs.push_back(serializedJobs[sent[index]]);
+      sentOptions.push_back(encodedOptions[sent[index]]);
+    }
+
+    std::vector<std::string> sentSteps;
+    std::vector<std::string> sentErrors;
+    int status = submitChunkWithHelper(uid, sentScripts, sentJobs, sentOptions, sentSteps, sentErrors);
+    if (status == BatchHelperPool::HELPER_UNAVAILABLE && ! submitted) {
+      return false;
+    }
+    submitted = true;
+    for (size_t index = 0; index < sent.size(); ++index) {
+      steps[sent[index]] = sentSteps[index];
+      errors[sent[index]] = sentErrors[index];
+    }
+  }
+  return true;
+}
+
+/**
+ * \brief Check the number of jobs of a multiple submission
+ * \param nbJobs the number of jobs
+ * \return raises an exception unless it is between 1 and MAX_JOBS_PER_SUBMISSION
+ */
+void
+JobServer::checkJobCount(size_t nbJobs)
+{
+  if (nbJobs == 0 || nbJobs > static_cast<size_t>(MAX_JOBS_PER_SUBMISSION)) {
+    throw UserException(ERRCODE_INVALID_PARAM,
+                        boost::str(boost::format("The number of jobs must be between 1 and %1%")
+                                   % MAX_JOBS_PER_SUBMISSION));
+  }
+}
+
+/**
+ * \brief Split the jobs sent to a batch helper into requests of at most
+ * MAX_JOBS_PER_HELPER_REQUEST jobs and maxRequestSize bytes, a larger job
+ * is sent alone
+ * \param jobSizes the size of each job once encoded
+ * \param errors the error of each job, the jobs which failed are not sent
+ * \param maxRequestSize the size of a request
+ * \param requests OUT, the jobs of each request
+ */
+void
+JobServer::splitHelperRequests(const std::vector<size_t>& jobSizes,
+                               const std::vector<std::string>& errors,
+                               size_t maxRequestSize,
+                               std::vector<std::vector<size_t> >& requests)
+{
+  requests.clear();
+  size_t requestSize = 0;
+  for (size_t job = 0; job < jobSizes.size(); ++job) {
+    if (! errors[job].empty()) {
+      continue;
+    }
+    if (requests.empty()
+        || requests.back().size() >= static_cast<size_t>(MAX_JOBS_PER_HELPER_REQUEST)
+        || requestSize + jobSizes[job] > maxRequestSize) {
+      requests.push_back(std::vector<size_t>());
+      requestSize = 0;
+    }
+    requests.back().push_back(job);
+    requestSize += jobSizes[job];
+  }
+}
+
+/**
+ * @brief Submit a group of prepared jobs in a single request to the batch
+ * helper of the user
+ * @param uid The user running the request
+ * @param scripts The script path of each job sent
+ * @param serializedJobs Each job sent, serialized
+ * @param encodedOptions The options of each job sent, encoded
+ * @param steps OUT, the job steps of each job sent, empty if it failed
+ * @param errors OUT, the error of each job sent, empty if it succeeded
+ * @return the status of the request, the errors are set unless it succeeds
+ */
+int
+JobServer::submitChunkWithHelper(uid_t uid,
+                                 const std::vector<std::string>& scripts,
+                                 const std::vector<std::string>& serializedJobs,
+                                 const std::vector<std::string>& encodedOptions,
+                                 std::vector<std::string>& steps,
+                                 std::vector<std::string>& errors)
+{
+  const size_t nbJobs = scripts.size();
+  steps.assign(nbJobs, "");
+
+  JsonObject request;
+  request.setProperty("action", SubmitManyBatchAction);
+  request.setProperty("batchtype", mbatchType);
+  request.setProperty("batchversion", mbatchVersion);
+  request.setArrayProperty("scripts");
+  for (size_t job = 0; job < nbJobs; ++job) {
+    request.addItemToLastArray(scripts[job]);
+  }
+  request.setArrayProperty("jobs");
+  for (size_t job = 0; job < nbJobs; ++job) {
+    request.addItemToLastArray(serializedJobs[job]);
+  }
+  request.setArrayProperty("options");
+  for (size_t job = 0; job < nbJobs; ++job) {
+    request.addItemToLastArray(encodedOptions[job]);
+  }
+
+  std::string response;
+  BatchHelperPool::ExecuteStatus status = BatchHelperPool::getInstance().execute(uid, request.encode(), response);
+  switch (status) {
+    case BatchHelperPool::HELPER_SUCCESS:
+      break;
+    case BatchHelperPool::HELPER_UNAVAILABLE:
+      LOG(boost::str(boost::format("[WARNING] %1%, submitting the jobs one at a time") % response), LogWarning);
+      errors.assign(nbJobs, boost::str(boost::format("Batch helper unavailable, message: %1%") % response));
+      return status;
+    case BatchHelperPool::HELPER_FAILED:
+    default:
+      // the jobs of this request may have been submitted, they can not be
+      // told apart, the other requests are not affected
+      LOG(boost::str(boost::format("[ERROR] batch helper failed while submitting %1% jobs: %2%")
+                     % nbJobs % response), LogErr);
+      errors.assign(nbJobs, boost::str(boost::format("Batch helper failed, the job may have been"
+                                                     " submitted, message: %1%") % response));
+      return status;
+  }
+
+  JsonObject result(response);
+  std::string errorMsg = result.getStringProperty("message");
+  std::vector<std::string> results;
+  std::vector<std::string> resultErrors;
+  result.getArrayProperty("results", results);
+  result.getArrayProperty("errors", resultErrors);
+  if (errorMsg != "SUCCESS" || results.size() != nbJobs || resultErrors.size() != nbJobs) {
+    if (errorMsg == "SUCCESS") {
+      errorMsg = "Invalid response returned by the batch helper";
+    }
+    errors.assign(nbJobs, errorMsg);
+    return BatchHelperPool::HELPER_FAILED;
+  }
+
+  steps = results;
+  errors = resultErrors;
+  return status;
+}
+
+namespace {
+
+/**
+ * \brief Get the backend running a request in a batch helper
+ * \param batchType The batch type
+ * \param batchVersion The batch version
+ * \param jobInfo The job, the cloud backends read it from the environment
+ * \return the backend, raises an exception on error
+ */
+boost::shared_ptr<BatchServer>
+getHelperBatchServer(int batchType, const std::string& batchVersion, const TMS_Data::Job& jobInfo) {
+  // the helper serves one request at a time, it can use its environment
+  setenv("VISHNU_JOB_ID", jobInfo.getJobId().c_str(), 1);
+  setenv("VISHNU_OUTPUT_DIR", jobInfo.getOutputDir().c_str(), 1);
+
+  // the plugin stays loaded in the helper between the requests
+  BatchFactory factory;
+  boost::shared_ptr<BatchServer> batchServer = factory.getBatchServerInstance(batchType, batchVersion);
+  if (! batchServer) {
+    throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR,
+                             boost::str(boost::format("getBatchServerInstance return NULL (batch: %1%, version: %2%)")
+                                        % vishnu::convertBatchTypeToString(static_cast<BatchType>(batchType))
+                                        % batchVersion));
+  }
+  return batchServer;
+}
+
+/**
+ * \brief Submit a job from a batch helper
+ * \param batchType The batch type
+ * \param batchVersion The batch version
+ * \param scriptPath The path of the script
+ * \param serializedJob The job, serialized
+ * \param serializedOptions The submit options, serialized
+ * \return the job steps, serialized
+ */
+std::string
+submitFromHelper(int batchType,
+                 const std::string& batchVersion,
+                 const std::string& scriptPath,
+                 const std::string& serializedJob,
+                 const std::string& serializedOptions) {
+  JsonObject jsonJob(serializedJob);
+  TMS_Data::Job jobInfo = jsonJob.getJob();
+  boost::shared_ptr<BatchServer> batchServer = getHelperBatchServer(batchType, batchVersion, jobInfo);
+
+  // create output dir if needed
+  if (! jobInfo.getOutputDir().empty()) {
+    vishnu::createDir(jobInfo.getOutputDir());
+  }
+
+  // submit the job
+  JsonObject jsonOptions(serializedOptions);
+  TMS_Data::ListJobs jobSteps;
+  batchServer->submit(vishnu::copyFileToUserHome(scriptPath), jsonOptions.getSubmitOptions(), jobSteps, NULL);
+  return vishnu::emfSerializer<TMS_Data::ListJobs>(&jobSteps);
+}
+
+} // namespace
+
+/**
+ * \brief Run a native batch action in a batch helper process, with the
+ * credentials of the user
+ * \param request The request sent by handleNativeBatchExec
+ * \return The response, holding the status, the error message and the job steps
+ */
+std::string
+JobServer::processHelperRequest(const std::string& request) {
+  int handlerExitCode = 0;
+  std::string errorMsg = "SUCCESS";
+  std::string jobStepsSerialized;
+  std::vector<std::string> results;
+  std::vector<std::string> errors;
+  try {
+    JsonObject jsonRequest(request);
+    int action = jsonRequest.getIntProperty("action");
+    int batchType = jsonRequest.getIntProperty("batchtype");
+    std::string batchVersion = jsonRequest.getStringProperty("batchversion");
+
+    switch(action) {
+      case SubmitBatchAction:
+        jobStepsSerialized = submitFromHelper(batchType,
+                                              batchVersion,
+                                              jsonRequest.getStringProperty("scriptpath"),
+                                              jsonRequest.getStringProperty("job"),
+                                              jsonRequest.getStringProperty("options"));
+        break;
+      case SubmitManyBatchAction: {
+        std::vector<std::string> scripts;
+        std::vector<std::string> jobs;
+        std::vector<std::string> options;
+        jsonRequest.getArrayProperty("scripts", scripts);
+        jsonRequest.getArrayProperty("jobs", jobs);
+        jsonRequest.getArrayProperty("options", options);
+        if (jobs.size() != scripts.size() || jobs.size() != options.size()) {
+          throw TMSVishnuException(ERRCODE_INVALID_PARAM, "Inconsistent multiple job submission");
+        }
+
+        // a failed job does not stop the others, the pooled backends keep
+        // their connection to the batch scheduler from one job to the next
+        for (size_t job = 0; job < jobs.size(); ++job) {
+          try {
+            results.push_back(submitFromHelper(batchType, batchVersion, scripts[job], jobs[job], options[job]));
+            errors.push_back("");
+          } catch (const VishnuException & ex) {
+            LOG("[ERROR] "+ std::string(ex.what()), LogErr);
+            results.push_back("");
+            errors.push_back(ex.what());
+          }
+        }
+      }
+        break;
+      case CancelBatchAction: {
+        JsonObject jsonJob(jsonRequest.getStringProperty("job"));
+        TMS_Data::Job jobInfo = jsonJob.getJob();
+        boost::shared_ptr<BatchServer> batchServer = getHelperBatchServer(batchType, batchVersion, jobInfo);
+        if (batchType == DELTACLOUD || batchType == OPENNEBULA) {
+          handlerExitCode = batchServer->cancel(jobInfo.getVmId());
+        } else {
+          handlerExitCode = batchServer->cancel(jobInfo.getBatchJobId());
+        }
+      }
+        break;
+      default:
+        throw TMSVishnuException(ERRCODE_INVALID_PARAM, "Unknown batch action");
+        break;
+    }
+  } catch (const VishnuException & ex) {
+    handlerExitCode = ex.getTypeI();
+    errorMsg = std::string(ex.what());
+    LOG("[ERROR] "+ errorMsg, LogErr);
+  }
+
+  JsonObject response;
+  response.setProperty("status", handlerExitCode);
+  response.setProperty("message", errorMsg);
+  response.setProperty("jobs", jobStepsSerialized);
+  response.setArrayProperty("results");
+  for (std::vector<std::string>::const_iterator it = results.begin(); it != results.end(); ++it) {
+    response.addItemToLastArray(*it);
+  }
+  response.setArrayProperty("errors");
+  for (std::vector<std::string>::const_iterator it = errors.begin(); it != errors.end(); ++it) {
+    response.addItemToLastArray(*it);
+  }
+  return response.encode();
+}
+
+/**
+ * @brief Run a native batch action in a child process forked for the request
+ * @param action action The type of action (cancel, submit...)
+ * @param scriptPath The path of the script to executed
+ * @param options: an object containing options
+ * @param jobInfo The default information provided to the job
+ * @param batchType The batch type. Ignored for POSIX backend
+ * @param batchVersion The batch version. Ignored for POSIX backend
+*/
+void
+JobServer::forkNativeBatchExec(int action,
+                                 const std::string& scriptPath,
+                                 JsonObject* options,
+                                 TMS_Data::Job& jobInfo,
+                                 int batchType,
+                                 const std::string& batchVersion) {
   BatchFactory factory;
-  BatchServer* batchServer = factory.getBatchServerInstance(batchType, batchVersion);
+  boost::shared_ptr<BatchServer> batchServer = factory.getBatchServerInstance(batchType, batchVersion);
   if (! batchServer) {
     throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR,
                              boost::str(boost::format("getBatchServerInstance return NULL (batch: %1%, version: %2%)")
@@ -291,6 +869,8 @@ JobServer::handleNativeBatchExec(int action,
     exit(handlerExitCode);
   } else { /** Parent process*/
     close(ipcPipe[1]);
+    // the child works on its own copy, the instance can serve other requests
+    batchServer.reset();
     // wait that child exists
     int exitCode;
     waitpid(pid, &exitCode, 0);
@@ -893,7 +1473,8 @@ JobServer::processScript(std::string& content,
  * @param baseJobInfo The base job info
  */
 void
-JobServer::updateAndSaveJobSteps(TMS_Data::ListJobs& jobSteps, TMS_Data::Job& baseJobInfo)
+JobServer::updateAndSaveJobSteps(TMS_Data::ListJobs& jobSteps, TMS_Data::Job& baseJobInfo,
+                                 int transacId)
 {
   if (jobSteps.getJobs().size() == 1) {
     TMS_Data::Job_ptr currentJobPtr = jobSteps.getJobs().get(0);
@@ -904,7 +1485,7 @@ JobServer::updateAndSaveJobSteps(TMS_Data::ListJobs& jobSteps, TMS_Data::Job& ba
     currentJobPtr->setJobId(baseJobInfo.getJobId());
     currentJobPtr->setOutputDir(baseJobInfo.getOutputDir());
     currentJobPtr->setJobWorkingDir(baseJobInfo.getJobWorkingDir());
-    updateJobRecordIntoDatabase(SubmitBatchAction, *currentJobPtr);
+    updateJobRecordIntoDatabase(SubmitBatchAction, *currentJobPtr, transacId);
   } else {
     int nbSteps = jobSteps.getJobs().size();
 
@@ -921,7 +1502,8 @@ JobServer::updateAndSaveJobSteps(TMS_Data::ListJobs& jobSteps, TMS_Data::Job& ba
       // create an entry to the database for the step
       mdatabaseInstance->process(boost::str(boost::format("INSERT INTO job (jobid, vsession_numsessionid)"
                                                           " VALUES ('%1%', %2%)"
-                                                          ) % currentJobPtr->getJobId() % muserSessionInfo.num_session));
+                                                          ) % currentJobPtr->getJobId() % muserSessionInfo.num_session),
+                                  transacId);
     }
 
     // now each job's related steps and record to database
@@ -934,7 +1516,7 @@ JobServer::updateAndSaveJobSteps(TMS_Data::ListJobs& jobSteps, TMS_Data::Job& ba
       }
       TMS_Data::Job_ptr currentJobPtr = jobSteps.getJobs().get(step);
       currentJobPtr->setRelatedSteps(relatedStepList);
-      updateJobRecordIntoDatabase(SubmitBatchAction, *currentJobPtr);
+      updateJobRecordIntoDatabase(SubmitBatchAction, *currentJobPtr, transacId);
     }
   }
 }
@@ -943,17 +1525,23 @@ JobServer::updateAndSaveJobSteps(TMS_Data::ListJobs& jobSteps, TMS_Data::Job& ba
  * \brief Function to save the encapsulated job into the database
  * @param action The type of action to finalize (submit, cancel...)
  * @param job The concerned job
+ * @param transacId the id of the transaction if one is used. -1 to ignore,
+ * otherwise the monitor is not notified: the caller does it once committed
  */
 void
-JobServer::updateJobRecordIntoDatabase(int action, TMS_Data::Job& job)
+JobServer::updateJobRecordIntoDatabase(int action, TMS_Data::Job& job, int transacId)
 {
   if (action == CancelBatchAction) {
-    std::string query = boost::str(boost::format("UPDATE job set status=%1% where jobid='%2%';")
-                                   % vishnu::convertToString(job.getStatus())
-                                   % job.getJobId());
-    mdatabaseInstance->process(query);
+    SqlParameters params;
+    params.add(job.getStatus()).add(job.getJobId());
+    mdatabaseInstance->processPrepared("update_job_status",
+                                       "UPDATE job SET status=$1 WHERE jobId=$2",
+                                       params, transacId);
     LOG(boost::str(boost::format("[INFO] job cancelled: %1%")
                    % job.getJobId()), LogInfo);
+    if (transacId == -1) {
+      JobEventChannel::getInstance().notifyCancelled(job.getJobId());
+    }
 
   } else if (action == SubmitBatchAction) {
     // Append the machine name to the error and output path if necessary
@@ -997,7 +1585,7 @@ JobServer::updateJobRecordIntoDatabase(int action, TMS_Data::Job& job)
     query+="relatedSteps='"+mdatabaseInstance->escapeData(job.getRelatedSteps())+"'";
     query+=" WHERE jobid='"+mdatabaseInstance->escapeData(job.getJobId())+"';";
 
-    mdatabaseInstance->process(query);
+    mdatabaseInstance->process(query, transacId);
 
     // logging
     if (job.getSubmitError().empty()) {
@@ -1005,6 +1593,10 @@ JobServer::updateJobRecordIntoDatabase(int action, TMS_Data::Job& job)
                      % job.getJobId()
                      % muserSessionInfo.userid
                      % muserSessionInfo.user_aclogin), LogInfo);
+      // the monitor would not see a row of an uncommitted transaction
+      if (transacId == -1) {
+        JobEventChannel::getInstance().notifySubmitted(job.getJobId());
+      }
     } else {
       LOG((boost::str(boost::format("[WARN] submission error: %1% [%2%]")
                       % job.getJobId()
@@ -1060,13 +1652,24 @@ JobServer::createJobScriptExecutaleFile(std::string& content,
                                         const std::vector<std::string>& defaultBatchOption)
 {
   std::string path = options->getStringProperty("scriptpath");
+  saveJobScript(path,
+                processScript(content,
+                              options,
+                              defaultBatchOption,
+                              muserSessionInfo.machine_name));
+  return path;
+}
 
+/**
+ * @brief Save a job script and make it executable
+ * @param path The path of the script
+ * @param content The processed script content
+ */
+void
+JobServer::saveJobScript(const std::string& path, const std::string& content)
+{
   // Create the file on the file system
-  vishnu::saveInFile(path,
-                     processScript(content,
-                                   options,
-                                   defaultBatchOption,
-                                   muserSessionInfo.machine_name));
+  vishnu::saveInFile(path, content);
 
   // Make the file executable
   if(0 != chmod(path.c_str(),
@@ -1075,8 +1678,6 @@ JobServer::createJobScriptExecutaleFile(std::string& content,
                 S_IROTH|S_IXOTH)) {
     throw SystemException(ERRCODE_INVDATA, "Unable to make the script executable" + path) ;
   }
-
-  return path;
 }
 
 /**
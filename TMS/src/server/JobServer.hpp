@@ -10,11 +10,23 @@
 
 #include "utils.hpp"
 #include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
 #include "TMS_Data.hpp"
 #include "SessionServer.hpp"
 #include "MachineServer.hpp"
 #include "tmsUtils.hpp"
 
+/**
+ * \brief The maximum number of jobs submitted by a single request
+ */
+static const int MAX_JOBS_PER_SUBMISSION = 10000;
+
+/**
+ * \brief The maximum number of jobs sent to a batch helper by a single
+ * request, a helper failing loses the results of a single request
+ */
+static const int MAX_JOBS_PER_HELPER_REQUEST = 100;
 
 /**
  * \class JobServer
@@ -30,7 +42,8 @@ public:
 
   enum BacthActionT {
     SubmitBatchAction = 0,
-    CancelBatchAction = 1
+    CancelBatchAction = 1,
+    SubmitManyBatchAction = 2
   };
 
   /**
@@ -59,6 +72,24 @@ public:
             int vishnuId,
             const std::vector<std::string>& defaultBatchOption);
 
+  /**
+   * \brief Function to submit a set of jobs built from a single script
+   * \param scriptContent the content of the script template
+   * \param options a json object describing the options shared by the jobs
+   * \param jobParams the parameters of each job, in the form PARAM1=value1 PARAM2=value2
+   * \param vishnuId The VISHNU identifier
+   * \param defaultBatchOption the default options on the batch scheduler
+   * \param jobs OUT, the jobs submitted, a failed submission holds its error
+   * \return raises an exception on error
+   */
+  void
+  submitJobs(std::string& scriptContent,
+             JsonObject* options,
+             const std::vector<std::string>& jobParams,
+             int vishnuId,
+             const std::vector<std::string>& defaultBatchOption,
+             TMS_Data::ListJobs& jobs);
+
   /**
    * \brief Destructor
    */
@@ -109,6 +140,38 @@ public:
   void
   setDebugLevel(const int& debugLevel) { mdebugLevel = debugLevel; }
 
+  /**
+   * \brief Run a native batch action in a batch helper process, with the
+   * credentials of the user
+   * \param request The request sent by handleNativeBatchExec
+   * \return The response, holding the status, the error message and the job steps
+   */
+  static std::string
+  processHelperRequest(const std::string& request);
+
+  /**
+   * \brief Check the number of jobs of a multiple submission
+   * \param nbJobs the number of jobs
+   * \return raises an exception unless it is between 1 and MAX_JOBS_PER_SUBMISSION
+   */
+  static void
+  checkJobCount(size_t nbJobs);
+
+  /**
+   * \brief Split the jobs sent to a batch helper into requests of at most
+   * MAX_JOBS_PER_HELPER_REQUEST jobs and maxRequestSize bytes, a larger job
+   * is sent alone
+   * \param jobSizes the size of each job once encoded
+   * \param errors the error of each job, the jobs which failed are not sent
+   * \param maxRequestSize the size of a request
+   * \param requests OUT, the jobs of each request
+   */
+  static void
+  splitHelperRequests(const std::vector<size_t>& jobSizes,
+                      const std::vector<std::string>& errors,
+                      size_t maxRequestSize,
+                      std::vector<std::vector<size_t> >& requests);
+
 private:
   /**
    * \brief Check the machineid is correct
@@ -175,17 +238,22 @@ private:
    * @brief Update the result job steps with the base information of the job and save them
    * @param jobSteps The list of steps
    * @param baseJobInfo The base job info
+   * @param transacId the id of the transaction if one is used. -1 to ignore,
+   * otherwise the monitor is not notified: the caller does it once committed
    */
   void
-  updateAndSaveJobSteps(TMS_Data::ListJobs& jobSteps, TMS_Data::Job& defaultJobInfo);
+  updateAndSaveJobSteps(TMS_Data::ListJobs& jobSteps, TMS_Data::Job& defaultJobInfo,
+                        int transacId = -1);
 
   /**
    * \brief Function to save the encapsulated job into the database
    * @param action The type of action to finalize (submit, cancel...)
    * @param job The concerned job
+   * @param transacId the id of the transaction if one is used. -1 to ignore,
+   * otherwise the monitor is not notified: the caller does it once committed
    */
   void
-  updateJobRecordIntoDatabase(int action, TMS_Data::Job& job);
+  updateJobRecordIntoDatabase(int action, TMS_Data::Job& job, int transacId = -1);
 
   /**
    * \brief Function to set the Working Directory
@@ -246,6 +314,24 @@ private:
                         int batchType,
                         const std::string& batchVersion);
 
+  /**
+   * @brief Run a native batch action in a child process forked for the
+   * request, when the batch helpers are not available
+   * @param action action The type of action (cancel, submit...)
+   * @param scriptPath The path of the script to executed
+   * @param options: an object containing options
+   * @param jobInfo The default information provided to the job
+   * @param batchType The batch type
+   * @param batchVersion The batch version. Ignored for POSIX backend
+  */
+  void
+  forkNativeBatchExec(int action,
+                      const std::string& scriptPath,
+                      JsonObject* options,
+                      TMS_Data::Job& jobInfo,
+                      int batchType,
+                      const std::string& batchVersion);
+
   /**
    * @brief Get the uid corresponding to given system user name
    * @param username
@@ -266,6 +352,48 @@ private:
                                JsonObject* options,
                                const std::vector<std::string>& defaultBatchOption);
 
+  /**
+   * @brief Save a job script and make it executable
+   * @param path The path of the script
+   * @param content The processed script content
+   */
+  void
+  saveJobScript(const std::string& path, const std::string& content);
+
+  /**
+   * @brief Submit a set of prepared jobs to the batch helper of the user, by
+   * requests fitting in a helper frame
+   * @param jobs The jobs, with their script path and output directory set
+   * @param jobOptions The options of each job
+   * @param steps OUT, the job steps of each job, empty if it failed
+   * @param errors OUT, the error of each job, empty if it succeeded
+   * @return false if the helpers could not take the request, nothing was submitted
+   */
+  bool
+  submitManyWithHelper(std::vector<TMS_Data::Job>& jobs,
+                       std::vector<boost::shared_ptr<JsonObject> >& jobOptions,
+                       std::vector<std::string>& steps,
+                       std::vector<std::string>& errors);
+
+  /**
+   * @brief Submit a group of prepared jobs in a single request to the batch
+   * helper of the user
+   * @param uid The user running the request
+   * @param scripts The script path of each job sent
+   * @param serializedJobs Each job sent, serialized
+   * @param encodedOptions The options of each job sent, encoded
+   * @param steps OUT, the job steps of each job sent, empty if it failed
+   * @param errors OUT, the error of each job sent, empty if it succeeded
+   * @return the status of the request, the errors are set unless it succeeds
+   */
+  int
+  submitChunkWithHelper(uid_t uid,
+                        const std::vector<std::string>& scripts,
+                        const std::vector<std::string>& serializedJobs,
+                        const std::vector<std::string>& encodedOptions,
+                        std::vector<std::string>& steps,
+                        std::vector<std::string>& errors);
+
   /**
    * @brief Export environment variables used throughout the execution, notably in cloud mode
    * @param defaultJobInfo The default job info
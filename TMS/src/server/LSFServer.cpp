@@ -468,6 +468,52 @@ LSFServer::getJobState(const std::string& jobId) {
   return state;
 }
 
+/**
+ * \brief Function to get the status of several jobs with a single request
+ * to the batch system
+ * \param jobIds the identifiers of the jobs
+ * \return the status of the jobs, by identifier
+ */
+std::map<std::string, int>
+LSFServer::getJobStates(const std::vector<std::string>& jobIds) {
+
+  std::map<std::string, int> states;
+  if (jobIds.empty()) {
+    return states;
+  }
+
+  if (lsb_init(NULL) < 0) {
+    std::string errorMsg = "LSFServer::getJobStates: lsb_init() failed with error "+vishnu::convertToString(lsberrno);
+    throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR, "LSF ERROR: "+errorMsg);
+  }
+
+  std::map<LS_LONG_INT, int> lsfStates;
+  int numJobs = lsb_openjobinfo(0, NULL, (char*)"all", NULL, NULL, ALL_JOB);
+  if (numJobs < 0) {
+    if (lsberrno != LSBE_NO_JOB) {
+      std::string errorMsg = "LSFServer::getJobStates: lsb_openjobinfo failed with error "+vishnu::convertToString(lsberrno);
+      throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR, "LSF ERROR: "+errorMsg);
+    }
+  } else {
+    int more = 1;
+    struct jobInfoEnt *jobInfo;
+    while (more) {
+      jobInfo = lsb_readjobinfo(&more);
+      if (jobInfo == NULL) {
+        break;
+      }
+      lsfStates[jobInfo->jobId] = convertLSFStateToVishnuState(jobInfo->status);
+    }
+    lsb_closejobinfo();
+  }
+
+  for (std::vector<std::string>::const_iterator it = jobIds.begin(); it != jobIds.end(); ++it) {
+    std::map<LS_LONG_INT, int>::const_iterator found = lsfStates.find(convertToLSFJobId(*it));
+    states[*it] = (found != lsfStates.end()) ? found->second : 5; //TERMINATED
+  }
+  return states;
+}
+
 /**
  * \brief Function to get the start time of the job
  * \param jobId the identifier of the job
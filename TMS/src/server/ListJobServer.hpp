@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <algorithm>
 #include <iostream>
 #include "boost/date_time/posix_time/posix_time.hpp"
 
@@ -19,7 +20,17 @@
 #include "TMS_Data.hpp"
 #include "BatchServer.hpp"
 #include "BatchFactory.hpp"
+#include <map>
+#include <set>
 #include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+
+/**
+ * \brief The maximum number of jobs returned in a single page
+ */
+static const int LIST_JOBS_MAX_PAGE_SIZE = 10000;
 
 /**
  * \class ListJobServer
@@ -44,20 +55,23 @@ public:
    * \brief Function to treat the listJobServer options
    * \param options the object which contains the ListJobServer options values
    * \param sqlRequest the sql data base request
+   * \param params the parameters of the request
    * \return raises an exception on error
    */
   void
-  processOptions(const TMS_Data::ListJobsOptions_ptr& options, std::string& sqlRequest) {
+  processOptions(const TMS_Data::ListJobsOptions_ptr& options, std::string& sqlRequest,
+                 SqlParameters& params) {
 
     //To check if the jobId is defined
     if (options->getJobId().size() != 0) {
       checkJobId(options->getJobId());
-      addOptionRequest("jobId", options->getJobId(), sqlRequest);
+      addOptionRequest("jobId", options->getJobId(), sqlRequest, params);
     }
 
     //To check if the number of cpu is defined and positive
     if (options->getNbCpu() > 0) {
-      addOptionRequest("nbCpus", vishnu::convertToString(options->getNbCpu()), sqlRequest);
+      long long nbCpu = options->getNbCpu();
+      addIntegerOptionRequest("nbCpus", nbCpu, sqlRequest, params);
     } else {
       if (options->getNbCpu() != -1) {
         throw UserException(ERRCODE_INVALID_PARAM, "The number of cpu is incorrect");
@@ -67,19 +81,20 @@ public:
     time_t fromSubmitDate = static_cast<time_t>(options->getFromSubmitDate());
     if (fromSubmitDate > 0) {
       std::string textTime = boost::posix_time::to_iso_string(boost::posix_time::from_time_t(fromSubmitDate));
-      addTimeRequest("submitDate", textTime, sqlRequest,">=");
+      addTimeRequest("submitDate", textTime, sqlRequest, ">=", params);
     }
 
     time_t toSubmitDate = static_cast<time_t>(options->getToSubmitDate());
     if(toSubmitDate > 0) {
       std::string textTime = boost::posix_time::to_iso_string(boost::posix_time::from_time_t(toSubmitDate));
-      addTimeRequest("submitDate", textTime, sqlRequest,"<=");
+      addTimeRequest("submitDate", textTime, sqlRequest, "<=", params);
     }
 
     //Check the job status
     if (options->getStatus() != -1) {
       vishnu::checkJobStatus(options->getStatus()); //check the job state options
-      addOptionRequest("job.status", vishnu::convertToString(options->getStatus()), sqlRequest); //Append the amount of the cpu
+      long long status = options->getStatus();
+      addIntegerOptionRequest("job.status", status, sqlRequest, params);
     } else {
       if (options->getJobId().empty() && options->getMultipleStatus().empty()) {
         sqlRequest.append(" and job.status < "+vishnu::convertToString(vishnu::STATE_COMPLETED));
@@ -87,70 +102,33 @@ public:
     }
 
     if(! options->getMultipleStatus().empty()) {
+      // a set, so the order and the repetitions of the states give the
+      // same request
+      std::set<int> states;
       std::string multStat = options->getMultipleStatus();
-      std::string::iterator iter;
-      std::string::iterator beg = multStat.begin();
-      std::string::iterator end = multStat.end();
-      std::vector<std::string> vec;
-      for (iter=beg; iter!=end; ++iter) {
-        switch(*iter) {
-        case 'S':
-        case 48+vishnu::STATE_SUBMITTED:
-          vec.push_back("job.status="+vishnu::convertToString(vishnu::STATE_SUBMITTED));
-          break;
-        case 'Q':
-        case 48+vishnu::STATE_QUEUED:
-          vec.push_back("job.status="+vishnu::convertToString(vishnu::STATE_QUEUED));
-          break;
-        case 'W':
-        case 48+vishnu::STATE_WAITING:
-          vec.push_back("job.status="+vishnu::convertToString(vishnu::STATE_WAITING));
-          break;
-        case 'R':
-        case 48+vishnu::STATE_RUNNING:
-          vec.push_back("job.status="+vishnu::convertToString(vishnu::STATE_RUNNING));
-          break;
-        case 'T':
-        case 48+vishnu::STATE_COMPLETED:
-          vec.push_back("job.status="+vishnu::convertToString(vishnu::STATE_COMPLETED));
-          break;
-        case 'C':
-        case 48+vishnu::STATE_CANCELLED:
-          vec.push_back("job.status="+vishnu::convertToString(vishnu::STATE_CANCELLED));
-          break;
-        case 'D':
-        case 48+vishnu::STATE_DOWNLOADED:
-          vec.push_back("job.status="+vishnu::convertToString(vishnu::STATE_DOWNLOADED));
-          break;
-        case 'F':
-        case 48+vishnu::STATE_FAILED:
-          vec.push_back("job.status="+vishnu::convertToString(vishnu::STATE_FAILED));
-          break;
-        default:
-          throw UserException(ERRCODE_INVALID_PARAM,
-                              (boost::format("Unknown job state: %1%")%*iter).str());
-          break;
-        }
+      for (std::string::const_iterator iter = multStat.begin(); iter != multStat.end(); ++iter) {
+        states.insert(getJobState(*iter));
       }
-      std::vector<std::string>::iterator vec_iter;
-      if (!vec.empty()) {
-        sqlRequest.append(" and ("+*vec.begin());
-        for (vec_iter=vec.begin()+1; vec_iter!=vec.end(); ++vec_iter) {
-          sqlRequest.append(" or "+*vec_iter);
+      std::string inList;
+      BOOST_FOREACH(int state, states) {
+        if (! inList.empty()) {
+          inList.append(",");
         }
-        sqlRequest.append(")");
+        inList.append(vishnu::convertToString(state));
       }
+      sqlRequest.append(" and job.status IN ("+inList+")");
     }
     //To check the job priority
     if (options->getPriority() != -1) {
       //To check the job priority options
       vishnu::checkJobPriority(options->getPriority());
       //To add the number of the cpu to the request
-      addOptionRequest("jobPrio", vishnu::convertToString(options->getPriority()), sqlRequest);
+      long long priority = options->getPriority();
+      addIntegerOptionRequest("jobPrio", priority, sqlRequest, params);
     }
 
     if (options->getOwner().size() != 0) {
-      addOptionRequest("owner", options->getOwner(), sqlRequest);
+      addOptionRequest("owner", options->getOwner(), sqlRequest, params);
     }
 
     //To check if the queue is defined
@@ -158,17 +136,90 @@ public:
       BatchFactory factory;
       BatchType batchType  = ServerXMS::getInstance()->getBatchType();
       std::string batchVersion  = ServerXMS::getInstance()->getBatchVersion();
-      boost::scoped_ptr<BatchServer> batchServer(factory.getBatchServerInstance(batchType, batchVersion));
+      boost::shared_ptr<BatchServer> batchServer(factory.getBatchServerInstance(batchType, batchVersion));
       batchServer->listQueues(options->getQueue()); //raise an exception if options->getQueue does not exist
 
-      addOptionRequest("jobQueue", options->getQueue(), sqlRequest);
+      addOptionRequest("jobQueue", options->getQueue(), sqlRequest, params);
     }
     if(options->getWorkId() >= 0 ) {
       long long int wid = options->getWorkId()  ;
-      addIntegerOptionRequest("workId", wid, sqlRequest);
+      addIntegerOptionRequest("workId", wid, sqlRequest, params);
+    }
+  }
+
+  /**
+   * \brief Function to get the job state given by a letter or a digit of
+   * the multiple status option
+   * \param state the letter or the digit
+   * \return the job state, raises an exception if it is unknown
+   */
+  static int
+  getJobState(char state) {
+    switch(state) {
+    case 'S':
+    case 48+vishnu::STATE_SUBMITTED:
+      return vishnu::STATE_SUBMITTED;
+    case 'Q':
+    case 48+vishnu::STATE_QUEUED:
+      return vishnu::STATE_QUEUED;
+    case 'W':
+    case 48+vishnu::STATE_WAITING:
+      return vishnu::STATE_WAITING;
+    case 'R':
+    case 48+vishnu::STATE_RUNNING:
+      return vishnu::STATE_RUNNING;
+    case 'T':
+    case 48+vishnu::STATE_COMPLETED:
+      return vishnu::STATE_COMPLETED;
+    case 'C':
+    case 48+vishnu::STATE_CANCELLED:
+      return vishnu::STATE_CANCELLED;
+    case 'D':
+    case 48+vishnu::STATE_DOWNLOADED:
+      return vishnu::STATE_DOWNLOADED;
+    case 'F':
+    case 48+vishnu::STATE_FAILED:
+      return vishnu::STATE_FAILED;
+    default:
+      throw UserException(ERRCODE_INVALID_PARAM,
+                          (boost::format("Unknown job state: %1%")%state).str());
     }
   }
 
+  /**
+   * \brief Function to restrict the request to a page of jobs, the jobs
+   * being ordered by primary key so that the jobs without submission date
+   * are listed too
+   * \param options the object which contains the ListJobServer options values
+   * \param sqlRequest the sql data base request
+   * \param params the parameters of the request
+   * \return raises an exception on error
+   */
+  void
+  processPageOptions(const TMS_Data::ListJobsOptions_ptr& options, std::string& sqlRequest,
+                     SqlParameters& params) {
+    if (options->getPageSize() < 0) {
+      throw UserException(ERRCODE_INVALID_PARAM, "The page size is incorrect");
+    }
+
+    std::string token = options->getResumeToken();
+    if (token.empty()) {
+      return;
+    }
+    // the token holds the primary key of the last job of the previous page
+    if (token.find_first_not_of("0123456789") != std::string::npos) {
+      throw UserException(ERRCODE_INVALID_PARAM, "The resume token is incorrect");
+    }
+    long long lastJob;
+    try {
+      lastJob = boost::lexical_cast<long long>(token);
+    } catch (boost::bad_lexical_cast&) {
+      // out of range
+      throw UserException(ERRCODE_INVALID_PARAM, "The resume token is incorrect");
+    }
+    sqlRequest.append(" and job.numjobid > "+params.bind(lastJob));
+  }
+
   /**
    * \brief Function to list sessions information
    * \return The pointer to the UMS_Data::ListSessions containing sessions information
@@ -179,14 +230,16 @@ public:
     std::string sqlQuery =
         "SELECT vsessionid, submitMachineId, submitMachineName, jobId, jobName, workId, jobPath,"
         " outputPath, errorPath, jobPrio, nbCpus, jobWorkingDir, job.status, submitDate, endDate, owner, jobQueue,"
-        " wallClockLimit, groupName, jobDescription, memLimit, nbNodes, nbNodesAndCpuPerNode, batchJobId, userid "
+        " wallClockLimit, groupName, jobDescription, memLimit, nbNodes, nbNodesAndCpuPerNode, batchJobId, userid,"
+        " numjobid "
         "FROM job, vsession, users "
         "WHERE vsession.numsessionid=job.vsession_numsessionid"
         " AND vsession.users_numuserid=users.numuserid";
 
+    SqlParameters params;
     if (!options->getMachineId().empty()) {
       checkMachineId(options->getMachineId());
-      sqlQuery.append(" and job.submitMachineId='"+mdatabaseInstance->escapeData(options->getMachineId())+"'");
+      sqlQuery.append(" and job.submitMachineId="+params.bind(options->getMachineId()));
     }
 
     std::vector<std::string>::iterator ii;
@@ -195,16 +248,31 @@ public:
     TMS_Data::TMS_DataFactory_ptr ecoreFactory = TMS_Data::TMS_DataFactory::_instance();
     mlistObject = ecoreFactory->createListJobs();
 
-    processOptions(options, sqlQuery);
-    sqlQuery.append(" order by submitDate");
+    processOptions(options, sqlQuery, params);
+
+    int pageSize = options->getPageSize();
+    if (pageSize != 0 || ! options->getResumeToken().empty()) {
+      processPageOptions(options, sqlQuery, params);
+      pageSize = std::min(pageSize > 0 ? pageSize : LIST_JOBS_MAX_PAGE_SIZE, LIST_JOBS_MAX_PAGE_SIZE);
+      // one more job tells whether another page follows
+      long long limit = pageSize + 1;
+      sqlQuery.append(" order by numjobid limit "+params.bind(limit));
+    } else {
+      sqlQuery.append(" order by submitDate");
+    }
 
-    boost::scoped_ptr<DatabaseResult> ListOfJobs (mdatabaseInstance->getResult(sqlQuery));
+    boost::scoped_ptr<DatabaseResult>
+      ListOfJobs(mdatabaseInstance->getPreparedResult(getStatementName(sqlQuery), sqlQuery, params));
     long nbRunningJobs = 0;
     long nbWaitingJobs = 0;
     std::string batchJobId;
     std::vector<std::string> ignoredIds;
 
     int nbJobs = ListOfJobs->getNbTuples();
+    std::string numJobId;
+    if (pageSize != 0 && nbJobs > pageSize) {
+      nbJobs = pageSize;
+    }
     if (nbJobs != 0) {
 
       for (size_t i = 0; i < nbJobs; ++i) {
@@ -248,8 +316,12 @@ public:
         job->setBatchJobId(batchJobId);
         ignoredIds.push_back(batchJobId);
         job->setUserId(*(++ii));
+        numJobId = *(++ii);
         mlistObject->getJobs().push_back(job);
       }
+      if (nbJobs < ListOfJobs->getNbTuples()) {
+        mlistObject->setNextToken(numJobId);
+      }
       mlistObject->setNbJobs(mlistObject->getJobs().size());
       mlistObject->setNbRunningJobs(nbRunningJobs);
       mlistObject->setNbWaitingJobs(nbWaitingJobs);
@@ -258,6 +330,40 @@ public:
   }
 
 
+  /**
+   * \brief Function to get the name of the statement of a request, the
+   * values being bound each combination of options gives its own request.
+   * Only the MAX_PREPARED_STATEMENTS requests used last keep their name.
+   * \param request the request, with the $n parameters
+   * \return the name of the statement, the same for the same request
+   */
+  static std::string
+  getStatementName(const std::string& request) {
+    static boost::mutex mutex;
+    // the requests, the most recently used first
+    static std::list<std::string> recent;
+    static std::map<std::string, std::pair<std::string, std::list<std::string>::iterator> > names;
+    static unsigned long count = 0;
+
+    boost::lock_guard<boost::mutex> lock(mutex);
+    std::map<std::string, std::pair<std::string, std::list<std::string>::iterator> >::iterator it = names.find(request);
+    if (it != names.end()) {
+      recent.splice(recent.begin(), recent, it->second.second);
+      return it->second.first;
+    }
+    // no more requests are kept than statements prepared on a connection;
+    // a name is never given to another request, the connection may still
+    // hold its statement
+    if (names.size() >= MAX_PREPARED_STATEMENTS) {
+      names.erase(recent.back());
+      recent.pop_back();
+    }
+    recent.push_front(request);
+    std::string name = "list_jobs_" + vishnu::convertToString(count++);
+    names[request] = std::make_pair(name, recent.begin());
+    return name;
+  }
+
   /**
    * \brief Function to get the name of the ListJobServer command line
    * \return The the name of the ListJobServer command line
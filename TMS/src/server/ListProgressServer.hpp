@@ -105,7 +105,7 @@ public:
         BatchFactory factory;
         BatchType batchType  = ServerXMS::getInstance()->getBatchType();
         std::string batchVersion  = ServerXMS::getInstance()->getBatchVersion();
-        boost::scoped_ptr<BatchServer> batchServer(factory.getBatchServerInstance(batchType,
+        boost::shared_ptr<BatchServer> batchServer(factory.getBatchServerInstance(batchType,
                                                                                   batchVersion));
 
         startTime = batchServer->getJobStartTime(batchJobId);
@@ -0,0 +1,251 @@
+/**
+ * \file PbsConnectionPool.cpp
+ * \brief This file implements the pool of connections to the PBS servers
+ */
+
+#include "PbsConnectionPool.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <unistd.h>
+#include <boost/format.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+extern "C" {
+#include "pbs_ifl.h"
+#include "pbs_error.h"
+#include "cmds.h"
+}
+#include "Logger.hpp"
+
+namespace {
+
+/**
+ * \brief Open a connection with the pbs library
+ * \param server the server, empty for the default server
+ * \return the connection, <= 0 on error
+ */
+int
+connectServer(const std::string& server) {
+  std::vector<char> name(server.begin(), server.end());
+  name.push_back('\0');
+  return cnt2server(&name[0]);
+}
+
+} // namespace
+
+
+PbsConnectionPool&
+PbsConnectionPool::getInstance() {
+  static PbsConnectionPool instance;
+  return instance;
+}
+
+
+PbsConnectionPool::PbsConnectionPool()
+  : mmaxConnections(PBS_POOL_MAX_CONNECTIONS), mowner(getpid()) {
+  const char* value = getenv(PBS_POOL_MAX_CONNECTIONS_VAR);
+  if (value != NULL && atoi(value) > 0) {
+    mmaxConnections = atoi(value);
+  }
+}
+
+
+bool
+PbsConnectionPool::isOwner() const {
+  // a forked process may hold a copy of a locked mutex, it must not
+  // touch the pool
+  return getpid() == mowner;
+}
+
+
+int
+PbsConnectionPool::acquire(const std::string& server) {
+  if (! isOwner()) {
+    return connectServer(server);
+  }
+
+  boost::unique_lock<boost::mutex> lock(mmutex);
+  ServerConnections& connections = mservers[server];
+  PbsConnectionMetrics& metrics = connections.metrics;
+
+  // wait for a connection if the limit is reached, then go above it
+  // rather than failing the request
+  if (connections.idle.empty() && metrics.open >= mmaxConnections) {
+    ++metrics.waits;
+    boost::system_time deadline = boost::get_system_time()
+                                  + boost::posix_time::seconds(PBS_POOL_TIMEOUT);
+    while (connections.idle.empty() && metrics.open >= mmaxConnections) {
+      if (! mreleased.timed_wait(lock, deadline)) {
+        ++metrics.overflows;
+        LOG(boost::str(boost::format("[WARNING] %1% connections to the pbs server %2% in use,"
+                                     " opening one more")
+                       % metrics.open % server), LogWarning);
+        break;
+      }
+    }
+  }
+
+  // the most recently used connection is the most likely to be alive
+  time_t now = time(NULL);
+  while (! connections.idle.empty()) {
+    IdleConnection idle = connections.idle.back();
+    connections.idle.pop_back();
+    if (now - idle.since < PBS_POOL_MAX_IDLE_TIME) {
+      ++metrics.reuses;
+      ++metrics.inUse;
+      return idle.connection;
+    }
+    // the server may have dropped it
+    pbs_disconnect(idle.connection);
+    --metrics.open;
+  }
+
+  // the connection is opened without the lock, it may take a while
+  ++metrics.open;
+  ++metrics.inUse;
+  lock.unlock();
+  int connection = connectServer(server);
+  lock.lock();
+
+  if (connection <= 0) {
+    --metrics.open;
+    --metrics.inUse;
+    ++metrics.failures;
+    mreleased.notify_one();
+    return connection;
+  }
+  ++metrics.connects;
+  metrics.peakOpen = std::max(metrics.peakOpen, metrics.open);
+  LOG(boost::str(boost::format("[INFO] pbs connection opened to '%1%': %2% open, %3% in use,"
+                               " peak %4%, %5% opened, %6% reused, %7% failed")
+                 % server % metrics.open % metrics.inUse % metrics.peakOpen
+                 % metrics.connects % metrics.reuses % metrics.failures), LogInfo);
+  return connection;
+}
+
+
+void
+PbsConnectionPool::release(const std::string& server, int connection) {
+  if (connection <= 0) {
+    return;
+  }
+  if (! isOwner()) {
+    pbs_disconnect(connection);
+    return;
+  }
+
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  ServerConnections& connections = mservers[server];
+  --connections.metrics.inUse;
+  if (connections.metrics.open > mmaxConnections) {
+    // opened above the limit
+    pbs_disconnect(connection);
+    --connections.metrics.open;
+  } else {
+    IdleConnection idle;
+    idle.connection = connection;
+    idle.since = time(NULL);
+    connections.idle.push_back(idle);
+  }
+  mreleased.notify_one();
+}
+
+
+int
+PbsConnectionPool::reconnect(const std::string& server, int connection) {
+  pbs_disconnect(connection);
+  if (! isOwner()) {
+    return connectServer(server);
+  }
+
+  {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    ServerConnections& connections = mservers[server];
+    // the idle connections were most likely lost with this one
+    for (std::vector<IdleConnection>::const_iterator it = connections.idle.begin();
+         it != connections.idle.end(); ++it) {
+      pbs_disconnect(it->connection);
+      --connections.metrics.open;
+    }
+    connections.idle.clear();
+    ++connections.metrics.reconnections;
+  }
+
+  // the new connection takes the place of the lost one
+  int newConnection = connectServer(server);
+  if (newConnection <= 0) {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    ServerConnections& connections = mservers[server];
+    --connections.metrics.open;
+    --connections.metrics.inUse;
+    ++connections.metrics.failures;
+    mreleased.notify_one();
+  }
+  return newConnection;
+}
+
+
+void
+PbsConnectionPool::setMaxConnections(int maxConnections) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  mmaxConnections = (maxConnections > 0) ? maxConnections : 1;
+  mreleased.notify_all();
+}
+
+
+PbsConnectionMetrics
+PbsConnectionPool::getMetrics(const std::string& server) const {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  std::map<std::string, ServerConnections>::const_iterator it = mservers.find(server);
+  return (it != mservers.end()) ? it->second.metrics : PbsConnectionMetrics();
+}
+
+
+bool
+PbsConnectionPool::isConnectionError(int error) {
+  // below PBSE_ the error is a system errno, from the socket
+  return error == PBSE_PROTOCOL
+    || (error > 0 && error < PBSE_);
+}
+
+
+PbsConnection::PbsConnection(const std::string& server)
+  : mserver(server) {
+  mconnection = PbsConnectionPool::getInstance().acquire(mserver);
+}
+
+
+PbsConnection::~PbsConnection() {
+  release();
+}
+
+
+void
+PbsConnection::release() {
+  if (mconnection > 0) {
+    PbsConnectionPool::getInstance().release(mserver, mconnection);
+  }
+  mconnection = 0;
+}
+
+
+int
+PbsConnection::get() const {
+  return mconnection;
+}
+
+
+bool
+PbsConnection::isValid() const {
+  return mconnection > 0;
+}
+
+
+bool
+PbsConnection::reconnectOnError(int error) {
+  if (mconnection <= 0 || ! PbsConnectionPool::isConnectionError(error)) {
+    return false;
+  }
+  mconnection = PbsConnectionPool::getInstance().reconnect(mserver, mconnection);
+  return mconnection > 0;
+}
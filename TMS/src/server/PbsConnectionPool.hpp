@@ -0,0 +1,283 @@
+/**
+ * \file PbsConnectionPool.hpp
+ * \brief This file defines the pool of connections to the PBS servers,
+ * shared by the Torque and PBSPro backends
+ */
+
+#ifndef TMS_PBS_CONNECTION_POOL_H
+#define TMS_PBS_CONNECTION_POOL_H
+
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+/**
+ * \brief The default number of connections opened to a server, it must stay
+ * below the connection limit of pbs_server
+ */
+const int PBS_POOL_MAX_CONNECTIONS = 4;
+
+/**
+ * \brief The environment variable overriding PBS_POOL_MAX_CONNECTIONS
+ */
+const char* const PBS_POOL_MAX_CONNECTIONS_VAR = "VISHNU_PBS_MAX_CONNECTIONS";
+
+/**
+ * \brief The time in seconds after which an idle connection is considered
+ * closed by the server and opened again
+ */
+const int PBS_POOL_MAX_IDLE_TIME = 60;
+
+/**
+ * \brief The time in seconds a request waits for a connection before
+ * opening one above the limit
+ */
+const int PBS_POOL_TIMEOUT = 10;
+
+/**
+ * \struct PbsConnectionMetrics
+ * \brief The usage statistics of the connections to a server
+ */
+struct PbsConnectionMetrics {
+  /**
+   * \brief Constructor
+   */
+  PbsConnectionMetrics()
+    : open(0), inUse(0), peakOpen(0), connects(0), reuses(0),
+      reconnections(0), failures(0), waits(0), overflows(0) {}
+
+  /**
+   * \brief The number of connections currently open
+   */
+  int open;
+  /**
+   * \brief The number of connections currently used by a request
+   */
+  int inUse;
+  /**
+   * \brief The highest number of connections open at once
+   */
+  int peakOpen;
+  /**
+   * \brief The number of connections opened
+   */
+  unsigned long connects;
+  /**
+   * \brief The number of requests served by an idle connection
+   */
+  unsigned long reuses;
+  /**
+   * \brief The number of connections replaced after an error
+   */
+  unsigned long reconnections;
+  /**
+   * \brief The number of connections that could not be opened
+   */
+  unsigned long failures;
+  /**
+   * \brief The number of requests that waited for a connection
+   */
+  unsigned long waits;
+  /**
+   * \brief The number of connections opened above the limit
+   */
+  unsigned long overflows;
+};
+
+
+/**
+ * \class PbsConnectionPool
+ * \brief Keeps the connections to the PBS servers open between the
+ * requests of a process. A connection is used by one request at a time.
+ * A process forked by the server, which may have switched user, never
+ * reuses the connections of its parent: it connects for each request.
+ */
+class PbsConnectionPool : public boost::noncopyable {
+public:
+  /**
+   * \brief Get the pool of the process
+   * \return the pool
+   */
+  static PbsConnectionPool&
+  getInstance();
+
+  /**
+   * \brief Borrow a connection to a server
+   * \param server the server, empty for the default server
+   * \return the connection, <= 0 on error with pbs_errno set
+   */
+  int
+  acquire(const std::string& server);
+
+  /**
+   * \brief Give a connection back to the pool
+   * \param server the server of the connection
+   * \param connection the connection
+   */
+  void
+  release(const std::string& server, int connection);
+
+  /**
+   * \brief Replace a connection which is no longer usable. The idle
+   * connections to the server are closed too.
+   * \param server the server of the connection
+   * \param connection the connection
+   * \return the new connection, <= 0 on error, in which case it does not
+   * need to be given back
+   */
+  int
+  reconnect(const std::string& server, int connection);
+
+  /**
+   * \brief Set the number of connections opened to a server
+   * \param maxConnections the number of connections
+   */
+  void
+  setMaxConnections(int maxConnections);
+
+  /**
+   * \brief Get the usage statistics of the connections to a server
+   * \param server the server, empty for the default server
+   * \return the statistics
+   */
+  PbsConnectionMetrics
+  getMetrics(const std::string& server) const;
+
+  /**
+   * \brief Whether an error means the connection is lost
+   * \param error the value of pbs_errno
+   * \return true if the connection must be replaced
+   */
+  static bool
+  isConnectionError(int error);
+
+private:
+  /**
+   * \brief Constructor, reads the limit of connections in the environment
+   */
+  PbsConnectionPool();
+
+  /**
+   * \brief Whether the pool belongs to the current process
+   * \return false in a forked process
+   */
+  bool
+  isOwner() const;
+
+  /**
+   * \struct IdleConnection
+   * \brief A connection waiting for a request
+   */
+  struct IdleConnection {
+    /**
+     * \brief The connection
+     */
+    int connection;
+    /**
+     * \brief The date the connection was given back
+     */
+    time_t since;
+  };
+
+  /**
+   * \struct ServerConnections
+   * \brief The connections to a server
+   */
+  struct ServerConnections {
+    /**
+     * \brief The idle connections, the most recently used last
+     */
+    std::vector<IdleConnection> idle;
+    /**
+     * \brief The usage statistics
+     */
+    PbsConnectionMetrics metrics;
+  };
+
+  /**
+   * \brief The connections, by server
+   */
+  std::map<std::string, ServerConnections> mservers;
+  /**
+   * \brief The number of connections opened to a server
+   */
+  int mmaxConnections;
+  /**
+   * \brief The process owning the connections
+   */
+  pid_t mowner;
+  /**
+   * \brief mutex protecting the pool
+   */
+  mutable boost::mutex mmutex;
+  /**
+   * \brief Signaled when a connection is given back or closed
+   */
+  boost::condition_variable mreleased;
+};
+
+
+/**
+ * \class PbsConnection
+ * \brief A connection borrowed from the pool for the time of a request
+ */
+class PbsConnection : public boost::noncopyable {
+public:
+  /**
+   * \brief Constructor, borrows a connection
+   * \param server the server, empty for the default server
+   */
+  explicit PbsConnection(const std::string& server);
+
+  /**
+   * \brief Destructor, gives the connection back
+   */
+  ~PbsConnection();
+
+  /**
+   * \brief Get the connection handle
+   * \return the handle, <= 0 if the connection failed
+   */
+  int
+  get() const;
+
+  /**
+   * \brief Whether the connection is opened
+   * \return true if opened
+   */
+  bool
+  isValid() const;
+
+  /**
+   * \brief Replace the connection if an error shows it is lost
+   * \param error the value of pbs_errno after the request
+   * \return true if the connection was replaced and the request can be
+   * sent again
+   */
+  bool
+  reconnectOnError(int error);
+
+  /**
+   * \brief Give the connection back before the end of the request, so a
+   * nested request to the same server does not wait for it
+   */
+  void
+  release();
+
+private:
+  /**
+   * \brief The server of the connection
+   */
+  std::string mserver;
+  /**
+   * \brief The connection handle
+   */
+  int mconnection;
+};
+
+#endif
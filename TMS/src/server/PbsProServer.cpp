@@ -8,6 +8,7 @@
 
 #include <vector>
 #include <sstream>
+#include <cstring>
 
 #include <boost/algorithm/string.hpp>
 
@@ -19,6 +20,7 @@ extern "C" {
 }
 
 #include "PbsProServer.hpp"
+#include "PbsConnectionPool.hpp"
 #include "TMSVishnuException.hpp"
 #include "utilVishnu.hpp"
 #include "tmsUtils.hpp" // For convertStringToWallTime
@@ -76,7 +78,8 @@ PbsProServer::submit(const std::string& scriptPath,
     throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR, "PBS ERROR: "+std::string(errMsg));
   }
 
-  int connect = cnt2server(serverOut);
+  PbsConnection connection(serverOut);
+  int connect = connection.get();
   if (connect <= 0) {
     std::ostringstream connect_error;
     connect_error << "PBS ERROR: pbs_submit: cannot connect to server ";
@@ -107,7 +110,6 @@ PbsProServer::submit(const std::string& scriptPath,
       submit_error << "PBS ERROR: pbs_submit: Error (" << pbs_errno << "-";
       submit_error << pbse_to_txt(pbs_errno) << std::endl;
     }
-    pbs_disconnect(connect);
 
     unlink(scriptTmp);
 
@@ -117,8 +119,6 @@ PbsProServer::submit(const std::string& scriptPath,
   unlink(scriptTmp);
   struct batch_status *p_status = pbs_statjob(connect, jobId, NULL, NULL);
 
-  pbs_disconnect(connect);
-
   if(p_status!=NULL) {
     fillJobInfo(job, p_status);
   }
@@ -322,11 +322,8 @@ PbsProServer::pbs_cancel(const char* jobId,
     }
   }
 
-  if(isLocal) {
-     connect = cnt2server(serverOut);
-  } else {
-     connect = cnt2server(remoteServer);
-  }
+  PbsConnection connection(isLocal ? std::string(serverOut) : std::string(remoteServer));
+  connect = connection.get();
 
   if (connect <= 0)
   {
@@ -348,26 +345,22 @@ PbsProServer::pbs_cancel(const char* jobId,
     } else {
        pbs_del_error <<  "PBS ERROR: pbs_deljob: Server returned error " << pbs_errno << " for job " << tmsJobIdOut << std::endl;
     }
-    pbs_disconnect(connect);
     throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR, pbs_del_error.str());
   } else if (stat && (pbs_errno == PBSE_UNKJOBID) && isLocal ) {
     if (locate_job(tmsJobIdOut, serverOut, remoteServer)) {
-      pbs_disconnect(connect);
+      // the connection is given back before the request to the other server
+      connection.release();
       pbs_cancel(tmsJobId,  remoteServer, false);
       return 0;
     }
 
     pbs_del_error << "Unknown JobId " << tmsJobIdOut << std::endl;
-    pbs_disconnect(connect);
     throw TMSVishnuException(ERRCODE_UNKNOWN_JOBID, pbs_del_error.str());
 
   } else if(pbs_errno == PBSE_UNKJOBID) {
     pbs_del_error << "Unknown JobId " << tmsJobIdOut << std::endl;
-    pbs_disconnect(connect);
     throw TMSVishnuException(ERRCODE_UNKNOWN_JOBID, pbs_del_error.str());
   }
-
-  pbs_disconnect(connect);
   return 0;
 }
 
@@ -396,13 +389,16 @@ PbsProServer::getJobState(const std::string& jobId) {
   }
 
   // Connect to the PbsPro server
-  connect = cnt2server(serverOut);
+  PbsConnection connection(serverOut);
+  connect = connection.get();
 
   if(connect <= 0) {
     return -1;
   } else {
     p_status = pbs_statjob(connect, tmsJobIdOut, NULL, NULL);
-    pbs_disconnect(connect);
+    if (p_status == NULL && connection.reconnectOnError(pbs_errno)) {
+      p_status = pbs_statjob(connection.get(), tmsJobIdOut, NULL, NULL);
+    }
   }
 
   if(p_status!=NULL) {
@@ -419,6 +415,62 @@ PbsProServer::getJobState(const std::string& jobId) {
 return state;
 }
 
+/**
+ * \brief Function to get the status of several jobs with a single request
+ * to the server
+ * \param jobIds the identifiers of the jobs
+ * \return the status of the jobs, by identifier
+ */
+std::map<std::string, int>
+PbsProServer::getJobStates(const std::vector<std::string>& jobIds) {
+  std::map<std::string, int> states;
+  if (jobIds.empty()) {
+    return states;
+  }
+
+  // Connect to the default PbsPro server, as getJobState does
+  serverOut[0] = '\0';
+  PbsConnection connection(serverOut);
+  int connect = connection.get();
+  if (connect <= 0) {
+    throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR,
+                             "PBS ERROR: cannot connect to the server");
+  }
+
+  // only the state of the jobs is requested, an empty identifier selects
+  // all the jobs of the server
+  struct attrl stateAttr;
+  memset(&stateAttr, 0, sizeof(stateAttr));
+  stateAttr.name = const_cast<char*>(ATTR_state);
+  char allJobs[] = "";
+  struct batch_status *p_status = pbs_statjob(connect, allJobs, &stateAttr, NULL);
+  if (p_status == NULL && connection.reconnectOnError(pbs_errno)) {
+    p_status = pbs_statjob(connection.get(), allJobs, &stateAttr, NULL);
+  }
+  int error = pbs_errno;
+  if (p_status == NULL && error != PBSE_NONE) {
+    throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR,
+                             "PBS ERROR: pbs_statjob: "+vishnu::convertToString(error));
+  }
+
+  // the jobs are identified by their sequence number, the server name may
+  // be written differently
+  std::map<std::string, int> serverStates;
+  for (struct batch_status *p = p_status; p != NULL; p = p->next) {
+    for (struct attrl *a = p->attribs; a != NULL; a = a->next) {
+      if (!strcmp(a->name, ATTR_state)) {
+        std::string name(p->name);
+        serverStates[name.substr(0, name.find('.'))] = convertPbsProStateToVishnuState(std::string(a->value));
+        break;
+      }
+    }
+  }
+  pbs_statfree(p_status);
+
+  // the jobs no longer known by the server are terminated
+  return matchJobStates(jobIds, serverStates, vishnu::STATE_COMPLETED);
+}
+
 /**
  * \brief Function to get the start time of the job
  * \param jobId the identifier of the job
@@ -444,13 +496,16 @@ PbsProServer::getJobStartTime(const std::string& jobId) {
   }
 
   // Connect to the PbsPro server
-  connect = cnt2server(serverOut);
+  PbsConnection connection(serverOut);
+  connect = connection.get();
 
   if(connect <= 0) {
     return 0;
   } else {
     p_status = pbs_statjob(connect, tmsJobIdOut, NULL, NULL);
-    pbs_disconnect(connect);
+    if (p_status == NULL && connection.reconnectOnError(pbs_errno)) {
+      p_status = pbs_statjob(connection.get(), tmsJobIdOut, NULL, NULL);
+    }
   }
 
   if(p_status!=NULL) {
@@ -706,7 +761,8 @@ PbsProServer::listQueues(const std::string& optqueueName) {
 
   serverOut[0] = '\0'; //le bon a recuperer dans la base vishnu
   // Connect to the PbsPro server
-  connect = cnt2server(serverOut);
+  PbsConnection connection(serverOut);
+  connect = connection.get();
 
   if (connect <= 0)
   {
@@ -722,11 +778,14 @@ PbsProServer::listQueues(const std::string& optqueueName) {
 
 
   struct batch_status *p_status;
-  if(optqueueName.size()!=0) {
-    p_status = pbs_statque(connect, strdup(optqueueName.c_str()), NULL, NULL);
-  } else {
-    p_status = pbs_statque(connect, NULL, NULL, NULL);
+  // the same copy of the name serves the request sent again
+  char* queueName = optqueueName.empty() ? NULL : strdup(optqueueName.c_str());
+  p_status = pbs_statque(connect, queueName, NULL, NULL);
+  if (p_status == NULL && connection.reconnectOnError(pbs_errno)) {
+    connect = connection.get();
+    p_status = pbs_statque(connect, queueName, NULL, NULL);
   }
+  free(queueName);
 
   if(p_status==NULL)
   {
@@ -739,13 +798,9 @@ PbsProServer::listQueues(const std::string& optqueueName) {
     else {
       errorMsg = "PBS: pbs_statque: getting status of server\n";
     }
-
-    pbs_disconnect(connect);
     throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR, errorMsg);
   }
 
-  pbs_disconnect(connect);
-
   int nbRunningJobs = 0;
   int nbJobsInQueue = 0;
   struct batch_status *p;
@@ -1115,7 +1170,8 @@ PbsProServer::convertPbsProMem(const std::string& memStr) {
 void PbsProServer::fillListOfJobs(TMS_Data::ListJobs*& listOfJobs,
                                   const std::vector<string>& ignoredIds) {
 
-   int connect = cnt2server(serverOut);
+   PbsConnection connection(serverOut);
+   int connect = connection.get();
 
    if (connect <= 0)
    {
@@ -1133,7 +1189,9 @@ void PbsProServer::fillListOfJobs(TMS_Data::ListJobs*& listOfJobs,
    }
 
    struct batch_status* p_status = pbs_selstat(connect, NULL, NULL, NULL);
-   pbs_disconnect(connect);
+   if (p_status == NULL && connection.reconnectOnError(pbs_errno)) {
+     p_status = pbs_selstat(connection.get(), NULL, NULL, NULL);
+   }
 
    if(p_status!=NULL)
    {
@@ -1222,7 +1280,8 @@ PbsProServer::queuesResourceMin(const std::string& optqueueName) {
 
   serverOut[0] = '\0'; //le bon a recuperer dans la base vishnu
   // Connect to the PbsPro server
-  connect = cnt2server(serverOut);
+  PbsConnection connection(serverOut);
+  connect = connection.get();
 
   if (connect <= 0)
   {
@@ -1238,11 +1297,14 @@ PbsProServer::queuesResourceMin(const std::string& optqueueName) {
 
 
   struct batch_status *p_status;
-  if(optqueueName.size()!=0) {
-    p_status = pbs_statque(connect, strdup(optqueueName.c_str()), NULL, NULL);
-  } else {
-    p_status = pbs_statque(connect, NULL, NULL, NULL);
+  // the same copy of the name serves the request sent again
+  char* queueName = optqueueName.empty() ? NULL : strdup(optqueueName.c_str());
+  p_status = pbs_statque(connect, queueName, NULL, NULL);
+  if (p_status == NULL && connection.reconnectOnError(pbs_errno)) {
+    connect = connection.get();
+    p_status = pbs_statque(connect, queueName, NULL, NULL);
   }
+  free(queueName);
   if(p_status==NULL)
   {
     char* errmsg = pbs_geterrmsg(connect);
@@ -1254,13 +1316,9 @@ PbsProServer::queuesResourceMin(const std::string& optqueueName) {
     else {
       errorMsg = "PBS: pbs_statque: getting status of server\n";
     }
-
-    pbs_disconnect(connect);
     throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR, errorMsg);
   }
 
-  pbs_disconnect(connect);
-
   struct batch_status *p;
   struct attrl *a;
 
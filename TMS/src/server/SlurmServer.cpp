@@ -502,6 +502,41 @@ SlurmServer::getJobState(const std::string& jobId) {
   return state;
 }
 
+/**
+ * \brief Function to get the status of several jobs with a single request
+ * to the controller
+ * \param jobIds the identifiers of the jobs
+ * \return the status of the jobs, by identifier
+ */
+std::map<std::string, int>
+SlurmServer::getJobStates(const std::vector<std::string>& jobIds) {
+
+  std::map<std::string, int> states;
+  if (jobIds.empty()) {
+    return states;
+  }
+
+  job_info_msg_t * job_buffer_ptr = NULL;
+  if (slurm_load_jobs(0, &job_buffer_ptr, SHOW_ALL) != 0 || ! job_buffer_ptr) {
+    throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR,
+                             boost::str(boost::format("slurm_load_jobs failed: %1%")
+                                        % slurm_strerror(slurm_get_errno())));
+  }
+
+  std::map<uint32_t, int> slurmStates;
+  for (uint32_t i = 0; i < job_buffer_ptr->record_count; ++i) {
+    slurmStates[job_buffer_ptr->job_array[i].job_id] =
+      convertSlurmStateToVishnuState(job_buffer_ptr->job_array[i].job_state);
+  }
+  slurm_free_job_info_msg(job_buffer_ptr);
+
+  for (std::vector<std::string>::const_iterator it = jobIds.begin(); it != jobIds.end(); ++it) {
+    std::map<uint32_t, int>::const_iterator found = slurmStates.find(convertToSlurmJobId(*it));
+    states[*it] = (found != slurmStates.end()) ? found->second : vishnu::STATE_UNDEFINED;
+  }
+  return states;
+}
+
 /**
  * \brief Function to get the start time of the job
  * \param jobId the identifier of the job
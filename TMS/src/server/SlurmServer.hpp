@@ -54,6 +54,15 @@ class SlurmServer : public BatchServer
     int
     getJobState(const std::string& jobId);
 
+    /**
+     * \brief Function to get the status of several jobs with a single
+     * request to the controller
+     * \param jobIds the identifiers of the jobs
+     * \return the status of the jobs, by identifier
+     */
+    std::map<std::string, int>
+    getJobStates(const std::vector<std::string>& jobIds);
+
     /**
      * \brief Function to get the start time of the job
      * \param jobId the identifier of the job
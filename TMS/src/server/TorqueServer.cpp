@@ -8,6 +8,7 @@
 
 #include <vector>
 #include <sstream>
+#include <cstring>
 
 #include <boost/algorithm/string.hpp>
 
@@ -18,6 +19,7 @@ extern "C" {
 #include "cmds.h"
 }
 #include "TorqueServer.hpp"
+#include "PbsConnectionPool.hpp"
 #include "TMSVishnuException.hpp"
 #include "utilVishnu.hpp"
 #include "constants.hpp"
@@ -77,7 +79,8 @@ TorqueServer::submit(const std::string& scriptPath,
     throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR, "TORQUE ERROR: "+std::string(errMsg));
   }
 
-  int connect = cnt2server(serverOut);
+  PbsConnection connection(serverOut);
+  int connect = connection.get();
   if (connect <= 0) {
     std::ostringstream connect_error;
     connect_error << "TORQUE ERROR: pbs_submit: cannot connect to server ";
@@ -109,7 +112,6 @@ TorqueServer::submit(const std::string& scriptPath,
       submit_error << "TORQUE ERROR: pbs_submit: Error (" << pbs_errno << "-";
       submit_error << pbs_strerror(pbs_errno) << std::endl;
     }
-    pbs_disconnect(connect);
 
     unlink(scriptTmp);
 
@@ -119,8 +121,6 @@ TorqueServer::submit(const std::string& scriptPath,
   unlink(scriptTmp);
   struct batch_status *p_status = pbs_statjob(connect, jobId, NULL, NULL);
 
-  pbs_disconnect(connect);
-
   if (p_status != NULL) {
     jobSteps.getJobs().push_back(new TMS_Data::Job());
     fillJobInfo(*(jobSteps.getJobs().get(0)), p_status);
@@ -323,11 +323,8 @@ TorqueServer::pbs_cancel(const char* jobId,
     }
   }
 
-  if(isLocal) {
-    connect = cnt2server(serverOut);
-  } else {
-    connect = cnt2server(remoteServer);
-  }
+  PbsConnection connection(isLocal ? std::string(serverOut) : std::string(remoteServer));
+  connect = connection.get();
 
   if (connect <= 0)
   {
@@ -349,26 +346,22 @@ TorqueServer::pbs_cancel(const char* jobId,
     } else {
       pbs_del_error <<  "TORQUE ERROR: pbs_deljob: Server returned error " << pbs_errno << " for job " << tmsJobIdOut << std::endl;
     }
-    pbs_disconnect(connect);
     throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR, pbs_del_error.str());
   } else if (stat && (pbs_errno == PBSE_UNKJOBID) && isLocal ) {
     if (locate_job(tmsJobIdOut, serverOut, remoteServer)) {
-      pbs_disconnect(connect);
+      // the connection is given back before the request to the other server
+      connection.release();
       pbs_cancel(tmsJobId,  remoteServer, false);
       return 0;
     }
 
     pbs_del_error << "Unknown JobId " << tmsJobIdOut << std::endl;
-    pbs_disconnect(connect);
     throw TMSVishnuException(ERRCODE_UNKNOWN_JOBID, pbs_del_error.str());
 
   } else if(pbs_errno == PBSE_UNKJOBID) {
     pbs_del_error << "Unknown JobId " << tmsJobIdOut << std::endl;
-    pbs_disconnect(connect);
     throw TMSVishnuException(ERRCODE_UNKNOWN_JOBID, pbs_del_error.str());
   }
-
-  pbs_disconnect(connect);
   return 0;
 }
 
@@ -397,13 +390,16 @@ TorqueServer::getJobState(const std::string& jobId) {
   }
 
   // Connect to the torque server
-  connect = cnt2server(serverOut);
+  PbsConnection connection(serverOut);
+  connect = connection.get();
 
   if(connect <= 0) {
     return -1;
   } else {
     p_status = pbs_statjob(connect, tmsJobIdOut, NULL, NULL);
-    pbs_disconnect(connect);
+    if (p_status == NULL && connection.reconnectOnError(pbs_errno)) {
+      p_status = pbs_statjob(connection.get(), tmsJobIdOut, NULL, NULL);
+    }
   }
 
   if(p_status!=NULL) {
@@ -420,6 +416,62 @@ TorqueServer::getJobState(const std::string& jobId) {
   return state;
 }
 
+/**
+ * \brief Function to get the status of several jobs with a single request
+ * to the server
+ * \param jobIds the identifiers of the jobs
+ * \return the status of the jobs, by identifier
+ */
+std::map<std::string, int>
+TorqueServer::getJobStates(const std::vector<std::string>& jobIds) {
+  std::map<std::string, int> states;
+  if (jobIds.empty()) {
+    return states;
+  }
+
+  // Connect to the default torque server, as getJobState does
+  serverOut[0] = '\0';
+  PbsConnection connection(serverOut);
+  int connect = connection.get();
+  if (connect <= 0) {
+    throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR,
+                             "TORQUE ERROR: cannot connect to the server");
+  }
+
+  // only the state of the jobs is requested, an empty identifier selects
+  // all the jobs of the server
+  struct attrl stateAttr;
+  memset(&stateAttr, 0, sizeof(stateAttr));
+  stateAttr.name = const_cast<char*>(ATTR_state);
+  char allJobs[] = "";
+  struct batch_status *p_status = pbs_statjob(connect, allJobs, &stateAttr, NULL);
+  if (p_status == NULL && connection.reconnectOnError(pbs_errno)) {
+    p_status = pbs_statjob(connection.get(), allJobs, &stateAttr, NULL);
+  }
+  int error = pbs_errno;
+  if (p_status == NULL && error != PBSE_NONE) {
+    throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR,
+                             "TORQUE ERROR: pbs_statjob: "+vishnu::convertToString(error));
+  }
+
+  // the jobs are identified by their sequence number, the server name may
+  // be written differently
+  std::map<std::string, int> serverStates;
+  for (struct batch_status *p = p_status; p != NULL; p = p->next) {
+    for (struct attrl *a = p->attribs; a != NULL; a = a->next) {
+      if (!strcmp(a->name, ATTR_state)) {
+        std::string name(p->name);
+        serverStates[name.substr(0, name.find('.'))] = convertTorqueStateToVishnuState(std::string(a->value));
+        break;
+      }
+    }
+  }
+  pbs_statfree(p_status);
+
+  // the jobs no longer known by the server are terminated
+  return matchJobStates(jobIds, serverStates, vishnu::STATE_COMPLETED);
+}
+
 /**
  * \brief Function to get the start time of the job
  * \param jobId the identifier of the job
@@ -445,13 +497,16 @@ TorqueServer::getJobStartTime(const std::string& jobId) {
   }
 
   // Connect to the torque server
-  connect = cnt2server(serverOut);
+  PbsConnection connection(serverOut);
+  connect = connection.get();
 
   if(connect <= 0) {
     return 0;
   } else {
     p_status = pbs_statjob(connect, tmsJobIdOut, NULL, NULL);
-    pbs_disconnect(connect);
+    if (p_status == NULL && connection.reconnectOnError(pbs_errno)) {
+      p_status = pbs_statjob(connection.get(), tmsJobIdOut, NULL, NULL);
+    }
   }
 
   if(p_status!=NULL) {
@@ -697,7 +752,8 @@ TorqueServer::listQueues(const std::string& optqueueName) {
 
   serverOut[0] = '\0'; //le bon a recuperer dans la base vishnu
   // Connect to the torque server
-  connect = cnt2server(serverOut);
+  PbsConnection connection(serverOut);
+  connect = connection.get();
 
   if (connect <= 0)
   {
@@ -713,11 +769,14 @@ TorqueServer::listQueues(const std::string& optqueueName) {
 
 
   struct batch_status *p_status;
-  if(optqueueName.size()!=0) {
-    p_status = pbs_statque(connect, strdup(optqueueName.c_str()), NULL, NULL);
-  } else {
-    p_status = pbs_statque(connect, NULL, NULL, NULL);
+  // the same copy of the name serves the request sent again
+  char* queueName = optqueueName.empty() ? NULL : strdup(optqueueName.c_str());
+  p_status = pbs_statque(connect, queueName, NULL, NULL);
+  if (p_status == NULL && connection.reconnectOnError(pbs_errno)) {
+    connect = connection.get();
+    p_status = pbs_statque(connect, queueName, NULL, NULL);
   }
+  free(queueName);
 
   if(p_status==NULL)
   {
@@ -730,13 +789,9 @@ TorqueServer::listQueues(const std::string& optqueueName) {
     else {
       errorMsg = "TORQUE: pbs_statque: getting status of server\n";
     }
-
-    pbs_disconnect(connect);
     throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR, errorMsg);
   }
 
-  pbs_disconnect(connect);
-
   int nbRunningJobs = 0;
   int nbJobsInQueue = 0;
   struct batch_status *p;
@@ -1107,7 +1162,8 @@ TorqueServer::convertTorqueMem(const std::string& memStr) {
 void TorqueServer::fillListOfJobs(TMS_Data::ListJobs*& listOfJobs,
                                   const std::vector<string>& ignoredIds) {
 
-  int connect = cnt2server(serverOut);
+  PbsConnection connection(serverOut);
+  int connect = connection.get();
 
   if (connect <= 0)
   {
@@ -1125,7 +1181,9 @@ void TorqueServer::fillListOfJobs(TMS_Data::ListJobs*& listOfJobs,
   }
 
   struct batch_status* p_status = pbs_selstat(connect, NULL, NULL);
-  pbs_disconnect(connect);
+  if (p_status == NULL && connection.reconnectOnError(pbs_errno)) {
+    p_status = pbs_selstat(connection.get(), NULL, NULL);
+  }
 
   if(p_status != NULL) {
     int jobStatus;
@@ -1212,7 +1270,8 @@ TorqueServer::queuesResourceMin(const std::string& optqueueName) {
 
   serverOut[0] = '\0'; //le bon a recuperer dans la base vishnu
   // Connect to the torque server
-  connect = cnt2server(serverOut);
+  PbsConnection connection(serverOut);
+  connect = connection.get();
 
   if (connect <= 0)
   {
@@ -1228,11 +1287,14 @@ TorqueServer::queuesResourceMin(const std::string& optqueueName) {
 
 
   struct batch_status *p_status;
-  if(optqueueName.size()!=0) {
-    p_status = pbs_statque(connect, strdup(optqueueName.c_str()), NULL, NULL);
-  } else {
-    p_status = pbs_statque(connect, NULL, NULL, NULL);
-  }
+  // the same copy of the name serves the request sent again
+  char* queueName = optqueueName.empty() ? NULL : strdup(optqueueName.c_str());
+  p_status = pbs_statque(connect, queueName, NULL, NULL);
+  if (p_status == NULL && connection.reconnectOnError(pbs_errno)) {
+    connect = connection.get();
+    p_status = pbs_statque(connect, queueName, NULL, NULL);
+  }
+  free(queueName);
   if(p_status==NULL)
   {
     char* errmsg = pbs_geterrmsg(connect);
@@ -1244,13 +1306,9 @@ TorqueServer::queuesResourceMin(const std::string& optqueueName) {
     else {
       errorMsg = "TORQUE: pbs_statque: getting status of server\n";
     }
-
-    pbs_disconnect(connect);
     throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR, errorMsg);
   }
 
-  pbs_disconnect(connect);
-
   struct batch_status *p;
   struct attrl *a;
 
@@ -14,6 +14,9 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
 #include <stdlib.h>
 #include <cstring>
 #include <unistd.h>
@@ -25,6 +28,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 #include <boost/lexical_cast.hpp>
+#include <map>
 #include <vector>
 #include <cstdio>
 #include <pwd.h>
@@ -44,151 +48,161 @@ static const char* LIB_HOSTNAME = "VISHNU_SUBMIT_MACHINE_NAME";
 static const char* LIB_NODEFILE = "VISHNU_BATCHJOB_NODEFILE";
 static const char* LIB_NUM_NODES = "VISHNU_BATCHJOB_NUM_NODES";
 
-static vector<struct trameJob> Board;
-
-static volatile bool terminated = false;
+/*
+ * Delay in seconds between the SIGTERM and the SIGKILL of a killed job, and
+ * during which a terminated job is still reported
+ */
+static const time_t GRACE_DELAY = 5;
 
-static volatile sig_atomic_t ChildSigs = 0;
-static volatile sig_atomic_t AlarmSig = 0;
+/*
+ * Maximum number of pending connections and of events handled at once
+ */
+static const int MAX_PENDING_CLIENTS = 128;
+static const int MAX_EVENTS = 64;
 
-static char homeDir[255];
+/*
+ * Actions planned on the jobs at a given time
+ */
+typedef enum {
+  CHECK_WALLTIME = 0,
+  CHECK_KILL,
+  FORGET_JOB
+} deadline_action_t;
 
 /*
- * Function SignalHandler for SIGCHLD
+ * A client connection: the request is read and the response written in
+ * several steps, so that the clients do not wait for each other
  */
+struct Client {
+  struct Request req;
+  size_t received;
+  struct Response ret;
+  size_t sent;
+};
 
-static bool isDead(const struct trameJob& test) {
-  return (test.state == TERMINATED);
-}
+// The jobs by identifier, and the identifiers of the running jobs by pid
+static map<string, struct trameJob> Jobs;
+static map<pid_t, string> JobPids;
 
-static void
-checkJobs() {
-  int taille;
-  bool checkIn5s = false;
-  vector<struct trameJob>::iterator it;
+// The actions planned on the jobs, by date
+static multimap<time_t, pair<string, deadline_action_t> > Deadlines;
 
-  taille = Board.size();
+static map<int, struct Client> Clients;
 
-  // End of Daemon ?
-  if (taille == 0) {
-    terminated = true;
-    return;
-  }
+static bool terminated = false;
 
-  // Clean the Board off Deads Processes
-  Board.erase(std::remove_if(Board.begin(), Board.end(), isDead), Board.end());
+// The signal mask of the daemon before SIGCHLD is blocked, restored in the jobs
+static sigset_t OrigMask;
 
-  if (taille != Board.size()) {
-    checkIn5s = true;
-  }
+static int EpollFd = -1;
+static int SignalFd = -1;
+static int TimerFd = -1;
 
-  // Manage Processes states
-  for (it = Board.begin(); it != Board.end(); ++it) {
-    if (it->state == KILL) {
-      if (kill(it->pid, 0) == -1) {
-        it->state = TERMINATED;
-        unlink(it->scriptPath);
-      }
-    }
-  }
-
-  // Checks for normal ends of process
-  for (it = Board.begin(); it != Board.end(); ++it) {
-    if ( kill(it->pid,0) == -1 ) {
-      it->state = TERMINATED;
-      unlink(it->scriptPath);
-      checkIn5s = true;
-    }
-  }
+static char homeDir[255];
 
-  // Groundwork for futurs signals
-  if (checkIn5s) {
-    ChildSigs = 1;
-    alarm(5);
-  } else {
-    ChildSigs = 0;
-  }
+/*
+ * Plan an action on a job
+ */
+static void
+addDeadline(time_t date, const string& jobId, deadline_action_t action) {
+  Deadlines.insert(make_pair(date, make_pair(jobId, action)));
 }
 
 /*
- * Function signal handler SIGALARM
+ * Arm the timer on the nearest planned action
  */
 static void
-timeStatement() {
-  time_t now;
-  time_t tmp;
-  time_t futur = 0;
-  vector<struct trameJob>::iterator it;
-
-  now = time(NULL);
-
-  // Manage Dangling Processes
-  for (it = Board.begin(); it != Board.end(); ++it) {
-    if (it->state == KILL) {
-      if (kill(it->pid,0) == -1) {
-        it->state = KILL9;
-        kill(it->pid,SIGKILL);
-      } else {
-        it->state = TERMINATED;
-        AlarmSig = 0;
-      }
-    }
-  }
-
-  if (AlarmSig == 0) {
-    alarm(5);
-    return;
-  }
-
-  // Manage walclocklimit
-  for (it = Board.begin(); it != Board.end(); ++it) {
-    if (it->maxTime != 0) {
-      if ( (it->startTime + it->maxTime) <= now) {
-        it->state = KILL;
-        kill(it->pid,SIGTERM);
-      } else {
-        tmp = (it->startTime + it->maxTime) - now;
-        if (futur == 0) {
-          futur = tmp;
-        } else {
-          if (tmp < futur) {
-            futur = tmp;
-          }
-        }
-      }
-    }
-  }
+armTimer() {
+  struct itimerspec spec;
 
-  if (futur != 0) {
-    alarm(futur);
+  memset(&spec, 0, sizeof(spec));
+  if (! Deadlines.empty()) {
+    // an absolute date in the past fires at once, 0 would disarm the timer
+    spec.it_value.tv_sec = max(Deadlines.begin()->first, static_cast<time_t>(1));
   }
-  AlarmSig = 0;
+  timerfd_settime(TimerFd, TFD_TIMER_ABSTIME, &spec, NULL);
 }
 
 /*
- * Function System sigchild handler
+ * Function reaping the ended jobs, when SIGCHLD is read from the signalfd
  */
-
 static void
-sigchldHandler(int sig) {
+reapJobs() {
+  struct signalfd_siginfo info;
   int status;
   pid_t childPid;
+  time_t now;
 
+  // the signals pending at once are merged, the whole buffer is drained
+  while (read(SignalFd, &info, sizeof(info)) == sizeof(info)) {
+  }
 
+  now = time(NULL);
   while ((childPid = waitpid(-1, &status, WNOHANG)) > 0) {
-    ChildSigs = 1;
+    map<pid_t, string>::iterator pidIt = JobPids.find(childPid);
+    if (pidIt == JobPids.end()) {
+      continue;
+    }
+    map<string, struct trameJob>::iterator jobIt = Jobs.find(pidIt->second);
+    if (jobIt != Jobs.end()) {
+      jobIt->second.state = TERMINATED;
+      unlink(jobIt->second.scriptPath);
+      // the state is still reported for a while, then the job is forgotten
+      addDeadline(now + GRACE_DELAY, jobIt->first, FORGET_JOB);
+    }
+    JobPids.erase(pidIt);
   }
+  armTimer();
 }
 
 /*
- * Function System sigalarm handler
+ * Function enforcing the wallclocklimits and the kills, when the timerfd expires
  */
-
 static void
-sigalarmHandler(int sig) {
-  AlarmSig = 1;
-}
+timeStatement() {
+  uint64_t expirations;
+  time_t now;
 
+  read(TimerFd, &expirations, sizeof(expirations));
+
+  now = time(NULL);
+  while (! Deadlines.empty() && Deadlines.begin()->first <= now) {
+    string jobId = Deadlines.begin()->second.first;
+    deadline_action_t action = Deadlines.begin()->second.second;
+    Deadlines.erase(Deadlines.begin());
+
+    map<string, struct trameJob>::iterator it = Jobs.find(jobId);
+    if (it == Jobs.end()) {
+      continue;
+    }
+    struct trameJob& job = it->second;
+
+    switch (action) {
+    case CHECK_WALLTIME:
+      if (job.state == RUNNING) {
+        job.state = KILL;
+        kill(job.pid, SIGTERM);
+        addDeadline(now + GRACE_DELAY, jobId, CHECK_KILL);
+      }
+      break;
+    case CHECK_KILL:
+      // the job ignored SIGTERM
+      if (job.state == KILL && JobPids.count(job.pid) != 0) {
+        job.state = KILL9;
+        kill(job.pid, SIGKILL);
+      }
+      break;
+    case FORGET_JOB:
+      if (job.state == TERMINATED) {
+        Jobs.erase(it);
+      }
+      break;
+    default:
+      break;
+    }
+  }
+  armTimer();
+}
 
 static int
 daemonize() {
@@ -296,6 +310,9 @@ execCommand( const boost::filesystem::path &command,
   if ((pid = fork()) == 0) {
     int fd;
 
+    // SIGCHLD is read from a signalfd by the daemon, not by the job
+    sigprocmask(SIG_SETMASK, &OrigMask, NULL);
+
     envJobId = boost::lexical_cast<string>(geteuid());
     envJobId.push_back('-');
     envJobId.append(boost::lexical_cast<string>(getpid()));
@@ -368,7 +385,7 @@ openSocketServer(const char* socketName) {
   }
 
   // Socket UNIX
-  sfd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sfd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
   if (sfd == -1) {
     return -2;
   }
@@ -385,38 +402,13 @@ openSocketServer(const char* socketName) {
     return -4;
   }
 
-  if (listen(sfd, 5) == -1) {
+  if (listen(sfd, MAX_PENDING_CLIENTS) == -1) {
     return -5;
   }
 
   return sfd;
 }
 
-static int
-acceptRequest(int sfd, struct Request* req) {
-  int cfd;
-
-  while ( (cfd = accept(sfd,NULL,NULL)) < 0) {
-    if (errno != EINTR) {
-      return -7;
-    }
-    if ( ChildSigs == 1) {
-      checkJobs();
-    }
-    if ( AlarmSig == 1) {
-      timeStatement();
-    }
-    if (terminated) {
-      return -1;
-    }
-  }
-
-  // A voir gestion retour et erreur
-  read(cfd, req, sizeof(struct Request));
-
-  return cfd;
-}
-
 static int
 requestEcho(struct Request* req, struct Response* ret) {
   memcpy(ret->data.echo.data, req->data.echo.data, sizeof(ret->data.echo));
@@ -427,12 +419,11 @@ requestEcho(struct Request* req, struct Response* ret) {
 
 static int
 requestSubmit(struct Request* req, struct Response* ret) {
-  sigset_t blockMask;
-  sigset_t emptyMask;
   struct trameJob currentState;
   boost::filesystem::path fout;
   boost::filesystem::path ferr;
   int wallclocklimit;
+  int status;
   std::map<std::string, std::string> context;
   boost::system::error_code ec;
   const boost::filesystem::path foutName("VISHNU-%%%%%%.out");
@@ -444,10 +435,7 @@ requestSubmit(struct Request* req, struct Response* ret) {
   boost::filesystem::path tmpScript;
   boost::filesystem::path workDir;
 
-  sigemptyset(&emptyMask);
-
-  sigemptyset(&blockMask);
-  sigaddset(&blockMask, SIGCHLD);
+  memset(&currentState, 0, sizeof(struct trameJob));
 
   POSIXParser::parseFile(req->data.submit.cmd, context);
 
@@ -493,16 +481,22 @@ requestSubmit(struct Request* req, struct Response* ret) {
     workDir = homeDir;
   }
 
-  sigprocmask(SIG_SETMASK, &blockMask, NULL);
-
-  execCommand(fileScript, fout, ferr, workDir, &currentState, wallclocklimit);
-
-  sigprocmask(SIG_SETMASK, &emptyMask, NULL);
+  // SIGCHLD stays blocked, the job cannot be reaped before it is indexed
+  status = execCommand(fileScript, fout, ferr, workDir, &currentState, wallclocklimit);
+  if (status < 0) {
+    unlink(fileScript.c_str());
+    memset(&(ret->data.submit), 0, sizeof(struct trameJob));
+    return status;
+  }
 
   strncpy(currentState.scriptPath,fileScript.c_str(),sizeof(currentState.scriptPath));
-  Board.push_back(currentState);
+  Jobs[currentState.jobId] = currentState;
+  JobPids[currentState.pid] = currentState.jobId;
 
-  AlarmSig = 1;
+  if (currentState.maxTime > 0) {
+    addDeadline(currentState.startTime + currentState.maxTime, currentState.jobId, CHECK_WALLTIME);
+    armTimer();
+  }
 
   ret->data.submit = currentState;
 
@@ -511,63 +505,185 @@ requestSubmit(struct Request* req, struct Response* ret) {
 
 static int
 requestCancel(struct Request* req, struct Response* ret) {
-  char* jobId;
-  int i;
-  int taille;
+  string jobId(req->data.cancel.jobId, strnlen(req->data.cancel.jobId, sizeof(req->data.cancel.jobId)));
 
-  jobId = req->data.cancel.jobId;
+  map<string, struct trameJob>::iterator it = Jobs.find(jobId);
+  if (it != Jobs.end() && JobPids.count(it->second.pid) != 0) {
+    kill(it->second.pid,SIGTERM);
+    it->second.state = KILL;
+    addDeadline(time(NULL) + GRACE_DELAY, jobId, CHECK_KILL);
+    armTimer();
+  }
+
+  return 0;
+}
 
-  taille = Board.size();
+static int
+requestGetInfo(struct Request* req, struct Response* ret) {
+  string jobId(req->data.info.jobId, strnlen(req->data.info.jobId, sizeof(req->data.info.jobId)));
 
-  for (i = 0; i < taille; i++) {
-    if (strncmp(jobId, Board[i].jobId, sizeof(Board[i].jobId)) == 0) {
-      kill(Board[i].pid,SIGTERM);
-      Board[i].state = KILL;
-    }
+  map<string, struct trameJob>::const_iterator it = Jobs.find(jobId);
+  if (it != Jobs.end()) {
+    memcpy(&(ret->data.info), &(it->second), sizeof(struct trameJob));
+  } else {
+    memset(&(ret->data.info), 0, sizeof(struct trameJob));
+    ret->data.info.state = DEAD;
   }
 
   return 0;
 }
 
 static int
-requestGetInfo(struct Request* req, struct Response* ret) {
-  char* jobId;
-  int taille;
-  int i;
-  struct trameJob NoJob;
+requestKill(struct Request* req, struct Response* ret) {
+  terminated = true;
+  return 0;
+}
 
-  jobId = req->data.info.jobId;
+/*
+ * Function closing a client connection
+ */
+static void
+closeClient(int cfd) {
+  epoll_ctl(EpollFd, EPOLL_CTL_DEL, cfd, NULL);
+  close(cfd);
+  Clients.erase(cfd);
+}
+
+/*
+ * Function writing the response to a client, the rest is written when the
+ * socket is writable again
+ */
+static void
+writeResponse(int cfd, struct Client& client) {
+  ssize_t nbCharWriten;
+  const char* data = reinterpret_cast<const char*>(&client.ret);
+
+  while (client.sent < sizeof(struct Response)) {
+    nbCharWriten = send(cfd, data + client.sent, sizeof(struct Response) - client.sent, MSG_NOSIGNAL);
+    if (nbCharWriten < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLOUT;
+        ev.data.fd = cfd;
+        epoll_ctl(EpollFd, EPOLL_CTL_MOD, cfd, &ev);
+        return;
+      }
+      break;
+    }
+    client.sent += nbCharWriten;
+  }
+  closeClient(cfd);
+}
+
+/*
+ * Function running a request once it has been read
+ */
+static void
+handleRequest(int cfd, struct Client& client) {
+  struct Request* req = &client.req;
+  struct Response* ret = &client.ret;
+
+  if (strncmp(req->sig, SIGNATURE, sizeof(req->sig)) != 0) {
+    closeClient(cfd);
+    return;
+  }
+
+  if (strncmp(req->req, LB_REQ_ECHO, sizeof(req->req)) == 0) {
+    ret->status = requestEcho(req,ret);
+  }
+  if (strncmp(req->req, LB_REQ_SUBMIT, sizeof(req->req)) == 0) {
+    ret->status = requestSubmit(req,ret);
+  }
+  if (strncmp(req->req, LB_REQ_CANCEL, sizeof(req->req)) == 0) {
+    ret->status = requestCancel(req,ret);
+  }
+  if (strncmp(req->req, LB_REQ_GINFO, sizeof(req->req)) == 0) {
+    ret->status = requestGetInfo(req,ret);
+  }
+  if (strncmp(req->req, LB_REQ_KILL, sizeof(req->req)) == 0) {
+    ret->status = requestKill(req,ret);
+  }
+
+  writeResponse(cfd, client);
+}
 
-  taille = Board.size();
+/*
+ * Function reading the available part of a request
+ */
+static void
+readRequest(int cfd, struct Client& client) {
+  ssize_t nbCharReaden;
+  char* data = reinterpret_cast<char*>(&client.req);
 
-  memset(&NoJob,0,sizeof(struct trameJob));
-  NoJob.state = DEAD;
+  while (client.received < sizeof(struct Request)) {
+    nbCharReaden = read(cfd, data + client.received, sizeof(struct Request) - client.received);
+    if (nbCharReaden < 0 && errno == EINTR) {
+      continue;
+    }
+    if (nbCharReaden < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    if (nbCharReaden <= 0) {
+      closeClient(cfd);
+      return;
+    }
+    client.received += nbCharReaden;
+  }
+  handleRequest(cfd, client);
+}
 
-  for (i = 0; i<taille; i++) {
-    if (strncmp(jobId,Board[i].jobId,sizeof(Board[i].jobId)) == 0) {
-      memcpy(&(ret->data.info),&(Board[i]), sizeof(struct trameJob));
-      return 0;
+/*
+ * Function accepting the pending connections
+ */
+static int
+acceptClients(int sfd) {
+  int cfd;
+  struct epoll_event ev;
+
+  while ((cfd = accept4(sfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = cfd;
+    if (epoll_ctl(EpollFd, EPOLL_CTL_ADD, cfd, &ev) == -1) {
+      close(cfd);
+      continue;
     }
+    struct Client& client = Clients[cfd];
+    memset(&client, 0, sizeof(struct Client));
   }
-  memcpy(&(ret->data.info),&NoJob,sizeof(struct trameJob));
 
+  if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR
+      && errno != ECONNABORTED && errno != EMFILE && errno != ENFILE) {
+    return -7;
+  }
   return 0;
 }
 
+/*
+ * Function registering a descriptor in the event loop
+ */
 static int
-requestKill(struct Request* req, struct Response* ret) {
-  terminated = true;
-  return 0;
+watchFd(int fd) {
+  struct epoll_event ev;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.fd = fd;
+  return epoll_ctl(EpollFd, EPOLL_CTL_ADD, fd, &ev);
 }
 
 
 void
 launchDaemon() {
-  struct sigaction sa;
   int sfd;
-  int cfd;
-  struct Request req;
-  struct Response ret;
+  int nbEvents;
+  struct epoll_event events[MAX_EVENTS];
+  sigset_t childMask;
+  bool jobsSubmitted = false;
   char name_sock[255];
   uid_t euid;
   struct passwd* lpasswd;
@@ -586,17 +702,17 @@ launchDaemon() {
 
   daemonize();
 
-  sigemptyset(&sa.sa_mask);
-  sa.sa_flags = 0;
-  sa.sa_handler = sigchldHandler;
-  if (sigaction(SIGCHLD, &sa, NULL) == -1) {
+  // the ends of the jobs are read from a signalfd, in the event loop
+  sigemptyset(&childMask);
+  sigaddset(&childMask, SIGCHLD);
+  if (sigprocmask(SIG_BLOCK, &childMask, &OrigMask) == -1) {
     exit(6);
   }
 
-  sigemptyset(&sa.sa_mask);
-  sa.sa_flags = 0;
-  sa.sa_handler = sigalarmHandler;
-  if (sigaction(SIGALRM, &sa, NULL) == -1) {
+  SignalFd = signalfd(-1, &childMask, SFD_NONBLOCK | SFD_CLOEXEC);
+  TimerFd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+  EpollFd = epoll_create1(EPOLL_CLOEXEC);
+  if (SignalFd == -1 || TimerFd == -1 || EpollFd == -1) {
     exit(6);
   }
 
@@ -605,42 +721,48 @@ launchDaemon() {
     exit(-sfd);
   }
 
-  for (terminated = false; ! terminated ; ) {
-    cfd = acceptRequest(sfd, &req);
+  if (watchFd(sfd) == -1 || watchFd(SignalFd) == -1 || watchFd(TimerFd) == -1) {
+    exit(6);
+  }
 
-    if (cfd < 0) {
+  for (terminated = false; ! terminated ; ) {
+    // End of Daemon once the jobs are over and forgotten
+    jobsSubmitted = jobsSubmitted || ! Jobs.empty();
+    if (jobsSubmitted && Jobs.empty() && Clients.empty()) {
       break;
     }
 
-    if (strncmp(req.sig, SIGNATURE, sizeof(req.sig)) != 0) {
-      continue;
-    }
-
-    if (strncmp(req.req, LB_REQ_ECHO, sizeof(req.req)) == 0) {
-      ret.status = requestEcho(&req,&ret);
-    }
-    if (strncmp(req.req, LB_REQ_SUBMIT, sizeof(req.req)) == 0) {
-      ret.status = requestSubmit(&req,&ret);
-    }
-    if (strncmp(req.req, LB_REQ_CANCEL, sizeof(req.req)) == 0) {
-      ret.status = requestCancel(&req,&ret);
-    }
-    if (strncmp(req.req, LB_REQ_GINFO, sizeof(req.req)) == 0) {
-      ret.status = requestGetInfo(&req,&ret);
-    }
-    if (strncmp(req.req, LB_REQ_KILL, sizeof(req.req)) == 0) {
-      ret.status = requestKill(&req,&ret);
+    nbEvents = epoll_wait(EpollFd, events, MAX_EVENTS, -1);
+    if (nbEvents < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
     }
 
-    write(cfd,&ret,sizeof(struct Response));
+    for (int i = 0; i < nbEvents; ++i) {
+      int fd = events[i].data.fd;
 
-    close(cfd);
-
-    if ( ChildSigs == 1) {
-      checkJobs();
-    }
-    if ( AlarmSig == 1) {
-      timeStatement();
+      if (fd == sfd) {
+        if (acceptClients(sfd) < 0) {
+          terminated = true;
+        }
+      } else if (fd == SignalFd) {
+        reapJobs();
+      } else if (fd == TimerFd) {
+        timeStatement();
+      } else {
+        // the client may have been closed by a previous event
+        map<int, struct Client>::iterator it = Clients.find(fd);
+        if (it == Clients.end()) {
+          continue;
+        }
+        if (it->second.received < sizeof(struct Request)) {
+          readRequest(fd, it->second);
+        } else {
+          writeResponse(fd, it->second);
+        }
+      }
     }
   }
   unlink(name_sock);
@@ -94,7 +94,7 @@ main(int argc, char* argv[]) {
     throw UMSVishnuException(ERRCODE_INVALID_PARAM, msg);
   }
 
-  BatchServer* batchServer;
+  boost::shared_ptr<BatchServer> batchServer;
   try {
     //To create batchServer Factory
     BatchFactory factory;
@@ -144,6 +144,6 @@ main(int argc, char* argv[]) {
     vishnu::saveInFile(slaveErrorPath, e.what());
     ret = EXIT_FAILURE;
   }
-  delete batchServer;
+  batchServer.reset();
   return ret;
 }
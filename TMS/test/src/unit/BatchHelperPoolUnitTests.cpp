@@ -0,0 +1,104 @@
+#include <boost/test/unit_test.hpp>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <stdint.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "BatchHelperPool.hpp"
+
+// anonymous namespace
+namespace {
+  /**
+   * \brief A connected pair of sockets, closed at the end of the test
+   */
+  struct SocketPairFixture {
+    SocketPairFixture() {
+      BOOST_REQUIRE_EQUAL(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    }
+
+    ~SocketPairFixture() {
+      closeWriter();
+      close(fds[1]);
+    }
+
+    void
+    closeWriter() {
+      if (fds[0] >= 0) {
+        close(fds[0]);
+        fds[0] = -1;
+      }
+    }
+
+    void
+    writeHeader(uint32_t size, char kind) {
+      char header[5];
+      uint32_t networkSize = htonl(size);
+      memcpy(header, &networkSize, sizeof(networkSize));
+      header[4] = kind;
+      BOOST_REQUIRE_EQUAL(write(fds[0], header, sizeof(header)), static_cast<ssize_t>(sizeof(header)));
+    }
+
+    int fds[2];
+  };
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( BatchHelperPool_unit_tests, SocketPairFixture )
+
+
+BOOST_AUTO_TEST_CASE( test_frame_roundtrip_n )
+{
+  // A frame keeps its kind and its payload, binary data included
+  std::string payload("job\0output\xff", 11);
+  BOOST_REQUIRE(BatchHelperPool::writeFrame(fds[0], 'R', payload));
+  BOOST_REQUIRE(BatchHelperPool::writeFrame(fds[0], 'E', ""));
+
+  char kind = 0;
+  std::string received;
+  BOOST_REQUIRE(BatchHelperPool::readFrame(fds[1], kind, received));
+  BOOST_REQUIRE_EQUAL(kind, 'R');
+  BOOST_REQUIRE(received == payload);
+  BOOST_REQUIRE(BatchHelperPool::readFrame(fds[1], kind, received));
+  BOOST_REQUIRE_EQUAL(kind, 'E');
+  BOOST_REQUIRE(received.empty());
+}
+
+BOOST_AUTO_TEST_CASE( test_write_oversized_b )
+{
+  // A payload above the limit is refused before anything is sent
+  std::string payload(BATCH_HELPER_MAX_FRAME_SIZE + 1, 'x');
+  BOOST_REQUIRE(! BatchHelperPool::writeFrame(fds[0], 'Q', payload));
+  BOOST_REQUIRE_EQUAL(errno, EMSGSIZE);
+
+  char byte;
+  BOOST_REQUIRE_EQUAL(recv(fds[1], &byte, 1, MSG_DONTWAIT), -1);
+}
+
+BOOST_AUTO_TEST_CASE( test_read_oversized_b )
+{
+  // A header announcing a payload above the limit is rejected
+  writeHeader(BATCH_HELPER_MAX_FRAME_SIZE + 1, 'R');
+  char kind;
+  std::string received;
+  BOOST_REQUIRE(! BatchHelperPool::readFrame(fds[1], kind, received));
+  BOOST_REQUIRE_EQUAL(errno, EMSGSIZE);
+}
+
+BOOST_AUTO_TEST_CASE( test_read_truncated_b )
+{
+  // A peer gone before the end of the payload gives no frame
+  writeHeader(10, 'R');
+  BOOST_REQUIRE_EQUAL(write(fds[0], "abc", 3), 3);
+  closeWriter();
+  char kind;
+  std::string received;
+  BOOST_REQUIRE(! BatchHelperPool::readFrame(fds[1], kind, received));
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// THE END
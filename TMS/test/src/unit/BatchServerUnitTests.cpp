@@ -0,0 +1,117 @@
+#include <boost/test/unit_test.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "BatchServer.hpp"
+#include "TMSVishnuException.hpp"
+#include "constants.hpp"
+
+// anonymous namespace
+namespace {
+  /**
+   * \brief A batch server knowing the state of some jobs, the others fail
+   */
+  class FakeBatchServer : public BatchServer {
+  public:
+    std::map<std::string, int> states;
+
+    int
+    submit(const std::string&, const TMS_Data::SubmitOptions&, TMS_Data::ListJobs&, char**) {
+      return 0;
+    }
+
+    int
+    cancel(const std::string&) {
+      return 0;
+    }
+
+    int
+    getJobState(const std::string& jobId) {
+      std::map<std::string, int>::const_iterator found = states.find(jobId);
+      if (found == states.end()) {
+        throw TMSVishnuException(ERRCODE_BATCH_SCHEDULER_ERROR, "unreachable server");
+      }
+      return found->second;
+    }
+
+    time_t
+    getJobStartTime(const std::string&) {
+      return 0;
+    }
+
+    TMS_Data::ListQueues*
+    listQueues(const std::string&) {
+      return NULL;
+    }
+
+    void
+    fillListOfJobs(TMS_Data::ListJobs*&, const std::vector<std::string>&) {
+    }
+  };
+
+  std::vector<std::string>
+  makeIds(const std::string& first, const std::string& second, const std::string& third) {
+    std::vector<std::string> jobIds;
+    jobIds.push_back(first);
+    jobIds.push_back(second);
+    jobIds.push_back(third);
+    return jobIds;
+  }
+}
+
+
+BOOST_AUTO_TEST_SUITE( BatchServer_unit_tests )
+
+
+BOOST_AUTO_TEST_CASE( test_getJobStates_n )
+{
+  // The jobs are asked one by one, the ones which fail are missing
+  FakeBatchServer server;
+  server.states["12"] = vishnu::STATE_RUNNING;
+  server.states["13"] = vishnu::STATE_COMPLETED;
+
+  std::map<std::string, int> states = server.getJobStates(makeIds("12", "13", "14"));
+
+  BOOST_REQUIRE_EQUAL(states.size(), 2);
+  BOOST_REQUIRE_EQUAL(states["12"], vishnu::STATE_RUNNING);
+  BOOST_REQUIRE_EQUAL(states["13"], vishnu::STATE_COMPLETED);
+  BOOST_REQUIRE(states.find("14") == states.end());
+}
+
+BOOST_AUTO_TEST_CASE( test_matchJobStates_n )
+{
+  // The jobs are matched by their sequence number, whatever the server name
+  std::map<std::string, int> serverStates;
+  serverStates["12"] = vishnu::STATE_RUNNING;
+  serverStates["13"] = vishnu::STATE_RUNNING;
+
+  std::map<std::string, int> states =
+    BatchServer::matchJobStates(makeIds("12.master", "13.master.example.com", "12"),
+                                serverStates, vishnu::STATE_COMPLETED);
+
+  BOOST_REQUIRE_EQUAL(states.size(), 3);
+  BOOST_REQUIRE_EQUAL(states["12.master"], vishnu::STATE_RUNNING);
+  BOOST_REQUIRE_EQUAL(states["13.master.example.com"], vishnu::STATE_RUNNING);
+  BOOST_REQUIRE_EQUAL(states["12"], vishnu::STATE_RUNNING);
+}
+
+BOOST_AUTO_TEST_CASE( test_matchJobStates_b )
+{
+  // The jobs the server no longer reports get the given state
+  std::map<std::string, int> serverStates;
+  serverStates["12"] = vishnu::STATE_RUNNING;
+
+  std::map<std::string, int> states =
+    BatchServer::matchJobStates(makeIds("12.master", "120.master", "1.master"),
+                                serverStates, vishnu::STATE_COMPLETED);
+
+  BOOST_REQUIRE_EQUAL(states["12.master"], vishnu::STATE_RUNNING);
+  BOOST_REQUIRE_EQUAL(states["120.master"], vishnu::STATE_COMPLETED);
+  BOOST_REQUIRE_EQUAL(states["1.master"], vishnu::STATE_COMPLETED);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// THE END
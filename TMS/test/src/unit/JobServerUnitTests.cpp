@@ -0,0 +1,129 @@
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+
+#include "JobServer.hpp"
+#include "api_tms.hpp"
+#include "UserException.hpp"
+
+// anonymous namespace
+namespace {
+  /**
+   * \brief The jobs of each request, as a flat list of their indexes
+   */
+  std::vector<size_t>
+  flatten(const std::vector<std::vector<size_t> >& requests) {
+    std::vector<size_t> jobs;
+    for (size_t i = 0; i < requests.size(); ++i) {
+      jobs.insert(jobs.end(), requests[i].begin(), requests[i].end());
+    }
+    return jobs;
+  }
+}
+
+
+BOOST_AUTO_TEST_SUITE( JobServer_unit_tests )
+
+
+BOOST_AUTO_TEST_CASE( test_submitJobs_empty_b )
+{
+  // An empty list of jobs is rejected before anything is sent
+  TMS_Data::ListJobs jobs;
+  TMS_Data::SubmitOptions options;
+  BOOST_REQUIRE_THROW(vishnu::submitJobs("sessionkey_1", "/tmp/script.sh", std::vector<std::string>(),
+                                         jobs, options),
+                      UserException);
+  BOOST_REQUIRE_EQUAL(jobs.getJobs().size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( test_checkJobCount_n )
+{
+  // A submission holds between 1 and MAX_JOBS_PER_SUBMISSION jobs
+  BOOST_REQUIRE_NO_THROW(JobServer::checkJobCount(1));
+  BOOST_REQUIRE_NO_THROW(JobServer::checkJobCount(MAX_JOBS_PER_SUBMISSION));
+}
+
+BOOST_AUTO_TEST_CASE( test_checkJobCount_b )
+{
+  // An empty submission or one above the limit is rejected
+  BOOST_REQUIRE_THROW(JobServer::checkJobCount(0), UserException);
+  BOOST_REQUIRE_THROW(JobServer::checkJobCount(MAX_JOBS_PER_SUBMISSION + 1), UserException);
+}
+
+BOOST_AUTO_TEST_CASE( test_splitHelperRequests_job_count_n )
+{
+  // The requests hold at most MAX_JOBS_PER_HELPER_REQUEST jobs, in order
+  const size_t nbJobs = 2 * MAX_JOBS_PER_HELPER_REQUEST + 1;
+  std::vector<size_t> jobSizes(nbJobs, 10);
+  std::vector<std::string> errors(nbJobs);
+  std::vector<std::vector<size_t> > requests;
+  JobServer::splitHelperRequests(jobSizes, errors, 1000000, requests);
+
+  BOOST_REQUIRE_EQUAL(requests.size(), 3);
+  BOOST_REQUIRE_EQUAL(requests[0].size(), MAX_JOBS_PER_HELPER_REQUEST);
+  BOOST_REQUIRE_EQUAL(requests[1].size(), MAX_JOBS_PER_HELPER_REQUEST);
+  BOOST_REQUIRE_EQUAL(requests[2].size(), 1);
+  std::vector<size_t> jobs = flatten(requests);
+  for (size_t job = 0; job < nbJobs; ++job) {
+    BOOST_REQUIRE_EQUAL(jobs[job], job);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_splitHelperRequests_job_count_b )
+{
+  // Exactly MAX_JOBS_PER_HELPER_REQUEST jobs fit in a single request
+  std::vector<size_t> jobSizes(MAX_JOBS_PER_HELPER_REQUEST, 10);
+  std::vector<std::string> errors(MAX_JOBS_PER_HELPER_REQUEST);
+  std::vector<std::vector<size_t> > requests;
+  JobServer::splitHelperRequests(jobSizes, errors, 1000000, requests);
+  BOOST_REQUIRE_EQUAL(requests.size(), 1);
+  BOOST_REQUIRE_EQUAL(requests[0].size(), MAX_JOBS_PER_HELPER_REQUEST);
+}
+
+BOOST_AUTO_TEST_CASE( test_splitHelperRequests_size_n )
+{
+  // A request is closed when the next job goes above its size, a job
+  // larger than a request is sent alone
+  std::vector<size_t> jobSizes;
+  jobSizes.push_back(40);
+  jobSizes.push_back(60);
+  jobSizes.push_back(1);
+  jobSizes.push_back(500);
+  jobSizes.push_back(30);
+  std::vector<std::string> errors(jobSizes.size());
+  std::vector<std::vector<size_t> > requests;
+  JobServer::splitHelperRequests(jobSizes, errors, 100, requests);
+
+  BOOST_REQUIRE_EQUAL(requests.size(), 4);
+  BOOST_REQUIRE_EQUAL(requests[0].size(), 2);
+  BOOST_REQUIRE_EQUAL(requests[1].size(), 1);
+  BOOST_REQUIRE_EQUAL(requests[1][0], 2);
+  BOOST_REQUIRE_EQUAL(requests[2].size(), 1);
+  BOOST_REQUIRE_EQUAL(requests[2][0], 3);
+  BOOST_REQUIRE_EQUAL(requests[3].size(), 1);
+  BOOST_REQUIRE_EQUAL(requests[3][0], 4);
+}
+
+BOOST_AUTO_TEST_CASE( test_splitHelperRequests_failed_b )
+{
+  // The jobs which failed to be prepared are not sent
+  std::vector<size_t> jobSizes(4, 10);
+  std::vector<std::string> errors(4);
+  errors[1] = "cannot write the script";
+  errors[3] = "cannot write the script";
+  std::vector<std::vector<size_t> > requests;
+  JobServer::splitHelperRequests(jobSizes, errors, 1000000, requests);
+  BOOST_REQUIRE_EQUAL(requests.size(), 1);
+  BOOST_REQUIRE_EQUAL(requests[0].size(), 2);
+  BOOST_REQUIRE_EQUAL(requests[0][0], 0);
+  BOOST_REQUIRE_EQUAL(requests[0][1], 2);
+
+  errors.assign(4, "cannot write the script");
+  JobServer::splitHelperRequests(jobSizes, errors, 1000000, requests);
+  BOOST_REQUIRE(requests.empty());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// THE END
@@ -1,4 +1,5 @@
 #include <boost/test/unit_test.hpp>
+#include <set>
 #include <string>
 #include <boost/format.hpp>
 #include <cstdlib>
@@ -26,9 +27,10 @@ BOOST_AUTO_TEST_CASE( test_processOptions_no_options )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
 
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
-  listJobServer.processOptions(options, test_sql);
+  listJobServer.processOptions(options, test_sql, params);
   BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and job.status < 5");
 }
 
@@ -37,11 +39,13 @@ BOOST_AUTO_TEST_CASE( test_processOptions_nbCpu )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
 
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
   options->setNbCpu(3);
-  listJobServer.processOptions(options, test_sql);
-  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and nbCpus='3' and job.status < 5");
+  listJobServer.processOptions(options, test_sql, params);
+  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and nbCpus=$1 and job.status < 5");
+  BOOST_CHECK_EQUAL(params.getInteger(0), 3);
 }
 
 BOOST_AUTO_TEST_CASE( test_processOptions_Bad_Nbcpu )
@@ -49,9 +53,10 @@ BOOST_AUTO_TEST_CASE( test_processOptions_Bad_Nbcpu )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
   options->setNbCpu(-2);
-  BOOST_CHECK_THROW(listJobServer.processOptions(options, test_sql) , UserException );
+  BOOST_CHECK_THROW(listJobServer.processOptions(options, test_sql, params) , UserException );
 
 }
 
@@ -60,12 +65,14 @@ BOOST_AUTO_TEST_CASE( test_processOptions_FromSubmitDate )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
   time_t test = 1121211221;
   options->setFromSubmitDate(test);
-  listJobServer.processOptions(options, test_sql);
+  listJobServer.processOptions(options, test_sql, params);
   std::string tmp = boost::posix_time::to_iso_string(boost::posix_time::from_time_t(vishnu::convertUTCtimeINLocaltime(test)));
-  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and submitDate >= '"+tmp+"' and job.status < 5");
+  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and submitDate >= $1 and job.status < 5");
+  BOOST_CHECK_EQUAL(params.getValue(0), tmp);
 
 }
 
@@ -74,9 +81,10 @@ BOOST_AUTO_TEST_CASE( test_processOptions_Bad_FromSubmitDate )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
   options->setFromSubmitDate(-1);
-  listJobServer.processOptions(options, test_sql);
+  listJobServer.processOptions(options, test_sql, params);
   BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and job.status < 5");
 
 }
@@ -86,12 +94,14 @@ BOOST_AUTO_TEST_CASE( test_processOptions_ToSubmitDate )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
   time_t test = 1121211221;
   options->setToSubmitDate(test);
-  listJobServer.processOptions(options, test_sql);
+  listJobServer.processOptions(options, test_sql, params);
   std::string tmp = boost::posix_time::to_iso_string(boost::posix_time::from_time_t(vishnu::convertUTCtimeINLocaltime(test)));
-  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and submitDate <= '"+tmp+"' and job.status < 5");
+  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and submitDate <= $1 and job.status < 5");
+  BOOST_CHECK_EQUAL(params.getValue(0), tmp);
 
 }
 
@@ -100,9 +110,10 @@ BOOST_AUTO_TEST_CASE( test_processOptions_Bad_ToSubmitDate )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
   options->setFromSubmitDate(-1);
-  listJobServer.processOptions(options, test_sql);
+  listJobServer.processOptions(options, test_sql, params);
   BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and job.status < 5");
 
 }
@@ -112,10 +123,12 @@ BOOST_AUTO_TEST_CASE( test_processOptions_JobState )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
   options->setStatus(5);
-  listJobServer.processOptions(options, test_sql);
-  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and job.status='5'");
+  listJobServer.processOptions(options, test_sql, params);
+  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and job.status=$1");
+  BOOST_CHECK_EQUAL(params.getInteger(0), 5);
 
 }
 
@@ -124,9 +137,10 @@ BOOST_AUTO_TEST_CASE( test_processOptions_bad_JobState )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
   options->setStatus(-5);
-  BOOST_CHECK_THROW(listJobServer.processOptions(options, test_sql) , UserException );
+  BOOST_CHECK_THROW(listJobServer.processOptions(options, test_sql, params) , UserException );
 }
 
 BOOST_AUTO_TEST_CASE( test_processOptions_multiple_JobState )
@@ -134,10 +148,29 @@ BOOST_AUTO_TEST_CASE( test_processOptions_multiple_JobState )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
   options->setMultipleStatus("SQWRTCDF");
-  listJobServer.processOptions(options, test_sql);
-  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and (job.status=1 or job.status=2 or job.status=3 or job.status=4 or job.status=5 or job.status=6 or job.status=7 or job.status=8)");
+  listJobServer.processOptions(options, test_sql, params);
+  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and job.status IN (1,2,3,4,5,6,7,8)");
+}
+
+BOOST_AUTO_TEST_CASE( test_processOptions_multiple_JobState_same_request )
+{
+  // the order and the repetitions of the states give the same statement
+  std::string machineId;
+  ListJobServer listJobServer(machineId);
+  std::string first_sql = sqlListOfJobs;
+  std::string second_sql = sqlListOfJobs;
+  SqlParameters params;
+  TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
+  options->setMultipleStatus("RRQ");
+  listJobServer.processOptions(options, first_sql, params);
+  options->setMultipleStatus("QR");
+  listJobServer.processOptions(options, second_sql, params);
+  BOOST_CHECK_EQUAL(first_sql, sqlListOfJobs+" and job.status IN (2,4)");
+  BOOST_CHECK_EQUAL(first_sql, second_sql);
+  BOOST_CHECK_EQUAL(ListJobServer::getStatementName(first_sql), ListJobServer::getStatementName(second_sql));
 }
 
 BOOST_AUTO_TEST_CASE( test_processOptions_bad_multiple_JobState )
@@ -145,9 +178,10 @@ BOOST_AUTO_TEST_CASE( test_processOptions_bad_multiple_JobState )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
   options->setMultipleStatus("hty");
-  BOOST_CHECK_THROW(listJobServer.processOptions(options, test_sql) , UserException );
+  BOOST_CHECK_THROW(listJobServer.processOptions(options, test_sql, params) , UserException );
 }
 
 BOOST_AUTO_TEST_CASE( test_processOptions_JobPriority )
@@ -155,10 +189,12 @@ BOOST_AUTO_TEST_CASE( test_processOptions_JobPriority )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
   options->setPriority(2);
-  listJobServer.processOptions(options, test_sql);
-  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and job.status < 5 and jobPrio='2'");
+  listJobServer.processOptions(options, test_sql, params);
+  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and job.status < 5 and jobPrio=$1");
+  BOOST_CHECK_EQUAL(params.getInteger(0), 2);
 
 }
 
@@ -167,9 +203,10 @@ BOOST_AUTO_TEST_CASE( test_processOptions_bad_JobPriority )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
   options->setPriority(-5);
-  BOOST_CHECK_THROW(listJobServer.processOptions(options, test_sql) , UserException );
+  BOOST_CHECK_THROW(listJobServer.processOptions(options, test_sql, params) , UserException );
 }
 
 BOOST_AUTO_TEST_CASE( test_processOptions_JobOwner )
@@ -177,10 +214,12 @@ BOOST_AUTO_TEST_CASE( test_processOptions_JobOwner )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
   options->setOwner("Unit");
-  listJobServer.processOptions(options, test_sql);
-  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and job.status < 5 and owner='Unit'");
+  listJobServer.processOptions(options, test_sql, params);
+  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and job.status < 5 and owner=$1");
+  BOOST_CHECK_EQUAL(params.getValue(0), "Unit");
 
 }
 
@@ -189,11 +228,79 @@ BOOST_AUTO_TEST_CASE( test_processOptions_WorkId )
   std::string machineId;
   ListJobServer listJobServer(machineId);
   std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
   TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
   options->setWorkId(2);
-  listJobServer.processOptions(options, test_sql);
-  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and job.status < 5 and workId='2'");
+  listJobServer.processOptions(options, test_sql, params);
+  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and job.status < 5 and workId=$1");
+  BOOST_CHECK_EQUAL(params.getInteger(0), 2);
+
+}
 
+BOOST_AUTO_TEST_CASE( test_processPageOptions_first_page )
+{
+  // the jobs without submission date are paged too
+  std::string machineId;
+  ListJobServer listJobServer(machineId);
+  std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
+  TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
+  options->setPageSize(10);
+  listJobServer.processPageOptions(options, test_sql, params);
+  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs);
+}
+
+BOOST_AUTO_TEST_CASE( test_processPageOptions_ResumeToken )
+{
+  std::string machineId;
+  ListJobServer listJobServer(machineId);
+  std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
+  TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
+  options->setPageSize(10);
+  options->setResumeToken("42");
+  listJobServer.processPageOptions(options, test_sql, params);
+  BOOST_CHECK_EQUAL(test_sql, sqlListOfJobs+" and job.numjobid > $1");
+  BOOST_CHECK_EQUAL(params.getInteger(0), 42);
+}
+
+BOOST_AUTO_TEST_CASE( test_processPageOptions_bad_ResumeToken )
+{
+  std::string machineId;
+  ListJobServer listJobServer(machineId);
+  std::string test_sql = sqlListOfJobs;
+  SqlParameters params;
+  TMS_Data::ListJobsOptions_ptr options = new TMS_Data::ListJobsOptions();
+  options->setResumeToken("42:2012-01-01");
+  BOOST_CHECK_THROW(listJobServer.processPageOptions(options, test_sql, params), UserException);
+  options->setResumeToken("99999999999999999999999");
+  BOOST_CHECK_THROW(listJobServer.processPageOptions(options, test_sql, params), UserException);
+  options->setResumeToken("");
+  options->setPageSize(-1);
+  BOOST_CHECK_THROW(listJobServer.processPageOptions(options, test_sql, params), UserException);
+}
+
+BOOST_AUTO_TEST_CASE( test_getStatementName )
+{
+  // the values being bound, the name only depends on the request
+  std::string first = ListJobServer::getStatementName(sqlListOfJobs+" and owner=$1");
+  std::string second = ListJobServer::getStatementName(sqlListOfJobs+" and workId=$1");
+  BOOST_CHECK(first != second);
+  BOOST_CHECK_EQUAL(ListJobServer::getStatementName(sqlListOfJobs+" and owner=$1"), first);
+}
+
+BOOST_AUTO_TEST_CASE( test_getStatementName_evicted )
+{
+  // only the requests used last keep their name, a name is never reused
+  std::string first = ListJobServer::getStatementName(sqlListOfJobs+" and jobQueue=$1");
+  std::set<std::string> names;
+  names.insert(first);
+  for (size_t i = 0; i < MAX_PREPARED_STATEMENTS; ++i) {
+    names.insert(ListJobServer::getStatementName(sqlListOfJobs+" limit "+vishnu::convertToString(i)));
+  }
+  BOOST_CHECK_EQUAL(names.size(), MAX_PREPARED_STATEMENTS + 1);
+  std::string again = ListJobServer::getStatementName(sqlListOfJobs+" and jobQueue=$1");
+  BOOST_CHECK(names.find(again) == names.end());
 }
 
 /*BOOST_AUTO_TEST_CASE( test_list )
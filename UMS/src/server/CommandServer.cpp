@@ -9,6 +9,7 @@
 #include "DbFactory.hpp"
 #include "utilVishnu.hpp"
 #include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
 using namespace vishnu;
 
 /**
@@ -57,21 +58,24 @@ CommandServer::record(CmdType cmdType,
                       std::string startTime,
                       std::string endTime) {
 
-  std::string numsess = msessionServer.getAttribut("WHERE sessionkey='"+msessionServer.getData().getSessionKey()+"'", "numsessionid");
-  std::string sqlCmd = (boost::format("INSERT INTO command (vsession_numsessionid, starttime,"
-                                      "   endtime, description, ctype, status, vishnuobjectid)"
-                                      " VALUES (%1%,%2%,%3%,'%4%',%5%,%6%,'%7%');"
-                                      )
-                        %numsess
-                        %startTime
-                        %endTime
-                        %mdatabaseVishnu->escapeData(mcommand)
-                        %convertToString(cmdType)
-                        %convertToString(cmdStatus)
-                        %mdatabaseVishnu->escapeData(newVishnuObjectID)
-                        ).str();
+  // the times are sql expressions given by the code, the session is looked
+  // up in the same request
+  std::string sqlCmd = "INSERT INTO command (vsession_numsessionid, starttime,"
+                       "   endtime, description, ctype, status, vishnuobjectid)"
+                       " SELECT numsessionid, " + startTime + ", " + endTime + ", $2, $3, $4, $5"
+                       " FROM vsession WHERE sessionkey=$1";
+  std::string statement = "record_command";
+  if (startTime != "CURRENT_TIMESTAMP" || endTime != "CURRENT_TIMESTAMP") {
+    statement = (boost::format("record_command_%1$x") % boost::hash<std::string>()(sqlCmd)).str();
+  }
+  SqlParameters params;
+  params.add(msessionServer.getData().getSessionKey())
+    .add(mcommand)
+    .add(cmdType)
+    .add(cmdStatus)
+    .add(newVishnuObjectID);
 
-  mdatabaseVishnu->process(sqlCmd.c_str());
+  mdatabaseVishnu->processPrepared(statement, sqlCmd, params);
   return 0;
 }
 
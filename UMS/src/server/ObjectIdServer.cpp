@@ -4,6 +4,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include "DbFactory.hpp"
+#include "ObjectIdGenerator.hpp"
 
 ObjectIdServer::ObjectIdServer(const UserServer session):msession(session) {
   DbFactory factory;
@@ -36,6 +37,9 @@ ObjectIdServer::setformat(std::string fmt, std::string entry){
     e.appendMsgComp("Failed to set the "+entry+" format to "+fmt);
     throw(e);
   }
+  // only the cache of this process is dropped, the other processes read the
+  // format again when their cached copy expires
+  ObjectIdGenerator::getInstance().invalidateFormats();
 }
 
 
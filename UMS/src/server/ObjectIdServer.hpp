@@ -30,7 +30,10 @@ public:
    */
   ~ObjectIdServer();
   /**
-   * \brief To set the format of an entry
+   * \brief To set the format of an entry. The identifiers generated by this
+   * process use it at once, the other processes sharing the database use it
+   * once their cached format expires, at most OBJECT_ID_FORMAT_TTL seconds
+   * later
    */
   void
   setformat(std::string fmt, std::string entry);
@@ -200,7 +200,7 @@ int value = convertToInt(moptionValue->getValue());
   }
   //if the option is VISHNU_TRANSFER_CMD
   if (moptionValue->getOptionName().compare(TRANSFERCMD_OPT) == 0) {
-      return ( ( value==0)|| ( value==1)  ) ;
+      return ( ( value==0)|| ( value==1) || ( value==3) ) ;
   }
   //if the option is VISHNU_TRANSFER_TIMEOUT
   if (moptionValue->getOptionName().compare(TRANSFER_TIMEOUT_OPT) == 0) {
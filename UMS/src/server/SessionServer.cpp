@@ -8,6 +8,7 @@
 #include "SessionServer.hpp"
 #include "CommandServer.hpp"
 #include "DbFactory.hpp"
+#include "SessionCache.hpp"
 #include "boost/format.hpp"
 
 
@@ -179,6 +180,7 @@ SessionServer::close() {
         mdatabaseVishnu->process((boost::format("UPDATE vsession"
                                                 " SET closure=CURRENT_TIMESTAMP"
                                                 " WHERE sessionkey='%1%';")%mdatabaseVishnu->escapeData(msession.getSessionKey())).str());
+        SessionCache::getInstance().invalidateSession(msession.getSessionKey());
       } else {
         //To get the close policy associated to the session
         closePolicyStr = (boost::format(" WHERE sessionkey='%1%';")%mdatabaseVishnu->escapeData(msession.getSessionKey())).str();
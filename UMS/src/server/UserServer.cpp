@@ -10,6 +10,7 @@
 #include "DbFactory.hpp"
 #include "DatabaseResult.hpp"
 #include "RequestFactory.hpp"
+#include "SessionCache.hpp"
 #include "LocalAccountServer.hpp"
 #include "utilVishnu.hpp"
 #include "utilServer.hpp"
@@ -140,7 +141,8 @@ UserServer::update(UMS_Data::User *user) {
   if (exist()) {
     if (isAdmin()) {
       //if the user whose information will be updated exists
-      if (! getNumUserId(user->getUserId()).empty()) {
+      std::string numUserId = getNumUserId(user->getUserId());
+      if (! numUserId.empty()) {
 
         //if a new fisrtname has been defined
         if (!user->getFirstname().empty()) {
@@ -210,6 +212,8 @@ UserServer::update(UMS_Data::User *user) {
                         %convertToString(vishnu::SESSION_ACTIVE)).str();
             mdatabaseVishnu->process(sqlquery);
           }
+          // the privilege and the sessions of the user may have changed
+          SessionCache::getInstance().invalidateUser(convertToInt(numUserId));
         }
       } else {
         throw UMSVishnuException (ERRCODE_UNKNOWN_USERID);
@@ -238,7 +242,10 @@ UserServer::deleteUser(UMS_Data::User user) {
                              %vishnu::STATUS_DELETED
                              %mdatabaseVishnu->escapeData(user.getUserId())
                              ).str();
-    return mdatabaseVishnu->process(sqlUpdate.c_str());
+    ret = mdatabaseVishnu->process(sqlUpdate.c_str());
+    std::string numUserId = getAttribut("WHERE userid='"+mdatabaseVishnu->escapeData(user.getUserId())+"'");
+    SessionCache::getInstance().invalidateUser(convertToInt(numUserId));
+    return ret;
   }
   return ret;
 }//END: deleteUser(UMS_Data::User user)
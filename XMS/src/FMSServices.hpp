@@ -35,6 +35,7 @@ typedef enum {
   FILETRANSFERSLIST,
   FILETRANSFERSTOP,
   UPDATECLIENTSIDETRANSFER,
+  FILEREAD,
   NB_SRV_FMS  // MUST always be the last
 } fms_service_t;
 
@@ -60,7 +61,8 @@ static const char* SERVICES_FMS[NB_SRV_FMS] = {
   "RemoteFileMove",  // 18
   "FileTransfersList",  // 19
   "FileTransferStop",  // 20
-  "UpdateClientSideTransfer"  // 21
+  "UpdateClientSideTransfer",  // 21
+  "FileRead"  // 22
 };
 
 // FIXME: compilation fails without inlining
@@ -1,5 +1,7 @@
 #include "MonitorXMS.hpp"
 #include <csignal>
+#include <algorithm>
+#include <boost/foreach.hpp>
 #include "AuthenticatorConfiguration.hpp"
 #include "AuthenticatorFactory.hpp"
 #include "Authenticator.hpp"
@@ -7,6 +9,7 @@
 #include "BatchFactory.hpp"
 #include "ServerXMS.hpp"
 #include "Logger.hpp"
+#include "JobEventChannel.hpp"
 
 
 MonitorXMS::MonitorXMS(int interval) :
@@ -58,66 +61,258 @@ MonitorXMS::init(const SedConfig& cfg) {
   }
 }
 
-void
-MonitorXMS::checkJobs(int batchtype){
-  std::string sqlRequest = boost::str(boost::format(
-                                        "SELECT jobId, batchJobId, vmIp, vmId, owner "
-                                        " FROM job, vsession "
-                                        " WHERE vsession.numsessionid=job.vsession_numsessionid "
-                                        " AND submitMachineId='%1%' "
-                                        " AND batchType=%2% "
-                                        " AND status >= %3% "
-                                        " AND status < %4% ")
-                                      % mmachineId
-                                      % vishnu::convertToString(batchtype)
-                                      % vishnu::STATE_UNDEFINED
-                                      % vishnu::STATE_COMPLETED);
+/**
+ * \brief The request selecting the active jobs of the machine
+ */
+static const std::string ACTIVE_JOBS_REQUEST =
+  "SELECT jobId, batchJobId, vmIp, vmId, owner, status, batchType, wallClockLimit "
+  " FROM job, vsession "
+  " WHERE vsession.numsessionid=job.vsession_numsessionid "
+  " AND submitMachineId=$1 "
+  " AND status >= $2 "
+  " AND status < $3 ";
+
+/**
+ * \brief The maximum delay between two polls of a running job, in
+ * monitor intervals
+ */
+static const int MAX_RUNNING_BACKOFF = 4;
+
+/**
+ * \brief The maximum delay between two polls of a job not yet running,
+ * in monitor intervals
+ */
+static const int MAX_PENDING_BACKOFF = 16;
 
+/**
+ * \brief The number of monitor intervals between two reloads of the active
+ * jobs from the database, which catch the notifications lost
+ */
+static const int JOBS_RESYNC_PERIOD = 30;
+
+void
+MonitorXMS::seedJobs() {
+  SqlParameters params;
+  params.add(mmachineId)
+    .add(vishnu::STATE_UNDEFINED)
+    .add(vishnu::STATE_COMPLETED);
   try {
-    BatchFactory factory;
-    boost::scoped_ptr<BatchServer> batchServer(factory.getBatchServerInstance(batchtype, mbatchVersion));
-    boost::scoped_ptr<DatabaseResult> result(mdatabaseVishnu->getResult(sqlRequest.c_str()));
+    boost::scoped_ptr<DatabaseResult>
+      result(mdatabaseVishnu->getPreparedResult("monitor_active_jobs", ACTIVE_JOBS_REQUEST, params));
+    std::map<std::string, ActiveJob> jobs;
+    time_t now = time(NULL);
+    for (size_t i = 0; i < result->getNbTuples(); ++i) {
+      addActiveJob(result->get(i), jobs, now);
+    }
+    mactiveJobs.swap(jobs);
+  } catch (VishnuException& ex) {
+    LOG(boost::str(boost::format("[TMSMONITOR][ERROR] %1%") % ex.what()), LogErr);
+  }
+}
+
 
-    std::vector<std::string> buffer;
-    std::vector<std::string>::iterator item;
+void
+MonitorXMS::loadJob(const std::string& jobId) {
+  SqlParameters params;
+  params.add(mmachineId)
+    .add(vishnu::STATE_UNDEFINED)
+    .add(vishnu::STATE_COMPLETED)
+    .add(jobId);
+  try {
+    boost::scoped_ptr<DatabaseResult>
+      result(mdatabaseVishnu->getPreparedResult("monitor_load_job",
+                                                ACTIVE_JOBS_REQUEST+" AND jobId=$4 ",
+                                                params));
+    time_t now = time(NULL);
     for (size_t i = 0; i < result->getNbTuples(); ++i) {
-      buffer.clear();
-      buffer = result->get(i);
-      item = buffer.begin();
-      TMS_Data::Job job;
-      job.setJobId( *item++ );
-      job.setBatchJobId( *item++ );
-      job.setVmIp( *item++ );
-      job.setVmId( *item++ );
-      job.setOwner( *item );
+      addActiveJob(result->get(i), mactiveJobs, now);
+    }
+  } catch (VishnuException& ex) {
+    LOG(boost::str(boost::format("[TMSMONITOR][ERROR] %1%") % ex.what()), LogErr);
+  }
+}
+
+
+void
+MonitorXMS::addActiveJob(const std::vector<std::string>& row,
+                         std::map<std::string, ActiveJob>& jobs, time_t now) {
+  std::vector<std::string>::const_iterator item = row.begin();
+  TMS_Data::Job job;
+  job.setJobId( *item++ );
+  job.setBatchJobId( *item++ );
+  job.setVmIp( *item++ );
+  job.setVmId( *item++ );
+  job.setOwner( *item++ );
+  int state = vishnu::convertToInt(*item++);
+  int batchType = vishnu::convertToInt(*item++);
+  int wallClockLimit = vishnu::convertToInt(*item);
+
+  // only the jobs of the batch schedulers of the server are followed
+  if (batchType != mbatchType && batchType != POSIX) {
+    return;
+  }
+
+  // the jobs already followed keep their schedule
+  std::map<std::string, ActiveJob>::const_iterator known = mactiveJobs.find(job.getJobId());
+  if (known != mactiveJobs.end()) {
+    jobs[job.getJobId()] = known->second;
+    return;
+  }
+
+  ActiveJob& active = jobs[job.getJobId()];
+  active.batchType = batchType;
+  switch (batchType) {
+    case DELTACLOUD:
+    case OPENNEBULA:
+      active.batchId = JsonObject::serialize(job);
+      break;
+    default:
+      active.batchId = job.getBatchJobId();
+      break;
+  }
+  active.state = state;
+  active.wallClockLimit = wallClockLimit > 0 ? wallClockLimit : 0;
+  active.runningSince = (state == vishnu::STATE_RUNNING) ? now : 0;
+  active.delay = std::max(minterval, 1);
+  active.nextPoll = now;
+}
+
+
+void
+MonitorXMS::handleJobEvents() {
+  std::vector<JobEventChannel::Event> events;
+  JobEventChannel::getInstance().receive(events);
+  BOOST_FOREACH(const JobEventChannel::Event& event, events) {
+    switch (event.type) {
+      case JobEventChannel::JOB_SUBMITTED:
+        loadJob(event.jobId);
+        break;
+      case JobEventChannel::JOB_CANCELLED:
+        mactiveJobs.erase(event.jobId);
+        break;
+      default:
+        break;
+    }
+  }
+}
 
+
+void
+MonitorXMS::scheduleJob(ActiveJob& job, time_t now, bool changed) {
+  int interval = std::max(minterval, 1);
+  int maxDelay = interval * ((job.state == vishnu::STATE_RUNNING) ? MAX_RUNNING_BACKOFF
+                                                                  : MAX_PENDING_BACKOFF);
+  job.delay = changed ? interval : std::min(job.delay * 2, maxDelay);
+  job.nextPoll = now + job.delay;
+
+  // a running job is watched closely when it nears its wall clock limit
+  if (job.state == vishnu::STATE_RUNNING
+      && job.wallClockLimit > 0
+      && job.runningSince > 0) {
+    time_t deadline = job.runningSince + job.wallClockLimit;
+    if (deadline < job.nextPoll) {
+      job.delay = interval;
+      job.nextPoll = std::max(deadline, now + interval);
+    }
+  }
+}
+
+
+time_t
+MonitorXMS::nextJobPoll(time_t limit) const {
+  time_t next = limit;
+  for (std::map<std::string, ActiveJob>::const_iterator it = mactiveJobs.begin();
+       it != mactiveJobs.end(); ++it) {
+    next = std::min(next, it->second.nextPoll);
+  }
+  return next;
+}
+
+
+void
+MonitorXMS::pollJobs() {
+  time_t now = time(NULL);
+
+  // the jobs due, by batch scheduler
+  std::map<int, std::vector<std::string> > dueJobs;
+  for (std::map<std::string, ActiveJob>::iterator it = mactiveJobs.begin();
+       it != mactiveJobs.end(); ++it) {
+    if (it->second.nextPoll <= now) {
+      dueJobs[it->second.batchType].push_back(it->first);
+      // backs off when the state cannot be got
+      scheduleJob(it->second, now, false);
+    }
+  }
+
+  for (std::map<int, std::vector<std::string> >::const_iterator due = dueJobs.begin();
+       due != dueJobs.end(); ++due) {
+    try {
+      std::vector<std::string> batchIds;
+      BOOST_FOREACH(const std::string& jobId, due->second) {
+        batchIds.push_back(mactiveJobs[jobId].batchId);
+      }
+
+      // a single request to the batch server for all the jobs due
+      BatchFactory factory;
+      boost::shared_ptr<BatchServer> batchServer(factory.getBatchServerInstance(due->first, mbatchVersion));
+      std::map<std::string, int> states = batchServer->getJobStates(batchIds);
+
+      // only the jobs whose status changed are written, in one transaction
+      std::map<std::string, int> changes;
+      int transacId = -1;
       try {
-        int state;
-        switch (batchtype) {
-          case DELTACLOUD:
-          case OPENNEBULA:
-            state = batchServer->getJobState(JsonObject::serialize(job));
-            break;
-          default:
-            state = batchServer->getJobState(job.getBatchJobId());
-            break;
+        BOOST_FOREACH(const std::string& jobId, due->second) {
+          const ActiveJob& job = mactiveJobs[jobId];
+          std::map<std::string, int>::const_iterator found = states.find(job.batchId);
+          if (found == states.end() || found->second == job.state) {
+            continue;
+          }
+          if (transacId == -1) {
+            transacId = mdatabaseVishnu->startTransaction();
+          }
+          SqlParameters update;
+          update.add(found->second).add(jobId);
+          if (found->second == vishnu::STATE_COMPLETED) {
+            mdatabaseVishnu->processPrepared("complete_job",
+                                             "UPDATE job SET status=$1, endDate=CURRENT_TIMESTAMP"
+                                             " WHERE jobId=$2",
+                                             update, transacId);
+          } else {
+            mdatabaseVishnu->processPrepared("update_job_status",
+                                             "UPDATE job SET status=$1 WHERE jobId=$2",
+                                             update, transacId);
+          }
+          changes[jobId] = found->second;
         }
-        std::string query = boost::str(boost::format("UPDATE job SET status=%1%"
-                                                     " WHERE jobId='%2%';")
-                                       % vishnu::convertToString(state) % job.getJobId());
-        if (state == vishnu::STATE_COMPLETED) {
-          query.append(boost::str(boost::format("UPDATE job SET endDate=CURRENT_TIMESTAMP"
-                                                " WHERE jobId='%1%';") % job.getJobId()));
+        if (transacId != -1) {
+          mdatabaseVishnu->endTransaction(transacId);
         }
-        mdatabaseVishnu->process(query);
       } catch (VishnuException& ex) {
-        LOG(boost::str(boost::format("[TMSMONITOR][ERROR] %1%") % ex.what()), LogErr);
+        if (transacId != -1) {
+          mdatabaseVishnu->cancelTransaction(transacId);
+        }
+        throw;
       }
+
+      // the jobs are followed with their new status once it is saved
+      for (std::map<std::string, int>::const_iterator change = changes.begin();
+           change != changes.end(); ++change) {
+        if (change->second >= vishnu::STATE_COMPLETED) {
+          mactiveJobs.erase(change->first);
+          continue;
+        }
+        ActiveJob& job = mactiveJobs[change->first];
+        if (change->second == vishnu::STATE_RUNNING) {
+          job.runningSince = now;
+        }
+        job.state = change->second;
+        scheduleJob(job, now, true);
+      }
+    } catch (VishnuException& ex) {
+      LOG(boost::str(boost::format("[TMSMONITOR][ERROR] %1%") % ex.what()), LogErr);
+    } catch (...) {
+      LOG("[TMSMONITOR][ERROR] Unknow error", LogErr);
     }
-  } catch (VishnuException& ex) {
-    LOG(boost::str(boost::format("[TMSMONITOR][ERROR] %1%") % ex.what()), LogErr);
-  } catch (...) {
-    LOG("[TMSMONITOR][ERROR] Unknow error", LogErr);
   }
 }
 
@@ -170,10 +365,12 @@ MonitorXMS::checkFile(){
   std::vector<std::string> tmp;
   std::string pid,transferId;
   std::string sqlUpdatedRequest;
+  // the transfers queued by a server are resumed when it restarts
   std::string sqlRequest = "SELECT transferid,processid "
                            " FROM filetransfer,vsession"
                            " WHERE vsession.numsessionid=filetransfer.vsession_numsessionid "
-                           " AND filetransfer.status=0";
+                           " AND filetransfer.status=0"
+                           " AND (filetransfer.serveruri IS NULL OR filetransfer.serveruri='')";
   try {
     boost::scoped_ptr<DatabaseResult> result(mdatabaseVishnu->getResult(sqlRequest));
     if (result->getNbTuples() != 0) {
@@ -204,20 +401,36 @@ MonitorXMS::checkFile(){
 
 int
 MonitorXMS::run() {
+  time_t nextSweep = 0;
+  time_t nextResync = 0;
   while (kill(getppid(), 0) == 0) {
-    if (mhasUMS) {
-      checkSession();
+    time_t now = time(NULL);
+    if (now >= nextSweep) {
+      if (mhasUMS) {
+        checkSession();
+      }
+      if (mhasFMS) {
+        checkFile();
+      }
+      nextSweep = now + minterval;
     }
     if (mhasTMS) {
-      checkJobs(mbatchType);
-      if (mbatchType != POSIX){
-        checkJobs(POSIX);
+      if (now >= nextResync) {
+        seedJobs();
+        nextResync = now + JOBS_RESYNC_PERIOD * minterval;
       }
+      pollJobs();
+    }
+
+    // sleep until the next poll due, or an event of the job servers
+    time_t wakeup = mhasTMS ? nextJobPoll(nextSweep) : nextSweep;
+    now = time(NULL);
+    if (wakeup > now) {
+      JobEventChannel::getInstance().wait(static_cast<int>(wakeup - now) * 1000);
     }
-    if (mhasFMS) {
-      checkFile();
+    if (mhasTMS) {
+      handleJobEvents();
     }
-    sleep(minterval);
   }
   return 0;
 }
@@ -1,3 +1,6 @@
+#include <ctime>
+#include <map>
+#include <string>
 #include "internalApiUMS.hpp"
 #include "internalApiTMS.hpp"
 #include "tmsUtils.hpp"
@@ -42,10 +45,89 @@ public:
 
 
 private:
+  /**
+   * @brief An active job followed by the monitor
+   */
+  struct ActiveJob {
+    /**
+     * @brief the batch scheduler of the job
+     */
+    int batchType;
+    /**
+     * @brief the identifier given to the batch server
+     */
+    std::string batchId;
+    /**
+     * @brief the last known status
+     */
+    int state;
+    /**
+     * @brief the wall clock limit in seconds, 0 if unknown
+     */
+    int wallClockLimit;
+    /**
+     * @brief the date the job was first seen running, 0 if not running
+     */
+    time_t runningSince;
+    /**
+     * @brief the current delay between two polls, in seconds
+     */
+    int delay;
+    /**
+     * @brief the date of the next poll
+     */
+    time_t nextPoll;
+  };
+
   void
   checkSession();
+  /**
+   * @brief Reload the active jobs from the database, keeping the schedule
+   * of the jobs already known
+   */
+  void
+  seedJobs();
+  /**
+   * @brief Load a newly submitted job from the database
+   * @param jobId the vishnu identifier of the job
+   */
+  void
+  loadJob(const std::string& jobId);
+  /**
+   * @brief Add a job read from the database to the active jobs
+   * @param row the columns of the job, as selected by seedJobs
+   * @param jobs the active jobs
+   * @param now the current date
+   */
+  void
+  addActiveJob(const std::vector<std::string>& row,
+               std::map<std::string, ActiveJob>& jobs, time_t now);
+  /**
+   * @brief Apply the events sent by the job servers
+   */
+  void
+  handleJobEvents();
+  /**
+   * @brief Poll the jobs whose next poll is due and save the status
+   * changes
+   */
+  void
+  pollJobs();
+  /**
+   * @brief Compute the date of the next poll of a job
+   * @param job the job
+   * @param now the current date
+   * @param changed whether the status of the job just changed
+   */
   void
-  checkJobs(int batchtype);
+  scheduleJob(ActiveJob& job, time_t now, bool changed);
+  /**
+   * @brief Get the date of the earliest poll due
+   * @param limit the date returned if no poll is due before
+   * @return the date of the next poll
+   */
+  time_t
+  nextJobPoll(time_t limit) const;
   void
   checkFile();
   int minterval;
@@ -57,4 +139,8 @@ private:
   bool mhasUMS;
   bool mhasTMS;
   bool mhasFMS;
+  /**
+   * @brief the active jobs of the machine, by vishnu identifier
+   */
+  std::map<std::string, ActiveJob> mactiveJobs;
 };
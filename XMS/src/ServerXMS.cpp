@@ -9,6 +9,7 @@
 #include "TMSServices.hpp"
 #include "FMSServices.hpp"
 #include "internalApiFMS.hpp"
+#include "TransferScheduler.hpp"
 
 
 Database *ServerXMS::mdatabaseVishnu = NULL;
@@ -158,6 +159,19 @@ ServerXMS::init(SedConfig& cfg) {
       throw e;
     }
 
+    // the transfers left by the previous run are queued again
+    if (mhasFMS) {
+      int transfersLimit;
+      if (! msedConfig->getConfigValue<int>(vishnu::TRANSFERS_LIMIT, transfersLimit)) {
+        transfersLimit = DEFAULT_TRANSFERS_LIMIT;
+      }
+      int transfersPerHostLimit;
+      if (! msedConfig->getConfigValue<int>(vishnu::TRANSFERS_PER_HOST_LIMIT, transfersPerHostLimit)) {
+        transfersPerHostLimit = DEFAULT_TRANSFERS_PER_HOST_LIMIT;
+      }
+      TransferScheduler::getInstance().start(transfersLimit, transfersPerHostLimit, cfg.uri);
+    }
+
   } catch (VishnuException& e) {
     std::cout << e.what() << "\n";
     errorCode = 1;
@@ -269,6 +283,8 @@ ServerXMS::initMap(const std::string& mid) {
       mcb[std::string(SERVICES_TMS[JOBOUTPUTGETRESULT])+"@"+mid] = functionPtr;
       functionPtr = solveJobOutPutGetCompletedJobs;
       mcb[std::string(SERVICES_TMS[JOBOUTPUTGETCOMPLETEDJOBS])+"@"+mid] = functionPtr;
+      functionPtr = solveSubmitJobs;
+      mcb[std::string(SERVICES_TMS[JOBSUBMITMANY])+"@"+mid] = functionPtr;
       // Remove ?
       functionPtr = solveGetListOfJobs;
       mcb[SERVICES_TMS[GETLISTOFJOBS_ALL]] = functionPtr;
@@ -295,6 +311,8 @@ ServerXMS::initMap(const std::string& mid) {
     mcb[SERVICES_FMS[FILEHEAD]] = functionPtr;
     functionPtr = solveGetFileContent;
     mcb[SERVICES_FMS[FILECONTENT]] = functionPtr;
+    functionPtr = solveReadFile;
+    mcb[SERVICES_FMS[FILEREAD]] = functionPtr;
     functionPtr = solveCreateFile;
     mcb[SERVICES_FMS[FILECREATE]] = functionPtr;
     functionPtr = solveCreateDir;
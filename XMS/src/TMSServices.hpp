@@ -19,6 +19,7 @@ typedef enum {
   GETLISTOFQUEUES,
   JOBOUTPUTGETRESULT,
   JOBOUTPUTGETCOMPLETEDJOBS,
+  JOBSUBMITMANY,
   GETLISTOFJOBS_ALL,
   ADDWORK,
   WORKUPDATE,
@@ -36,6 +37,7 @@ static const char* SERVICES_TMS[NB_SRV_TMS] = {
   "getListOfQueues",  // 5
   "jobOutputGetResult",  // 6
   "jobOutputGetCompletedJobs",  // 7
+  "jobSubmitMany",  // 8
   "getListOfJobs_all",  // 8
   "addwork",  // 10
   "workUpdate",  // 11
@@ -47,7 +49,7 @@ static const char* SERVICES_TMS[NB_SRV_TMS] = {
 // needs to be moved in an implementation file
 inline bool
 isMachineSpecificServicesTMS(unsigned id) {
-    bool machineLocal = (id <= 7) ? true : false;
+    bool machineLocal = (id <= 8) ? true : false;
   return machineLocal;
 }
 
@@ -312,6 +312,69 @@ int solveGetFileContent(diet_profile_t* profile) {
   return 0;
 }
 
+/* read Vishnu callback function.
+ client parameters. Returns an error message if something gone wrong. */
+/* Returns a bounded range of the file and its current size to the client
+ * application, which reads a large file chunk by chunk. */
+int solveReadFile(diet_profile_t* profile) {
+  std::string localPath, userKey, acLogin, machineName;
+  std::string path = "";
+  std::string host = "";
+  std::string sessionKey = "";
+  std::string offsetInString = "";
+  std::string lengthInString = "";
+
+  diet_string_get(profile, 0, sessionKey);
+  diet_string_get(profile, 1, path);
+  diet_string_get(profile, 2, host);
+  diet_string_get(profile, 3, offsetInString);
+  diet_string_get(profile, 4, lengthInString);
+
+  // reset the profile to handle result
+  diet_profile_reset(profile, 3);
+
+  localPath = path;
+  SessionServer sessionServer (sessionKey);
+
+  try {
+    // the chunks are not registered as commands, a follow reads them
+    // continuously
+    sessionServer.check();
+
+    UMS_Data::Machine_ptr machine = new UMS_Data::Machine();
+    machine->setMachineId(host);
+    MachineServer machineServer(machine);
+
+    // check the machine
+    machineServer.checkMachine();
+
+    // get the machineName
+    machineName = machineServer.getMachineName();
+    delete machine;
+
+    // get the acLogin
+    acLogin = UserServer(sessionServer).getUserAccountLogin(host);
+
+    FileFactory ff;
+    ff.setSSHServer(machineName);
+    boost::scoped_ptr<File> file(ff.getFileServer(sessionServer,localPath, acLogin, userKey));
+
+    file_size_t fileSize = 0;
+    std::string chunk = file->read(vishnu::convertToLong(offsetInString),
+                                   vishnu::convertToLong(lengthInString),
+                                   fileSize);
+
+    diet_string_set(profile, 0, "success");
+    // the chunk may be binary, the JSON profiles stop at the first NUL
+    diet_string_set(profile, 1, vishnu::encodeBase64(chunk));
+    diet_string_set(profile, 2, vishnu::convertToString(fileSize));
+  } catch (VishnuException& err) {
+    diet_string_set(profile, 0, "error");
+    diet_string_set(profile, 1, err.what());
+  }
+  return 0;
+}
+
 /* get information Vishnu callback function. Proceed to the group change using the
  client parameters. Returns an error message if something gone wrong. */
 /* The function returns all the information about a file:
@@ -43,6 +43,13 @@ int solveChangeMode(diet_profile_t* profile);
  */
 int solveGetFileContent(diet_profile_t* profile);
 
+/**
+ * \brief the read file solve function
+ * \param profile the service profile
+ * \return 0 if the service succeds or an error code otherwise
+ */
+int solveReadFile(diet_profile_t* profile);
+
 /**
  * \brief the get infos solve function
  * \param profile the service profile
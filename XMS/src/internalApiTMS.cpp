@@ -112,6 +112,74 @@ solveSubmitJob(diet_profile_t* pb) {
   return 0;
 }
 
+/**
+ * \brief Function to solve the jobSubmitMany service
+ * \param pb is a structure which corresponds to the descriptor of a profile
+ * \return raises an exception on error
+ */
+int
+solveSubmitJobs(diet_profile_t* pb) {
+
+  std::string scriptContent;
+  std::string machineId;
+  std::string jsonEncodedOptions;
+  std::string jsonEncodedParams;
+  std::string authKey;
+
+  // get profile parameters
+  diet_string_get(pb,0, authKey);
+  diet_string_get(pb,1, machineId);
+  diet_string_get(pb,2, scriptContent);
+  diet_string_get(pb,3, jsonEncodedOptions);
+  diet_string_get(pb,4, jsonEncodedParams);
+
+  // reset the profile to send back result
+  diet_profile_reset(pb, 2);
+
+  try {
+    //MAPPER CREATION
+    Mapper *mapper = MapperRegistry::getInstance()->getMapper(vishnu::TMSMAPPERNAME);
+    int mapperkey = mapper->code("vishnu_submit_jobs");
+    mapper->code(machineId, mapperkey);
+    mapper->code(jsonEncodedOptions, mapperkey);
+    std::string cmd = mapper->finalize(mapperkey);
+
+    ServerXMS* server = ServerXMS::getInstance();
+
+    JobServer jobServer(authKey, machineId, server->getSedConfig());
+    jobServer.setDebugLevel(server->getDebugLevel()); // Set the debug level
+
+    JsonObject options(jsonEncodedOptions);
+    JsonObject params(jsonEncodedParams);
+    std::vector<std::string> jobParams;
+    params.getArrayProperty("params", jobParams);
+
+    TMS_Data::ListJobs jobs;
+    jobServer.submitJobs(scriptContent,
+                         &options,
+                         jobParams,
+                         server->getVishnuId(),
+                         server->getDefaultBatchOption(),
+                         jobs);
+
+    diet_string_set(pb,0, "success");
+    diet_string_set(pb,1, vishnu::emfSerializer<TMS_Data::ListJobs>(&jobs));
+
+    FINISH_COMMAND(authKey, cmd, vishnu::TMS, vishnu::CMDSUCCESS, "");
+
+  } catch (VishnuException& ex) {
+    try {
+      FINISH_COMMAND(authKey, "", vishnu::TMS, vishnu::CMDFAILED, "");
+    } catch (VishnuException& fe) {
+      ex.appendMsgComp(fe.what());
+    }
+    diet_string_set(pb,0, "error");
+    diet_string_set(pb,1, ex.what());
+  }
+
+  return 0;
+}
+
 /**
  * \brief Function to solve the jobCancel service
  * \param pb is a structure which corresponds to the descriptor of a profile
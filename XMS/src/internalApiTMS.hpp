@@ -20,6 +20,14 @@
 int
 solveSubmitJob(diet_profile_t* pb);
 
+/**
+ * \brief Function to solve the jobSubmitMany service
+ * \param pb is a structure which corresponds to the descriptor of a profile
+ * \return raises an exception on error
+ */
+int
+solveSubmitJobs(diet_profile_t* pb);
+
 /**
  * \brief Function to solve the jobCancel service
  * \param pb is a structure which corresponds to the descriptor of a profile
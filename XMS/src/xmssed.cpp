@@ -9,6 +9,10 @@
 #include "CommServer.hpp"
 #include "tmsUtils.hpp"
 #include "Logger.hpp"
+#include "SessionCache.hpp"
+#include "JobEventChannel.hpp"
+#include "BatchHelperPool.hpp"
+#include "JobServer.hpp"
 
 
 
@@ -149,11 +153,33 @@ main(int argc, char* argv[], char* envp[]) {
   SedConfig cfg;
   readConfiguration(argv[1], cfg);
 
+  // the cache must exist before forking to get the sessions closed by
+  // the monitor
+  int sessionCacheTtl;
+  if (! cfg.config.getConfigValue<int>(vishnu::SESSION_CACHE_TTL, sessionCacheTtl)) {
+    sessionCacheTtl = DEFAULT_SESSION_CACHE_TTL;
+  }
+  SessionCache::getInstance().setTtl(sessionCacheTtl);
+
+  // the servers notify the monitor of the jobs they submit and cancel
+  if (cfg.hasTMS) {
+    JobEventChannel::getInstance().open();
+  }
+
   // forking a child: sed monitoring
   pid_t pid;
   pid = fork();
 
   if (pid > 0) {
+    // the native batch actions run in helper processes, forked from the
+    // launcher before the server threads are created
+    int standalone;
+    if (cfg.hasTMS
+        && cfg.config.getConfigValue<int>(vishnu::STANDALONE, standalone)
+        && standalone != 0) {
+      BatchHelperPool::getInstance().start(&JobServer::processHelperRequest);
+    }
+
     //Initialize the UMS Server (Opens a connection to the database)
     boost::shared_ptr<ServerXMS> serverXMS(ServerXMS::getInstance());
     int res = serverXMS->init(cfg);
@@ -16,8 +16,14 @@
 #include "TMSServices.hpp"
 #include "FMSServices.hpp"
 
+Annuary::Annuary()
+  : mindex(boost::make_shared<Index>()),
+    mpolicy(boost::make_shared<LeastOutstandingPolicy>()) {}
+
 Annuary::Annuary(const std::vector<boost::shared_ptr<Server> >& serv)
-  : mservers(serv) {}
+  : mpolicy(boost::make_shared<LeastOutstandingPolicy>()) {
+  publish(serv);
+}
 
 
 // anonymous namespace
@@ -38,15 +44,39 @@ namespace {
   };
 }
 
+
+boost::shared_ptr<const Annuary::Index>
+Annuary::snapshot() const {
+  return boost::atomic_load(&mindex);
+}
+
+void
+Annuary::publish(const std::vector<boost::shared_ptr<Server> >& servers) {
+  boost::shared_ptr<Index> index = boost::make_shared<Index>();
+  index->servers = servers;
+  BOOST_FOREACH(const boost::shared_ptr<Server>& server, servers) {
+    BOOST_FOREACH(const std::string& service, server->getServices()) {
+      std::vector<boost::shared_ptr<Server> >& candidates = index->services[service];
+      // a server may declare a service twice
+      if (candidates.empty() || candidates.back() != server) {
+        candidates.push_back(server);
+      }
+    }
+  }
+  boost::atomic_store(&mindex, boost::shared_ptr<const Index>(index));
+}
+
 int
 Annuary::add(const std::string& name, const std::string& uri,
              const std::vector<std::string>& services) {
-  boost::lock_guard<boost::recursive_mutex> lock(mmutex);
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  boost::shared_ptr<const Index> current = snapshot();
   is_server helper(name, uri);
-  std::vector<boost::shared_ptr<Server> >::iterator it =
-    std::find_if(mservers.begin(), mservers.end(), helper);
-  if (it == mservers.end()) {
-    mservers.push_back(boost::make_shared<Server>(name, services, uri));
+  if (std::find_if(current->servers.begin(), current->servers.end(), helper)
+      == current->servers.end()) {
+    std::vector<boost::shared_ptr<Server> > servers(current->servers);
+    servers.push_back(boost::make_shared<Server>(name, services, uri));
+    publish(servers);
     std::cerr << "[INFO]: added " << name << "@" << uri << "\n";
   }
   return 0;
@@ -54,10 +84,24 @@ Annuary::add(const std::string& name, const std::string& uri,
 
 int
 Annuary::remove(const std::string& name, const std::string& uri) {
-  boost::lock_guard<boost::recursive_mutex> lock(mmutex);
-  is_server helper(name, uri);
-  mservers.erase(std::remove_if(mservers.begin(), mservers.end(), helper),
-                 mservers.end());
+  std::vector<boost::shared_ptr<Server> > servers;
+  servers.push_back(boost::make_shared<Server>(name, std::vector<std::string>(), uri));
+  return remove(servers);
+}
+
+int
+Annuary::remove(const std::vector<boost::shared_ptr<Server> >& toRemove) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  boost::shared_ptr<const Index> current = snapshot();
+  std::vector<boost::shared_ptr<Server> > servers(current->servers);
+  BOOST_FOREACH(const boost::shared_ptr<Server>& server, toRemove) {
+    is_server helper(server->getName(), server->getURI());
+    servers.erase(std::remove_if(servers.begin(), servers.end(), helper),
+                  servers.end());
+  }
+  if (servers.size() != current->servers.size()) {
+    publish(servers);
+  }
   return 0;
 }
 
@@ -65,27 +109,49 @@ Annuary::remove(const std::string& name, const std::string& uri) {
 // Note: we're using copy elision optimization here, no useless copy
 std::vector<boost::shared_ptr<Server> >
 Annuary::get(const std::string& service) {
-  boost::lock_guard<boost::recursive_mutex> lock(mmutex);
-  std::vector<boost::shared_ptr<Server> > res;
+  boost::shared_ptr<const Index> index = snapshot();
 
   if (service.empty()) {
-    res.assign(mservers.begin(), mservers.end());
-  } else {
-    std::remove_copy_if(mservers.begin(), mservers.end(),
-                        std::back_inserter(res),
-                        !boost::bind(&Server::hasService, _1, service));
+    return index->servers;
+  }
+  ServiceIndex::const_iterator it = index->services.find(service);
+  if (it == index->services.end()) {
+    return std::vector<boost::shared_ptr<Server> >();
+  }
+  return it->second;
+}
+
+
+std::string
+Annuary::elect(const std::string& service) {
+  boost::shared_ptr<const Index> index = snapshot();
+  ServiceIndex::const_iterator it = index->services.find(service);
+  if (it == index->services.end()) {
+    return "";
   }
-  return res;
+  return boost::atomic_load(&mpolicy)->elect(it->second, mstats);
+}
+
+
+void
+Annuary::setElectionPolicy(boost::shared_ptr<ElectionPolicy> policy) {
+  boost::atomic_store(&mpolicy, policy);
+}
+
+
+ServerStatistics&
+Annuary::getStatistics() {
+  return mstats;
 }
 
 
 void
 Annuary::print() {
-  boost::lock_guard<boost::recursive_mutex> lock(mmutex);
-  if (!mservers.empty()) {
+  boost::shared_ptr<const Index> index = snapshot();
+  if (!index->servers.empty()) {
     std::cerr << "\n==== Initial startup services ====\n";
     std::vector<boost::shared_ptr<Server> >::const_iterator it;
-    for (it = mservers.begin(); it != mservers.end(); ++it) {
+    for (it = index->servers.begin(); it != index->servers.end(); ++it) {
       std::cerr << "" << it->get()->getName() << ": " << it->get()->getURI() << "\n";
     }
     std::cerr << "==================================\n";
@@ -102,7 +168,8 @@ Annuary::print() {
  */
 void
 Annuary::setInitConfig(const std::string& module, std::vector<std::string>& cfgInfo, std::string mid) {
-  boost::lock_guard<boost::recursive_mutex> lock(mmutex);
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  std::vector<boost::shared_ptr<Server> > servers(snapshot()->servers);
   BOOST_FOREACH(const std::string& entry, cfgInfo) {
     std::istringstream iss(entry);
     std::string uri;
@@ -114,15 +181,15 @@ Annuary::setInitConfig(const std::string& module, std::vector<std::string>& cfgI
     }
     std::vector<std::string> services;
     fillServices(services, module, mid_tmp);
-    mservers.push_back(boost::make_shared<Server>(module, services, uri));
+    servers.push_back(boost::make_shared<Server>(module, services, uri));
   }
+  publish(servers);
 }
 
 void
 Annuary::fillServices(std::vector< std::string> &services,
                       const std::string& name,
                       const std::string& mid) {
-  boost::lock_guard<boost::recursive_mutex> lock(mmutex);
   unsigned int nb;
   std::string tmpserv;
 
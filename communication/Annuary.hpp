@@ -7,22 +7,28 @@
 #define __ANNUARY__H__
 
 #include "Server.hpp"
+#include "ElectionPolicy.hpp"
 #include <string>
 #include <vector>
 #include <boost/shared_ptr.hpp>
-#include <boost/thread/recursive_mutex.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/thread/mutex.hpp>
 
 
 /**
  * \brief This class represents the annuary to store the services
  * \class Annuary
+ *
+ * The servers are kept in an immutable index from the service names to
+ * the servers offering them. Updates build a new index and publish it
+ * atomically, so that lookups never wait for a lock.
  */
 class Annuary {
 public:
   /**
    * \brief Default constructor
    */
-  Annuary() {}
+  Annuary();
   /**
    * \brief Constructor
    * \param serv
@@ -53,6 +59,14 @@ public:
   int
   remove(const std::string& name, const std::string& uri);
 
+  /**
+   * \brief Remove several servers at once, the index is rebuilt only once
+   * \param servers The servers to remove, matched by name and uri
+   * \return 0 on success, an error code otherwise
+   */
+  int
+  remove(const std::vector<boost::shared_ptr<Server> >& servers);
+
   /**
    * \brief Return all the servers offering the service called service
    * \param service The name of the desired service
@@ -61,6 +75,29 @@ public:
   std::vector<boost::shared_ptr<Server> >
   get(const std::string& service = "");
 
+  /**
+   * \brief Elect the server to handle a request for a service
+   * \param service The name of the desired service
+   * \return The uri of the elected server, empty if none offers service
+   */
+  std::string
+  elect(const std::string& service);
+
+  /**
+   * \brief Set the policy used to elect the servers
+   * \param policy The policy
+   */
+  void
+  setElectionPolicy(boost::shared_ptr<ElectionPolicy> policy);
+
+  /**
+   * \brief Get the load statistics of the servers, to be updated by
+   * the callers forwarding the requests
+   * \return The statistics
+   */
+  ServerStatistics&
+  getStatistics();
+
   //TODO: clean later
   /**
    * \brief Init the annuary from a file
@@ -87,6 +124,41 @@ public:
   print();
 
 private :
+  /**
+   * \brief The servers offering a service
+   */
+  typedef boost::unordered_map<std::string,
+                               std::vector<boost::shared_ptr<Server> > > ServiceIndex;
+
+  /**
+   * \struct Index
+   * \brief Immutable snapshot of the annuary content
+   */
+  struct Index {
+    /**
+     * \brief All the servers, in registration order
+     */
+    std::vector<boost::shared_ptr<Server> > servers;
+    /**
+     * \brief The servers by service name
+     */
+    ServiceIndex services;
+  };
+
+  /**
+   * \brief Get the current snapshot
+   * \return the index
+   */
+  boost::shared_ptr<const Index>
+  snapshot() const;
+
+  /**
+   * \brief Build and publish a new index, must be called with mmutex held
+   * \param servers The servers of the new index
+   */
+  void
+  publish(const std::vector<boost::shared_ptr<Server> >& servers);
+
   /**
    * \brief Fill the services for a given server name. Function used to easily create services from given names
    * \param services OUT, the list of services for name
@@ -98,14 +170,24 @@ private :
                const std::string& mid);
 
   /**
-   * \brief The servers
+   * \brief The current index, only accessed through atomic operations
+   */
+  boost::shared_ptr<const Index> mindex;
+
+  /**
+   * \brief The election policy
+   */
+  boost::shared_ptr<ElectionPolicy> mpolicy;
+
+  /**
+   * \brief The load statistics of the servers
    */
-  std::vector<boost::shared_ptr<Server> > mservers;
+  ServerStatistics mstats;
 
   /**
-   * \brief mutex to lock the annuary
+   * \brief mutex serializing the updates of the annuary
    */
-  mutable boost::recursive_mutex mmutex;
+  mutable boost::mutex mmutex;
 };
 
 #endif // __ANNUARY__H__
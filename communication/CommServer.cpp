@@ -118,8 +118,7 @@ keepRegistered(const std::string& sedType,
         }
       }
     } else {
-      zmq::context_t ctx(1);
-      LazyPirateClient lpc(ctx, dispUri, timeout);
+      LazyPirateClient lpc(dispUri, timeout);
       lpc.send(requestData);
       response = lpc.recv();
       if (response == "OK") {
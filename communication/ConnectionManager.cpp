@@ -0,0 +1,81 @@
+#include "ConnectionManager.hpp"
+
+#include <boost/make_shared.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/once.hpp>
+
+#include "zhelpers.hpp"
+
+// anonymous namespace
+namespace {
+  /**
+   * \brief The process-wide instance, never destroyed on purpose: sockets
+   * may still be in use by detached threads when static objects are destroyed
+   */
+  ConnectionManager* theManager = NULL;
+  boost::once_flag theManagerFlag = BOOST_ONCE_INIT;
+}
+
+
+ConnectionManager::ConnectionManager()
+  : ctx_(boost::make_shared<zmq::context_t>(CONNECTION_MANAGER_IO_THREADS)) {}
+
+
+void
+ConnectionManager::create() {
+  theManager = new ConnectionManager();
+}
+
+ConnectionManager&
+ConnectionManager::instance() {
+  boost::call_once(theManagerFlag, &ConnectionManager::create);
+  return *theManager;
+}
+
+zmq::context_t&
+ConnectionManager::context() {
+  return *ctx_;
+}
+
+boost::shared_ptr<Socket>
+ConnectionManager::acquire(const std::string& uri) {
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    SocketPool::iterator it = idle_.find(uri);
+    if (it != idle_.end() && !it->second.empty()) {
+      boost::shared_ptr<Socket> sock = it->second.back();
+      it->second.pop_back();
+      return sock;
+    }
+  }
+  // connecting does not need the lock
+  return connect(uri);
+}
+
+void
+ConnectionManager::release(const std::string& uri,
+                           boost::shared_ptr<Socket> sock) {
+  if (!sock) {
+    return;
+  }
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  std::vector<boost::shared_ptr<Socket> >& sockets = idle_[uri];
+  if (sockets.size() < CONNECTION_MANAGER_MAX_IDLE) {
+    sockets.push_back(sock);
+  }
+  // otherwise the socket is closed when sock goes out of scope
+}
+
+void
+ConnectionManager::invalidate(const std::string& uri) {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  idle_.erase(uri);
+}
+
+boost::shared_ptr<Socket>
+ConnectionManager::connect(const std::string& uri) {
+  boost::shared_ptr<Socket> sock(new Socket(*ctx_, ZMQ_REQ));
+  sock->connect(uri);
+  sock->setLinger(0);
+  return sock;
+}
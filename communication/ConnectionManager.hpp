@@ -0,0 +1,119 @@
+/**
+ * \file ConnectionManager.hpp
+ * \brief This file defines the process-wide pool of zmq client connections
+ */
+#ifndef _CONNECTIONMANAGER_HPP_
+#define _CONNECTIONMANAGER_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <zmq.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+class Socket;
+
+/**
+ * \brief The number of zmq I/O threads of the shared context
+ */
+const int CONNECTION_MANAGER_IO_THREADS = 1;
+
+/**
+ * \brief The maximum number of idle sockets kept for a given uri
+ */
+const unsigned int CONNECTION_MANAGER_MAX_IDLE = 16;
+
+/**
+ * \class ConnectionManager
+ * \brief Keeps a single zmq context for the whole process and a pool
+ * of connected REQ sockets per server uri, so that clients do not pay
+ * the context creation and the TCP connection on each request.
+ *
+ * A socket is taken out of the pool with acquire() and must be given back
+ * with release() once a full request/reply exchange succeeded. A socket
+ * whose exchange failed is in an undefined state (REQ pattern) and must
+ * simply be dropped.
+ */
+class ConnectionManager : public boost::noncopyable {
+public:
+  /**
+   * \brief Get the process-wide instance
+   * \return the connection manager
+   */
+  static ConnectionManager&
+  instance();
+
+  /**
+   * \brief Get the shared zmq context
+   * \return the context
+   */
+  zmq::context_t&
+  context();
+
+  /**
+   * \brief Get a connected socket for the given uri, reusing an idle one
+   * if there is any
+   * \param uri the uri of the server
+   * \return a connected REQ socket
+   */
+  boost::shared_ptr<Socket>
+  acquire(const std::string& uri);
+
+  /**
+   * \brief Give back a socket to the pool after a successful exchange
+   * \param uri the uri the socket is connected to
+   * \param sock the socket
+   */
+  void
+  release(const std::string& uri, boost::shared_ptr<Socket> sock);
+
+  /**
+   * \brief Drop all the idle sockets connected to uri, used when the
+   * server stopped answering
+   * \param uri the uri of the server
+   */
+  void
+  invalidate(const std::string& uri);
+
+private:
+  /**
+   * \brief Constructor, use instance()
+   */
+  ConnectionManager();
+
+  /**
+   * \brief Allocate the process-wide instance, called once
+   */
+  static void
+  create();
+
+  /**
+   * \brief Create a new socket connected to uri
+   * \param uri the uri of the server
+   * \return the socket
+   */
+  boost::shared_ptr<Socket>
+  connect(const std::string& uri);
+
+  /**
+   * \brief Idle sockets per uri
+   */
+  typedef std::map<std::string, std::vector<boost::shared_ptr<Socket> > > SocketPool;
+
+  /**
+   * \brief The shared context
+   */
+  boost::shared_ptr<zmq::context_t> ctx_;
+  /**
+   * \brief The idle sockets
+   */
+  SocketPool idle_;
+  /**
+   * \brief Mutex protecting the pool
+   */
+  boost::mutex mutex_;
+};
+
+#endif /* _CONNECTIONMANAGER_HPP_ */
@@ -24,6 +24,7 @@
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/thread/once.hpp>
 #include <zmq.hpp>                      // for context_t
 
 #include "constants.hpp"                // for ::DISP_URIADDR, etc
@@ -67,7 +68,9 @@ std::string
 get_module(const std::string& service) {
   std::size_t pos = service.find("@");
   ServiceMap::const_iterator it;
-  fill_sMap();
+  // the clients may call the services from several threads
+  static boost::once_flag sMapFilled = BOOST_ONCE_INIT;
+  boost::call_once(sMapFilled, fill_sMap);
 
   if (std::string::npos != pos) {
     it = sMap->find(service.substr(0, pos));
@@ -99,6 +102,17 @@ getTimeout() {
 }
 
 
+int
+getOutputTransferParallelism() {
+  int parallelism(DEFAULT_OUTPUT_TRANSFER_PARALLELISM);
+  config.getConfigValue(vishnu::OUTPUT_TRANSFER_PARALLELISM, parallelism);
+  if (parallelism <= 0) {
+    parallelism = DEFAULT_OUTPUT_TRANSFER_PARALLELISM;
+  }
+  return parallelism;
+}
+
+
 diet_profile_t*
 diet_profile_alloc(const std::string &name, int nbparams) {
   diet_profile_t* res = new diet_profile_t;
@@ -201,18 +215,17 @@ diet_call(diet_profile_t* prof) {
 int
 diet_call_gen(diet_profile_t* prof, const std::string& uri, bool shortTimeout, int verbosity) {
   int timeout = shortTimeout?SHORT_TIMEOUT:getTimeout();
-  zmq::context_t ctx(5);
-  LazyPirateClient lpc(ctx, uri, timeout, verbosity);
-  std::string s1 = my_serialize(prof);
+  LazyPirateClient lpc(uri, timeout, verbosity);
+  std::string s1 = my_serialize(prof, true);
   if (!lpc.send(s1)) {
     std::cerr << "E: request failed, exiting ...\n";
     return -1;
   }
 
-  std::string response = lpc.recv();
-  boost::shared_ptr<diet_profile_t> result(my_deserialize(response));
+  const Message& response = lpc.reply();
+  boost::shared_ptr<diet_profile_t> result(my_deserialize(response.data(), response.size()));
   if (! result) {
-    std::cerr << boost::format("[ERROR] %1%\n")%response;
+    std::cerr << boost::format("[ERROR] %1%\n")%response.str();
     return 1;
   }
   // To signal a communication problem (bad server receive request)
@@ -268,13 +281,25 @@ diet_profile_free(diet_profile_t* prof) {
 
 
 std::string
-my_serialize(diet_profile_t* prof) {
+my_serialize(diet_profile_t* prof, bool binary) {
+  if (binary) {
+    return BinaryProfile::serialize(prof);
+  }
   return JsonObject::serialize(prof);
 }
 
 boost::shared_ptr<diet_profile_t>
 my_deserialize(const std::string& prof) {
-  return JsonObject::deserialize(prof);
+  return my_deserialize(prof.data(), prof.size());
+}
+
+boost::shared_ptr<diet_profile_t>
+my_deserialize(const char* data, size_t size) {
+  // the version byte tells the binary profiles from the JSON ones
+  if (BinaryProfile::isBinary(data, size)) {
+    return BinaryProfile::deserialize(data, size);
+  }
+  return JsonObject::deserialize(std::string(data, size));
 }
 
 int
@@ -306,8 +331,7 @@ communicate_dispatcher(const std::string& requestData, std::string& response, bo
       response = tlsClient.recv();
     }
   } else {
-    zmq::context_t ctx(1);
-    LazyPirateClient lpc(ctx, uriDispatcher, timeout, verbosity);
+    LazyPirateClient lpc(uriDispatcher, timeout, verbosity);
     if (!lpc.send(requestData)) {
       return -1; // Dont throw exception
     }
@@ -30,6 +30,10 @@ namespace TMS_Data  {
  * \brief Short timeout
  */
 #define SHORT_TIMEOUT 2
+/**
+ * \brief The default number of output files of the jobs copied at once
+ */
+#define DEFAULT_OUTPUT_TRANSFER_PARALLELISM 8
 /**
  * \brief Overload of DIET structure
  */
@@ -135,23 +139,40 @@ diet_profile_free(diet_profile_t* prof);
 int
 getTimeout();
 
+/**
+ * @brief Get the number of output files of the jobs copied at once
+ * @return the configured value, DEFAULT_OUTPUT_TRANSFER_PARALLELISM if unset
+ */
+int
+getOutputTransferParallelism();
+
 
 /**
  * \brief To serialize a profile
  * \param prof The profile
+ * \param binary Whether to use the binary encoding rather than JSON
  * \return The serialized profile
  */
 std::string
-my_serialize(diet_profile_t* prof);
+my_serialize(diet_profile_t* prof, bool binary = false);
 
 /**
- * \brief To deserialize a profile
+ * \brief To deserialize a profile, in either encoding
  * \param prof The serialized profile
  * \return The deserialized profile
  */
 boost::shared_ptr<diet_profile_t>
 my_deserialize(const std::string& prof);
 
+/**
+ * \brief To deserialize a profile in place, in either encoding
+ * \param data The serialized profile
+ * \param size The size of the serialized profile
+ * \return The deserialized profile
+ */
+boost::shared_ptr<diet_profile_t>
+my_deserialize(const char* data, size_t size);
+
 /**
  * \brief Overload of DIET function, to initialize
  * \param cfg DEPRECATED, kept for compatibility
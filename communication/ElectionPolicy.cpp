@@ -0,0 +1,151 @@
+#include "ElectionPolicy.hpp"
+
+#include <boost/make_shared.hpp>
+#include <boost/thread/locks.hpp>
+#include "UserException.hpp"
+
+
+void
+ServerStatistics::requestStarted(const std::string& uri) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  ++mloads[uri].inflight;
+}
+
+void
+ServerStatistics::requestCompleted(const std::string& uri, double elapsed) {
+  requestEnded(uri, elapsed, false);
+}
+
+void
+ServerStatistics::requestFailed(const std::string& uri, double elapsed) {
+  requestEnded(uri, elapsed, true);
+}
+
+void
+ServerStatistics::requestEnded(const std::string& uri, double elapsed, bool failed) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  ServerLoad& load = mloads[uri];
+  if (load.inflight > 0) {
+    --load.inflight;
+  }
+  // a failure counts as a response as slow as the time waited for it
+  if (load.requests == 0) {
+    load.latency = elapsed;
+  } else {
+    load.latency = LATENCY_EWMA_ALPHA * elapsed
+                   + (1. - LATENCY_EWMA_ALPHA) * load.latency;
+  }
+  ++load.requests;
+  if (failed) {
+    ++load.failures;
+  }
+}
+
+void
+ServerStatistics::heartbeatReceived(const std::string& uri, double rtt) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  ServerLoad& load = mloads[uri];
+  load.heartbeatRtt = rtt;
+  load.missedBeats = 0;
+}
+
+unsigned int
+ServerStatistics::heartbeatMissed(const std::string& uri) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  return ++mloads[uri].missedBeats;
+}
+
+void
+ServerStatistics::remove(const std::string& uri) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  mloads.erase(uri);
+}
+
+ServerLoad
+ServerStatistics::get(const std::string& uri) const {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  std::map<std::string, ServerLoad>::const_iterator it = mloads.find(uri);
+  if (it == mloads.end()) {
+    return ServerLoad();
+  }
+  return it->second;
+}
+
+
+boost::shared_ptr<ElectionPolicy>
+ElectionPolicy::create(const std::string& name) {
+  if (name == "roundrobin") {
+    return boost::make_shared<RoundRobinPolicy>();
+  } else if (name == "leastoutstanding") {
+    return boost::make_shared<LeastOutstandingPolicy>();
+  } else if (name == "latency") {
+    return boost::make_shared<LatencyPolicy>();
+  }
+  throw UserException(ERRCODE_INVALID_PARAM,
+                      "Unknown election policy " + name
+                      + " (expected roundrobin, leastoutstanding or latency)");
+}
+
+unsigned long
+ElectionPolicy::next() {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  return mcounter++;
+}
+
+
+std::string
+RoundRobinPolicy::elect(const std::vector<boost::shared_ptr<Server> >& serv,
+                        const ServerStatistics& stats) {
+  if (serv.empty()) {
+    return "";
+  }
+  return serv.at(next() % serv.size())->getURI();
+}
+
+
+std::string
+LeastOutstandingPolicy::elect(const std::vector<boost::shared_ptr<Server> >& serv,
+                              const ServerStatistics& stats) {
+  if (serv.empty()) {
+    return "";
+  }
+  // start at a rotating position so that ties are spread among servers
+  size_t start = next() % serv.size();
+  size_t best = start;
+  unsigned int bestInflight = stats.get(serv[start]->getURI()).inflight;
+  for (size_t i = 1; i < serv.size() && bestInflight > 0; ++i) {
+    size_t pos = (start + i) % serv.size();
+    unsigned int inflight = stats.get(serv[pos]->getURI()).inflight;
+    if (inflight < bestInflight) {
+      best = pos;
+      bestInflight = inflight;
+    }
+  }
+  return serv[best]->getURI();
+}
+
+
+std::string
+LatencyPolicy::elect(const std::vector<boost::shared_ptr<Server> >& serv,
+                     const ServerStatistics& stats) {
+  if (serv.empty()) {
+    return "";
+  }
+  size_t start = next() % serv.size();
+  size_t best = start;
+  double bestCost = 0.;
+  for (size_t i = 0; i < serv.size(); ++i) {
+    size_t pos = (start + i) % serv.size();
+    ServerLoad load = stats.get(serv[pos]->getURI());
+    // a server never used yet is tried first to get a latency sample
+    if (load.requests == 0 && load.inflight == 0) {
+      return serv[pos]->getURI();
+    }
+    double cost = load.latency * (load.inflight + 1);
+    if (i == 0 || cost < bestCost) {
+      best = pos;
+      bestCost = cost;
+    }
+  }
+  return serv[best]->getURI();
+}
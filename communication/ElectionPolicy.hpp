@@ -0,0 +1,228 @@
+/**
+ * \file ElectionPolicy.hpp
+ * \brief This file defines the policies used to elect the server handling a request
+ */
+#ifndef __ELECTIONPOLICY__H__
+#define __ELECTIONPOLICY__H__
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include "Server.hpp"
+
+/**
+ * \brief Weight of the last sample in the latency moving average
+ */
+const double LATENCY_EWMA_ALPHA = 0.3;
+
+/**
+ * \struct ServerLoad
+ * \brief The load statistics of a server
+ */
+struct ServerLoad {
+  /**
+   * \brief Constructor
+   */
+  ServerLoad()
+    : inflight(0), latency(0.), requests(0), failures(0),
+      heartbeatRtt(0.), missedBeats(0) {}
+
+  /**
+   * \brief The number of requests sent and not answered yet
+   */
+  unsigned int inflight;
+  /**
+   * \brief The moving average of the response time, in seconds
+   */
+  double latency;
+  /**
+   * \brief The number of requests answered or failed
+   */
+  unsigned long requests;
+  /**
+   * \brief The number of requests failed
+   */
+  unsigned long failures;
+  /**
+   * \brief The round trip time of the last heartbeat, in seconds
+   */
+  double heartbeatRtt;
+  /**
+   * \brief The number of consecutive heartbeats left unanswered
+   */
+  unsigned int missedBeats;
+};
+
+
+/**
+ * \class ServerStatistics
+ * \brief Thread-safe collection of the load statistics of the servers,
+ * by server uri
+ */
+class ServerStatistics {
+public:
+  /**
+   * \brief Record that a request has been sent to a server
+   * \param uri the uri of the server
+   */
+  void
+  requestStarted(const std::string& uri);
+
+  /**
+   * \brief Record that a server answered a request
+   * \param uri the uri of the server
+   * \param elapsed the response time in seconds
+   */
+  void
+  requestCompleted(const std::string& uri, double elapsed);
+
+  /**
+   * \brief Record that a request to a server failed or timed out
+   * \param uri the uri of the server
+   * \param elapsed the time spent waiting in seconds
+   */
+  void
+  requestFailed(const std::string& uri, double elapsed);
+
+  /**
+   * \brief Record that a server answered a heartbeat
+   * \param uri the uri of the server
+   * \param rtt the round trip time in seconds
+   */
+  void
+  heartbeatReceived(const std::string& uri, double rtt);
+
+  /**
+   * \brief Record that a server did not answer a heartbeat in time
+   * \param uri the uri of the server
+   * \return the number of consecutive heartbeats missed
+   */
+  unsigned int
+  heartbeatMissed(const std::string& uri);
+
+  /**
+   * \brief Forget the statistics of a server
+   * \param uri the uri of the server
+   */
+  void
+  remove(const std::string& uri);
+
+  /**
+   * \brief Get the statistics of a server
+   * \param uri the uri of the server
+   * \return the statistics, empty ones if the server is unknown
+   */
+  ServerLoad
+  get(const std::string& uri) const;
+
+private:
+  /**
+   * \brief Update the statistics of a finished request
+   */
+  void
+  requestEnded(const std::string& uri, double elapsed, bool failed);
+
+  /**
+   * \brief The statistics by uri
+   */
+  std::map<std::string, ServerLoad> mloads;
+  /**
+   * \brief mutex protecting the statistics
+   */
+  mutable boost::mutex mmutex;
+};
+
+
+/**
+ * \class ElectionPolicy
+ * \brief Base class of the policies choosing a server among the eligible ones
+ */
+class ElectionPolicy {
+public:
+  /**
+   * \brief Constructor
+   */
+  ElectionPolicy() : mcounter(0) {}
+
+  /**
+   * \brief Destructor
+   */
+  virtual ~ElectionPolicy() {}
+
+  /**
+   * \brief Elect a server
+   * \param serv list of eligible servers
+   * \param stats the load statistics of the servers
+   * \return the uri of the choosen one, empty if there is none
+   */
+  virtual std::string
+  elect(const std::vector<boost::shared_ptr<Server> >& serv,
+        const ServerStatistics& stats) = 0;
+
+  /**
+   * \brief Create a policy from its name
+   * \param name roundrobin, leastoutstanding or latency
+   * \return the policy, throw a UserException if the name is unknown
+   */
+  static boost::shared_ptr<ElectionPolicy>
+  create(const std::string& name);
+
+protected:
+  /**
+   * \brief Get the next value of the rotation counter
+   * \return the counter
+   */
+  unsigned long
+  next();
+
+private:
+  /**
+   * \brief Rotation counter, used to spread the requests among equivalent servers
+   */
+  unsigned long mcounter;
+  /**
+   * \brief mutex protecting the counter
+   */
+  boost::mutex mmutex;
+};
+
+
+/**
+ * \class RoundRobinPolicy
+ * \brief Elect the servers in turn
+ */
+class RoundRobinPolicy : public ElectionPolicy {
+public:
+  std::string
+  elect(const std::vector<boost::shared_ptr<Server> >& serv,
+        const ServerStatistics& stats);
+};
+
+
+/**
+ * \class LeastOutstandingPolicy
+ * \brief Elect the server with the fewest requests in flight
+ */
+class LeastOutstandingPolicy : public ElectionPolicy {
+public:
+  std::string
+  elect(const std::vector<boost::shared_ptr<Server> >& serv,
+        const ServerStatistics& stats);
+};
+
+
+/**
+ * \class LatencyPolicy
+ * \brief Elect the server with the lowest expected response time, that is
+ * its average latency times the number of requests it is handling
+ */
+class LatencyPolicy : public ElectionPolicy {
+public:
+  std::string
+  elect(const std::vector<boost::shared_ptr<Server> >& serv,
+        const ServerStatistics& stats);
+};
+
+#endif // __ELECTIONPOLICY__H__
@@ -96,11 +96,10 @@ public:
   operator()() {
     Socket socket(*ctx_, ZMQ_REP);
     socket.connect(queue_.c_str());
-    std::string data;
+    Message data;
     while (true) {
-      data.clear();
       try {
-        data = socket.get();
+        socket.get(data);
       } catch (zmq::error_t &error) {
         LOG(boost::str(boost::format("[ERROR] %1%\n")
                        % error.what()), LogErr);
@@ -110,9 +109,11 @@ public:
       // Deserialize and call the target method
       if (!data.empty()) {
         try {
-          boost::shared_ptr<diet_profile_t> profile(my_deserialize(data));
+          boost::shared_ptr<diet_profile_t> profile(my_deserialize(data.data(), data.size()));
           server_->call(profile.get()); //FIXME: deal with possibly error
-          socket.send(my_serialize(profile.get()));
+          std::string result = my_serialize(profile.get(),
+                                            BinaryProfile::isBinary(data.data(), data.size()));
+          socket.sendNoCopy(result);
         } catch (const VishnuException& ex) {
           socket.send(ex.what());
           LOG(boost::str(boost::format("[ERROR] %1%\n")
@@ -49,14 +49,16 @@ private:
    * \return the serialized data (out data are updated)
    */
   std::string
-  doCall(std::string& data) throw(VishnuException) {
-    boost::shared_ptr<diet_profile_t> profile(my_deserialize(data));
+  doCall(const Message& data) throw(VishnuException) {
+    boost::shared_ptr<diet_profile_t> profile(my_deserialize(data.data(), data.size()));
+    // answer in the encoding of the request, old clients only know JSON
+    bool binary = BinaryProfile::isBinary(data.data(), data.size());
     int ret = server_->call(profile.get());
     if (ret != 0) {
       throw SystemException(ERRCODE_SYSTEM,
                             boost::str(boost::format("Service call failed for the profile %1%\n") % profile.get()->name));
     }
-    return my_serialize(profile.get());
+    return my_serialize(profile.get(), binary);
   }
 
 private:
@@ -43,13 +43,13 @@ public:
   operator()() {
     Socket socket(*ctx_, ZMQ_REP);
     socket.connect(uriInproc_.c_str());
-    std::string data;
+    // the requests are read in place in the zmq buffer
+    Message data;
 
     while (true) {
       //vishnu::exitProcessIfAnyZombieChild(-1);
-      data.clear();
       try {
-        data = socket.get();
+        socket.get(data);
       } catch (zmq::error_t &error) {
         LOG(boost::str(boost::format("[ERROR] %1%\n") % error.what()), LogErr);
         continue;
@@ -59,7 +59,7 @@ public:
       if (! data.empty()) {
         try {
           std::string resultSerialized = doCall(data);
-          socket.send(resultSerialized);
+          socket.sendNoCopy(resultSerialized);
         } catch (const VishnuException& ex) {
           diet_profile_t* profile = diet_profile_alloc("docall", 2);
           diet_string_set(profile, 0, "error");
@@ -77,11 +77,11 @@ protected:
   /**
    * \brief method to provide implementation specific behavior
    * to handle received data.
-   * \param data a string containing the data
+   * \param data the message containing the data
    * \return the updated data
    */
   virtual std::string
-  doCall(std::string& data) = 0;
+  doCall(const Message& data) = 0;
 
   /**
    * \brief zmq context
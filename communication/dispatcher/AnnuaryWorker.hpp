@@ -9,6 +9,7 @@
 
 
 #include <boost/algorithm/string/join.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include "Worker.hpp"
 #include "DIET_client.h"
 #include "UserException.hpp"
@@ -85,18 +86,28 @@ private:
    * \return the serialized data (out data are updated)
    */
   std::string
-  doCall(std::string& data) {
+  doCall(const Message& data) {
     using boost::format;
     using boost::str;
 
-    boost::shared_ptr<diet_profile_t> profile = my_deserialize(data);
+    boost::shared_ptr<diet_profile_t> profile = my_deserialize(data.data(), data.size());
+    bool binary = BinaryProfile::isBinary(data.data(), data.size());
     std::string servname = profile->name;
-    std::vector<boost::shared_ptr<Server> > serv = mann_->get(servname);
-    std::string uriServer = elect(serv);
+    std::string uriServer = mann_->elect(servname);
 
     if (!uriServer.empty()) {
-      abstract_call_gen(profile.get(), uriServer);
-      return my_serialize(profile.get());
+      ServerStatistics& stats = mann_->getStatistics();
+      boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+      stats.requestStarted(uriServer);
+      int ret = abstract_call_gen(profile.get(), uriServer);
+      boost::posix_time::time_duration elapsed =
+        boost::posix_time::microsec_clock::universal_time() - start;
+      if (ret == 0) {
+        stats.requestCompleted(uriServer, elapsed.total_microseconds() / 1000000.);
+      } else {
+        stats.requestFailed(uriServer, elapsed.total_microseconds() / 1000000.);
+      }
+      return my_serialize(profile.get(), binary);
     } else {
       // reset profile to handle result
       diet_profile_t* pb = diet_profile_alloc("response", 2);
@@ -104,23 +115,12 @@ private:
       diet_string_set(pb, 1, str(format("error %1%: the service %2% is not available")
                                  % ERRCODE_INVALID_PARAM
                                  % servname));
-      return my_serialize(pb);
+      std::string result = my_serialize(pb, binary);
+      diet_profile_free(pb);
+      return result;
     }
   }
 
-  /**
-   * \brief Elect a server
-   * \param serv list of eligible servers
-   * \return the choosen one
-   */
-  std::string
-  elect(const std::vector<boost::shared_ptr<Server> >& serv){
-    if (serv.empty()) {
-      return "";
-    }
-    return serv.at(0)->getURI();
-  }
-
 };
 
 
@@ -159,11 +159,12 @@ private:
   std::string cafile;
   /**
    * \brief Call the function
-   * \param data the serialized data containing the funcion and its parameters
+   * \param message the serialized data containing the funcion and its parameters
    * \return the serialized data (out data are updated)
    */
   std::string
-  doCall(std::string& data) {
+  doCall(const Message& message) {
+    std::string data = message.str();
     int mode = boost::lexical_cast<int>(data.substr(0,1));
     std::string result("OK");
 
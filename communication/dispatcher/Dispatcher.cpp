@@ -1,5 +1,6 @@
 #include "Dispatcher.hpp"
 #include "Server.hpp"
+#include "HeartbeatMonitor.hpp"
 #include <boost/make_shared.hpp>
 #include <boost/thread.hpp>
 #include "utilVishnu.hpp"
@@ -11,7 +12,8 @@
 
 Dispatcher::Dispatcher(const std::string &confFile)
   : uriAddr("tcp://127.0.0.1:5560"),
-    uriSubs("tcp://127.0.0.1:5561"), confFil(confFile), nthread(5), timeout(10) {
+    uriSubs("tcp://127.0.0.1:5561"), confFil(confFile), nthread(5), timeout(10),
+    electionPolicy("leastoutstanding") {
   if (!confFile.empty()) {
     config.initFromFile(confFile);
   }
@@ -25,7 +27,9 @@ Dispatcher::printConfiguration() const{
                                "disp_uriSubs=%2%"
                                "disp_timeout=%3%"
                                "disp_nbthread=%4%"
-                               ) % uriAddr % uriSubs % timeout % nthread), LogInfo);
+                               "disp_electionPolicy=%5%"
+                               ) % uriAddr % uriSubs % timeout % nthread
+                 % electionPolicy), LogInfo);
 }
 
 
@@ -35,6 +39,7 @@ Dispatcher::readConfiguration() {
   config.getConfigValue<std::string>(vishnu::DISP_URISUBS, uriSubs);
   config.getConfigValue<unsigned int>(vishnu::NBTHREADS, nthread);
   config.getConfigValue<unsigned int>(vishnu::TIMEOUT, timeout);
+  config.getConfigValue<std::string>(vishnu::DISP_ELECTION_POLICY, electionPolicy);
   printConfiguration();
 }
 
@@ -42,6 +47,7 @@ void
 Dispatcher::configureAnnuary() {
   // Prepare our context and socket
   ann = boost::make_shared<Annuary>();
+  ann->setElectionPolicy(ElectionPolicy::create(electionPolicy));
   std::string mid;
   config.getConfigValue<std::string>(vishnu::MACHINEID, mid);
 
@@ -69,29 +75,16 @@ Dispatcher::getAnnuary(){
 
 
 void
-Dispatcher::bayWatch(boost::shared_ptr<Annuary> ann, int timeout, std::string& confFile){
+Dispatcher::bayWatch(boost::shared_ptr<Annuary> ann, int timeout, bool useSsl, std::string& confFile){
   try {
     diet_initialize(confFile.c_str(), 0, NULL);
   } catch (VishnuException& e){
   }
+  // the servers are pinged concurrently, a dead one only costs the
+  // heartbeat deadline to the whole sweep
+  HeartbeatMonitor monitor(ann, useSsl);
   while (true){
-    // get all servers
-    std::vector<boost::shared_ptr<Server> > list = ann->get();
-    std::vector<boost::shared_ptr<Server> >::iterator iter;
-    std::string service = "heartbeat";
-    // For each server
-    for (iter = list.begin() ; iter != list.end() ; ++iter){
-      diet_profile_t* profile = diet_profile_alloc(service, 0);
-      // try to ping them
-      if (abstract_call_gen(profile, iter->get()->getURI())){
-        // If failed : remove the server
-        ann->remove(iter->get()->getName(), iter->get()->getURI());
-        LOG(boost::str(boost::format("[INFO]: removed %1%@%2% from the annuary")
-                       % iter->get()->getName()
-                       % iter->get()->getURI()), LogInfo);
-      }
-      diet_profile_free(profile);
-    }
+    monitor.sweep();
     // Sleep a bit
     sleep(timeout);
   }
@@ -116,11 +109,13 @@ Dispatcher::configureHandlers() {
   bool useSsl = false;
   if (! config.getConfigValue<bool>(vishnu::USE_SSL, useSsl) ||
       ! useSsl) { /* TLS dont required */
-    clientHandler.reset(new Handler4Clients(uriAddr, ann, nthread, false, ""));
+    // requests are forwarded asynchronously, only the subscriptions need workers,
+    // a server has the configured timeout to answer
+    broker.reset(new ServiceBroker(uriAddr, ann, timeout));
     serverHandler.reset(new Handler4Servers(uriSubs, ann, nthread, false, ""));
-    boost::thread th1(boost::bind(&Handler4Clients::run, clientHandler.get()));
+    boost::thread th1(boost::bind(&ServiceBroker::run, broker.get()));
     boost::thread th2(boost::bind(&Handler4Servers::run, serverHandler.get()));
-    boost::thread th3(boost::bind(&Dispatcher::bayWatch, ann, timeout, confFil));
+    boost::thread th3(boost::bind(&Dispatcher::bayWatch, ann, timeout, useSsl, confFil));
     th1.join();
     th2.join();
     th3.join();
@@ -141,7 +136,7 @@ Dispatcher::configureHandlers() {
       serverHandler.reset(new Handler4Servers(BACKEND_IPC_URI, ann, nthread, useSsl, sslCa));
       boost::thread th1(boost::bind(&Handler4Clients::run, clientHandler.get()));
       boost::thread th2(boost::bind(&Handler4Servers::run, serverHandler.get()));
-      boost::thread th3(boost::bind(&Dispatcher::bayWatch, ann, timeout, confFil));
+      boost::thread th3(boost::bind(&Dispatcher::bayWatch, ann, timeout, useSsl, confFil));
       th1.join();
       th2.join();
       th3.join();
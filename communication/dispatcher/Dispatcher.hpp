@@ -11,6 +11,7 @@
 #include <string>
 #include "Annuary.hpp"
 #include "handlers.hpp"
+#include "ServiceBroker.hpp"
 #include "ExecConfiguration.hpp"
 
 /**
@@ -37,13 +38,15 @@ public:
   getAnnuary();
 
   /**
-   * \brief Function that continuously check the content of the annuary with pings and remove it if ping fails
+   * \brief Function that continuously check the content of the annuary with pings and remove
+   * the servers missing several pings in a row
    * \param ann The annuary to check
    * \param timeout The frequency to sleep between each turn of check
+   * \param useSsl Whether the servers are reached through TLS
    * \param confFile The configuration file
    */
   static void
-  bayWatch(boost::shared_ptr<Annuary> ann, int timeout, std::string& confFile);
+  bayWatch(boost::shared_ptr<Annuary> ann, int timeout, bool useSsl, std::string& confFile);
 
 
 private:
@@ -80,9 +83,13 @@ private:
    */
   ExecConfiguration config;
   /**
-   * \brief The handlers of the clients
+   * \brief The handlers of the clients (with TLS)
    */
   boost::scoped_ptr<Handler4Clients> clientHandler;
+  /**
+   * \brief The broker forwarding the client requests (without TLS)
+   */
+  boost::scoped_ptr<ServiceBroker> broker;
   /**
    * \brief The handlers of the servers
    */
@@ -107,6 +114,10 @@ private:
    * \brief The timeout of the dispatcher
    */
   unsigned int timeout;
+  /**
+   * \brief The name of the policy used to elect the servers
+   */
+  std::string electionPolicy;
 };
 
 
@@ -0,0 +1,204 @@
+#include "HeartbeatMonitor.hpp"
+
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <boost/foreach.hpp>
+#include <boost/thread.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include "DIET_client.h"
+#include "Logger.hpp"
+
+// anonymous namespace
+namespace {
+  /**
+   * \brief Get the time elapsed since a date
+   * \param start the date
+   * \return the elapsed time in seconds
+   */
+  double
+  elapsedSeconds(const boost::posix_time::ptime& start) {
+    boost::posix_time::time_duration elapsed =
+      boost::posix_time::microsec_clock::universal_time() - start;
+    return elapsed.total_microseconds() / 1000000.;
+  }
+
+  /**
+   * \brief Ping a server through TLS, run in its own thread
+   * \param uri the uri of the server
+   * \param ok OUT, set to 1 if the server answered
+   * \param rtt OUT, the round trip time in seconds
+   */
+  void
+  pingOne(const std::string& uri, int* ok, double* rtt) {
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+    diet_profile_t* profile = diet_profile_alloc("heartbeat", 0);
+    *ok = (abstract_call_gen(profile, uri, true, 0) == 0) ? 1 : 0;
+    *rtt = elapsedSeconds(start);
+    diet_profile_free(profile);
+  }
+}
+
+
+HeartbeatMonitor::HeartbeatMonitor(boost::shared_ptr<Annuary> ann, bool useSsl)
+  : mann(ann), museSsl(useSsl), ctx(1), sequence(0) {}
+
+
+void
+HeartbeatMonitor::sweep() {
+  std::vector<boost::shared_ptr<Server> > list = mann->get();
+  // several servers (ums, tms, fms) may run in the same process
+  std::set<std::string> uris;
+  BOOST_FOREACH(const boost::shared_ptr<Server>& server, list) {
+    uris.insert(server->getURI());
+  }
+
+  RttMap answered;
+  if (museSsl) {
+    pingSsl(uris, answered);
+  } else {
+    pingZmq(uris, answered);
+  }
+
+  ServerStatistics& stats = mann->getStatistics();
+  std::set<std::string> deadUris;
+  BOOST_FOREACH(const std::string& uri, uris) {
+    RttMap::const_iterator it = answered.find(uri);
+    if (it != answered.end()) {
+      stats.heartbeatReceived(uri, it->second);
+      LOG(boost::str(boost::format("[DEBUG] heartbeat of %1% in %2%s")
+                     % uri % it->second), LogDebug);
+    } else {
+      unsigned int missed = stats.heartbeatMissed(uri);
+      LOG(boost::str(boost::format("[WARNING] %1% missed %2% heartbeat(s)")
+                     % uri % missed), LogWarning);
+      if (missed >= HEARTBEAT_MAX_MISSED) {
+        deadUris.insert(uri);
+      }
+    }
+  }
+
+  std::vector<boost::shared_ptr<Server> > dead;
+  BOOST_FOREACH(const boost::shared_ptr<Server>& server, list) {
+    if (deadUris.count(server->getURI())) {
+      dead.push_back(server);
+      LOG(boost::str(boost::format("[INFO]: removed %1%@%2% from the annuary")
+                     % server->getName()
+                     % server->getURI()), LogInfo);
+    }
+  }
+  // all the failed servers are removed in a single update of the index
+  if (!dead.empty()) {
+    mann->remove(dead);
+  }
+  BOOST_FOREACH(const std::string& uri, deadUris) {
+    stats.remove(uri);
+  }
+
+  // close the sockets of the servers no longer registered, dropping the
+  // heartbeats queued for them
+  for (SocketMap::iterator it = sockets.begin(); it != sockets.end();) {
+    if (!uris.count(it->first) || deadUris.count(it->first)) {
+      sockets.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+
+void
+HeartbeatMonitor::pingZmq(const std::set<std::string>& uris, RttMap& answered) {
+  std::string seq = boost::str(boost::format("%016x") % sequence++);
+  diet_profile_t* profile = diet_profile_alloc("heartbeat", 0);
+  std::string data = my_serialize(profile);
+  diet_profile_free(profile);
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+  boost::posix_time::ptime deadline = start + boost::posix_time::seconds(HEARTBEAT_DEADLINE);
+
+  // send all the heartbeats at once
+  BOOST_FOREACH(const std::string& uri, uris) {
+    Frames request;
+    request.push_back(makeFrame(seq.data(), seq.size()));
+    request.push_back(makeFrame(NULL, 0));
+    request.push_back(makeFrame(data.c_str(), data.length() + 1));
+    getSocket(uri)->sendFrames(request, ZMQ_NOBLOCK);
+  }
+
+  // then collect the answers until all arrived or the deadline expired
+  std::vector<zmq::pollitem_t> items;
+  std::vector<std::string> waited;
+  boost::posix_time::ptime now = start;
+  while (answered.size() < uris.size() && now < deadline) {
+    items.clear();
+    waited.clear();
+    BOOST_FOREACH(const std::string& uri, uris) {
+      if (!answered.count(uri)) {
+        zmq::pollitem_t item = { *getSocket(uri), 0, ZMQ_POLLIN, 0 };
+        items.push_back(item);
+        waited.push_back(uri);
+      }
+    }
+
+    long remaining = (deadline - now).total_milliseconds();
+    try {
+      zmq::poll(&items[0], items.size(), remaining * ZMQ_POLL_MSEC);
+    } catch (const zmq::error_t& e) {
+      if (EINTR != e.num()) {
+        LOG(boost::str(boost::format("[ERROR] %1%\n") % e.what()), LogErr);
+        break;
+      }
+    }
+
+    for (size_t i = 0; i < items.size(); ++i) {
+      if (!(items[i].revents & ZMQ_POLLIN)) {
+        continue;
+      }
+      Frames reply;
+      while (getSocket(waited[i])->getFrames(reply, ZMQ_NOBLOCK)) {
+        // answers to the previous sweeps are late and ignored
+        if (!reply.empty()
+            && std::string(static_cast<const char*>(reply[0]->data()), reply[0]->size()) == seq) {
+          answered[waited[i]] = elapsedSeconds(start);
+        }
+      }
+    }
+    now = boost::posix_time::microsec_clock::universal_time();
+  }
+}
+
+
+void
+HeartbeatMonitor::pingSsl(const std::set<std::string>& uris, RttMap& answered) {
+  std::vector<std::string> targets(uris.begin(), uris.end());
+  std::vector<int> ok(targets.size(), 0);
+  std::vector<double> rtts(targets.size(), 0.);
+
+  boost::thread_group pingers;
+  for (size_t i = 0; i < targets.size(); ++i) {
+    pingers.create_thread(boost::bind(&pingOne, targets[i], &ok[i], &rtts[i]));
+  }
+  pingers.join_all();
+
+  for (size_t i = 0; i < targets.size(); ++i) {
+    if (ok[i]) {
+      answered[targets[i]] = rtts[i];
+    }
+  }
+}
+
+
+boost::shared_ptr<Socket>
+HeartbeatMonitor::getSocket(const std::string& uri) {
+  SocketMap::iterator it = sockets.find(uri);
+  if (it != sockets.end()) {
+    return it->second;
+  }
+
+  boost::shared_ptr<Socket> sock(new Socket(ctx, ZMQ_DEALER));
+  sock->connect(uri);
+  sock->setLinger(0);
+  sockets[uri] = sock;
+  return sock;
+}
@@ -0,0 +1,106 @@
+/**
+ * \file HeartbeatMonitor.hpp
+ * \brief This file defines the monitor checking that the servers of the annuary are alive
+ */
+#ifndef _HEARTBEATMONITOR_HPP_
+#define _HEARTBEATMONITOR_HPP_
+
+#include <map>
+#include <set>
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include "zhelpers.hpp"
+#include "Annuary.hpp"
+
+/**
+ * \brief The time in seconds the servers have to answer a heartbeat
+ */
+const int HEARTBEAT_DEADLINE = 5;
+
+/**
+ * \brief The number of consecutive heartbeats a server may miss before
+ * being removed from the annuary
+ */
+const unsigned int HEARTBEAT_MAX_MISSED = 3;
+
+/**
+ * \class HeartbeatMonitor
+ * \brief Pings all the servers of the annuary at once and removes those
+ * that missed too many heartbeats. The round trip times are recorded in
+ * the statistics of the annuary.
+ */
+class HeartbeatMonitor : public boost::noncopyable {
+public:
+  /**
+   * \brief Constructor
+   * \param ann the annuary to check
+   * \param useSsl whether the servers are reached through TLS
+   */
+  HeartbeatMonitor(boost::shared_ptr<Annuary> ann, bool useSsl);
+
+  /**
+   * \brief Ping every server once and update the annuary
+   */
+  void
+  sweep();
+
+private:
+  /**
+   * \brief The round trip times of the servers that answered, by uri
+   */
+  typedef std::map<std::string, double> RttMap;
+
+  /**
+   * \brief Ping the servers over persistent zmq sockets
+   * \param uris the uris of the servers
+   * \param answered OUT, the servers that answered in time
+   */
+  void
+  pingZmq(const std::set<std::string>& uris, RttMap& answered);
+
+  /**
+   * \brief Ping the servers through TLS, one thread per server
+   * \param uris the uris of the servers
+   * \param answered OUT, the servers that answered in time
+   */
+  void
+  pingSsl(const std::set<std::string>& uris, RttMap& answered);
+
+  /**
+   * \brief Get the DEALER socket connected to a server, creating it on
+   * first use
+   * \param uri the uri of the server
+   * \return the socket
+   */
+  boost::shared_ptr<Socket>
+  getSocket(const std::string& uri);
+
+  /**
+   * \brief The sockets connected to the servers, by uri
+   */
+  typedef std::map<std::string, boost::shared_ptr<Socket> > SocketMap;
+
+  /**
+   * \brief The annuary
+   */
+  boost::shared_ptr<Annuary> mann;
+  /**
+   * \brief Whether the servers are reached through TLS
+   */
+  bool museSsl;
+  /**
+   * \brief The zmq context
+   */
+  zmq::context_t ctx;
+  /**
+   * \brief The sockets connected to the servers
+   */
+  SocketMap sockets;
+  /**
+   * \brief Counter identifying the sweeps, to discard late answers
+   */
+  unsigned long sequence;
+};
+
+#endif /* _HEARTBEATMONITOR_HPP_ */
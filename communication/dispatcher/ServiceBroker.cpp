@@ -0,0 +1,236 @@
+#include "ServiceBroker.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <boost/format.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include "DIET_client.h"
+#include "VishnuException.hpp"
+#include "UserException.hpp"
+#include "SystemException.hpp"
+#include "Logger.hpp"
+
+// anonymous namespace
+namespace {
+  /**
+   * \brief Maximum time in milliseconds spent waiting for an event, bounds
+   * the delay before a timed out request is answered
+   */
+  const long BROKER_POLL_INTERVAL = 1000;
+
+  /**
+   * \brief Get the time elapsed since a date
+   * \param start the date
+   * \return the elapsed time in seconds
+   */
+  double
+  elapsedSeconds(const boost::posix_time::ptime& start) {
+    boost::posix_time::time_duration elapsed =
+      boost::posix_time::microsec_clock::universal_time() - start;
+    return elapsed.total_microseconds() / 1000000.;
+  }
+
+  /**
+   * \brief Tell whether a frame is the empty delimiter ending an envelope
+   */
+  bool
+  isDelimiter(const boost::shared_ptr<zmq::message_t>& frame) {
+    return frame->size() == 0;
+  }
+}
+
+
+ServiceBroker::ServiceBroker(const std::string& uri,
+                             boost::shared_ptr<Annuary> ann,
+                             int timeout)
+  : ctx(1), frontend(ctx, ZMQ_ROUTER), muri(uri), mann(ann),
+    mtimeout(boost::posix_time::seconds(timeout)), nextRequestId(0) {}
+
+
+void
+ServiceBroker::run() {
+  try {
+    frontend.bind(muri.c_str());
+    std::string logMsg = boost::str(boost::format("[INFO] Server started on %1%") % muri);
+    std::cerr << logMsg << "\n";
+    LOG(logMsg, LogInfo);
+  } catch (const zmq::error_t& e) {
+    LOG(boost::str(boost::format("[ERROR] zmq socket_server (%1%) binding failed (%2%)")
+                   % muri % e.what()), LogErr);
+    exit(1);
+  }
+
+  std::vector<zmq::pollitem_t> items;
+  std::vector<std::string> uris;
+  while (true) {
+    items.clear();
+    uris.clear();
+    zmq::pollitem_t front = { frontend, 0, ZMQ_POLLIN, 0 };
+    items.push_back(front);
+    for (SocketMap::iterator it = servers.begin(); it != servers.end(); ++it) {
+      zmq::pollitem_t item = { *(it->second), 0, ZMQ_POLLIN, 0 };
+      items.push_back(item);
+      uris.push_back(it->first);
+    }
+
+    try {
+      zmq::poll(&items[0], items.size(), BROKER_POLL_INTERVAL * ZMQ_POLL_MSEC);
+    } catch (const zmq::error_t& e) {
+      if (EINTR != e.num()) {
+        LOG(boost::str(boost::format("[ERROR] %1%\n") % e.what()), LogErr);
+      }
+      continue;
+    }
+
+    for (size_t i = 1; i < items.size(); ++i) {
+      if (items[i].revents & ZMQ_POLLIN) {
+        handleServer(uris[i - 1]);
+      }
+    }
+    if (items[0].revents & ZMQ_POLLIN) {
+      handleClient();
+    }
+    expireRequests();
+  }
+}
+
+
+void
+ServiceBroker::handleClient() {
+  Frames frames;
+  while (frontend.getFrames(frames, ZMQ_NOBLOCK)) {
+    // the client envelope ends with an empty delimiter, followed by the body
+    Frames::iterator delim = std::find_if(frames.begin(), frames.end(), isDelimiter);
+    if (delim == frames.end() || delim + 1 == frames.end()) {
+      LOG("[WARNING] malformed request dropped", LogWarning);
+      continue;
+    }
+    Frames envelope(frames.begin(), delim + 1);
+    boost::shared_ptr<zmq::message_t> body = *(delim + 1);
+
+    std::string servname;
+    try {
+      const char* data = static_cast<const char*>(body->data());
+      // only the name of a binary profile is decoded, in place
+      if (BinaryProfile::isBinary(data, body->size())) {
+        servname = BinaryProfile::peekName(data, body->size());
+      } else {
+        servname = my_deserialize(data, body->size())->name;
+      }
+    } catch (const VishnuException& ex) {
+      replyError(envelope, ex.what());
+      continue;
+    }
+
+    std::string uri = mann->elect(servname);
+    if (uri.empty()) {
+      replyError(envelope,
+                 boost::str(boost::format("error %1%: the service %2% is not available")
+                            % ERRCODE_INVALID_PARAM
+                            % servname));
+      continue;
+    }
+
+    // fixed width identifiers keep the pending requests sorted by age
+    std::string requestId = boost::str(boost::format("%016x") % nextRequestId++);
+    Frames request;
+    request.push_back(makeFrame(requestId.data(), requestId.size()));
+    request.push_back(makeFrame(NULL, 0));
+    request.push_back(body);
+    if (!getServerSocket(uri)->sendFrames(request, ZMQ_NOBLOCK)) {
+      replyError(envelope,
+                 boost::str(boost::format("error %1%: the server %2% is overloaded")
+                            % ERRCODE_SYSTEM
+                            % uri));
+      continue;
+    }
+
+    PendingRequest& req = pending[requestId];
+    req.envelope = envelope;
+    req.service = servname;
+    req.uri = uri;
+    req.start = boost::posix_time::microsec_clock::universal_time();
+    mann->getStatistics().requestStarted(uri);
+  }
+}
+
+
+void
+ServiceBroker::handleServer(const std::string& uri) {
+  SocketMap::iterator server = servers.find(uri);
+  if (server == servers.end()) {
+    return;
+  }
+
+  Frames frames;
+  while (server->second->getFrames(frames, ZMQ_NOBLOCK)) {
+    // reply is: request id, empty delimiter, body
+    if (frames.size() < 3) {
+      LOG(boost::str(boost::format("[WARNING] malformed reply from %1% dropped") % uri),
+          LogWarning);
+      continue;
+    }
+    std::string requestId(static_cast<const char*>(frames[0]->data()), frames[0]->size());
+    PendingMap::iterator req = pending.find(requestId);
+    if (req == pending.end()) {
+      // the client has already been answered with a timeout error
+      continue;
+    }
+
+    Frames reply(req->second.envelope);
+    reply.insert(reply.end(), frames.begin() + 2, frames.end());
+    frontend.sendFrames(reply, ZMQ_NOBLOCK);
+    mann->getStatistics().requestCompleted(uri, elapsedSeconds(req->second.start));
+    pending.erase(req);
+  }
+}
+
+
+void
+ServiceBroker::expireRequests() {
+  boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+  // requests are sorted by age, stop at the first one still in time
+  PendingMap::iterator req = pending.begin();
+  while (req != pending.end() && now - req->second.start > mtimeout) {
+    LOG(boost::str(boost::format("[WARNING] %1% did not answer the request for %2% in time")
+                   % req->second.uri % req->second.service), LogWarning);
+    replyError(req->second.envelope,
+               boost::str(boost::format("error %1%: the server %2% did not answer in time")
+                          % ERRCODE_SYSTEM
+                          % req->second.uri));
+    mann->getStatistics().requestFailed(req->second.uri,
+                                        elapsedSeconds(req->second.start));
+    pending.erase(req++);
+  }
+}
+
+
+void
+ServiceBroker::replyError(Frames& envelope, const std::string& msg) {
+  diet_profile_t* profile = diet_profile_alloc("response", 2);
+  diet_string_set(profile, 0, "error");
+  diet_string_set(profile, 1, msg);
+  std::string data = my_serialize(profile);
+  diet_profile_free(profile);
+
+  Frames reply(envelope);
+  // same layout as Socket::send, including the trailing null character
+  reply.push_back(makeFrame(data.c_str(), data.length() + 1));
+  frontend.sendFrames(reply, ZMQ_NOBLOCK);
+}
+
+
+boost::shared_ptr<Socket>
+ServiceBroker::getServerSocket(const std::string& uri) {
+  SocketMap::iterator it = servers.find(uri);
+  if (it != servers.end()) {
+    return it->second;
+  }
+
+  boost::shared_ptr<Socket> sock(new Socket(ctx, ZMQ_DEALER));
+  sock->connect(uri);
+  sock->setLinger(0);
+  servers[uri] = sock;
+  return sock;
+}
+
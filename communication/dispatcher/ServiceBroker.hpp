@@ -0,0 +1,145 @@
+/**
+ * \file ServiceBroker.hpp
+ * \brief This file defines the broker forwarding the client requests to the servers
+ */
+#ifndef _SERVICEBROKER_HPP_
+#define _SERVICEBROKER_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include "zhelpers.hpp"
+#include "Annuary.hpp"
+
+/**
+ * \class ServiceBroker
+ * \brief Event-driven ROUTER to DEALER broker. Client requests are
+ * received on a ROUTER socket, forwarded to the elected server over a
+ * persistent DEALER socket and the replies are matched back to the
+ * clients as they arrive, so that a slow server never holds a thread.
+ */
+class ServiceBroker : public boost::noncopyable {
+public:
+  /**
+   * \brief Constructor
+   * \param uri the uri the clients connect to
+   * \param ann the annuary
+   * \param timeout the time in seconds a server has to answer a request
+   */
+  ServiceBroker(const std::string& uri,
+                boost::shared_ptr<Annuary> ann,
+                int timeout = DEFAULT_TIMEOUT);
+
+  /**
+   * \brief Main loop of the broker, never returns
+   */
+  void
+  run();
+
+private:
+  /**
+   * \struct PendingRequest
+   * \brief A request forwarded to a server and waiting for its reply
+   */
+  struct PendingRequest {
+    /**
+     * \brief The routing frames of the client
+     */
+    Frames envelope;
+    /**
+     * \brief The name of the requested service
+     */
+    std::string service;
+    /**
+     * \brief The uri of the server handling the request
+     */
+    std::string uri;
+    /**
+     * \brief When the request was forwarded
+     */
+    boost::posix_time::ptime start;
+  };
+
+  /**
+   * \brief Handle a request from a client
+   */
+  void
+  handleClient();
+
+  /**
+   * \brief Handle a reply from a server
+   * \param uri the uri of the server
+   */
+  void
+  handleServer(const std::string& uri);
+
+  /**
+   * \brief Answer the requests whose server did not reply in time
+   */
+  void
+  expireRequests();
+
+  /**
+   * \brief Send an error profile to a client
+   * \param envelope the routing frames of the client
+   * \param msg the error message
+   */
+  void
+  replyError(Frames& envelope, const std::string& msg);
+
+  /**
+   * \brief Get the DEALER socket connected to a server, creating it on
+   * first use
+   * \param uri the uri of the server
+   * \return the socket
+   */
+  boost::shared_ptr<Socket>
+  getServerSocket(const std::string& uri);
+
+  /**
+   * \brief The pending requests, by request identifier
+   */
+  typedef std::map<std::string, PendingRequest> PendingMap;
+  /**
+   * \brief The DEALER sockets, by server uri
+   */
+  typedef std::map<std::string, boost::shared_ptr<Socket> > SocketMap;
+
+  /**
+   * \brief The zmq context
+   */
+  zmq::context_t ctx;
+  /**
+   * \brief The socket receiving the client requests
+   */
+  Socket frontend;
+  /**
+   * \brief The uri of the frontend
+   */
+  std::string muri;
+  /**
+   * \brief The annuary
+   */
+  boost::shared_ptr<Annuary> mann;
+  /**
+   * \brief The time a server has to answer a request
+   */
+  boost::posix_time::time_duration mtimeout;
+  /**
+   * \brief The sockets connected to the servers
+   */
+  SocketMap servers;
+  /**
+   * \brief The requests waiting for a reply
+   */
+  PendingMap pending;
+  /**
+   * \brief Counter used to identify the requests
+   */
+  unsigned long nextRequestId;
+};
+
+#endif /* _SERVICEBROKER_HPP_ */
@@ -69,6 +69,22 @@ BOOST_AUTO_TEST_CASE( test_remove_n )
   BOOST_REQUIRE(ann.get().empty());
 }
 
+BOOST_AUTO_TEST_CASE( test_remove_several_n )
+{
+// Test the annuary class
+  Annuary ann(mservers);
+  std::vector<std::string> servicesTmp;
+  servicesTmp.push_back("loup");
+  ann.add("titi", "tutu", servicesTmp);
+  BOOST_REQUIRE_EQUAL(ann.get("loup").size(), 2);
+  std::vector<boost::shared_ptr<Server> > dead;
+  dead.push_back(boost::make_shared<Server>(name, services, uri));
+  dead.push_back(boost::make_shared<Server>("titi", servicesTmp, "tutu"));
+  ann.remove(dead);
+  BOOST_REQUIRE(ann.get().empty());
+  BOOST_REQUIRE(ann.get("loup").empty());
+}
+
 BOOST_AUTO_TEST_CASE( test_get_n )
 {
 // Test the annuary class
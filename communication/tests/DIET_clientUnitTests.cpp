@@ -114,6 +114,16 @@ BOOST_AUTO_TEST_CASE( my_test_serial_n )
   BOOST_REQUIRE_EQUAL(param2, "");
 }
 
+BOOST_AUTO_TEST_CASE( my_test_serial_binary_n )
+{
+  diet_profile_t* prof = diet_profile_alloc("alloc", 1);
+  diet_string_set(prof, 0, "param1");
+  boost::shared_ptr<diet_profile_t> prof2 = my_deserialize(my_serialize(prof, true));
+  BOOST_REQUIRE_EQUAL(prof2->name, "alloc");
+  BOOST_REQUIRE_EQUAL(prof2->params[0], "param1");
+  diet_profile_free(prof);
+}
+
 BOOST_AUTO_TEST_CASE( my_test_serial_b )
 {
   BOOST_REQUIRE_THROW(my_serialize(NULL), SystemException);
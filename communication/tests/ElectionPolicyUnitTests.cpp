@@ -0,0 +1,100 @@
+#include <boost/test/unit_test.hpp>
+#include <iostream>
+#include <set>
+#include <vector>
+#include <boost/make_shared.hpp>
+#include "ElectionPolicy.hpp"
+#include "Annuary.hpp"
+#include "VishnuException.hpp"
+
+std::vector<boost::shared_ptr<Server> > candidates;
+std::vector<std::string> offered;
+
+
+class ElectionFixture {
+public:
+  ElectionFixture(){
+    offered.clear();
+    offered.push_back("loup");
+    candidates.clear();
+    candidates.push_back(boost::make_shared<Server>("pierre", offered, "tcp://a:5555"));
+    candidates.push_back(boost::make_shared<Server>("pierre", offered, "tcp://b:5555"));
+    candidates.push_back(boost::make_shared<Server>("pierre", offered, "tcp://c:5555"));
+  }
+
+  ~ElectionFixture(){
+    candidates.clear();
+    offered.clear();
+  }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( election_policy_unit_tests, ElectionFixture )
+
+
+BOOST_AUTO_TEST_CASE( test_create_bad )
+{
+  BOOST_REQUIRE_THROW(ElectionPolicy::create("bad"), VishnuException);
+}
+
+BOOST_AUTO_TEST_CASE( test_elect_empty_n )
+{
+  ServerStatistics stats;
+  RoundRobinPolicy policy;
+  BOOST_REQUIRE(policy.elect(std::vector<boost::shared_ptr<Server> >(), stats).empty());
+}
+
+BOOST_AUTO_TEST_CASE( test_round_robin_n )
+{
+// Every server is elected once in a turn
+  ServerStatistics stats;
+  boost::shared_ptr<ElectionPolicy> policy = ElectionPolicy::create("roundrobin");
+  std::set<std::string> elected;
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    elected.insert(policy->elect(candidates, stats));
+  }
+  BOOST_REQUIRE_EQUAL(elected.size(), candidates.size());
+}
+
+BOOST_AUTO_TEST_CASE( test_least_outstanding_n )
+{
+  ServerStatistics stats;
+  stats.requestStarted("tcp://a:5555");
+  stats.requestStarted("tcp://a:5555");
+  stats.requestStarted("tcp://c:5555");
+  boost::shared_ptr<ElectionPolicy> policy = ElectionPolicy::create("leastoutstanding");
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    BOOST_REQUIRE_EQUAL(policy->elect(candidates, stats), "tcp://b:5555");
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_latency_n )
+{
+  ServerStatistics stats;
+  stats.requestStarted("tcp://a:5555");
+  stats.requestCompleted("tcp://a:5555", 2.);
+  stats.requestStarted("tcp://b:5555");
+  stats.requestCompleted("tcp://b:5555", 0.1);
+  stats.requestStarted("tcp://c:5555");
+  stats.requestFailed("tcp://c:5555", 120.);
+  boost::shared_ptr<ElectionPolicy> policy = ElectionPolicy::create("latency");
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    BOOST_REQUIRE_EQUAL(policy->elect(candidates, stats), "tcp://b:5555");
+  }
+  BOOST_REQUIRE_EQUAL(stats.get("tcp://c:5555").failures, 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_annuary_elect_spreads_n )
+{
+// A second server offering the service does receive requests
+  Annuary ann(candidates);
+  ann.setElectionPolicy(ElectionPolicy::create("roundrobin"));
+  std::set<std::string> elected;
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    elected.insert(ann.elect("loup"));
+  }
+  BOOST_REQUIRE_EQUAL(elected.size(), candidates.size());
+  BOOST_REQUIRE(ann.elect("bad").empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
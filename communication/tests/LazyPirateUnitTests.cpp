@@ -42,4 +42,31 @@ BOOST_AUTO_TEST_CASE( test_recv_b_addr )
   BOOST_REQUIRE_NE(lp.recv(), "ok");
 }
 
+BOOST_AUTO_TEST_CASE( test_send_pooled_n )
+{
+// Test the lazy pirate class with the connection manager
+  LazyPirateClient lp(addr);
+  BOOST_REQUIRE(lp.send("bonjour"));
+  BOOST_REQUIRE_EQUAL(lp.recv(), "ok");
+}
+
+BOOST_AUTO_TEST_CASE( test_send_pooled_reuse_n )
+{
+// Test that a released socket is reused by the next client
+  {
+    LazyPirateClient lp(addr);
+    BOOST_REQUIRE(lp.send("bonjour"));
+  }
+  LazyPirateClient lp2(addr);
+  BOOST_REQUIRE(lp2.send("bonjour"));
+  BOOST_REQUIRE_EQUAL(lp2.recv(), "ok");
+}
+
+BOOST_AUTO_TEST_CASE( test_send_pooled_b_addr )
+{
+// Test the lazy pirate class with the connection manager
+  LazyPirateClient lp("bad");
+  BOOST_REQUIRE_THROW(lp.send("bonjour"), std::exception);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
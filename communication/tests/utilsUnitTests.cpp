@@ -3,6 +3,7 @@
 #include <vector>
 #include "DIET_client.h"
 #include "utils.hpp"
+#include "SystemException.hpp"
 #include "TMS_Data/Job.hpp"
 #include "TMS_Data/SubmitOptions.hpp"
 
@@ -96,6 +97,34 @@ BOOST_AUTO_TEST_CASE( ProfileDeserialization ) {
   BOOST_REQUIRE(std::equal(params.begin(), params.end(), reference.begin()));
 }
 
+BOOST_AUTO_TEST_CASE( BinaryProfileRoundTrip ) {
+  diet_profile_t *profile = diet_profile_alloc("tutu", 3);
+  diet_string_set(profile, 0, "<xmi:XMI name=\"job\"/>");
+  diet_string_set(profile, 1, "");
+  diet_string_set(profile, 2, std::string("a\0b", 3));
+  std::string data = BinaryProfile::serialize(profile);
+  BOOST_REQUIRE(BinaryProfile::isBinary(data.data(), data.size()));
+  BOOST_REQUIRE_EQUAL(BinaryProfile::peekName(data.data(), data.size()), "tutu");
+  // the NUL byte appended by the sockets is accepted
+  data.push_back('\0');
+  boost::shared_ptr<diet_profile_t> decoded =
+    BinaryProfile::deserialize(data.data(), data.size());
+  BOOST_REQUIRE_EQUAL(decoded->name, "tutu");
+  BOOST_REQUIRE_EQUAL(decoded->param_count, 3);
+  BOOST_REQUIRE(decoded->params == profile->params);
+  diet_profile_free(profile);
+}
+
+BOOST_AUTO_TEST_CASE( BinaryProfileTruncated ) {
+  diet_profile_t *profile = diet_profile_alloc("tutu", 1);
+  diet_string_set(profile, 0, "7");
+  std::string data = BinaryProfile::serialize(profile);
+  diet_profile_free(profile);
+  BOOST_REQUIRE_THROW(BinaryProfile::deserialize(data.data(), data.size() - 1),
+                      SystemException);
+  BOOST_REQUIRE_THROW(BinaryProfile::deserialize("{}", 2), SystemException);
+}
+
 BOOST_AUTO_TEST_CASE( TMS_DataSerialization ) {
   TMS_Data::Job job;
   std::string res = JsonObject::serialize(job);
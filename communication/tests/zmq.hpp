@@ -13,6 +13,9 @@
 #define ZMQ_ROUTER 1
 #define ZMQ_DEALER 1
 #define ZMQ_QUEUE 1
+#define ZMQ_SNDMORE 2
+#define ZMQ_RCVMORE 13
+#define ZMQ_NOBLOCK 1
 
 bool
 setsockopt(int p1, int* p2, int p3);
@@ -33,12 +36,25 @@ public:
 };
 
 
+typedef void (free_fn)(void* data, void* hint);
+
 class message_t{
 public:
   message_t() : mbuff("ok") {
     msize = mbuff.length();
   }
 
+  message_t(void* p1, size_t p2, free_fn* p3, void* p4) : mbuff("ok") {
+    msize = mbuff.length();
+    p3(p1, p4);
+  }
+
+  void
+  copy(message_t* msg) {
+    mbuff = msg->mbuff;
+    msize = msg->msize;
+  }
+
   message_t(const std::string& p1) : mbuff("ok") {
     msize = mbuff.length();
   }
@@ -101,6 +117,11 @@ public:
     return true;
   }
 
+  void
+  getsockopt(int opt, void* value, size_t* size){
+    memset(value, 0, *size);
+  }
+
   void
   connect(const char* addr){
     maddr = std::string(addr);
@@ -1,5 +1,6 @@
 #include "utils.hpp"
 #include <iostream>
+#include <stdint.h>
 #include <sys/wait.h>
 #include "SystemException.hpp"
 #include "TMS_Data/Job.hpp"
@@ -378,6 +379,137 @@ JsonObject::deserialize(const std::string& encodedJson) {
 }
 
 
+// anonymous namespace
+namespace {
+  /**
+   * \brief Append a 4 bytes big endian length
+   * \param out the buffer
+   * \param value the length
+   */
+  void
+  appendLength(std::string& out, uint32_t value) {
+    out.push_back(static_cast<char>((value >> 24) & 0xff));
+    out.push_back(static_cast<char>((value >> 16) & 0xff));
+    out.push_back(static_cast<char>((value >> 8) & 0xff));
+    out.push_back(static_cast<char>(value & 0xff));
+  }
+
+  /**
+   * \brief Read a 4 bytes big endian length
+   * \param pos IN/OUT, the read position, moved after the length
+   * \param end the end of the buffer
+   * \return the length
+   */
+  uint32_t
+  readLength(const char*& pos, const char* end) {
+    if (end - pos < 4) {
+      throw SystemException(ERRCODE_INVDATA, "Truncated binary profile");
+    }
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(pos);
+    pos += 4;
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16)
+           | (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+  }
+
+  /**
+   * \brief Read a length-prefixed string
+   * \param pos IN/OUT, the read position, moved after the string
+   * \param end the end of the buffer
+   * \param value OUT, the string
+   */
+  void
+  readString(const char*& pos, const char* end, std::string& value) {
+    uint32_t length = readLength(pos, end);
+    if (static_cast<size_t>(end - pos) < length) {
+      throw SystemException(ERRCODE_INVDATA, "Truncated binary profile");
+    }
+    value.assign(pos, length);
+    pos += length;
+  }
+
+  /**
+   * \brief Check that a message holds a binary encoded profile
+   * \param data the message
+   * \param size the size of the message
+   */
+  void
+  checkVersion(const char* data, size_t size) {
+    if (!BinaryProfile::isBinary(data, size)) {
+      throw SystemException(ERRCODE_INVDATA, "Unknown profile encoding");
+    }
+  }
+}
+
+
+std::string
+BinaryProfile::serialize(diet_profile_t* prof) {
+  if (!prof) {
+    throw SystemException(ERRCODE_SYSTEM, "Cannot serialize a null pointer profile");
+  }
+  if (prof->param_count < 0
+      || prof->params.size() < static_cast<size_t>(prof->param_count)) {
+    throw SystemException(ERRCODE_INVDATA,
+                          "Incoherent profile, wrong number of parameters");
+  }
+
+  size_t size = 1 + 4 + prof->name.size() + 4;
+  for (int i = 0; i < prof->param_count; ++i) {
+    size += 4 + prof->params[i].size();
+  }
+
+  std::string out;
+  // room for the NUL byte the sockets append, to send it without copy
+  out.reserve(size + 1);
+  out.push_back(BINARY_PROFILE_V1);
+  appendLength(out, prof->name.size());
+  out.append(prof->name);
+  appendLength(out, prof->param_count);
+  for (int i = 0; i < prof->param_count; ++i) {
+    appendLength(out, prof->params[i].size());
+    out.append(prof->params[i]);
+  }
+  return out;
+}
+
+
+boost::shared_ptr<diet_profile_t>
+BinaryProfile::deserialize(const char* data, size_t size) {
+  checkVersion(data, size);
+  const char* pos = data + 1;
+  const char* end = data + size;
+
+  boost::shared_ptr<diet_profile_t> profile(new diet_profile_t);
+  readString(pos, end, profile->name);
+  uint32_t count = readLength(pos, end);
+  // each parameter takes at least its length
+  if (count > static_cast<size_t>(end - pos) / 4) {
+    throw SystemException(ERRCODE_INVDATA,
+                          "Incoherent profile, wrong number of parameters");
+  }
+  profile->param_count = count;
+  profile->params.resize(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    readString(pos, end, profile->params[i]);
+  }
+  // the sockets terminate the messages with a NUL byte
+  if (pos != end && !(pos + 1 == end && *pos == '\0')) {
+    throw SystemException(ERRCODE_INVDATA, "Trailing data in binary profile");
+  }
+  return profile;
+}
+
+
+std::string
+BinaryProfile::peekName(const char* data, size_t size) {
+  checkVersion(data, size);
+  const char* pos = data + 1;
+  const char* end = data + size;
+  std::string name;
+  readString(pos, end, name);
+  return name;
+}
+
+
 /**
  * @brief getJob
  * @return
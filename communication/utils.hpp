@@ -294,6 +294,61 @@ private:
 };
 
 
+/**
+ * \brief Version byte starting a binary encoded profile. A JSON encoded
+ * profile starts with '{', so both encodings can be told apart
+ */
+const char BINARY_PROFILE_V1 = '\x01';
+
+/**
+ * @class BinaryProfile
+ * @brief Compact binary encoding of the profiles: the version byte, then
+ * the name, the number of parameters and the parameters, each string being
+ * prefixed by its length (4 bytes, big endian). Unlike JSON, the parameters
+ * are neither escaped nor scanned.
+ */
+class BinaryProfile {
+public:
+  /**
+   * @brief Encode a profile
+   * @param prof the profile
+   * @return the encoded profile
+   */
+  static std::string
+  serialize(diet_profile_t* prof);
+
+  /**
+   * @brief Decode a profile
+   * @param data the encoded profile, a trailing NUL byte is allowed
+   * @param size the size of the encoded profile
+   * @return the profile, throw a SystemException if the data are invalid
+   */
+  static boost::shared_ptr<diet_profile_t>
+  deserialize(const char* data, size_t size);
+
+  /**
+   * @brief Get the name of the service of an encoded profile, without
+   * decoding its parameters
+   * @param data the encoded profile
+   * @param size the size of the encoded profile
+   * @return the name, throw a SystemException if the data are invalid
+   */
+  static std::string
+  peekName(const char* data, size_t size);
+
+  /**
+   * @brief Tell whether a message holds a binary encoded profile
+   * @param data the message
+   * @param size the size of the message
+   * @return true if the message starts with the version byte
+   */
+  static bool
+  isBinary(const char* data, size_t size) {
+    return size > 0 && data[0] == BINARY_PROFILE_V1;
+  }
+};
+
+
 namespace vishnu {
 
   /**
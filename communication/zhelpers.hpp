@@ -10,19 +10,116 @@
 #include <iostream>
 #include <cstring>
 #include <cerrno>
+#include <vector>
+#include <stdint.h>
 
 #include <zmq.hpp>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/noncopyable.hpp>
-#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 #include "utils.hpp"
+#include "ConnectionManager.hpp"
 
 /**
  * \brief The default timeout value used to comunicate
  */
 const int DEFAULT_TIMEOUT = 120; // seconds
 
+/**
+ * \brief Factor to express a poll timeout in milliseconds
+ * (zmq::poll takes microseconds before zmq 3)
+ */
+#if ZMQ_VERSION_MAJOR >= 3
+const long ZMQ_POLL_MSEC = 1;
+#else
+const long ZMQ_POLL_MSEC = 1000;
+#endif
+
+/**
+ * \brief The frames of a multipart message
+ */
+typedef std::vector<boost::shared_ptr<zmq::message_t> > Frames;
+
+/**
+ * \brief Create a frame holding a copy of the given buffer
+ * \param data the buffer
+ * \param size the size of the buffer
+ * \return the frame
+ */
+inline boost::shared_ptr<zmq::message_t>
+makeFrame(const char* data, size_t size) {
+  boost::shared_ptr<zmq::message_t> frame(new zmq::message_t(size));
+  if (size) {
+    memcpy(frame->data(), data, size);
+  }
+  return frame;
+}
+
+/**
+ * \class Message
+ * \brief A received message. It owns the zmq buffer and gives access to
+ * the data in place, without the NUL byte terminating the messages
+ */
+class Message : public boost::noncopyable {
+public:
+  /**
+   * \brief Get the data
+   * \return the beginning of the zmq buffer
+   */
+  const char*
+  data() const {
+    return static_cast<const char*>(msg_.data());
+  }
+
+  /**
+   * \brief Get the size of the data
+   * \return the size, without the terminating NUL byte
+   */
+  size_t
+  size() const {
+    size_t size = msg_.size();
+    if (size > 0 && data()[size - 1] == '\0') {
+      --size;
+    }
+    return size;
+  }
+
+  /**
+   * \brief Tell whether the message holds no data
+   * \return true if the message is empty
+   */
+  bool
+  empty() const {
+    return size() == 0;
+  }
+
+  /**
+   * \brief Get a copy of the data
+   * \return the data
+   */
+  std::string
+  str() const {
+    return std::string(data(), size());
+  }
+
+  /**
+   * \brief Get the underlying zmq message
+   * \return the message
+   */
+  zmq::message_t&
+  frame() {
+    return msg_;
+  }
+
+private:
+  /**
+   * \brief The zmq message (zmq::message_t::data is not const)
+   */
+  mutable zmq::message_t msg_;
+};
+
+
 /**
  * \class Socket
  * \brief wraps zmq::socket_t to simplify its use
@@ -98,6 +195,32 @@ public:
     return send(data, strlen(data)+1, flags);
   }
 
+  /**
+   * \brief send data without copying it, the buffer is handed over to zmq
+   * \param data string to be sent, left empty
+   * \param flags zmq flags
+   * \return true if it succeeded
+   */
+  bool
+  sendNoCopy(std::string& data, int flags = 0) {
+    std::string* buffer = new std::string;
+    buffer->swap(data);
+    buffer->push_back('\0');
+    zmq::message_t msg(&(*buffer)[0], buffer->size(), &releaseString, buffer);
+    return socket_t::send(msg, flags);
+  }
+
+  /**
+   * \brief send a zmq message, its content is handed over to zmq
+   * \param msg the message
+   * \param flags zmq flags
+   * \return true if it succeeded
+   */
+  bool
+  send(zmq::message_t& msg, int flags = 0) {
+    return socket_t::send(msg, flags);
+  }
+
   /**
    * \brief get response for server
    * \param flags zmq flags
@@ -105,12 +228,24 @@ public:
    */
   std::string
   get(int flags = 0) {
-    zmq::message_t message;
+    Message message;
+    get(message, flags);
+    return message.str();
+  }
+
+  /**
+   * \brief get response for server, without copying it
+   * \param message OUT, the message received
+   * \param flags zmq flags
+   * \throw error_t if it fails
+   */
+  void
+  get(Message& message, int flags = 0) {
     bool rv = false;
 
     do {
       try {
-        rv = recv(&message, flags);
+        rv = recv(&message.frame(), flags);
         break;
       } catch (const zmq::error_t& e) {
         if (EINTR == e.num()) {
@@ -124,21 +259,86 @@ public:
     if (!rv) {
       throw zmq::error_t();
     }
+  }
 
-    char* decData;
-    int decDataLength = message.size();
-    //    if (cipher != NULL) {
-    //      decDataLength = cipher->aesDecrypt(reinterpret_cast<unsigned char*>(message.data()), decDataLength, &decData);
-    //    } else {
-    decData = static_cast<char*>(message.data());
-    //   }
-    const char* pos = decData + decDataLength;
-    std::string ret = std::string(static_cast<const char*>(decData), pos);
-    ret.erase(std::remove(ret.begin(), ret.end(), '\0'), ret.end());
-    return ret;
+  /**
+   * \brief receive all the frames of a multipart message, the frames
+   * are handed out as is (no copy)
+   * \param frames OUT, the received frames
+   * \param flags zmq flags
+   * \return true if it succeeded
+   */
+  bool
+  getFrames(Frames& frames, int flags = 0) {
+    frames.clear();
+    bool more = true;
+    while (more) {
+      boost::shared_ptr<zmq::message_t> frame(new zmq::message_t);
+      bool rv = false;
+      try {
+        rv = recv(frame.get(), flags);
+      } catch (const zmq::error_t& e) {
+        if (EINTR == e.num()) {
+          continue;
+        }
+        throw;
+      }
+      if (!rv) {
+        return false;
+      }
+      frames.push_back(frame);
+      // the following parts of a message are already there
+      flags &= ~ZMQ_NOBLOCK;
+      more = hasMore();
+    }
+    return true;
+  }
+
+  /**
+   * \brief send the frames of a multipart message, the frames are
+   * emptied by zmq once sent
+   * \param frames the frames to be sent
+   * \param flags zmq flags
+   * \return true if it succeeded
+   */
+  bool
+  sendFrames(Frames& frames, int flags = 0) {
+    for (size_t i = 0; i < frames.size(); ++i) {
+      int more = (i + 1 < frames.size()) ? ZMQ_SNDMORE : 0;
+      if (!socket_t::send(*frames[i], flags | more)) {
+        return false;
+      }
+    }
+    return true;
   }
 
 private:
+  /**
+   * \brief free function of the buffers given to sendNoCopy
+   * \param data the buffer
+   * \param hint the string owning the buffer
+   */
+  static void
+  releaseString(void* data, void* hint) {
+    delete static_cast<std::string*>(hint);
+  }
+
+  /**
+   * \brief tells whether the last received frame is followed by others
+   * \return true if more frames are pending
+   */
+  bool
+  hasMore() {
+#if ZMQ_VERSION_MAJOR >= 3
+    int more = 0;
+#else
+    int64_t more = 0;
+#endif
+    size_t size = sizeof(more);
+    getsockopt(ZMQ_RCVMORE, &more, &size);
+    return more != 0;
+  }
+
   /**
    * \brief internal method that sends message
    * \param data buffer to be sent
@@ -182,10 +382,37 @@ public:
                    const std::string& addr,
                    const int& timeout = DEFAULT_TIMEOUT,
                    int verbosity = 1)
-    : addr_(addr), ctx_(ctx), timeout_(timeout * 1000000), _verbosity(verbosity) {
+    : addr_(addr), ctx_(ctx), pool_(NULL), healthy_(false),
+      timeout_(timeout * 1000000), _verbosity(verbosity) {
     reset();
   }
 
+  /**
+   * \brief Constructor using the sockets of the process-wide
+   * connection manager
+   * \param addr the address to connect
+   * \param timeout the timeout before retrying to send the message
+   * \param verbosity the verbosity of the communication
+   */
+  explicit LazyPirateClient(const std::string& addr,
+                            const int& timeout = DEFAULT_TIMEOUT,
+                            int verbosity = 1)
+    : addr_(addr), ctx_(ConnectionManager::instance().context()),
+      pool_(&ConnectionManager::instance()), healthy_(false),
+      timeout_(timeout * 1000000), _verbosity(verbosity) {
+    sock_ = pool_->acquire(addr_);
+  }
+
+  /**
+   * \brief Destructor, gives the socket back to the pool if the last
+   * exchange completed
+   */
+  ~LazyPirateClient() {
+    if (pool_ && healthy_) {
+      pool_->release(addr_, sock_);
+    }
+  }
+
   /**
    * \brief most of the pattern is implemented here
    * \param data message to be sent
@@ -194,8 +421,12 @@ public:
    */
   bool
   send(const std::string& data, int retries = 3) {
+    healthy_ = false;
+    // the request is copied once, the retries share its buffer
+    zmq::message_t request(data.length() + 1);
+    memcpy(request.data(), data.c_str(), data.length() + 1);
     while (retries) {
-      sock_->send(data);
+      sendCopy(request);
       bool expect_reply(true);
 
       while (expect_reply) {
@@ -203,8 +434,9 @@ public:
         zmq::poll(&items[0], 1, timeout_);
 
         if (items[0].revents & ZMQ_POLLIN) {
-          buff_ = sock_->get();
-          if (buff_.length()) {
+          sock_->get(reply_);
+          if (!reply_.empty()) {
+            healthy_ = true;
             return true;
           } else {
             if (_verbosity) {
@@ -224,7 +456,7 @@ public:
               std::cerr << boost::format("W: no response from %1%, retrying ...\n") % addr_;
             }
             reset();
-            sock_->send(data);
+            sendCopy(request);
           }
         }
       }
@@ -237,16 +469,42 @@ public:
    */
   std::string
   recv() const {
-    return buff_;
+    return reply_.str();
+  }
+
+  /**
+   * \brief Get the message received, without copying it
+   * \return the message, valid until the next call of send
+   */
+  const Message&
+  reply() const {
+    return reply_;
   }
 
 
 private:
   /**
-   * \brief Reset the connection
+   * \brief Send a request, sharing its buffer rather than copying it
+   * \param request the request
+   */
+  void
+  sendCopy(zmq::message_t& request) {
+    zmq::message_t msg;
+    msg.copy(&request);
+    sock_->send(msg);
+  }
+
+  /**
+   * \brief Reset the connection. With a connection manager, the idle
+   * sockets of the server are dropped too since it stopped answering
    */
   void
   reset() {
+    if (pool_) {
+      pool_->invalidate(addr_);
+      sock_ = pool_->acquire(addr_);
+      return;
+    }
     sock_.reset(new Socket(ctx_, ZMQ_REQ));
     sock_->connect(addr_);
     sock_->setLinger(0);
@@ -257,17 +515,25 @@ private:
    */
   std::string addr_;
   /**
-   * \brief The buffer storing the messages
+   * \brief The last message received
    */
-  std::string buff_;
+  Message reply_;
   /**
    * \brief The context
    */
   zmq::context_t& ctx_;
+  /**
+   * \brief The connection manager owning the socket, if any
+   */
+  ConnectionManager* pool_;
+  /**
+   * \brief Whether the last request/reply exchange completed
+   */
+  bool healthy_;
   /**
    * \brief The socket
    */
-  boost::scoped_ptr<Socket> sock_;
+  boost::shared_ptr<Socket> sock_;
   /**
    * \brief The timeout
    */
@@ -0,0 +1,23 @@
+-- This script is for update of the VISHNU database content
+-- Script name          : database_update_idcounters_mysql.sql
+-- Script owner         : SysFera SA
+
+-- REVISIONS
+-- Revision nb          : 1.0
+-- Revision comment     : counters of the generated identifiers, reserved by blocks
+--                        by the servers. They start above the rows numbered by
+--                        the previous releases.
+
+alter table vishnu add cptauth bigint NOT NULL default 0;
+alter table vishnu add cptfiletransfer bigint NOT NULL default 0;
+alter table vishnu add cptjob bigint NOT NULL default 0;
+alter table vishnu add cptmachine bigint NOT NULL default 0;
+alter table vishnu add cptuser bigint NOT NULL default 0;
+alter table vishnu add cptwork bigint NOT NULL default 0;
+
+update vishnu set cptauth=(select coalesce(max(numauthsystemid), 0) from authsystem);
+update vishnu set cptfiletransfer=(select coalesce(max(numfiletransferid), 0) from filetransfer);
+update vishnu set cptjob=(select coalesce(max(numjobid), 0) from job);
+update vishnu set cptmachine=(select coalesce(max(nummachineid), 0) from machine);
+update vishnu set cptuser=(select coalesce(max(numuserid), 0) from users);
+update vishnu set cptwork=(select coalesce(max(id), 0) from work);
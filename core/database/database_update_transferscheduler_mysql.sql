@@ -0,0 +1,17 @@
+-- This script is for update of the VISHNU database content
+-- Script name          : database_update_transferscheduler_mysql.sql
+-- Script owner         : SysFera SA
+
+-- REVISIONS
+-- Revision nb          : 1.0
+-- Revision comment     : state of the transfers queued by the servers: the kind
+--                        of transfer, its command, the bytes already copied and
+--                        the server running it, so a restarted server resumes
+--                        its queue. The login reaching the source is kept for
+--                        the sources which are not VISHNU machines.
+
+alter table filetransfer add transfertype integer NOT NULL default 0;
+alter table filetransfer add transfercmd varchar(255);
+alter table filetransfer add bytesdone bigint NOT NULL default 0;
+alter table filetransfer add serveruri varchar(255);
+alter table filetransfer add sourceuser varchar(255);
@@ -350,6 +350,11 @@ CREATE TABLE `filetransfer` (
   `trcommand` int(11) DEFAULT NULL,
   `userid` varchar(255) DEFAULT NULL,
   `vsession_numsessionid` bigint(20) NOT NULL,
+  `transfertype` int(11) NOT NULL DEFAULT 0,
+  `transfercmd` varchar(255) DEFAULT NULL,
+  `bytesdone` bigint(20) NOT NULL DEFAULT 0,
+  `serveruri` varchar(255) DEFAULT NULL,
+  `sourceuser` varchar(255) DEFAULT NULL,
   PRIMARY KEY (`numfiletransferid`),
   KEY `FKFCE97167F58538BC` (`vsession_numsessionid`),
   CONSTRAINT `FKFCE97167F58538BC` FOREIGN KEY (`vsession_numsessionid`) REFERENCES `vsession` (`numsessionid`) ON DELETE CASCADE
@@ -911,6 +916,12 @@ CREATE TABLE `vishnu` (
   `formatiduser` varchar(255) DEFAULT NULL,
   `formatidwork` varchar(255) DEFAULT NULL,
   `updatefreq` int(11) DEFAULT NULL,
+  `cptauth` bigint(20) NOT NULL DEFAULT 0,
+  `cptfiletransfer` bigint(20) NOT NULL DEFAULT 0,
+  `cptjob` bigint(20) NOT NULL DEFAULT 0,
+  `cptmachine` bigint(20) NOT NULL DEFAULT 0,
+  `cptuser` bigint(20) NOT NULL DEFAULT 0,
+  `cptwork` bigint(20) NOT NULL DEFAULT 0,
   PRIMARY KEY (`vishnuid`)
 ) ENGINE=InnoDB AUTO_INCREMENT=378 DEFAULT CHARSET=latin1;
 /*!40101 SET character_set_client = @saved_cs_client */;
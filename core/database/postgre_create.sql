@@ -413,7 +413,12 @@ CREATE TABLE filetransfer (
     transferid character varying(255),
     trcommand integer,
     userid character varying(255),
-    vsession_numsessionid bigint NOT NULL
+    vsession_numsessionid bigint NOT NULL,
+    transfertype integer DEFAULT 0 NOT NULL,
+    transfercmd character varying(255),
+    bytesdone bigint DEFAULT 0 NOT NULL,
+    serveruri character varying(255),
+    sourceuser character varying(255)
 );
 
 
@@ -1082,7 +1087,13 @@ CREATE TABLE vishnu (
     formatidmachine character varying(255),
     formatiduser character varying(255),
     formatidwork character varying(255),
-    updatefreq integer
+    updatefreq integer,
+    cptauth bigint DEFAULT 0 NOT NULL,
+    cptfiletransfer bigint DEFAULT 0 NOT NULL,
+    cptjob bigint DEFAULT 0 NOT NULL,
+    cptmachine bigint DEFAULT 0 NOT NULL,
+    cptuser bigint DEFAULT 0 NOT NULL,
+    cptwork bigint DEFAULT 0 NOT NULL
 );
 
 
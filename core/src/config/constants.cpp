@@ -47,7 +47,12 @@ namespace vishnu {
     /* [34] */ {HAS_UMS, "enableUMS", BOOL_PARAMETER},
     /* [35] */ {HAS_TMS, "enableTMS", BOOL_PARAMETER},
     /* [36] */ {HAS_FMS, "enableFMS", BOOL_PARAMETER},
-    /* [37] */ {IPC_URI_BASE, "ipcUriBase", URI_PARAMETER}
+    /* [37] */ {IPC_URI_BASE, "ipcUriBase", URI_PARAMETER},
+    /* [38] */ {DISP_ELECTION_POLICY, "disp_electionPolicy", STRING_PARAMETER},
+    /* [39] */ {SESSION_CACHE_TTL, "sessionCacheTtl", INT_PARAMETER},
+    /* [40] */ {OUTPUT_TRANSFER_PARALLELISM, "outputTransferParallelism", INT_PARAMETER},
+    /* [41] */ {TRANSFERS_LIMIT, "transfersLimit", INT_PARAMETER},
+    /* [42] */ {TRANSFERS_PER_HOST_LIMIT, "transfersPerHostLimit", INT_PARAMETER}
   };
 
   std::map<cloud_env_vars_t, std::string> CLOUD_ENV_VARS =  boost::assign::map_list_of
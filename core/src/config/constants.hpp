@@ -60,7 +60,12 @@ namespace vishnu {
     HAS_UMS,
     HAS_TMS,
     HAS_FMS,
-    IPC_URI_BASE
+    IPC_URI_BASE,
+    DISP_ELECTION_POLICY,
+    SESSION_CACHE_TTL,
+    OUTPUT_TRANSFER_PARALLELISM,
+    TRANSFERS_LIMIT,
+    TRANSFERS_PER_HOST_LIMIT
   };
 
   /**
@@ -123,7 +128,8 @@ namespace vishnu {
   enum transfert_type_t {
     SCP_TRANSFER = 0,
     RSYNC_TRANSFER = 1,
-    UNDEFINED_TRANSFER_MANAGER = 1
+    UNDEFINED_TRANSFER_MANAGER = 2,
+    PARALLEL_TRANSFER = 3
   };
 
 
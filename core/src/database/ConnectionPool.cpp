@@ -0,0 +1,231 @@
+/**
+ * \file ConnectionPool.cpp
+ * \brief This file implements the pool handing out the database connections
+ */
+#include "ConnectionPool.hpp"
+
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+
+#include "SystemException.hpp"
+#include "Logger.hpp"
+
+using boost::posix_time::microsec_clock;
+using boost::posix_time::ptime;
+
+
+ConnectionPool::ConnectionPool(int size, Checker checker, Connector connector,
+                               int timeout)
+  : mstates(size, FREE), mlastUsed(size), mchecker(checker),
+    mconnector(connector), mtimeout(boost::posix_time::seconds(timeout)),
+    mstopped(false), msync(new Sync()), mreconnector(NULL), mowner(getpid()) {
+  for (int i = 0; i < size; ++i) {
+    mfree.push_back(i);
+  }
+  mmetrics.size = size;
+}
+
+
+ConnectionPool::~ConnectionPool() {
+  stop();
+  delete mreconnector;
+  delete msync;
+}
+
+
+int
+ConnectionPool::acquire() {
+  ptime start = microsec_clock::universal_time();
+  ptime deadline = start + mtimeout;
+  bool waited = false;
+
+  checkOwner();
+  boost::unique_lock<boost::mutex> lock(msync->mutex);
+  while (true) {
+    while (mfree.empty()) {
+      waited = true;
+      if (!msync->available.timed_wait(lock, deadline) && mfree.empty()) {
+        ++mmetrics.timeouts;
+        throw SystemException(ERRCODE_DBCONN,
+                              boost::str(boost::format("No database connection freed within %1%s "
+                                                       "(%2% in use, %3% broken)")
+                                         % mtimeout.total_seconds()
+                                         % mmetrics.inUse
+                                         % mbroken.size()));
+      }
+    }
+
+    int pos = mfree.front();
+    mfree.pop_front();
+    mstates[pos] = USED;
+    ++mmetrics.inUse;
+
+    // the connections idle for a while may have been closed by the server
+    ptime now = microsec_clock::universal_time();
+    if (mlastUsed[pos].is_not_a_date_time()
+        || now - mlastUsed[pos] > boost::posix_time::seconds(DB_POOL_CHECK_INTERVAL)) {
+      lock.unlock();
+      bool alive = false;
+      try {
+        alive = mchecker(pos);
+      } catch (...) {
+      }
+      lock.lock();
+      if (!alive) {
+        --mmetrics.inUse;
+        markBroken(pos);
+        continue;
+      }
+    }
+
+    double wait = (microsec_clock::universal_time() - start).total_microseconds() / 1000000.;
+    ++mmetrics.acquisitions;
+    if (waited) {
+      ++mmetrics.waits;
+    }
+    mmetrics.totalWait += wait;
+    if (wait > mmetrics.maxWait) {
+      mmetrics.maxWait = wait;
+    }
+    if (mmetrics.inUse > mmetrics.peakInUse) {
+      mmetrics.peakInUse = mmetrics.inUse;
+    }
+    return pos;
+  }
+}
+
+
+void
+ConnectionPool::release(int pos) {
+  checkOwner();
+  boost::lock_guard<boost::mutex> lock(msync->mutex);
+  if (pos < 0 || pos >= static_cast<int>(mstates.size()) || mstates[pos] != USED) {
+    return;
+  }
+  mstates[pos] = FREE;
+  mlastUsed[pos] = microsec_clock::universal_time();
+  --mmetrics.inUse;
+  // the connection used last is handed out first, the others may stay idle
+  mfree.push_front(pos);
+  msync->available.notify_one();
+}
+
+
+void
+ConnectionPool::invalidate(int pos) {
+  checkOwner();
+  boost::lock_guard<boost::mutex> lock(msync->mutex);
+  if (pos < 0 || pos >= static_cast<int>(mstates.size()) || mstates[pos] != USED) {
+    return;
+  }
+  --mmetrics.inUse;
+  markBroken(pos);
+}
+
+
+void
+ConnectionPool::stop() {
+  checkOwner();
+  {
+    boost::lock_guard<boost::mutex> lock(msync->mutex);
+    mstopped = true;
+    msync->brokenCond.notify_all();
+  }
+  if (mreconnector != NULL && mreconnector->joinable()) {
+    mreconnector->join();
+  }
+}
+
+
+ConnectionPoolMetrics
+ConnectionPool::getMetrics() {
+  checkOwner();
+  boost::lock_guard<boost::mutex> lock(msync->mutex);
+  ConnectionPoolMetrics metrics = mmetrics;
+  metrics.broken = mbroken.size();
+  return metrics;
+}
+
+
+void
+ConnectionPool::checkOwner() {
+  if (getpid() == mowner) {
+    return;
+  }
+  // a forked process starts with this thread only: the locks copied from
+  // the parent may be held by a thread which does not exist here, and the
+  // reconnection thread is not running, both are left behind
+  mowner = getpid();
+  msync = new Sync();
+  mreconnector = NULL;
+  // the connection being reopened by the parent is still broken here
+  mbroken.clear();
+  for (size_t pos = 0; pos < mstates.size(); ++pos) {
+    if (mstates[pos] == BROKEN) {
+      mbroken.push_back(pos);
+    }
+  }
+  LOG(boost::str(boost::format("[INFO] database pool taken over by the process %1% "
+                               "(%2% broken connections)") % mowner % mbroken.size()),
+      LogInfo);
+
+  boost::lock_guard<boost::mutex> lock(msync->mutex);
+  if (!mstopped && !mbroken.empty()) {
+    mreconnector = new boost::thread(boost::bind(&ConnectionPool::reconnectLoop, this));
+  }
+}
+
+
+void
+ConnectionPool::markBroken(int pos) {
+  mstates[pos] = BROKEN;
+  mbroken.push_back(pos);
+  if (!mstopped && mreconnector == NULL) {
+    mreconnector = new boost::thread(boost::bind(&ConnectionPool::reconnectLoop, this));
+  }
+  msync->brokenCond.notify_one();
+}
+
+
+void
+ConnectionPool::reconnectLoop() {
+  // the locks are those of the process which started the thread
+  Sync* sync = msync;
+  boost::unique_lock<boost::mutex> lock(sync->mutex);
+  while (!mstopped) {
+    if (mbroken.empty()) {
+      sync->brokenCond.wait(lock);
+      continue;
+    }
+    int pos = mbroken.front();
+    mbroken.pop_front();
+
+    lock.unlock();
+    std::string error;
+    try {
+      mconnector(pos);
+    } catch (const std::exception& ex) {
+      error = ex.what();
+      if (error.empty()) {
+        error = "unknown error";
+      }
+    }
+    lock.lock();
+
+    if (error.empty()) {
+      mstates[pos] = FREE;
+      mlastUsed[pos] = microsec_clock::universal_time();
+      mfree.push_back(pos);
+      ++mmetrics.reconnections;
+      sync->available.notify_one();
+      LOG(boost::str(boost::format("[INFO] database connection %1% reconnected") % pos),
+          LogInfo);
+    } else {
+      mbroken.push_back(pos);
+      LOG(boost::str(boost::format("[WARNING] cannot reconnect database connection %1%: %2%")
+                     % pos % error), LogWarning);
+      sync->brokenCond.timed_wait(lock, microsec_clock::universal_time()
+                             + boost::posix_time::seconds(DB_POOL_RECONNECT_DELAY));
+    }
+  }
+}
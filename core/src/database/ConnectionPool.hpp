@@ -0,0 +1,261 @@
+/**
+ * \file ConnectionPool.hpp
+ * \brief This file defines the pool handing out the database connections
+ */
+
+#ifndef _CONNECTIONPOOL_HPP_
+#define _CONNECTIONPOOL_HPP_
+
+#include <deque>
+#include <vector>
+#include <unistd.h>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+/**
+ * \brief The time in seconds a borrower waits for a free connection
+ */
+const int DB_POOL_TIMEOUT = 60;
+
+/**
+ * \brief The time in seconds a connection may stay idle before being
+ * checked again when borrowed
+ */
+const int DB_POOL_CHECK_INTERVAL = 30;
+
+/**
+ * \brief The time in seconds between two attempts to reconnect a broken
+ * connection
+ */
+const int DB_POOL_RECONNECT_DELAY = 5;
+
+/**
+ * \struct ConnectionPoolMetrics
+ * \brief The usage statistics of a connection pool
+ */
+struct ConnectionPoolMetrics {
+  /**
+   * \brief Constructor
+   */
+  ConnectionPoolMetrics()
+    : size(0), inUse(0), peakInUse(0), broken(0), acquisitions(0),
+      waits(0), timeouts(0), reconnections(0), totalWait(0.), maxWait(0.) {}
+
+  /**
+   * \brief The number of connections of the pool
+   */
+  unsigned int size;
+  /**
+   * \brief The number of connections currently borrowed
+   */
+  unsigned int inUse;
+  /**
+   * \brief The highest number of connections borrowed at once
+   */
+  unsigned int peakInUse;
+  /**
+   * \brief The number of connections waiting to be reconnected
+   */
+  unsigned int broken;
+  /**
+   * \brief The number of connections handed out
+   */
+  unsigned long acquisitions;
+  /**
+   * \brief The number of borrowers that had to wait for a connection
+   */
+  unsigned long waits;
+  /**
+   * \brief The number of borrowers that gave up waiting
+   */
+  unsigned long timeouts;
+  /**
+   * \brief The number of connections successfully reconnected
+   */
+  unsigned long reconnections;
+  /**
+   * \brief The time spent waiting for a connection, in seconds
+   */
+  double totalWait;
+  /**
+   * \brief The longest wait for a connection, in seconds
+   */
+  double maxWait;
+};
+
+
+/**
+ * \class ConnectionPool
+ * \brief Hands out the connections of a database driver. The connections
+ * are identified by their position, the driver keeps the handles. A
+ * borrower blocks until a connection is free, the connections idle for a
+ * while are checked before being handed out, and the broken ones are
+ * reconnected by a background thread. A forked process gets its own
+ * locks and reconnection thread on its first use of the pool.
+ */
+class ConnectionPool : public boost::noncopyable {
+public:
+  /**
+   * \brief Checks a connection, returns true if it is usable
+   */
+  typedef boost::function1<bool, int> Checker;
+  /**
+   * \brief Reconnects a connection, throws an exception on failure
+   */
+  typedef boost::function1<void, int> Connector;
+
+  /**
+   * \brief Constructor
+   * \param size the number of connections
+   * \param checker the function checking a connection
+   * \param connector the function reconnecting a connection
+   * \param timeout the time in seconds a borrower waits for a connection
+   */
+  ConnectionPool(int size, Checker checker, Connector connector,
+                 int timeout = DB_POOL_TIMEOUT);
+
+  /**
+   * \brief Destructor, stops the reconnection
+   */
+  ~ConnectionPool();
+
+  /**
+   * \brief Borrow a connection, waiting for one to be free
+   * \return the position of the connection, throw a SystemException if
+   * none was freed in time
+   */
+  int
+  acquire();
+
+  /**
+   * \brief Give a connection back to the pool
+   * \param pos the position of the connection
+   */
+  void
+  release(int pos);
+
+  /**
+   * \brief Give back a broken connection, to be reconnected in background
+   * \param pos the position of the connection
+   */
+  void
+  invalidate(int pos);
+
+  /**
+   * \brief Stop the reconnection thread, must be called before the
+   * connections are closed
+   */
+  void
+  stop();
+
+  /**
+   * \brief Get the usage statistics of the pool
+   * \return the statistics
+   */
+  ConnectionPoolMetrics
+  getMetrics();
+
+private:
+  /**
+   * \brief The states of the connections
+   */
+  typedef enum {
+    FREE,
+    USED,
+    BROKEN
+  } state_t;
+
+  /**
+   * \brief The locks of the pool
+   */
+  struct Sync {
+    /**
+     * \brief mutex protecting the pool
+     */
+    boost::mutex mutex;
+    /**
+     * \brief Signaled when a connection is given back
+     */
+    boost::condition_variable available;
+    /**
+     * \brief Signaled when a connection breaks or the pool stops
+     */
+    boost::condition_variable brokenCond;
+  };
+
+  /**
+   * \brief Give the pool its own locks and reconnection thread when it is
+   * used by a forked process, mutex must not be held
+   */
+  void
+  checkOwner();
+
+  /**
+   * \brief Mark a connection broken and wake up the reconnection thread,
+   * mutex must be held
+   * \param pos the position of the connection
+   */
+  void
+  markBroken(int pos);
+
+  /**
+   * \brief Body of the reconnection thread
+   */
+  void
+  reconnectLoop();
+
+  /**
+   * \brief The state of each connection
+   */
+  std::vector<state_t> mstates;
+  /**
+   * \brief The last time each connection was known to work
+   */
+  std::vector<boost::posix_time::ptime> mlastUsed;
+  /**
+   * \brief The free connections, the most recently used first
+   */
+  std::deque<int> mfree;
+  /**
+   * \brief The connections waiting to be reconnected
+   */
+  std::deque<int> mbroken;
+  /**
+   * \brief The function checking a connection
+   */
+  Checker mchecker;
+  /**
+   * \brief The function reconnecting a connection
+   */
+  Connector mconnector;
+  /**
+   * \brief The time a borrower waits for a connection
+   */
+  boost::posix_time::time_duration mtimeout;
+  /**
+   * \brief The usage statistics
+   */
+  ConnectionPoolMetrics mmetrics;
+  /**
+   * \brief Whether the pool is being stopped
+   */
+  bool mstopped;
+  /**
+   * \brief The locks of the pool, left to the parent by a forked process
+   * as they may be held by one of its threads
+   */
+  Sync* msync;
+  /**
+   * \brief The reconnection thread, started on the first broken connection
+   */
+  boost::thread* mreconnector;
+  /**
+   * \brief The process using the pool
+   */
+  pid_t mowner;
+};
+#endif // _CONNECTIONPOOL_HPP_
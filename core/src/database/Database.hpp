@@ -9,10 +9,19 @@
 #define _ABSTRACTDATABASE_H_
 
 #include <string>
+#include "ConnectionPool.hpp"
 #include "DatabaseResult.hpp"
 #include "DbConfiguration.hpp"
+#include "SqlParameters.hpp"
 
 static const int SUCCESS = 0;
+
+/**
+ * \brief The number of statements kept prepared on a connection, the
+ * statements are all closed once it is reached
+ */
+static const size_t MAX_PREPARED_STATEMENTS = 128;
+
 /**
  * \class Database
  * \brief This class describes a database
@@ -102,6 +111,38 @@ virtual ~Database();
    */
   virtual std::string escapeData(const std::string& data) = 0;
 
+  /**
+   * \brief To get the usage statistics of the connection pool
+   * \return the statistics, empty ones if the driver has no pool
+   */
+  virtual ConnectionPoolMetrics
+  getPoolMetrics();
+
+  /**
+   * \brief Function to process a prepared request in the database. The
+   * request is prepared once per connection and then only executed.
+   * \param name The name of the statement, identifying the request
+   * \param request The request, the parameters are noted $1, $2...
+   * \param params The values of the parameters
+   * \param transacId the id of the transaction if one is used
+   * \return raises an exception on error
+   */
+  virtual int
+  processPrepared(const std::string& name, const std::string& request,
+                  const SqlParameters& params, int transacId = -1);
+
+  /**
+   * \brief To get the result of a prepared select request
+   * \param name The name of the statement, identifying the request
+   * \param request The request, the parameters are noted $1, $2...
+   * \param params The values of the parameters
+   * \param transacId the id of the transaction if one is used
+   * \return An object which encapsulates the database results
+   */
+  virtual DatabaseResult*
+  getPreparedResult(const std::string& name, const std::string& request,
+                    const SqlParameters& params, int transacId = -1);
+
 
 protected :
   /**
@@ -109,6 +150,16 @@ protected :
    */
   Database();
 
+  /**
+   * \brief To substitute the escaped values of the parameters in a
+   * request, for the drivers without prepared statements
+   * \param request The request, the parameters are noted $1, $2...
+   * \param params The values of the parameters
+   * \return the request to process
+   */
+  std::string
+  expandParameters(const std::string& request, const SqlParameters& params);
+
 private :
   /**
    * \brief To disconnect from the database
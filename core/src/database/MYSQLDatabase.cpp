@@ -6,7 +6,11 @@
  */
 #include "MYSQLDatabase.hpp"
 
+#include <boost/bind.hpp>
 #include <boost/scoped_ptr.hpp>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <vector>
 
 #include "SystemException.hpp"
@@ -25,6 +29,54 @@ int dbErrorNo(MYSQL *conn) {
   return mysql_errno(conn);
 }
 
+// anonymous namespace
+namespace {
+  /**
+   * \brief The size of the buffer receiving a column of a prepared
+   * request, the longer values are fetched again
+   */
+  const unsigned long MYSQL_FETCH_BUFFER = 256;
+
+  string
+  stmtErrorMsg(MYSQL_STMT *stmt) {
+    const char *msg = mysql_stmt_error(stmt);
+    return (msg != NULL && *msg != '\0') ? " {" + string(msg) + "}" : "";
+  }
+
+  /**
+   * \brief To replace the $n parameters of a request by markers
+   * \param request The request
+   * \param order OUT, the parameter, from 0, bound to each marker
+   * \return the request understood by MySQL
+   */
+  string
+  toMarkers(const string& request, vector<int>& order) {
+    string result;
+    size_t pos = 0;
+    while (pos < request.size()) {
+      size_t end = pos + 1;
+      while (request[pos] == '$'
+             && end < request.size()
+             && isdigit(static_cast<unsigned char>(request[end]))) {
+        ++end;
+      }
+      if (end == pos + 1) {
+        result += request[pos++];
+        continue;
+      }
+      order.push_back(atoi(request.substr(pos + 1, end - pos - 1).c_str()) - 1);
+      result += '?';
+      pos = end;
+    }
+    // a statement holds a single request
+    while (!result.empty() && (result[result.size() - 1] == ';'
+                               || isspace(static_cast<unsigned char>(result[result.size() - 1])))) {
+      result.erase(result.size() - 1);
+    }
+    return result;
+  }
+}
+
 int
 MYSQLDatabase::process(string request, int transacId){
   int reqPos;
@@ -47,19 +99,7 @@ MYSQLDatabase::process(string request, int transacId){
     request.append(";");
   }
 
-  res=mysql_real_query(conn, request.c_str (), request.length());
-  if (res) {
-    if((dbErrorNo(conn) != CR_SERVER_LOST) && (dbErrorNo(conn) != CR_SERVER_GONE_ERROR)) {
-      throw SystemException(ERRCODE_DBERR, dbErrorMsg(conn));
-    }
-    connectPoolIndex(reqPos);  // try to reinitialise the socket
-    res=mysql_real_query(conn, request.c_str (), request.length());
-    if (res) {
-      // Could not execute the query
-      releaseConnection(reqPos);
-      throw SystemException(ERRCODE_DBERR, "P-Query error" + dbErrorMsg(conn));
-    }
-  }
+  query(request, reqPos, (transacId == -1) ? reqPos : transacId, "P-Query error");
 
   // Due to CLIENT_MULTI_STATEMENTS option, results must always be retrieved
   // process each statement result
@@ -134,12 +174,13 @@ MYSQLDatabase::connectPoolIndex(const int& poolIdx) {
  * \brief Constructor, raises an exception on error
  */
 MYSQLDatabase::MYSQLDatabase(DbConfiguration dbConfig)
-  : Database(), mconfig(dbConfig) {
+  : Database(), mconfig(dbConfig),
+    mpool(new pool_t[dbConfig.getDbPoolSize()]),
+    mconnPool(dbConfig.getDbPoolSize(),
+              boost::bind(&MYSQLDatabase::checkConnection, this, _1),
+              boost::bind(&MYSQLDatabase::reconnect, this, _1)) {
   mysql_library_init(0, NULL, NULL);
-  mpool = new pool_t[mconfig.getDbPoolSize()];
   for (unsigned int i=0;i<mconfig.getDbPoolSize();i++) {
-    pthread_mutex_init(&(mpool[i].mmutex), NULL);
-    mpool[i].mused = false;
     mysql_init(&(mpool[i].mmysql));
   }
 }
@@ -148,6 +189,8 @@ MYSQLDatabase::MYSQLDatabase(DbConfiguration dbConfig)
  * \brief Destructor, raises an exception on error
  */
 MYSQLDatabase::~MYSQLDatabase(){
+  // no reconnection may happen while the connections are closed
+  mconnPool.stop();
   disconnect();
   mysql_library_end();
   delete [] mpool;
@@ -159,6 +202,7 @@ MYSQLDatabase::~MYSQLDatabase(){
 int
 MYSQLDatabase::disconnect(){
   for (unsigned int i = 0 ; i < mconfig.getDbPoolSize() ; i++) {
+    closeStatements(i);
     mysql_close (&(mpool[i].mmysql));
   }
   return SUCCESS;
@@ -174,7 +218,6 @@ DatabaseResult*
 MYSQLDatabase::getResult(string request, int transacId) {
   int reqPos;
   MYSQL* conn = NULL;
-  int res;
   if (transacId==-1) {
     conn = getConnection(reqPos);
   } else {
@@ -182,18 +225,7 @@ MYSQLDatabase::getResult(string request, int transacId) {
     conn = (&(mpool[transacId].mmysql));
   }
   // Execute the SQL query
-  if ((res=mysql_real_query(conn, request.c_str (), request.length())) != 0) {
-
-    if((dbErrorNo(conn) != CR_SERVER_LOST) && (dbErrorNo(conn) != CR_SERVER_GONE_ERROR)) {
-      throw SystemException(ERRCODE_DBERR, dbErrorMsg(conn));
-    }
-    connectPoolIndex(reqPos);  // try to reinitialise the socket
-    res=mysql_real_query(conn, request.c_str (), request.length());
-    if (res) {
-      releaseConnection(reqPos);
-      throw SystemException(ERRCODE_DBERR, "S-Query error" + dbErrorMsg(conn));
-    }
-  }
+  query(request, reqPos, (transacId == -1) ? reqPos : transacId, "S-Query error");
 
   // Get the result handle (does not fetch data from the server)
   MYSQL_RES *result = mysql_use_result(conn);
@@ -231,45 +263,267 @@ MYSQLDatabase::getResult(string request, int transacId) {
 
 MYSQL*
 MYSQLDatabase::getConnection(int& id){
-  int i = 0;
-  int locked;
-  // Looking for an unused connection (will block until a connection is free)
-  while (true) {
-    // If the connection is not used
-    if(!mpool[i].mused) {
-      locked = pthread_mutex_trylock(&(mpool[i].mmutex));
-      // If lock fails-> the mutex was taken before trylock call
-      if (locked) {
-        // Try next connexion
-        sleep(2);
-        continue;
+  id = mconnPool.acquire();
+  return &(mpool[id].mmysql);
+}
+
+void
+MYSQLDatabase::releaseConnection(int pos) {
+  if (pos==-1){
+    return;
+  }
+  mconnPool.release(pos);
+}
+
+bool
+MYSQLDatabase::checkConnection(int pos) {
+  return mysql_ping(&(mpool[pos].mmysql)) == 0;
+}
+
+void
+MYSQLDatabase::reconnect(int pos) {
+  // the statements are prepared again on the new connection
+  closeStatements(pos);
+  mysql_close(&(mpool[pos].mmysql));
+  mysql_init(&(mpool[pos].mmysql));
+  connectPoolIndex(pos);
+}
+
+void
+MYSQLDatabase::query(const string& request, int reqPos, int connPos,
+                     const string& errorPrefix) {
+  MYSQL* conn = &(mpool[connPos].mmysql);
+  if (mysql_real_query(conn, request.c_str(), request.length()) == 0) {
+    return;
+  }
+  // a new connection would lose the previous requests of a transaction
+  if (((dbErrorNo(conn) != CR_SERVER_LOST) && (dbErrorNo(conn) != CR_SERVER_GONE_ERROR))
+      || reqPos == -1) {
+    std::string errorMsg = dbErrorMsg(conn);
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBERR, errorMsg);
+  }
+  try {
+    reconnect(connPos);  // try to reinitialise the socket
+  } catch (const SystemException&) {
+    // the pool keeps trying in background
+    mconnPool.invalidate(reqPos);
+    throw;
+  }
+  if (mysql_real_query(conn, request.c_str(), request.length()) != 0) {
+    // Could not execute the query
+    std::string errorMsg = dbErrorMsg(conn);
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBERR, errorPrefix + errorMsg);
+  }
+}
+
+void
+MYSQLDatabase::closeStatements(int pos) {
+  std::map<std::string, statement_t>& statements = mpool[pos].mstatements;
+  for (std::map<std::string, statement_t>::iterator it = statements.begin();
+       it != statements.end(); ++it) {
+    mysql_stmt_close(it->second.mstmt);
+  }
+  statements.clear();
+}
+
+MYSQL_STMT*
+MYSQLDatabase::execPrepared(int pos, const string& name, const string& request,
+                            const SqlParameters& params, bool inTransaction) {
+  // a new connection would lose the previous requests of a transaction
+  int attempts = inTransaction ? 1 : 2;
+  for (int attempt = 1; ; ++attempt) {
+    MYSQL* conn = &(mpool[pos].mmysql);
+    std::map<std::string, statement_t>& statements = mpool[pos].mstatements;
+    std::map<std::string, statement_t>::iterator it = statements.find(name);
+    if (it == statements.end()) {
+      if (statements.size() >= MAX_PREPARED_STATEMENTS) {
+        closeStatements(pos);
+      }
+      statement_t statement;
+      string sql = toMarkers(request, statement.morder);
+      statement.mrequest = request;
+      statement.mstmt = mysql_stmt_init(conn);
+      if (statement.mstmt == NULL) {
+        throw SystemException(ERRCODE_DBERR, "Cannot prepare " + name + dbErrorMsg(conn));
       }
-      else {
-        mpool[i].mused=true;
-        id = i;
-        return &(mpool[i].mmysql);
+      if (mysql_stmt_prepare(statement.mstmt, sql.c_str(), sql.length()) != 0) {
+        int errorNo = mysql_stmt_errno(statement.mstmt);
+        string errorMsg = stmtErrorMsg(statement.mstmt);
+        mysql_stmt_close(statement.mstmt);
+        if (attempt < attempts
+            && (errorNo == CR_SERVER_LOST || errorNo == CR_SERVER_GONE_ERROR)) {
+          reconnect(pos);
+          continue;
+        }
+        throw SystemException(ERRCODE_DBERR, "Cannot prepare " + name + errorMsg);
       }
+      it = statements.insert(std::make_pair(name, statement)).first;
+    } else if (it->second.mrequest != request) {
+      throw SystemException(ERRCODE_DBERR,
+                            "The statement " + name + " is prepared with another request");
+    }
+
+    const statement_t& statement = it->second;
+    size_t nMarkers = statement.morder.size();
+    vector<MYSQL_BIND> binds(nMarkers);
+    vector<long long> integers(nMarkers);
+    vector<unsigned long> lengths(nMarkers);
+    for (size_t i = 0; i < nMarkers; ++i) {
+      size_t param = static_cast<size_t>(statement.morder[i]);
+      if (param >= params.size()) {
+        throw SystemException(ERRCODE_DBERR, "Missing parameter in the request " + name);
+      }
+      memset(&binds[i], 0, sizeof(MYSQL_BIND));
+      if (params.getType(param) == SqlParameters::INTEGER) {
+        integers[i] = params.getInteger(param);
+        binds[i].buffer_type = MYSQL_TYPE_LONGLONG;
+        binds[i].buffer = &integers[i];
+      } else {
+        const string& value = params.getValue(param);
+        lengths[i] = value.length();
+        binds[i].buffer_type = MYSQL_TYPE_STRING;
+        binds[i].buffer = const_cast<char*>(value.data());
+        binds[i].buffer_length = value.length();
+        binds[i].length = &lengths[i];
+      }
+    }
+    if (nMarkers > 0 && mysql_stmt_bind_param(statement.mstmt, &binds[0]) != 0) {
+      throw SystemException(ERRCODE_DBERR, "Cannot bind " + name + stmtErrorMsg(statement.mstmt));
     }
-    i++;
-    // I do not use modulo '%' because i need to be sure i>0
-    if (i==mconfig.getDbPoolSize()) {
-      i=0;
-      sleep(10);
+    if (mysql_stmt_execute(statement.mstmt) == 0) {
+      return statement.mstmt;
     }
+    int errorNo = mysql_stmt_errno(statement.mstmt);
+    if (attempt < attempts
+        && (errorNo == CR_SERVER_LOST || errorNo == CR_SERVER_GONE_ERROR)) {
+      reconnect(pos);  // try to reinitialise the socket
+      continue;
+    }
+    throw SystemException(ERRCODE_DBERR, "E-Query error" + stmtErrorMsg(statement.mstmt));
   }
-  throw SystemException(ERRCODE_DBCONN, "Cannot get available DB connection");
 }
 
-void
-MYSQLDatabase::releaseConnection(int pos) {
-  if (pos==-1){
-    return;
+int
+MYSQLDatabase::processPrepared(const string& name, const string& request,
+                               const SqlParameters& params, int transacId) {
+  int reqPos = -1;
+  int connPos = transacId;
+  if (transacId == -1) {
+    getConnection(reqPos);
+    connPos = reqPos;
   }
-  int ret = pthread_mutex_unlock(&(mpool[pos].mmutex));
-  if (ret) {
-    throw SystemException(ERRCODE_DBCONN, "Cannot release connection lock");
+  try {
+    MYSQL_STMT* stmt = execPrepared(connPos, name, request, params, transacId != -1);
+    mysql_stmt_free_result(stmt);
+  } catch (const SystemException&) {
+    if (mysql_ping(&(mpool[connPos].mmysql)) != 0) {
+      // the pool keeps trying in background
+      mconnPool.invalidate(reqPos);
+    } else {
+      releaseConnection(reqPos);
+    }
+    throw;
+  }
+  releaseConnection(reqPos);
+  return SUCCESS;
+}
+
+DatabaseResult*
+MYSQLDatabase::getPreparedResult(const string& name, const string& request,
+                                 const SqlParameters& params, int transacId) {
+  int reqPos = -1;
+  int connPos = transacId;
+  if (transacId == -1) {
+    getConnection(reqPos);
+    connPos = reqPos;
   }
-  mpool[pos].mused = false;
+  vector<vector<string> > results;
+  vector<string> attributesNames;
+  MYSQL_STMT* stmt = NULL;
+  try {
+    stmt = execPrepared(connPos, name, request, params, transacId != -1);
+  } catch (const SystemException&) {
+    if (mysql_ping(&(mpool[connPos].mmysql)) != 0) {
+      mconnPool.invalidate(reqPos);
+    } else {
+      releaseConnection(reqPos);
+    }
+    throw;
+  }
+
+  MYSQL_RES *meta = mysql_stmt_result_metadata(stmt);
+  if (!meta) {
+    string errorMsg = stmtErrorMsg(stmt);
+    mysql_stmt_free_result(stmt);
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBERR, "Cannot get query results" + errorMsg);
+  }
+  unsigned int nFields = mysql_num_fields(meta);
+  MYSQL_FIELD *fields = mysql_fetch_fields(meta);
+  for (unsigned int i = 0; i < nFields; i++) {
+    attributesNames.push_back(string(fields[i].name));
+  }
+
+  // the columns are fetched as strings
+  vector<MYSQL_BIND> binds(nFields);
+  vector<char> buffers(nFields * MYSQL_FETCH_BUFFER + 1);
+  vector<unsigned long> lengths(nFields);
+  vector<my_bool> nulls(nFields);
+  for (unsigned int i = 0; i < nFields; i++) {
+    memset(&binds[i], 0, sizeof(MYSQL_BIND));
+    binds[i].buffer_type = MYSQL_TYPE_STRING;
+    binds[i].buffer = &buffers[i * MYSQL_FETCH_BUFFER];
+    binds[i].buffer_length = MYSQL_FETCH_BUFFER;
+    binds[i].length = &lengths[i];
+    binds[i].is_null = &nulls[i];
+  }
+  int rc = 0;
+  if (nFields > 0 && mysql_stmt_bind_result(stmt, &binds[0]) != 0) {
+    rc = 1;
+  }
+  vector<string> rowStr;
+  while (rc == 0
+         && ((rc = mysql_stmt_fetch(stmt)) == 0 || rc == MYSQL_DATA_TRUNCATED)) {
+    rc = 0;
+    rowStr.clear();
+    for (unsigned int i = 0; i < nFields; i++) {
+      unsigned long length = lengths[i];
+      if (nulls[i]) {
+        rowStr.push_back("");
+      } else if (length <= MYSQL_FETCH_BUFFER) {
+        rowStr.push_back(string(&buffers[i * MYSQL_FETCH_BUFFER], length));
+      } else {
+        // the value was truncated, get it whole
+        string value(length, '\0');
+        MYSQL_BIND column;
+        memset(&column, 0, sizeof(MYSQL_BIND));
+        column.buffer_type = MYSQL_TYPE_STRING;
+        column.buffer = &value[0];
+        column.buffer_length = length;
+        mysql_stmt_fetch_column(stmt, &column, i, 0);
+        rowStr.push_back(value);
+      }
+    }
+    results.push_back(rowStr);
+  }
+  mysql_free_result(meta);
+  if (rc != MYSQL_NO_DATA) {
+    string errorMsg = stmtErrorMsg(stmt);
+    mysql_stmt_free_result(stmt);
+    releaseConnection(reqPos);
+    throw SystemException(ERRCODE_DBERR, "Cannot fetch query results" + errorMsg);
+  }
+  mysql_stmt_free_result(stmt);
+
+  releaseConnection(reqPos);
+  return new DatabaseResult(results, attributesNames);
+}
+
+ConnectionPoolMetrics
+MYSQLDatabase::getPoolMetrics() {
+  return mconnPool.getMetrics();
 }
 
 int
@@ -8,9 +8,11 @@
 #ifndef _MYSDLDATABASE_H_
 #define _MYSQLDATABASE_H_
 
+#include <map>
 #include <string>
-#include <pthread.h>
+#include <vector>
 
+#include "ConnectionPool.hpp"
 #include "Database.hpp"
 #include "DatabaseResult.hpp"
 #include "DbConfiguration.hpp"
@@ -127,6 +129,37 @@ public :
   virtual std::string
   escapeData(const std::string& data);
 
+  /**
+   * \brief To get the usage statistics of the connection pool
+   * \return the statistics
+   */
+  virtual ConnectionPoolMetrics
+  getPoolMetrics();
+
+  /**
+   * \brief Function to process a prepared request in the database
+   * \param name The name of the statement, identifying the request
+   * \param request The request, the parameters are noted $1, $2...
+   * \param params The values of the parameters
+   * \param transacId the id of the transaction if one is used
+   * \return raises an exception on error
+   */
+  virtual int
+  processPrepared(const std::string& name, const std::string& request,
+                  const SqlParameters& params, int transacId = -1);
+
+  /**
+   * \brief To get the result of a prepared select request
+   * \param name The name of the statement, identifying the request
+   * \param request The request, the parameters are noted $1, $2...
+   * \param params The values of the parameters
+   * \param transacId the id of the transaction if one is used
+   * \return An object which encapsulates the database results
+   */
+  virtual DatabaseResult*
+  getPreparedResult(const std::string& name, const std::string& request,
+                    const SqlParameters& params, int transacId = -1);
+
 private :
   /**
    * \brief To get a valid connexion
@@ -142,21 +175,82 @@ private :
   void releaseConnection(int pos);
 
   /**
-   * \brief An element of the pool
+   * \brief To check that a connection of the pool still works
+   * \param pos The position of the connection
+   * \return true if the connection works
    */
-  typedef struct pool_t{
+  bool checkConnection(int pos);
+
+  /**
+   * \brief To reopen a connection of the pool, raises an exception on error
+   * \param pos The position of the connection
+   */
+  void reconnect(int pos);
+
+  /**
+   * \brief To run a query, reconnecting once if the server went away
+   * outside a transaction
+   * \param request The request to run
+   * \param reqPos The position of the connection borrowed, -1 in a transaction
+   * \param connPos The position of the connection used
+   * \param errorPrefix The prefix of the error messages
+   * \return raises an exception on error, the borrowed connection being released
+   */
+  void query(const std::string& request, int reqPos, int connPos,
+             const std::string& errorPrefix);
+
+  /**
+   * \brief To execute a prepared request, preparing it first if the
+   * connection does not know it and reconnecting once if the server went
+   * away outside a transaction, raises an exception on error
+   * \param pos The position of the connection
+   * \param name The name of the statement
+   * \param request The request
+   * \param params The values of the parameters
+   * \param inTransaction whether the connection runs a transaction
+   * \return the executed statement
+   */
+  MYSQL_STMT* execPrepared(int pos, const std::string& name,
+                           const std::string& request,
+                           const SqlParameters& params,
+                           bool inTransaction);
+
+  /**
+   * \brief To close the statements prepared on a connection
+   * \param pos The position of the connection
+   */
+  void closeStatements(int pos);
+
+  /**
+   * \brief A statement prepared on a connection
+   */
+  typedef struct statement_t{
+    /**
+     * \brief The statement handle
+     */
+    MYSQL_STMT* mstmt;
+    /**
+     * \brief The request, with the $n parameters
+     */
+    std::string mrequest;
     /**
-     * \brief If the connexion is used
+     * \brief The parameter bound to each marker of the statement
      */
-    bool mused;
+    std::vector<int> morder;
+  }statement_t;
+
+  /**
+   * \brief An element of the pool
+   */
+  typedef struct pool_t{
     /**
      * \brief The connection mysql structure
      */
     MYSQL mmysql;
     /**
-     * \brief The associated mutex
+     * \brief The statements prepared on the connection, by name
      */
-    pthread_mutex_t mmutex;
+    std::map<std::string, statement_t> mstatements;
   }pool_t;
   /////////////////////////////////
   // Attributes
@@ -169,6 +263,10 @@ private :
    * \brief The pool of connection
    */
   pool_t *mpool;
+  /**
+   * \brief Hands out the connections of the pool
+   */
+  ConnectionPool mconnPool;
 
   /////////////////////////////////
   // Functions
@@ -8,6 +8,7 @@
 
 #include <sstream>
 #include <vector>
+#include <boost/bind.hpp>
 #include <boost/scoped_ptr.hpp>
 
 #include "SystemException.hpp"
@@ -16,6 +17,39 @@
 
 using namespace std;
 
+// anonymous namespace
+namespace {
+  /**
+   * \brief The type of the integer parameters, INT8OID of the server headers
+   */
+  const Oid PG_INT8_OID = 20;
+
+  /**
+   * \brief To copy the rows of a result
+   * \param res the result of a select request
+   * \return An object which encapsulates the database results
+   */
+  DatabaseResult*
+  toDatabaseResult(PGresult* res) {
+    std::vector<std::vector<std::string> > results;
+    std::vector<std::string> attributesNames;
+    std::vector<std::string> tmp;
+    int nFields = PQnfields(res);
+    for (int i = 0; i < nFields; i++) {
+      attributesNames.push_back(std::string(PQfname(res, i)));
+    }
+
+    for (int i = 0; i < PQntuples(res); i++) {
+      tmp.clear();
+      for (int j = 0; j < nFields; j++) {
+        tmp.push_back(std::string(PQgetvalue(res, i, j)));
+      }
+      results.push_back(tmp);
+    }
+    return new DatabaseResult(results, attributesNames);
+  }
+}
+
 /**
  * \brief Function to process the request in the database
  * \param request The request to process
@@ -23,8 +57,14 @@ using namespace std;
  */
 int
 POSTGREDatabase::process(std::string request, int transacId){
-  int reqPos;
-  PGconn* lconn = getConnection(reqPos);
+  int reqPos = -1;
+  PGconn* lconn = NULL;
+  // the requests of a transaction use the connection holding it
+  if (transacId == -1) {
+    lconn = getConnection(reqPos);
+  } else {
+    lconn = mpool[transacId].mconn;
+  }
 
   if (PQstatus(lconn) == CONNECTION_OK) {
     PGresult* res = PQexec(lconn, request.c_str());
@@ -33,13 +73,14 @@ POSTGREDatabase::process(std::string request, int transacId){
       PQclear(res);
       std::string errorMsg = std::string(PQerrorMessage(lconn));
       errorMsg.append("- Note: The process function must not be used for select request");
-      releaseConnection(reqPos);
+      releaseFailedConnection(reqPos, lconn);
       throw SystemException(ERRCODE_DBERR, errorMsg);
     }
     PQclear(res);
   } else {
-    releaseConnection(reqPos);
-    throw SystemException(ERRCODE_DBCONN, std::string(PQerrorMessage(lconn)));
+    std::string errorMsg = std::string(PQerrorMessage(lconn));
+    releaseFailedConnection(reqPos, lconn);
+    throw SystemException(ERRCODE_DBCONN, errorMsg);
   }
   releaseConnection(reqPos);
   return SUCCESS;
@@ -53,33 +94,16 @@ POSTGREDatabase::process(std::string request, int transacId){
 int
 POSTGREDatabase::connect() {
 
-  std::string pgPort = "5432"; //PostGreSQL default port
-  if ((mconfig.getDbPort() != 0)) {
-    pgPort = vishnu::convertToString(mconfig.getDbPort());
-  }
-  std::string sslOptions = "";
-  if (mconfig.getUseSsl()) {
-    sslOptions = (boost::format("sslmode=verify-ca sslrootcert=%1%")%mconfig.getSslCaFile()).str();
-  }
-  std::string conninfo = (boost::format("host=%1% "
-                                        "port=%2% "
-                                        "dbname=%3% "
-                                        "user=%4% "
-                                        "password=%5% "
-                                        "%6%"
-                                        )
-                          %mconfig.getDbHost()
-                          %pgPort
-                          %mconfig.getDbName()
-                          %mconfig.getDbUserPassword()
-                          %mconfig.getDbUserName()
-                          %sslOptions
-                          ).str();
+  std::string conninfo = getConnInfo();
 
   for (int i=0;i<mconfig.getDbPoolSize();i++) {
 
     if (PQstatus(mpool[i].mconn) != CONNECTION_OK) {
 
+      if (mpool[i].mconn != NULL) {
+        PQfinish(mpool[i].mconn);
+      }
+      mpool[i].mprepared.clear();
       mpool[i].mconn = PQconnectdb(conninfo.c_str());
 
       if (PQstatus(mpool[i].mconn) != CONNECTION_OK) {
@@ -90,19 +114,64 @@ POSTGREDatabase::connect() {
       throw SystemException(ERRCODE_DBCONN, "The database is already connected");
     }
   }
+
+  // the escaping only depends on the encoding and settings of the server
+  boost::lock_guard<boost::mutex> lock(mescapeMutex);
+  if (mescapeConn == NULL) {
+    mescapeConn = PQconnectdb(conninfo.c_str());
+    if (PQstatus(mescapeConn) != CONNECTION_OK) {
+      std::string error = PQerrorMessage(mescapeConn);
+      PQfinish(mescapeConn);
+      mescapeConn = NULL;
+      throw SystemException(ERRCODE_DBCONN, error);
+    }
+  }
   return SUCCESS;
 }
 
+/**
+ * \brief To get the connection string of the database
+ * \return the connection string
+ */
+std::string
+POSTGREDatabase::getConnInfo() {
+  std::string pgPort = "5432"; //PostGreSQL default port
+  if ((mconfig.getDbPort() != 0)) {
+    pgPort = vishnu::convertToString(mconfig.getDbPort());
+  }
+  std::string sslOptions = "";
+  if (mconfig.getUseSsl()) {
+    sslOptions = (boost::format("sslmode=verify-ca sslrootcert=%1%")%mconfig.getSslCaFile()).str();
+  }
+  return (boost::format("host=%1% "
+                        "port=%2% "
+                        "dbname=%3% "
+                        "user=%4% "
+                        "password=%5% "
+                        "%6%"
+                        )
+          %mconfig.getDbHost()
+          %pgPort
+          %mconfig.getDbName()
+          %mconfig.getDbUserPassword()
+          %mconfig.getDbUserName()
+          %sslOptions
+          ).str();
+}
+
 /**
  * \brief Constructor
  */
 POSTGREDatabase::POSTGREDatabase(DbConfiguration dbConfig)
-  : Database(), mconfig(dbConfig), misConnected(false) {
+  : Database(), mconfig(dbConfig),
+    mpool(new pool_t[dbConfig.getDbPoolSize()]),
+    mconnPool(dbConfig.getDbPoolSize(),
+              boost::bind(&POSTGREDatabase::checkConnection, this, _1),
+              boost::bind(&POSTGREDatabase::reconnect, this, _1)),
+    mescapeConn(NULL),
+    misConnected(false) {
   int i;
-  mpool = new pool_t[mconfig.getDbPoolSize()];
   for (i=0;i<mconfig.getDbPoolSize();i++){
-    pthread_mutex_init(&(mpool[i].mmutex), NULL);
-    mpool[i].mused = false;
     mpool[i].mconn = NULL;
   }
 }
@@ -111,6 +180,8 @@ POSTGREDatabase::POSTGREDatabase(DbConfiguration dbConfig)
  * \brief Destructor
  */
 POSTGREDatabase::~POSTGREDatabase(){
+  // no reconnection may happen while the connections are closed
+  mconnPool.stop();
   disconnect();
   delete [] mpool;
 }
@@ -126,8 +197,14 @@ POSTGREDatabase::disconnect(){
   for (i = 0; i < mconfig.getDbPoolSize(); i++){
     if (mpool[i].mconn != NULL) {
       PQfinish(mpool[i].mconn);
+      mpool[i].mconn = NULL;
+      mpool[i].mprepared.clear();
     }
-    pthread_mutex_destroy(&(mpool[i].mmutex));
+  }
+  boost::lock_guard<boost::mutex> lock(mescapeMutex);
+  if (mescapeConn != NULL) {
+    PQfinish(mescapeConn);
+    mescapeConn = NULL;
   }
   return SUCCESS;
 }
@@ -140,106 +217,236 @@ POSTGREDatabase::disconnect(){
  */
 DatabaseResult*
 POSTGREDatabase::getResult(std::string request, int transacId) {
-  std::vector<std::vector<std::string> > results;
-  std::vector<std::string> attributesNames;
-  std::vector<std::string> tmp;
-  int reqPos;
-  PGconn* lconn = getConnection(reqPos);
+  int reqPos = -1;
+  PGconn* lconn = NULL;
+  if (transacId == -1) {
+    lconn = getConnection(reqPos);
+  } else {
+    lconn = mpool[transacId].mconn;
+  }
 
+  DatabaseResult* result = NULL;
   if (PQstatus(lconn) == CONNECTION_OK) {
     PGresult* res = PQexec(lconn, request.c_str());
-    int i;
-    int j;
 
     if (PQresultStatus(res) != PGRES_TUPLES_OK) {
       PQclear(res);
-      releaseConnection(reqPos);
-      throw SystemException(ERRCODE_DBERR, std::string(PQerrorMessage(lconn)));
-    }
-    int nFields = PQnfields(res);
-    for (i = 0; i < nFields; i++) {
-      attributesNames.push_back(std::string(PQfname(res, i)));
-    }
-
-    for (i = 0; i < PQntuples(res); i++) {
-      tmp.clear();
-      for (j = 0; j < nFields; j++) {
-        tmp.push_back(std::string(PQgetvalue(res, i, j)));
-      }
-      results.push_back(tmp);
+      std::string errorMsg = std::string(PQerrorMessage(lconn));
+      releaseFailedConnection(reqPos, lconn);
+      throw SystemException(ERRCODE_DBERR, errorMsg);
     }
+    result = toDatabaseResult(res);
     releaseConnection(reqPos);
     PQclear(res);
   } else {
-    releaseConnection(reqPos);
+    releaseFailedConnection(reqPos, lconn);
     throw SystemException(ERRCODE_DBCONN, "The database is not connected");
   }
-  return new DatabaseResult(results, attributesNames);
+  return result;
 }
 
-PGconn* POSTGREDatabase::getConnection(int& id){
-  int i = 0;
-  int locked;
-  // Looking for an unused connection
-  while (true) {
-    // If the connection is not used
-    if(!mpool[i].mused) {
-      locked = pthread_mutex_trylock(&(mpool[i].mmutex));
-      // If lock fails-> the mutex was taken before trylock call
-      if (locked) {
-        // Try next connexion
-        sleep(2);
-        continue;
-      }
-      else {
-        mpool[i].mused=true;
-        id = i;
-        return mpool[i].mconn;
+/**
+ * \brief Function to process a prepared request in the database
+ * \param name The name of the statement
+ * \param request The request to process
+ * \param params The values of the parameters
+ * \return raises an exception on error
+ */
+int
+POSTGREDatabase::processPrepared(const std::string& name, const std::string& request,
+                                 const SqlParameters& params, int transacId) {
+  int reqPos = -1;
+  int connPos = transacId;
+  if (transacId == -1) {
+    getConnection(reqPos);
+    connPos = reqPos;
+  }
+  PGconn* lconn = mpool[connPos].mconn;
+
+  PGresult* res = NULL;
+  try {
+    res = execPrepared(connPos, name, request, params);
+  } catch (const SystemException&) {
+    releaseFailedConnection(reqPos, lconn);
+    throw;
+  }
+  if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+    PQclear(res);
+    std::string errorMsg = std::string(PQerrorMessage(lconn));
+    releaseFailedConnection(reqPos, lconn);
+    throw SystemException(ERRCODE_DBERR, errorMsg);
+  }
+  PQclear(res);
+  releaseConnection(reqPos);
+  return SUCCESS;
+}
+
+/**
+ * \brief To get the result of a prepared select request
+ * \param name The name of the statement
+ * \param request The request to process
+ * \param params The values of the parameters
+ * \return An object which encapsulates the database results
+ */
+DatabaseResult*
+POSTGREDatabase::getPreparedResult(const std::string& name, const std::string& request,
+                                   const SqlParameters& params, int transacId) {
+  int reqPos = -1;
+  int connPos = transacId;
+  if (transacId == -1) {
+    getConnection(reqPos);
+    connPos = reqPos;
+  }
+  PGconn* lconn = mpool[connPos].mconn;
+
+  PGresult* res = NULL;
+  try {
+    res = execPrepared(connPos, name, request, params);
+  } catch (const SystemException&) {
+    releaseFailedConnection(reqPos, lconn);
+    throw;
+  }
+  if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+    PQclear(res);
+    std::string errorMsg = std::string(PQerrorMessage(lconn));
+    releaseFailedConnection(reqPos, lconn);
+    throw SystemException(ERRCODE_DBERR, errorMsg);
+  }
+  DatabaseResult* result = toDatabaseResult(res);
+  PQclear(res);
+  releaseConnection(reqPos);
+  return result;
+}
+
+PGresult*
+POSTGREDatabase::execPrepared(int pos, const std::string& name,
+                              const std::string& request,
+                              const SqlParameters& params) {
+  PGconn* conn = mpool[pos].mconn;
+  if (PQstatus(conn) != CONNECTION_OK) {
+    throw SystemException(ERRCODE_DBCONN, "The database is not connected");
+  }
+  int nParams = static_cast<int>(params.size());
+
+  std::map<std::string, std::string>& prepared = mpool[pos].mprepared;
+  std::map<std::string, std::string>::const_iterator it = prepared.find(name);
+  if (it == prepared.end()) {
+    if (prepared.size() >= MAX_PREPARED_STATEMENTS) {
+      PQclear(PQexec(conn, "DEALLOCATE ALL"));
+      prepared.clear();
+    }
+    std::vector<Oid> types(nParams, 0);
+    for (int i = 0; i < nParams; ++i) {
+      if (params.getType(i) == SqlParameters::INTEGER) {
+        types[i] = PG_INT8_OID;
       }
     }
-    i++;
-    // I do not use modulo '%' because i need to be sure i>0
-    if (i==mconfig.getDbPoolSize()) {
-      i=0;
-      sleep(10);
+    PGresult* res = PQprepare(conn, name.c_str(), request.c_str(), nParams,
+                              types.empty() ? NULL : &types[0]);
+    if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+      PQclear(res);
+      throw SystemException(ERRCODE_DBERR,
+                            "Cannot prepare " + name + ": " + std::string(PQerrorMessage(conn)));
     }
+    PQclear(res);
+    prepared[name] = request;
+  } else if (it->second != request) {
+    throw SystemException(ERRCODE_DBERR,
+                          "The statement " + name + " is prepared with another request");
+  }
+
+  std::vector<const char*> values(nParams);
+  for (int i = 0; i < nParams; ++i) {
+    values[i] = params.getValue(i).c_str();
   }
-  throw SystemException(ERRCODE_DBCONN, "Unknown error, cannot get connexion on database");
+  return PQexecPrepared(conn, name.c_str(), nParams,
+                        values.empty() ? NULL : &values[0], NULL, NULL, 0);
+}
+
+PGconn* POSTGREDatabase::getConnection(int& id){
+  id = mconnPool.acquire();
+  return mpool[id].mconn;
 }
 
 void POSTGREDatabase::releaseConnection(int pos){
-  int ret;
-  ret = pthread_mutex_unlock(&(mpool[pos].mmutex));
-  if (ret) {
-    throw SystemException(ERRCODE_DBCONN, "Fail to release a mutex");
+  mconnPool.release(pos);
+}
+
+void POSTGREDatabase::releaseFailedConnection(int pos, PGconn* conn){
+  if (PQstatus(conn) != CONNECTION_OK) {
+    mconnPool.invalidate(pos);
+  } else {
+    mconnPool.release(pos);
+  }
+}
+
+bool POSTGREDatabase::checkConnection(int pos){
+  PGconn* conn = mpool[pos].mconn;
+  if (PQstatus(conn) != CONNECTION_OK) {
+    return false;
   }
-  mpool[pos].mused = false;
+  // PQstatus does not notice a connection closed by the server
+  PGresult* res = PQexec(conn, "SELECT 1");
+  bool alive = (PQresultStatus(res) == PGRES_TUPLES_OK);
+  PQclear(res);
+  return alive;
+}
+
+void POSTGREDatabase::reconnect(int pos){
+  if (mpool[pos].mconn != NULL) {
+    PQfinish(mpool[pos].mconn);
+  }
+  // the statements are prepared again on the new connexion
+  mpool[pos].mprepared.clear();
+  mpool[pos].mconn = PQconnectdb(getConnInfo().c_str());
+  if (PQstatus(mpool[pos].mconn) != CONNECTION_OK) {
+    throw SystemException(ERRCODE_DBCONN, std::string(PQerrorMessage(mpool[pos].mconn)));
+  }
+}
+
+ConnectionPoolMetrics
+POSTGREDatabase::getPoolMetrics(){
+  return mconnPool.getMetrics();
 }
 
 int
 POSTGREDatabase::startTransaction(){
   int reqPos;
   getConnection(reqPos);
-  process("BEGIN;", reqPos);
+  try {
+    process("BEGIN;", reqPos);
+  } catch (const SystemException&) {
+    releaseFailedConnection(reqPos, mpool[reqPos].mconn);
+    throw;
+  }
   return reqPos;
 }
 
 void
 POSTGREDatabase::endTransaction(int transactionID) {
-  process("COMMIT;", transactionID);
+  try {
+    process("COMMIT;", transactionID);
+  } catch (const SystemException&) {
+    releaseFailedConnection(transactionID, mpool[transactionID].mconn);
+    throw;
+  }
   releaseConnection(transactionID);
 }
 
 void
 POSTGREDatabase::cancelTransaction(int transactionID) {
-  process("ROLLBACK;", transactionID);
+  try {
+    process("ROLLBACK;", transactionID);
+  } catch (const SystemException&) {
+    releaseFailedConnection(transactionID, mpool[transactionID].mconn);
+    throw;
+  }
   releaseConnection(transactionID);
 }
 
 void
 POSTGREDatabase::flush(int transactionID){
-  process("COMMIT;", transactionID);
-  releaseConnection(transactionID);
+  endTransaction(transactionID);
 }
 
 int
@@ -277,12 +484,13 @@ std::string
 POSTGREDatabase::escapeData(const std::string& data)
 {
   size_t len = data.size();
-  char escapedSql[2*len + 1];
+  std::vector<char> escapedSql(2*len + 1);
 
-  int connId;
-  PGconn* conn = getConnection(connId);
-  size_t escapedSqlLen = PQescapeStringConn(conn, escapedSql, data.c_str(), len, NULL);
-  releaseConnection(connId);
+  boost::lock_guard<boost::mutex> lock(mescapeMutex);
+  if (mescapeConn == NULL) {
+    throw SystemException(ERRCODE_DBCONN, "The database is not connected");
+  }
+  size_t escapedSqlLen = PQescapeStringConn(mescapeConn, &escapedSql[0], data.c_str(), len, NULL);
 
-  return std::string(escapedSql, escapedSqlLen);
+  return std::string(&escapedSql[0], escapedSqlLen);
 }
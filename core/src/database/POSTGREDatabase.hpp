@@ -8,9 +8,11 @@
 #ifndef _POSTGREDATABASE_H_
 #define _POSTGREDATABASE_H_
 
+#include <map>
 #include <string>
-#include <pthread.h>
+#include <boost/thread/mutex.hpp>
 
+#include "ConnectionPool.hpp"
 #include "Database.hpp"
 #include "DatabaseResult.hpp"
 #include "DbConfiguration.hpp"
@@ -117,24 +119,52 @@ public :
   virtual std::string
   escapeData(const std::string& data);
 
+  /**
+   * \brief To get the usage statistics of the connection pool
+   * \return the statistics
+   */
+  virtual ConnectionPoolMetrics
+  getPoolMetrics();
+
+  /**
+   * \brief Function to process a prepared request in the database
+   * \param name The name of the statement, identifying the request
+   * \param request The request, the parameters are noted $1, $2...
+   * \param params The values of the parameters
+   * \param transacId the id of the transaction if one is used
+   * \return raises an exception on error
+   */
+  virtual int
+  processPrepared(const std::string& name, const std::string& request,
+                  const SqlParameters& params, int transacId = -1);
+
+  /**
+   * \brief To get the result of a prepared select request
+   * \param name The name of the statement, identifying the request
+   * \param request The request, the parameters are noted $1, $2...
+   * \param params The values of the parameters
+   * \param transacId the id of the transaction if one is used
+   * \return An object which encapsulates the database results
+   */
+  virtual DatabaseResult*
+  getPreparedResult(const std::string& name, const std::string& request,
+                    const SqlParameters& params, int transacId = -1);
+
 private :
 
   /**
    * \brief An element of the pool
    */
   typedef struct pool_t{
-    /**
-     * \brief If the connexion is used
-     */
-    bool mused;
     /**
      * \brief The connexion
      */
     PGconn* mconn;
     /**
-     * \brief The associated mutex
+     * \brief The requests of the statements prepared on the connexion,
+     * by name
      */
-    pthread_mutex_t mmutex;
+    std::map<std::string, std::string> mprepared;
   }pool_t;
 
   /**
@@ -150,6 +180,46 @@ private :
    */
   void releaseConnection(int pos);
 
+  /**
+   * \brief To release a connexion after a failed request, the connexion
+   * is reconnected in background if it is broken
+   * \param pos The position of the connexion to release
+   * \param conn The connexion
+   */
+  void releaseFailedConnection(int pos, PGconn* conn);
+
+  /**
+   * \brief To check that a connexion of the pool still works
+   * \param pos The position of the connexion
+   * \return true if the connexion works
+   */
+  bool checkConnection(int pos);
+
+  /**
+   * \brief To reopen a connexion of the pool, raises an exception on error
+   * \param pos The position of the connexion
+   */
+  void reconnect(int pos);
+
+  /**
+   * \brief To get the connection string of the database
+   * \return the connection string
+   */
+  std::string getConnInfo();
+
+  /**
+   * \brief To execute a prepared request, preparing it first if the
+   * connexion does not know it, raises an exception on error
+   * \param pos The position of the connexion
+   * \param name The name of the statement
+   * \param request The request
+   * \param params The values of the parameters
+   * \return the result, to be cleared by the caller
+   */
+  PGresult* execPrepared(int pos, const std::string& name,
+                         const std::string& request,
+                         const SqlParameters& params);
+
   /////////////////////////////////
   // Attributes
   /////////////////////////////////
@@ -164,6 +234,22 @@ private :
    */
   pool_t *mpool;
 
+  /**
+   * \brief Hands out the connections of the pool
+   */
+  ConnectionPool mconnPool;
+
+  /**
+   * \brief The connexion escaping the strings, kept out of the pool so
+   * that escaping does not wait for a free connexion
+   */
+  PGconn* mescapeConn;
+
+  /**
+   * \brief mutex protecting the connexion escaping the strings
+   */
+  boost::mutex mescapeMutex;
+
   /**
    * \brief If the connection is right
    */
@@ -0,0 +1,159 @@
+/**
+ * \file SqlParameters.hpp
+ * \brief This file defines the parameters bound to a prepared statement
+ */
+
+#ifndef _SQLPARAMETERS_HPP_
+#define _SQLPARAMETERS_HPP_
+
+#include <string>
+#include <vector>
+#include <boost/lexical_cast.hpp>
+
+/**
+ * \class SqlParameters
+ * \brief The typed values bound to the parameters of a prepared statement.
+ * The parameters are numbered from 1 in the requests: $1, $2...
+ */
+class SqlParameters {
+public:
+  /**
+   * \brief The types of the parameters
+   */
+  typedef enum {
+    TEXT,
+    INTEGER
+  } param_type_t;
+
+  /**
+   * \brief Add a text parameter
+   * \param value the value
+   * \return the parameters, to chain the calls
+   */
+  SqlParameters&
+  add(const std::string& value) {
+    mtypes.push_back(TEXT);
+    mvalues.push_back(value);
+    mintegers.push_back(0);
+    return *this;
+  }
+
+  /**
+   * \brief Add a text parameter
+   * \param value the value
+   * \return the parameters, to chain the calls
+   */
+  SqlParameters&
+  add(const char* value) {
+    return add(std::string(value));
+  }
+
+  /**
+   * \brief Add an integer parameter
+   * \param value the value
+   * \return the parameters, to chain the calls
+   */
+  SqlParameters&
+  add(long long value) {
+    mtypes.push_back(INTEGER);
+    mvalues.push_back(boost::lexical_cast<std::string>(value));
+    mintegers.push_back(value);
+    return *this;
+  }
+
+  /**
+   * \brief Add an integer parameter
+   * \param value the value
+   * \return the parameters, to chain the calls
+   */
+  SqlParameters&
+  add(int value) {
+    return add(static_cast<long long>(value));
+  }
+
+  /**
+   * \brief Add a text parameter, to build a request
+   * \param value the value
+   * \return the placeholder of the parameter in the request
+   */
+  std::string
+  bind(const std::string& value) {
+    add(value);
+    return placeholder();
+  }
+
+  /**
+   * \brief Add an integer parameter, to build a request
+   * \param value the value
+   * \return the placeholder of the parameter in the request
+   */
+  std::string
+  bind(long long value) {
+    add(value);
+    return placeholder();
+  }
+
+  /**
+   * \brief Get the number of parameters
+   * \return the number of parameters
+   */
+  size_t
+  size() const {
+    return mvalues.size();
+  }
+
+  /**
+   * \brief Get the type of a parameter
+   * \param pos the position of the parameter, from 0
+   * \return the type
+   */
+  param_type_t
+  getType(size_t pos) const {
+    return mtypes.at(pos);
+  }
+
+  /**
+   * \brief Get the value of a parameter as text
+   * \param pos the position of the parameter, from 0
+   * \return the value
+   */
+  const std::string&
+  getValue(size_t pos) const {
+    return mvalues.at(pos);
+  }
+
+  /**
+   * \brief Get the value of an integer parameter
+   * \param pos the position of the parameter, from 0
+   * \return the value
+   */
+  long long
+  getInteger(size_t pos) const {
+    return mintegers.at(pos);
+  }
+
+private:
+  /**
+   * \brief Get the placeholder of the last parameter added
+   * \return the placeholder
+   */
+  std::string
+  placeholder() const {
+    return "$" + boost::lexical_cast<std::string>(mvalues.size());
+  }
+
+  /**
+   * \brief The types of the parameters
+   */
+  std::vector<param_type_t> mtypes;
+  /**
+   * \brief The values of the parameters, as text
+   */
+  std::vector<std::string> mvalues;
+  /**
+   * \brief The values of the integer parameters
+   */
+  std::vector<long long> mintegers;
+};
+
+#endif // _SQLPARAMETERS_HPP_
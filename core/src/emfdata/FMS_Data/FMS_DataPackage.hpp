@@ -308,70 +308,75 @@ namespace FMS_Data
          */
         static const int FILETRANSFER__ERRORMSG = 34;
 
+        /**
+         * \brief Constant for FILETRANSFER__BYTESDONE feature
+         */
+        static const int FILETRANSFER__BYTESDONE = 35;
+
         /**
          * \brief Constant for FILETRANSFERLIST__FILETRANSFERS feature
          */
-        static const int FILETRANSFERLIST__FILETRANSFERS = 35;
+        static const int FILETRANSFERLIST__FILETRANSFERS = 36;
 
         /**
          * \brief Constant for HEADOFFILEOPTIONS__NLINE feature
          */
-        static const int HEADOFFILEOPTIONS__NLINE = 36;
+        static const int HEADOFFILEOPTIONS__NLINE = 37;
 
         /**
          * \brief Constant for TAILOFFILEOPTIONS__NLINE feature
          */
-        static const int TAILOFFILEOPTIONS__NLINE = 37;
+        static const int TAILOFFILEOPTIONS__NLINE = 38;
 
         /**
          * \brief Constant for RMFILEOPTIONS__ISRECURSIVE feature
          */
-        static const int RMFILEOPTIONS__ISRECURSIVE = 38;
+        static const int RMFILEOPTIONS__ISRECURSIVE = 39;
 
         /**
          * \brief Constant for CREATEDIROPTIONS__ISRECURSIVE feature
          */
-        static const int CREATEDIROPTIONS__ISRECURSIVE = 39;
+        static const int CREATEDIROPTIONS__ISRECURSIVE = 40;
 
         /**
          * \brief Constant for DIRENTRY__PATH feature
          */
-        static const int DIRENTRY__PATH = 40;
+        static const int DIRENTRY__PATH = 41;
 
         /**
          * \brief Constant for DIRENTRY__OWNER feature
          */
-        static const int DIRENTRY__OWNER = 41;
+        static const int DIRENTRY__OWNER = 42;
 
         /**
          * \brief Constant for DIRENTRY__GROUP feature
          */
-        static const int DIRENTRY__GROUP = 42;
+        static const int DIRENTRY__GROUP = 43;
 
         /**
          * \brief Constant for DIRENTRY__PERMS feature
          */
-        static const int DIRENTRY__PERMS = 43;
+        static const int DIRENTRY__PERMS = 44;
 
         /**
          * \brief Constant for DIRENTRY__SIZE feature
          */
-        static const int DIRENTRY__SIZE = 44;
+        static const int DIRENTRY__SIZE = 45;
 
         /**
          * \brief Constant for DIRENTRY__CTIME feature
          */
-        static const int DIRENTRY__CTIME = 45;
+        static const int DIRENTRY__CTIME = 46;
 
         /**
          * \brief Constant for DIRENTRY__TYPE feature
          */
-        static const int DIRENTRY__TYPE = 46;
+        static const int DIRENTRY__TYPE = 47;
 
         /**
          * \brief Constant for DIRENTRYLIST__DIRENTRIES feature
          */
-        static const int DIRENTRYLIST__DIRENTRIES = 47;
+        static const int DIRENTRYLIST__DIRENTRIES = 48;
 
         // EClassifiers methods
 
@@ -689,6 +694,12 @@ namespace FMS_Data
          */
         virtual ::ecore::EAttribute_ptr getFileTransfer__errorMsg();
 
+        /**
+         * \brief Returns the reflective object for feature bytesDone of class FileTransfer
+         * \return A pointer to the reflective object
+         */
+        virtual ::ecore::EAttribute_ptr getFileTransfer__bytesDone();
+
         /**
          * \brief Returns the reflective object for feature fileTransfers of class FileTransferList
          * \return A pointer to the reflective object
@@ -1045,6 +1056,11 @@ namespace FMS_Data
          */
         ::ecore::EAttribute_ptr m_FileTransfer__errorMsg;
 
+        /**
+         * \brief The instance for the feature bytesDone of class FileTransfer
+         */
+        ::ecore::EAttribute_ptr m_FileTransfer__bytesDone;
+
         /**
          * \brief The instance for the feature fileTransfers of class FileTransferList
          */
@@ -248,6 +248,11 @@ FMS_DataPackage::FMS_DataPackage()
             ::FMS_Data::FMS_DataPackage::FILETRANSFER__ERRORMSG);
     m_FileTransferEClass->getEStructuralFeatures().push_back(
             m_FileTransfer__errorMsg);
+    m_FileTransfer__bytesDone = new ::ecore::EAttribute();
+    m_FileTransfer__bytesDone->setFeatureID(
+            ::FMS_Data::FMS_DataPackage::FILETRANSFER__BYTESDONE);
+    m_FileTransferEClass->getEStructuralFeatures().push_back(
+            m_FileTransfer__bytesDone);
 
     // FileTransferList
     m_FileTransferListEClass = new ::ecore::EClass();
@@ -889,6 +894,20 @@ FMS_DataPackage::FMS_DataPackage()
     m_FileTransfer__errorMsg->setUnique(true);
     m_FileTransfer__errorMsg->setDerived(false);
     m_FileTransfer__errorMsg->setOrdered(true);
+    m_FileTransfer__bytesDone->setEType(
+            dynamic_cast< ::ecore::EcorePackage* > (::ecore::EcorePackage::_instance())->getEBigInteger());
+    m_FileTransfer__bytesDone->setName("bytesDone");
+    m_FileTransfer__bytesDone->setDefaultValueLiteral("0");
+    m_FileTransfer__bytesDone->setLowerBound(0);
+    m_FileTransfer__bytesDone->setUpperBound(1);
+    m_FileTransfer__bytesDone->setTransient(false);
+    m_FileTransfer__bytesDone->setVolatile(false);
+    m_FileTransfer__bytesDone->setChangeable(true);
+    m_FileTransfer__bytesDone->setUnsettable(false);
+    m_FileTransfer__bytesDone->setID(false);
+    m_FileTransfer__bytesDone->setUnique(true);
+    m_FileTransfer__bytesDone->setDerived(false);
+    m_FileTransfer__bytesDone->setOrdered(true);
     // FileTransferList
     m_FileTransferListEClass->setName("FileTransferList");
     m_FileTransferListEClass->setAbstract(false);
@@ -1262,6 +1281,16 @@ FMS_DataPackage::FMS_DataPackage()
         m_TransferCommandEEnum->getELiterals().push_back(_el);
     }
 
+    {
+        ::ecore::EEnumLiteral_ptr _el = new ::ecore::EEnumLiteral();
+        // PARALLEL
+        _el->setName("PARALLEL");
+        _el->setValue(3);
+        _el->setLiteral("PARALLEL");
+        _el->setEEnum(m_TransferCommandEEnum);
+        m_TransferCommandEEnum->getELiterals().push_back(_el);
+    }
+
     _initialize();
 }
 
@@ -1474,6 +1503,10 @@ FMS_DataPackage::FMS_DataPackage()
 {
     return m_FileTransfer__errorMsg;
 }
+::ecore::EAttribute_ptr FMS_DataPackage::getFileTransfer__bytesDone()
+{
+    return m_FileTransfer__bytesDone;
+}
 ::ecore::EReference_ptr FMS_DataPackage::getFileTransferList__fileTransfers()
 {
     return m_FileTransferList__fileTransfers;
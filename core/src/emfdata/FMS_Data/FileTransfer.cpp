@@ -31,7 +31,7 @@ using namespace ::FMS_Data;
 
 // Default constructor
 FileTransfer::FileTransfer() :
-    m_status(4), m_size(-1), m_startTime(0), m_trCommand(2)
+    m_status(4), m_size(-1), m_startTime(0), m_trCommand(2), m_bytesDone(0)
 {
 
     /*PROTECTED REGION ID(FileTransferImpl__FileTransferImpl) START*/
@@ -365,5 +365,31 @@ void FileTransfer::setErrorMsg(::ecore::EString const& _errorMsg)
 #endif
 }
 
+::ecore::EBigInteger FileTransfer::getBytesDone() const
+{
+    return m_bytesDone;
+}
+
+void FileTransfer::setBytesDone(::ecore::EBigInteger _bytesDone)
+{
+#ifdef ECORECPP_NOTIFICATION_API
+    ::ecore::EBigInteger _old_bytesDone = m_bytesDone;
+#endif
+    m_bytesDone = _bytesDone;
+#ifdef ECORECPP_NOTIFICATION_API
+    if (eNotificationRequired())
+    {
+        ::ecorecpp::notify::Notification notification(
+                ::ecorecpp::notify::Notification::SET,
+                (::ecore::EObject_ptr) this,
+                (::ecore::EStructuralFeature_ptr) ::FMS_Data::FMS_DataPackage::_instance()->getFileTransfer__bytesDone(),
+                _old_bytesDone,
+                m_bytesDone
+        );
+        eNotify(&notification);
+    }
+#endif
+}
+
 // References
 
@@ -203,6 +203,17 @@ namespace FMS_Data
          **/
         void setErrorMsg(::ecore::EString const& _errorMsg);
 
+        /**
+         * \brief To get the bytesDone
+         * \return The bytesDone attribute value
+         **/
+        ::ecore::EBigInteger getBytesDone() const;
+        /**
+         * \brief To set the bytesDone
+         * \param _bytesDone The bytesDone value
+         **/
+        void setBytesDone(::ecore::EBigInteger _bytesDone);
+
         // References
 
 
@@ -252,6 +263,8 @@ namespace FMS_Data
 
         ::ecore::EString m_errorMsg;
 
+        ::ecore::EBigInteger m_bytesDone;
+
         // References
 
     };
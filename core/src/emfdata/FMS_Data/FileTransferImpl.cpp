@@ -127,6 +127,12 @@ void FileTransfer::_initialize()
                 m_errorMsg);
     }
         return _any;
+    case ::FMS_Data::FMS_DataPackage::FILETRANSFER__BYTESDONE:
+    {
+        ::ecorecpp::mapping::any_traits< ::ecore::EBigInteger >::toAny(_any,
+                m_bytesDone);
+    }
+        return _any;
 
     }
     throw "Error";
@@ -209,6 +215,12 @@ void FileTransfer::eSet(::ecore::EInt _featureID,
                 m_errorMsg);
     }
         return;
+    case ::FMS_Data::FMS_DataPackage::FILETRANSFER__BYTESDONE:
+    {
+        ::ecorecpp::mapping::any_traits< ::ecore::EBigInteger >::fromAny(
+                _newValue, m_bytesDone);
+    }
+        return;
 
     }
     throw "Error";
@@ -250,6 +262,8 @@ void FileTransfer::eSet(::ecore::EInt _featureID,
     case ::FMS_Data::FMS_DataPackage::FILETRANSFER__ERRORMSG:
         return ::ecorecpp::mapping::set_traits< ::ecore::EString >::is_set(
                 m_errorMsg);
+    case ::FMS_Data::FMS_DataPackage::FILETRANSFER__BYTESDONE:
+        return m_bytesDone != 0;
 
     }
     throw "Error";
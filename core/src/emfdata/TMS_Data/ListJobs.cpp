@@ -133,6 +133,32 @@ void ListJobs::setNbWaitingJobs(::ecore::ELong _nbWaitingJobs)
 #endif
 }
 
+::ecore::EString const& ListJobs::getNextToken() const
+{
+    return m_nextToken;
+}
+
+void ListJobs::setNextToken(::ecore::EString const& _nextToken)
+{
+#ifdef ECORECPP_NOTIFICATION_API
+    ::ecore::EString _old_nextToken = m_nextToken;
+#endif
+    m_nextToken = _nextToken;
+#ifdef ECORECPP_NOTIFICATION_API
+    if (eNotificationRequired())
+    {
+        ::ecorecpp::notify::Notification notification(
+                ::ecorecpp::notify::Notification::SET,
+                (::ecore::EObject_ptr) this,
+                (::ecore::EStructuralFeature_ptr) ::TMS_Data::TMS_DataPackage::_instance()->getListJobs__nextToken(),
+                _old_nextToken,
+                m_nextToken
+        );
+        eNotify(&notification);
+    }
+#endif
+}
+
 // References
 ::ecorecpp::mapping::EList< ::TMS_Data::Job >& ListJobs::getJobs()
 {
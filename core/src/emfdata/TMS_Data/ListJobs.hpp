@@ -101,6 +101,17 @@ namespace TMS_Data
          **/
         void setNbWaitingJobs(::ecore::ELong _nbWaitingJobs);
 
+        /**
+         * \brief To get the nextToken
+         * \return The nextToken attribute value
+         **/
+        ::ecore::EString const& getNextToken() const;
+        /**
+         * \brief To set the nextToken
+         * \param _nextToken The nextToken value
+         **/
+        void setNextToken(::ecore::EString const& _nextToken);
+
         // References
         /**
          * \brief To get the list of Jobs
@@ -136,6 +147,8 @@ namespace TMS_Data
 
         ::ecore::ELong m_nbWaitingJobs;
 
+        ::ecore::EString m_nextToken;
+
         // References
 
         ::ecorecpp::mapping::out_ptr< ::ecorecpp::mapping::EList<
@@ -79,6 +79,12 @@ void ListJobs::_initialize()
                 m_nbWaitingJobs);
     }
         return _any;
+    case ::TMS_Data::TMS_DataPackage::LISTJOBS__NEXTTOKEN:
+    {
+        ::ecorecpp::mapping::any_traits< ::ecore::EString >::toAny(_any,
+                m_nextToken);
+    }
+        return _any;
     case ::TMS_Data::TMS_DataPackage::LISTJOBS__JOBS:
     {
         _any = m_jobs->asEListOf< ::ecore::EObject > ();
@@ -112,6 +118,12 @@ void ListJobs::eSet(::ecore::EInt _featureID,
                 m_nbWaitingJobs);
     }
         return;
+    case ::TMS_Data::TMS_DataPackage::LISTJOBS__NEXTTOKEN:
+    {
+        ::ecorecpp::mapping::any_traits< ::ecore::EString >::fromAny(_newValue,
+                m_nextToken);
+    }
+        return;
     case ::TMS_Data::TMS_DataPackage::LISTJOBS__JOBS:
     {
         ::ecorecpp::mapping::EList_ptr _t0 =
@@ -136,6 +148,9 @@ void ListJobs::eSet(::ecore::EInt _featureID,
         return m_nbRunningJobs != 0;
     case ::TMS_Data::TMS_DataPackage::LISTJOBS__NBWAITINGJOBS:
         return m_nbWaitingJobs != 0;
+    case ::TMS_Data::TMS_DataPackage::LISTJOBS__NEXTTOKEN:
+        return ::ecorecpp::mapping::set_traits< ::ecore::EString >::is_set(
+                m_nextToken);
     case ::TMS_Data::TMS_DataPackage::LISTJOBS__JOBS:
         return m_jobs && m_jobs->size();
 
@@ -33,7 +33,7 @@ using namespace ::TMS_Data;
 ListJobsOptions::ListJobsOptions() :
     m_jobId(""), m_nbCpu(-1), m_fromSubmitDate(-1), m_toSubmitDate(-1),
             m_status(-1), m_priority(-1), m_batchJob(false), m_workId(-1),
-            m_listAll(false)
+            m_listAll(false), m_pageSize(0)
 {
 
     /*PROTECTED REGION ID(ListJobsOptionsImpl__ListJobsOptionsImpl) START*/
@@ -391,5 +391,57 @@ void ListJobsOptions::setMachineId(::ecore::EString const& _machineId)
 #endif
 }
 
+::ecore::EInt ListJobsOptions::getPageSize() const
+{
+    return m_pageSize;
+}
+
+void ListJobsOptions::setPageSize(::ecore::EInt _pageSize)
+{
+#ifdef ECORECPP_NOTIFICATION_API
+    ::ecore::EInt _old_pageSize = m_pageSize;
+#endif
+    m_pageSize = _pageSize;
+#ifdef ECORECPP_NOTIFICATION_API
+    if (eNotificationRequired())
+    {
+        ::ecorecpp::notify::Notification notification(
+                ::ecorecpp::notify::Notification::SET,
+                (::ecore::EObject_ptr) this,
+                (::ecore::EStructuralFeature_ptr) ::TMS_Data::TMS_DataPackage::_instance()->getListJobsOptions__pageSize(),
+                _old_pageSize,
+                m_pageSize
+        );
+        eNotify(&notification);
+    }
+#endif
+}
+
+::ecore::EString const& ListJobsOptions::getResumeToken() const
+{
+    return m_resumeToken;
+}
+
+void ListJobsOptions::setResumeToken(::ecore::EString const& _resumeToken)
+{
+#ifdef ECORECPP_NOTIFICATION_API
+    ::ecore::EString _old_resumeToken = m_resumeToken;
+#endif
+    m_resumeToken = _resumeToken;
+#ifdef ECORECPP_NOTIFICATION_API
+    if (eNotificationRequired())
+    {
+        ::ecorecpp::notify::Notification notification(
+                ::ecorecpp::notify::Notification::SET,
+                (::ecore::EObject_ptr) this,
+                (::ecore::EStructuralFeature_ptr) ::TMS_Data::TMS_DataPackage::_instance()->getListJobsOptions__resumeToken(),
+                _old_resumeToken,
+                m_resumeToken
+        );
+        eNotify(&notification);
+    }
+#endif
+}
+
 // References
 
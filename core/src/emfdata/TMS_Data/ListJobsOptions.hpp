@@ -212,6 +212,28 @@ namespace TMS_Data
          **/
         void setMachineId(::ecore::EString const& _machineId);
 
+        /**
+         * \brief To get the pageSize
+         * \return The pageSize attribute value
+         **/
+        ::ecore::EInt getPageSize() const;
+        /**
+         * \brief To set the pageSize
+         * \param _pageSize The pageSize value
+         **/
+        void setPageSize(::ecore::EInt _pageSize);
+
+        /**
+         * \brief To get the resumeToken
+         * \return The resumeToken attribute value
+         **/
+        ::ecore::EString const& getResumeToken() const;
+        /**
+         * \brief To set the resumeToken
+         * \param _resumeToken The resumeToken value
+         **/
+        void setResumeToken(::ecore::EString const& _resumeToken);
+
         // References
 
 
@@ -263,6 +285,10 @@ namespace TMS_Data
 
         ::ecore::EString m_machineId;
 
+        ::ecore::EInt m_pageSize;
+
+        ::ecore::EString m_resumeToken;
+
         // References
 
     };
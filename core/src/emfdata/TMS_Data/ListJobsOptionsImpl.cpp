@@ -131,6 +131,18 @@ void ListJobsOptions::_initialize()
                 m_machineId);
     }
         return _any;
+    case ::TMS_Data::TMS_DataPackage::LISTJOBSOPTIONS__PAGESIZE:
+    {
+        ::ecorecpp::mapping::any_traits< ::ecore::EInt >::toAny(_any,
+                m_pageSize);
+    }
+        return _any;
+    case ::TMS_Data::TMS_DataPackage::LISTJOBSOPTIONS__RESUMETOKEN:
+    {
+        ::ecorecpp::mapping::any_traits< ::ecore::EString >::toAny(_any,
+                m_resumeToken);
+    }
+        return _any;
 
     }
     throw "Error";
@@ -219,6 +231,18 @@ void ListJobsOptions::eSet(::ecore::EInt _featureID,
                 m_machineId);
     }
         return;
+    case ::TMS_Data::TMS_DataPackage::LISTJOBSOPTIONS__PAGESIZE:
+    {
+        ::ecorecpp::mapping::any_traits< ::ecore::EInt >::fromAny(_newValue,
+                m_pageSize);
+    }
+        return;
+    case ::TMS_Data::TMS_DataPackage::LISTJOBSOPTIONS__RESUMETOKEN:
+    {
+        ::ecorecpp::mapping::any_traits< ::ecore::EString >::fromAny(_newValue,
+                m_resumeToken);
+    }
+        return;
 
     }
     throw "Error";
@@ -258,6 +282,11 @@ void ListJobsOptions::eSet(::ecore::EInt _featureID,
     case ::TMS_Data::TMS_DataPackage::LISTJOBSOPTIONS__MACHINEID:
         return ::ecorecpp::mapping::set_traits< ::ecore::EString >::is_set(
                 m_machineId);
+    case ::TMS_Data::TMS_DataPackage::LISTJOBSOPTIONS__PAGESIZE:
+        return m_pageSize != 0;
+    case ::TMS_Data::TMS_DataPackage::LISTJOBSOPTIONS__RESUMETOKEN:
+        return ::ecorecpp::mapping::set_traits< ::ecore::EString >::is_set(
+                m_resumeToken);
 
     }
     throw "Error";
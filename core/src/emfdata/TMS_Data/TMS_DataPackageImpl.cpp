@@ -174,6 +174,11 @@ TMS_DataPackage::TMS_DataPackage()
             ::TMS_Data::TMS_DataPackage::LISTJOBS__NBWAITINGJOBS);
     m_ListJobsEClass->getEStructuralFeatures().push_back(
             m_ListJobs__nbWaitingJobs);
+    m_ListJobs__nextToken = new ::ecore::EAttribute();
+    m_ListJobs__nextToken->setFeatureID(
+            ::TMS_Data::TMS_DataPackage::LISTJOBS__NEXTTOKEN);
+    m_ListJobsEClass->getEStructuralFeatures().push_back(
+            m_ListJobs__nextToken);
     m_ListJobs__jobs = new ::ecore::EReference();
     m_ListJobs__jobs->setFeatureID(::TMS_Data::TMS_DataPackage::LISTJOBS__JOBS);
     m_ListJobsEClass->getEStructuralFeatures().push_back(m_ListJobs__jobs);
@@ -359,6 +364,16 @@ TMS_DataPackage::TMS_DataPackage()
             ::TMS_Data::TMS_DataPackage::LISTJOBSOPTIONS__MACHINEID);
     m_ListJobsOptionsEClass->getEStructuralFeatures().push_back(
             m_ListJobsOptions__machineId);
+    m_ListJobsOptions__pageSize = new ::ecore::EAttribute();
+    m_ListJobsOptions__pageSize->setFeatureID(
+            ::TMS_Data::TMS_DataPackage::LISTJOBSOPTIONS__PAGESIZE);
+    m_ListJobsOptionsEClass->getEStructuralFeatures().push_back(
+            m_ListJobsOptions__pageSize);
+    m_ListJobsOptions__resumeToken = new ::ecore::EAttribute();
+    m_ListJobsOptions__resumeToken->setFeatureID(
+            ::TMS_Data::TMS_DataPackage::LISTJOBSOPTIONS__RESUMETOKEN);
+    m_ListJobsOptionsEClass->getEStructuralFeatures().push_back(
+            m_ListJobsOptions__resumeToken);
 
     // ProgressOptions
     m_ProgressOptionsEClass = new ::ecore::EClass();
@@ -1231,6 +1246,20 @@ TMS_DataPackage::TMS_DataPackage()
     m_ListJobs__nbWaitingJobs->setUnique(true);
     m_ListJobs__nbWaitingJobs->setDerived(false);
     m_ListJobs__nbWaitingJobs->setOrdered(true);
+    m_ListJobs__nextToken->setEType(
+            dynamic_cast< ::ecore::EcorePackage* > (::ecore::EcorePackage::_instance())->getEString());
+    m_ListJobs__nextToken->setName("nextToken");
+    m_ListJobs__nextToken->setDefaultValueLiteral("");
+    m_ListJobs__nextToken->setLowerBound(0);
+    m_ListJobs__nextToken->setUpperBound(1);
+    m_ListJobs__nextToken->setTransient(false);
+    m_ListJobs__nextToken->setVolatile(false);
+    m_ListJobs__nextToken->setChangeable(true);
+    m_ListJobs__nextToken->setUnsettable(false);
+    m_ListJobs__nextToken->setID(false);
+    m_ListJobs__nextToken->setUnique(true);
+    m_ListJobs__nextToken->setDerived(false);
+    m_ListJobs__nextToken->setOrdered(true);
     m_ListJobs__jobs->setEType(m_JobEClass);
     m_ListJobs__jobs->setName("jobs");
     m_ListJobs__jobs->setDefaultValueLiteral("");
@@ -1725,6 +1754,34 @@ TMS_DataPackage::TMS_DataPackage()
     m_ListJobsOptions__machineId->setUnique(true);
     m_ListJobsOptions__machineId->setDerived(false);
     m_ListJobsOptions__machineId->setOrdered(true);
+    m_ListJobsOptions__pageSize->setEType(
+            dynamic_cast< ::ecore::EcorePackage* > (::ecore::EcorePackage::_instance())->getEInt());
+    m_ListJobsOptions__pageSize->setName("pageSize");
+    m_ListJobsOptions__pageSize->setDefaultValueLiteral("0");
+    m_ListJobsOptions__pageSize->setLowerBound(0);
+    m_ListJobsOptions__pageSize->setUpperBound(1);
+    m_ListJobsOptions__pageSize->setTransient(false);
+    m_ListJobsOptions__pageSize->setVolatile(false);
+    m_ListJobsOptions__pageSize->setChangeable(true);
+    m_ListJobsOptions__pageSize->setUnsettable(false);
+    m_ListJobsOptions__pageSize->setID(false);
+    m_ListJobsOptions__pageSize->setUnique(true);
+    m_ListJobsOptions__pageSize->setDerived(false);
+    m_ListJobsOptions__pageSize->setOrdered(true);
+    m_ListJobsOptions__resumeToken->setEType(
+            dynamic_cast< ::ecore::EcorePackage* > (::ecore::EcorePackage::_instance())->getEString());
+    m_ListJobsOptions__resumeToken->setName("resumeToken");
+    m_ListJobsOptions__resumeToken->setDefaultValueLiteral("");
+    m_ListJobsOptions__resumeToken->setLowerBound(0);
+    m_ListJobsOptions__resumeToken->setUpperBound(1);
+    m_ListJobsOptions__resumeToken->setTransient(false);
+    m_ListJobsOptions__resumeToken->setVolatile(false);
+    m_ListJobsOptions__resumeToken->setChangeable(true);
+    m_ListJobsOptions__resumeToken->setUnsettable(false);
+    m_ListJobsOptions__resumeToken->setID(false);
+    m_ListJobsOptions__resumeToken->setUnique(true);
+    m_ListJobsOptions__resumeToken->setDerived(false);
+    m_ListJobsOptions__resumeToken->setOrdered(true);
     // ProgressOptions
     m_ProgressOptionsEClass->setName("ProgressOptions");
     m_ProgressOptionsEClass->setAbstract(false);
@@ -3218,6 +3275,10 @@ TMS_DataPackage::TMS_DataPackage()
 {
     return m_ListJobs__nbWaitingJobs;
 }
+::ecore::EAttribute_ptr TMS_DataPackage::getListJobs__nextToken()
+{
+    return m_ListJobs__nextToken;
+}
 ::ecore::EReference_ptr TMS_DataPackage::getListJobs__jobs()
 {
     return m_ListJobs__jobs;
@@ -3358,6 +3419,14 @@ TMS_DataPackage::TMS_DataPackage()
 {
     return m_ListJobsOptions__machineId;
 }
+::ecore::EAttribute_ptr TMS_DataPackage::getListJobsOptions__pageSize()
+{
+    return m_ListJobsOptions__pageSize;
+}
+::ecore::EAttribute_ptr TMS_DataPackage::getListJobsOptions__resumeToken()
+{
+    return m_ListJobsOptions__resumeToken;
+}
 ::ecore::EAttribute_ptr TMS_DataPackage::getProgressOptions__jobId()
 {
     return m_ProgressOptions__jobId;
@@ -46,6 +46,7 @@ TMSMapper::TMSMapper(MapperRegistry* reg, string na):Mapper(reg){
   mmap.insert (pair<int, string>(VISHNU_GETCOMPLETEDJOB, "vishnu_get_completed_jobs_output"));
   mmap.insert (pair<int, string>(VISHNU_CANCEL, "vishnu_cancel_job"));
   mmap.insert (pair<int, string>(VISHNU_ADD_WORK, "vishnu_add_work"));
+  mmap.insert (pair<int, string>(VISHNU_SUBMITJOBS, "vishnu_submit_jobs"));
 };
 
 int
@@ -171,6 +172,9 @@ TMSMapper::decode (const string& msg){
   case VISHNU_ADD_WORK:
     res = decodeAddWork(separatorPos, msg);
     break;
+  case VISHNU_SUBMITJOBS:
+    res = decodeSubmitMany(separatorPos, msg);
+    break;
   default:
     res = "";
     break;
@@ -543,6 +547,18 @@ TMSMapper::decodeJobInfo(vector<unsigned int> separator, const string& msg){
 }
 
 
+string
+TMSMapper::decodeSubmitMany(vector<unsigned int> separator, const string& msg){
+  string res = string("");
+  string u;
+  res += (mmap.find(VISHNU_SUBMITJOBS))->second;
+  res+= " ";
+  u    = msg.substr(separator.at(0)+1, separator.at(1)-separator.at(0)-1);
+  res += u;
+  return res;
+}
+
+
 string
 TMSMapper::decodeAddWork(vector<unsigned int> separator, const string& msg){
   string res = string("");
@@ -51,6 +51,10 @@ const int VISHNU_CANCEL                  = 8;
  * \brief Add a work
  */
 const int VISHNU_ADD_WORK                  = 9;
+/**
+ * \brief Submit many jobs key
+ */
+const int VISHNU_SUBMITJOBS              = 10;
 
 /**
  * \class TMSMapper
@@ -130,6 +134,14 @@ protected:
    */
   virtual std::string
   decodeSubmit(std::vector<unsigned int> separator, const std::string& msg);
+  /**
+   * \brief To decode the submit many jobs call sequence of the std::string returned by finalize
+   * \param separator A std::vector containing the position of the separator in the message msg
+   * \param msg The message to decode
+   * \return The cli like close command
+   */
+  virtual std::string
+  decodeSubmitMany(std::vector<unsigned int> separator, const std::string& msg);
   /**
    * \brief To decode the add work call sequence of the std::string returned by finalize
    * \param separator A std::vector containing the position of the separator in the message msg
@@ -21,4 +21,9 @@ static const mode_t defaultFileAccessMode=420;
  */
 static const mode_t defaultDirectoryAccessMode=493;
 
+/**
+ * \brief the maximum number of bytes returned by a single read of a file
+ */
+static const long long maxFileReadChunkSize=1048576;
+
 #endif
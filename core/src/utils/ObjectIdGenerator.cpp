@@ -0,0 +1,319 @@
+/**
+ * \file ObjectIdGenerator.cpp
+ * \brief This file implements the generator of the identifiers of the
+ * VISHNU objects
+ */
+#include "ObjectIdGenerator.hpp"
+
+#include <set>
+#include <unistd.h>
+#include <boost/format.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "DbFactory.hpp"
+#include "DatabaseResult.hpp"
+#include "SystemException.hpp"
+#include "utilVishnu.hpp"
+
+using boost::posix_time::microsec_clock;
+using boost::posix_time::ptime;
+
+namespace {
+
+/**
+ * \struct ObjectTable
+ * \brief The table holding the objects of a type
+ */
+struct ObjectTable {
+  /**
+   * \brief The table
+   */
+  const char* table;
+  /**
+   * \brief The column of the identifier
+   */
+  const char* idname;
+  /**
+   * \brief The primary key, which was used as counter before the counters
+   * of the table vishnu
+   */
+  const char* primary;
+  /**
+   * \brief The column of the table vishnu holding the counter
+   */
+  const char* counter;
+  /**
+   * \brief The columns set when the row is inserted
+   */
+  const char* fields;
+  /**
+   * \brief The values of the columns, %1% is the vishnu Id
+   */
+  const char* values;
+  /**
+   * \brief The number of counters reserved at once, the objects created
+   * rarely do not keep any
+   */
+  int blockSize;
+};
+
+/**
+ * \brief The tables, by type of identifier
+ */
+const ObjectTable OBJECT_TABLES[OBJECT_ID_NB_TYPES] = {
+  // MACHINE
+  { "machine", "machineid", "nummachineid", "cptmachine",
+    "vishnu_vishnuid", "%1%", 1 },
+  // USER
+  { "users", "userid", "numuserid", "cptuser",
+    "vishnu_vishnuid, pwd", "%1%, ''", 1 },
+  // JOB
+  { "job", "jobid", "numjobid", "cptjob",
+    "job_owner_id, machine_id, workId, vsession_numsessionid",
+    "(select max(numuserid) from users), (select max(nummachineid) from machine),"
+    " NULL, (select max(numsessionid) from vsession)", OBJECT_ID_BLOCK_SIZE },
+  // FILETRANSFERT
+  { "filetransfer", "transferid", "numfiletransferid", "cptfiletransfer",
+    "vsession_numsessionid",
+    "(select max(numsessionid) from vsession)", OBJECT_ID_BLOCK_SIZE },
+  // AUTH
+  { "authsystem", "authsystemid", "numauthsystemid", "cptauth",
+    "vishnu_vishnuid", "%1%", 1 },
+  // WORK
+  { "work", "identifier", "id", "cptwork",
+    "application_id, date_created, done_ratio, nbcpus, owner_id, project_id,"
+    " status, subject, consolidated",
+    "(select min(id) from application_version), CURRENT_TIMESTAMP, 1, 1,"
+    " (select min(numuserid) from users), (select min(id) from project),"
+    " 1, 'toto', false", OBJECT_ID_BLOCK_SIZE }
+};
+
+/**
+ * \brief Get the table holding the objects of a type
+ * \param type the type of identifier
+ * \return the table, raises an exception if the type is unknown
+ */
+const ObjectTable&
+getObjectTable(vishnu::IdType type) {
+  if (type < vishnu::MACHINE || type > vishnu::WORK) {
+    throw SystemException(ERRCODE_SYSTEM, "Cannot generate the id, the type is unrecognized");
+  }
+  return OBJECT_TABLES[type];
+}
+
+} // namespace
+
+
+ObjectIdGenerator&
+ObjectIdGenerator::getInstance() {
+  static ObjectIdGenerator instance;
+  return instance;
+}
+
+
+ObjectIdGenerator::ObjectIdGenerator()
+  : mvishnuId(-1), mowner(getpid()) {
+  for (int type = 0; type < OBJECT_ID_NB_TYPES; ++type) {
+    mblocks[type] = 0;
+  }
+}
+
+
+std::string
+ObjectIdGenerator::getObjectId(int vishnuId,
+                               const std::string& formatName,
+                               vishnu::IdType type,
+                               const std::string& stringforgeneration) {
+  std::vector<std::string> ids;
+  getObjectIds(vishnuId, formatName, type, stringforgeneration, 1, ids);
+  return ids.back();
+}
+
+
+void
+ObjectIdGenerator::getObjectIds(int vishnuId,
+                                const std::string& formatName,
+                                vishnu::IdType type,
+                                const std::string& stringforgeneration,
+                                int count,
+                                std::vector<std::string>& ids) {
+  if (count <= 0) {
+    return;
+  }
+  const ObjectTable& table = getObjectTable(type);
+  std::string format = getFormat(vishnuId, formatName);
+  int first = getCounters(vishnuId, type, count);
+
+  DbFactory factory;
+  Database* database = factory.getDatabaseInstance();
+  boost::format valuesFormat(table.values);
+  valuesFormat.exceptions(boost::io::all_error_bits ^ boost::io::too_many_args_bit);
+  std::string rowValues = boost::str(valuesFormat % vishnuId);
+
+  // the counters are never handed out twice, the names built with them are
+  // unique unless the format does not use the counter
+  bool checkNames = (format.find("$CPT") == std::string::npos);
+  std::set<std::string> names;
+  std::string values;
+  for (int i = 0; i < count; ++i) {
+    int counter = first + i;
+    std::string name = vishnu::getGeneratedName(format.c_str(), counter, type, stringforgeneration);
+    if (name.empty()) {
+      throw SystemException(ERRCODE_SYSTEM, "There is a problem during the id generation with the format:"+ formatName);
+    }
+    if (checkNames) {
+      while (names.count(name) != 0
+             || ! vishnu::checkObjectId(table.table, table.idname, name)) {
+        name += vishnu::convertToString(counter);
+      }
+    }
+    names.insert(name);
+    if (! values.empty()) {
+      values += ", ";
+    }
+    values += "("+ rowValues +", '"+ database->escapeData(name) +"')";
+    ids.push_back(name);
+  }
+
+  try {
+    database->process(boost::str(boost::format("INSERT INTO %1% (%2%, %3%) VALUES %4%")
+                                 % table.table % table.fields % table.idname % values));
+  } catch (SystemException& e) {
+    ids.resize(ids.size() - count);
+    e.appendMsgComp(" Cannot reserve Object id");
+    throw;
+  }
+}
+
+
+void
+ObjectIdGenerator::invalidateFormats() {
+  boost::lock_guard<boost::mutex> lock(mformatMutex);
+  mformats.clear();
+}
+
+
+std::string
+ObjectIdGenerator::getFormat(int vishnuId, const std::string& formatName) {
+  boost::lock_guard<boost::mutex> lock(mformatMutex);
+  ptime now = microsec_clock::universal_time();
+  std::pair<int, std::string> key(vishnuId, formatName);
+  std::map<std::pair<int, std::string>, CachedFormat>::const_iterator it = mformats.find(key);
+  if (it != mformats.end() && now < it->second.expiry) {
+    return it->second.format;
+  }
+
+  // the format may be changed by the other processes, it is read again
+  // from time to time
+  std::string format = vishnu::getAttrVishnu(formatName, vishnu::convertToString(vishnuId));
+  if (format.empty()) {
+    throw SystemException(ERRCODE_SYSTEM, "The format "+ formatName +" is undefined");
+  }
+  CachedFormat& cached = mformats[key];
+  cached.format = format;
+  cached.expiry = now + boost::posix_time::seconds(OBJECT_ID_FORMAT_TTL);
+  return format;
+}
+
+
+int
+ObjectIdGenerator::getCounters(int vishnuId, vishnu::IdType type, int count) {
+  int first;
+  if (mowner == getpid() && mvishnuId == vishnuId && takeCounters(type, count, first)) {
+    return first;
+  }
+
+  boost::lock_guard<boost::mutex> lock(mreserveMutex);
+  if (mowner != getpid()) {
+    // the counters of the parent process are its own
+    for (int block = 0; block < OBJECT_ID_NB_TYPES; ++block) {
+      __sync_lock_test_and_set(&mblocks[block], 0);
+    }
+    mowner = getpid();
+  }
+  if (mvishnuId == -1) {
+    mvishnuId = vishnuId;
+  }
+
+  int blockSize = getObjectTable(type).blockSize;
+  if (mvishnuId != vishnuId || count >= blockSize) {
+    return reserveCounters(vishnuId, type, count);
+  }
+  // another thread may have reserved a block meanwhile
+  if (takeCounters(type, count, first)) {
+    return first;
+  }
+  first = reserveCounters(vishnuId, type, blockSize);
+  __sync_lock_test_and_set(&mblocks[type], makeBlock(first + count, first + blockSize));
+  return first;
+}
+
+
+bool
+ObjectIdGenerator::takeCounters(vishnu::IdType type, int count, int& first) {
+  return takeFromBlock(mblocks[type], count, first);
+}
+
+
+ObjectIdGenerator::CounterBlock
+ObjectIdGenerator::makeBlock(int next, int end) {
+  return (static_cast<CounterBlock>(static_cast<unsigned int>(end)) << 32)
+         | static_cast<unsigned int>(next);
+}
+
+
+bool
+ObjectIdGenerator::takeFromBlock(volatile CounterBlock& block, int count, int& first) {
+  CounterBlock current = block;
+  while (true) {
+    unsigned int next = static_cast<unsigned int>(current & 0xffffffffULL);
+    unsigned int end = static_cast<unsigned int>(current >> 32);
+    if (next + count > end) {
+      return false;
+    }
+    CounterBlock updated = (current & 0xffffffff00000000ULL) | (next + count);
+    CounterBlock previous = __sync_val_compare_and_swap(&block, current, updated);
+    if (previous == current) {
+      first = static_cast<int>(next);
+      return true;
+    }
+    current = previous;
+  }
+}
+
+
+int
+ObjectIdGenerator::reserveCounters(int vishnuId, vishnu::IdType type, int count) {
+  const ObjectTable& table = getObjectTable(type);
+  std::string vishnuIdString = vishnu::convertToString(vishnuId);
+
+  // the counter stays above the primary keys, which the previous versions
+  // used as counters; the row stays locked until the end of the transaction
+  // so the processes sharing the database get distinct blocks
+  std::string sqlReserve = boost::str(boost::format("UPDATE vishnu"
+                                                    " SET %1%=GREATEST(COALESCE(%1%, 0),"
+                                                    " (SELECT COALESCE(MAX(%2%), 0) FROM %3%))+%4%"
+                                                    " WHERE vishnuid=%5%")
+                                      % table.counter % table.primary % table.table
+                                      % count % vishnuIdString);
+  std::string sqlCounter = boost::str(boost::format("SELECT %1% FROM vishnu WHERE vishnuid=%2%")
+                                      % table.counter % vishnuIdString);
+
+  DbFactory factory;
+  Database* database = factory.getDatabaseInstance();
+  int last = 0;
+  int tid = database->startTransaction();
+  try {
+    database->process(sqlReserve, tid);
+    boost::scoped_ptr<DatabaseResult> result(database->getResult(sqlCounter, tid));
+    if (result->getNbTuples() == 0) {
+      throw SystemException(ERRCODE_SYSTEM, "Unknown vishnu identifier "+ vishnuIdString);
+    }
+    last = vishnu::convertToInt(result->getFirstElement());
+    database->endTransaction(tid);
+  } catch (...) {
+    database->cancelTransaction(tid);
+    throw;
+  }
+  return last - count + 1;
+}
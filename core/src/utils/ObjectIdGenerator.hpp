@@ -0,0 +1,207 @@
+/**
+ * \file ObjectIdGenerator.hpp
+ * \brief This file defines the generator of the identifiers of the VISHNU
+ * objects
+ */
+
+#ifndef _OBJECTIDGENERATOR_HPP_
+#define _OBJECTIDGENERATOR_HPP_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sys/types.h>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "utilServer.hpp"
+
+/**
+ * \brief The number of counters reserved at once for the jobs, the file
+ * transfers and the works
+ */
+const int OBJECT_ID_BLOCK_SIZE = 64;
+
+/**
+ * \brief The time in seconds a format of identifier is kept
+ */
+const int OBJECT_ID_FORMAT_TTL = 30;
+
+/**
+ * \brief The number of types of identifier
+ */
+const int OBJECT_ID_NB_TYPES = vishnu::WORK + 1;
+
+/**
+ * \class ObjectIdGenerator
+ * \brief Generates the identifiers of the machines, users, jobs, file
+ * transfers, authentication systems and works. The counters are reserved by
+ * blocks in the table vishnu, so the processes sharing the database never
+ * get the same counter, and handed out without locking between the
+ * threads. The row of each object is inserted with its identifier already
+ * set. The unused counters of a block are lost when the process stops.
+ */
+class ObjectIdGenerator : public boost::noncopyable {
+public:
+  /**
+   * \brief Get the generator of the process
+   * \return the generator
+   */
+  static ObjectIdGenerator&
+  getInstance();
+
+  /**
+   * \brief Generate an identifier and insert the row of the object
+   * \param vishnuId the vishnu Id
+   * \param formatName the name of the format
+   * \param type the type of the Id generated
+   * \param stringforgeneration the string used for generation
+   * \return the identifier, raises an exception on error
+   */
+  std::string
+  getObjectId(int vishnuId,
+              const std::string& formatName,
+              vishnu::IdType type,
+              const std::string& stringforgeneration);
+
+  /**
+   * \brief Generate a set of identifiers and insert the rows of the objects
+   * in a single request
+   * \param vishnuId the vishnu Id
+   * \param formatName the name of the format
+   * \param type the type of the Ids generated
+   * \param stringforgeneration the string used for generation
+   * \param count the number of Ids
+   * \param ids OUT, the Ids generated are appended
+   */
+  void
+  getObjectIds(int vishnuId,
+               const std::string& formatName,
+               vishnu::IdType type,
+               const std::string& stringforgeneration,
+               int count,
+               std::vector<std::string>& ids);
+
+  /**
+   * \brief Forget the cached formats of this process, after one of them
+   * changes. The other processes keep theirs for at most
+   * OBJECT_ID_FORMAT_TTL seconds
+   */
+  void
+  invalidateFormats();
+
+  /**
+   * \brief A block of counters: the next counter in the low 32 bits and
+   * the end of the block in the high 32 bits, so that both change at once
+   */
+  typedef unsigned long long CounterBlock;
+
+  /**
+   * \brief Build a block of counters
+   * \param next the next counter to hand out
+   * \param end the counter following the block
+   * \return the block
+   */
+  static CounterBlock
+  makeBlock(int next, int end);
+
+  /**
+   * \brief Take counters from a block, without locking
+   * \param block the block, shared between the threads
+   * \param count the number of counters
+   * \param first OUT, the first counter
+   * \return false if the block does not hold enough counters
+   */
+  static bool
+  takeFromBlock(volatile CounterBlock& block, int count, int& first);
+
+private:
+  /**
+   * \brief Constructor
+   */
+  ObjectIdGenerator();
+
+  /**
+   * \brief Get a format of identifier
+   * \param vishnuId the vishnu Id
+   * \param formatName the name of the format
+   * \return the format, raises an exception if it is undefined
+   */
+  std::string
+  getFormat(int vishnuId, const std::string& formatName);
+
+  /**
+   * \brief Get consecutive counters
+   * \param vishnuId the vishnu Id
+   * \param type the type of the Ids generated
+   * \param count the number of counters
+   * \return the first counter
+   */
+  int
+  getCounters(int vishnuId, vishnu::IdType type, int count);
+
+  /**
+   * \brief Take counters from the block of a type, without locking
+   * \param type the type of the Ids generated
+   * \param count the number of counters
+   * \param first OUT, the first counter
+   * \return false if the block does not hold enough counters
+   */
+  bool
+  takeCounters(vishnu::IdType type, int count, int& first);
+
+  /**
+   * \brief Reserve counters in the database
+   * \param vishnuId the vishnu Id
+   * \param type the type of the Ids generated
+   * \param count the number of counters
+   * \return the first counter
+   */
+  int
+  reserveCounters(int vishnuId, vishnu::IdType type, int count);
+
+  /**
+   * \struct CachedFormat
+   * \brief A format of identifier
+   */
+  struct CachedFormat {
+    /**
+     * \brief The format
+     */
+    std::string format;
+    /**
+     * \brief The date after which the format is read again
+     */
+    boost::posix_time::ptime expiry;
+  };
+
+  /**
+   * \brief The blocks of counters, by type
+   */
+  volatile CounterBlock mblocks[OBJECT_ID_NB_TYPES];
+  /**
+   * \brief The vishnu Id of the blocks, the others do not use them
+   */
+  volatile int mvishnuId;
+  /**
+   * \brief The process owning the blocks, a forked process must not use
+   * the counters of its parent
+   */
+  volatile pid_t mowner;
+  /**
+   * \brief The cached formats, by vishnu Id and name
+   */
+  std::map<std::pair<int, std::string>, CachedFormat> mformats;
+  /**
+   * \brief mutex protecting the formats
+   */
+  boost::mutex mformatMutex;
+  /**
+   * \brief mutex serializing the reservations of counters
+   */
+  boost::mutex mreserveMutex;
+};
+
+#endif // _OBJECTIDGENERATOR_HPP_
@@ -101,6 +101,47 @@ protected:
     request.append("'"+osValue.str()+"'");
   }
 
+  /**
+   * \brief Function to add sql resquest "and condition" to a given prepared
+   * request, the value being bound as a parameter
+   * \param name The column name of the data base table
+   * \param value The value to search in the given column
+   * \param request The request
+   * \param params The parameters of the request
+   */
+  void addOptionRequest(const std::string& name, const std::string& value,
+                        std::string& request, SqlParameters& params) {
+    request.append(" and "+name+"="+params.bind(value));
+  }
+
+  /**
+   * \brief Function to add sql resquest "and condition" which contain an
+   * integer value to a given prepared request
+   * \param name The column name of the data base table
+   * \param value The integer value to search in the given column
+   * \param request the request
+   * \param params The parameters of the request
+   */
+  template <class T>
+  void addIntegerOptionRequest(const std::string& name, T& value,
+                               std::string& request, SqlParameters& params) {
+    request.append(" and "+name+"="+params.bind(static_cast<long long>(value)));
+  }
+
+  /**
+   * \brief Function to add sql resquest "and condition" on a date to a
+   * given prepared request
+   * \param name The column name of the data base table
+   * \param value The date, as text
+   * \param request the request
+   * \param comp The where statement
+   * \param params The parameters of the request
+   */
+  void addTimeRequest(const std::string& name, const std::string& value,
+                      std::string& request, std::string comp, SqlParameters& params) {
+    request.append(" and "+name+ " "+comp+" "+params.bind(value));
+  }
+
   /**
    * \brief Function to add sql resquest "where condition" to a given request
    * \param name The column name of the data base table
@@ -0,0 +1,159 @@
+/**
+ * \file SessionCache.cpp
+ * \brief This file implements the cache of the validated session keys
+ */
+#include "SessionCache.hpp"
+
+#include <sys/mman.h>
+#include <boost/format.hpp>
+
+#include "Logger.hpp"
+
+using boost::posix_time::microsec_clock;
+using boost::posix_time::ptime;
+
+
+SessionCache&
+SessionCache::getInstance() {
+  static SessionCache instance;
+  return instance;
+}
+
+
+SessionCache::SessionCache()
+  : mttl(boost::posix_time::seconds(DEFAULT_SESSION_CACHE_TTL)),
+    msharedEpoch(NULL), mepoch(0), mhits(0), mmisses(0) {
+  void* shared = mmap(NULL, sizeof(unsigned long), PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (shared == MAP_FAILED) {
+    // the cache is then invalidated by its ttl only in the other processes
+    LOG("[WARNING] cannot share the invalidations of the session cache", LogWarning);
+    shared = new unsigned long;
+  }
+  msharedEpoch = static_cast<volatile unsigned long*>(shared);
+  *msharedEpoch = 0;
+}
+
+
+void
+SessionCache::setTtl(int ttl) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  mttl = boost::posix_time::seconds(ttl > 0 ? ttl : 0);
+  if (ttl <= 0) {
+    mentries.clear();
+  }
+}
+
+
+bool
+SessionCache::get(const std::string& authKey, const std::string& machineId,
+                  UserSessionInfo& info) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  checkEpoch();
+  std::map<Key, Entry>::iterator it = mentries.find(Key(authKey, machineId));
+  if (it == mentries.end()) {
+    ++mmisses;
+    return false;
+  }
+  if (it->second.expiry < microsec_clock::universal_time()) {
+    mentries.erase(it);
+    ++mmisses;
+    return false;
+  }
+  info = it->second.info;
+  ++mhits;
+  return true;
+}
+
+
+void
+SessionCache::put(const std::string& authKey, const std::string& machineId,
+                  const UserSessionInfo& info) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  if (mttl.total_seconds() == 0) {
+    return;
+  }
+  checkEpoch();
+  ptime now = microsec_clock::universal_time();
+  if (mentries.size() >= SESSION_CACHE_MAX_ENTRIES) {
+    for (std::map<Key, Entry>::iterator it = mentries.begin(); it != mentries.end();) {
+      if (it->second.expiry < now) {
+        mentries.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    if (mentries.size() >= SESSION_CACHE_MAX_ENTRIES) {
+      mentries.clear();
+    }
+  }
+  Entry& entry = mentries[Key(authKey, machineId)];
+  entry.info = info;
+  entry.expiry = now + mttl;
+}
+
+
+void
+SessionCache::invalidateSession(const std::string& authKey) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  std::map<Key, Entry>::iterator it = mentries.lower_bound(Key(authKey, ""));
+  while (it != mentries.end() && it->first.first == authKey) {
+    mentries.erase(it++);
+  }
+  // the other processes forget all their sessions
+  unsigned long epoch = __sync_add_and_fetch(msharedEpoch, 1);
+  if (epoch == mepoch + 1) {
+    mepoch = epoch;
+  }
+}
+
+
+void
+SessionCache::invalidateUser(int numUser) {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  for (std::map<Key, Entry>::iterator it = mentries.begin(); it != mentries.end();) {
+    if (it->second.info.num_user == numUser) {
+      mentries.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  unsigned long epoch = __sync_add_and_fetch(msharedEpoch, 1);
+  if (epoch == mepoch + 1) {
+    mepoch = epoch;
+  }
+}
+
+
+void
+SessionCache::invalidateAll() {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  mentries.clear();
+  mepoch = __sync_add_and_fetch(msharedEpoch, 1);
+}
+
+
+unsigned long
+SessionCache::getHits() const {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  return mhits;
+}
+
+
+unsigned long
+SessionCache::getMisses() const {
+  boost::lock_guard<boost::mutex> lock(mmutex);
+  return mmisses;
+}
+
+
+void
+SessionCache::checkEpoch() {
+  unsigned long epoch = *msharedEpoch;
+  if (epoch != mepoch) {
+    LOG(boost::str(boost::format("[DEBUG] session cache invalidated, %1% entries dropped")
+                   % mentries.size()), LogDebug);
+    mentries.clear();
+    mepoch = epoch;
+  }
+}
@@ -0,0 +1,172 @@
+/**
+ * \file SessionCache.hpp
+ * \brief This file defines the cache of the validated session keys
+ */
+
+#ifndef _SESSIONCACHE_HPP_
+#define _SESSIONCACHE_HPP_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "utilServer.hpp"
+
+/**
+ * \brief The default time in seconds a validated session key is kept
+ */
+const int DEFAULT_SESSION_CACHE_TTL = 10;
+
+/**
+ * \brief The number of entries above which the expired ones are purged
+ */
+const size_t SESSION_CACHE_MAX_ENTRIES = 4096;
+
+/**
+ * \class SessionCache
+ * \brief Keeps the result of the session key validations for a short
+ * time, keyed by session key and machine. The entries are invalidated when
+ * a session is closed or an account changes. The invalidations are shared
+ * with the processes forked after the creation of the cache, so that the
+ * monitor closing the sessions in timeout reaches the servers.
+ */
+class SessionCache : public boost::noncopyable {
+public:
+  /**
+   * \brief Get the cache of the process
+   * \return the cache
+   */
+  static SessionCache&
+  getInstance();
+
+  /**
+   * \brief Set the time the entries are kept
+   * \param ttl the time in seconds, 0 disables the cache
+   */
+  void
+  setTtl(int ttl);
+
+  /**
+   * \brief Get the information of a session if it is cached
+   * \param authKey the session key
+   * \param machineId the machine, empty if none
+   * \param info OUT, the information of the session
+   * \return true if the session was found
+   */
+  bool
+  get(const std::string& authKey, const std::string& machineId,
+      UserSessionInfo& info);
+
+  /**
+   * \brief Cache the information of a validated session
+   * \param authKey the session key
+   * \param machineId the machine, empty if none
+   * \param info the information of the session
+   */
+  void
+  put(const std::string& authKey, const std::string& machineId,
+      const UserSessionInfo& info);
+
+  /**
+   * \brief Forget a session, on all the machines
+   * \param authKey the session key
+   */
+  void
+  invalidateSession(const std::string& authKey);
+
+  /**
+   * \brief Forget the sessions of a user, after a change of its accounts
+   * \param numUser the database number of the user
+   */
+  void
+  invalidateUser(int numUser);
+
+  /**
+   * \brief Forget all the sessions, in this process and the processes
+   * sharing the cache
+   */
+  void
+  invalidateAll();
+
+  /**
+   * \brief Get the number of validations served by the cache
+   * \return the number of hits
+   */
+  unsigned long
+  getHits() const;
+
+  /**
+   * \brief Get the number of validations that went to the database
+   * \return the number of misses
+   */
+  unsigned long
+  getMisses() const;
+
+private:
+  /**
+   * \brief Constructor, maps the shared invalidation counter
+   */
+  SessionCache();
+
+  /**
+   * \brief Empty the cache if another process invalidated it, mmutex
+   * must be held
+   */
+  void
+  checkEpoch();
+
+  /**
+   * \brief The key of an entry: session key and machine
+   */
+  typedef std::pair<std::string, std::string> Key;
+
+  /**
+   * \struct Entry
+   * \brief A cached session
+   */
+  struct Entry {
+    /**
+     * \brief The information of the session
+     */
+    UserSessionInfo info;
+    /**
+     * \brief The date after which the entry is ignored
+     */
+    boost::posix_time::ptime expiry;
+  };
+
+  /**
+   * \brief The cached sessions
+   */
+  std::map<Key, Entry> mentries;
+  /**
+   * \brief The time the entries are kept
+   */
+  boost::posix_time::time_duration mttl;
+  /**
+   * \brief The number of invalidations of the whole cache, shared between
+   * the processes
+   */
+  volatile unsigned long* msharedEpoch;
+  /**
+   * \brief The value of msharedEpoch when the cache was last emptied
+   */
+  unsigned long mepoch;
+  /**
+   * \brief The number of hits
+   */
+  unsigned long mhits;
+  /**
+   * \brief The number of misses
+   */
+  unsigned long mmisses;
+  /**
+   * \brief mutex protecting the cache
+   */
+  mutable boost::mutex mmutex;
+};
+
+#endif // _SESSIONCACHE_HPP_
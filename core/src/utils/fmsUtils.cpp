@@ -47,6 +47,8 @@ vishnu::buildTransferBaseCommand(int type,
     command = boost::str(boost::format("rsync -aPq %1%") % options);
     break;
 
+  // a parallel transfer sends a single stream when it cannot be split
+  case vishnu::PARALLEL_TRANSFER:
   case vishnu::SCP_TRANSFER:
   default:
 
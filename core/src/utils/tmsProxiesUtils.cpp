@@ -18,6 +18,9 @@
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/find.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include "DIET_client.h"
 
 using namespace std;
 namespace bfs = boost::filesystem;
@@ -119,18 +122,149 @@ void vishnu::copyFiles(const std::string& sessionKey,
                        std::string& missingFiles,
                        const int& startPos)
 {
-  missingFiles.clear();
-  int nbFiles = remoteFileList.size() ;
-  for (int index=startPos; index < nbFiles; ++index) {
-    try {
-      genericFileCopier(sessionKey,
-                        sourceMachineId,
-                        remoteFileList[index],
-                        "",
-                        localDestinationDir,
-                        copts);
-    } catch (...) {
-      missingFiles+=remoteFileList[index]+"\n";
+  std::vector<std::vector<std::string> > remoteFileLists(1, remoteFileList);
+  std::vector<std::string> localDestinationDirs(1, localDestinationDir);
+  std::vector<std::string> missingFileLists;
+  copyJobOutputs(sessionKey, sourceMachineId, remoteFileLists, localDestinationDirs,
+                 copts, missingFileLists, startPos);
+  missingFiles = missingFileLists[0];
+}
+
+
+namespace {
+
+/**
+ * \class OutputTransferQueue
+ * \brief The files to copy, taken one at a time by the copying threads
+ */
+class OutputTransferQueue {
+public:
+  /**
+   * \brief Constructor
+   * \param sessionKey the session key
+   * \param sourceMachineId Id of the remote machine
+   * \param copts Copy option
+   */
+  OutputTransferQueue(const std::string& sessionKey,
+                      const std::string& sourceMachineId,
+                      const FMS_Data::CpFileOptions& copts)
+    : msessionKey(sessionKey), msourceMachineId(sourceMachineId), mcopts(copts), mnext(0) {}
+
+  /**
+   * \brief Add a file to copy
+   * \param source the remote file
+   * \param destination the local directory
+   */
+  void
+  add(const std::string& source, const std::string& destination) {
+    msources.push_back(source);
+    mdestinations.push_back(destination);
+    mfailed.push_back(false);
+  }
+
+  /**
+   * \brief The number of files to copy
+   * \return the number of files
+   */
+  size_t
+  size() const {
+    return msources.size();
+  }
+
+  /**
+   * \brief Whether the copy of a file failed
+   * \param index the index of the file
+   * \return true if it failed
+   */
+  bool
+  failed(size_t index) const {
+    return mfailed[index];
+  }
+
+  /**
+   * \brief Copy the files until none remains, run by each thread
+   */
+  void
+  run() {
+    size_t index;
+    while (take(index)) {
+      bool failed = false;
+      try {
+        vishnu::genericFileCopier(msessionKey, msourceMachineId, msources[index],
+                                  "", mdestinations[index], mcopts);
+      } catch (...) {
+        failed = true;
+      }
+      boost::lock_guard<boost::mutex> lock(mmutex);
+      mfailed[index] = failed;
+    }
+  }
+
+private:
+  /**
+   * \brief Take the next file to copy
+   * \param index OUT, the index of the file
+   * \return false if no file remains
+   */
+  bool
+  take(size_t& index) {
+    boost::lock_guard<boost::mutex> lock(mmutex);
+    if (mnext >= msources.size()) {
+      return false;
+    }
+    index = mnext++;
+    return true;
+  }
+
+  std::string msessionKey;
+  std::string msourceMachineId;
+  FMS_Data::CpFileOptions mcopts;
+  std::vector<std::string> msources;
+  std::vector<std::string> mdestinations;
+  std::vector<bool> mfailed;
+  size_t mnext;
+  boost::mutex mmutex;
+};
+
+} // namespace
+
+
+void vishnu::copyJobOutputs(const std::string& sessionKey,
+                            const std::string& sourceMachineId,
+                            const std::vector<std::vector<std::string> >& remoteFileLists,
+                            const std::vector<std::string>& localDestinationDirs,
+                            const FMS_Data::CpFileOptions& copts,
+                            std::vector<std::string>& missingFiles,
+                            const int& startPos)
+{
+  // each copy is a cp request followed by a scp, they are run side by side
+  // rather than one after the other
+  OutputTransferQueue queue(sessionKey, sourceMachineId, copts);
+  for (size_t job = 0; job < remoteFileLists.size(); ++job) {
+    for (size_t index = startPos; index < remoteFileLists[job].size(); ++index) {
+      queue.add(remoteFileLists[job][index], localDestinationDirs[job]);
+    }
+  }
+
+  size_t nbThreads = std::min(queue.size(), static_cast<size_t>(getOutputTransferParallelism()));
+  if (nbThreads <= 1) {
+    queue.run();
+  } else {
+    boost::thread_group threads;
+    for (size_t i = 0; i < nbThreads; ++i) {
+      threads.create_thread(boost::bind(&OutputTransferQueue::run, &queue));
+    }
+    threads.join_all();
+  }
+
+  // the missing files are reported in the order of the lists
+  missingFiles.assign(remoteFileLists.size(), "");
+  size_t file = 0;
+  for (size_t job = 0; job < remoteFileLists.size(); ++job) {
+    for (size_t index = startPos; index < remoteFileLists[job].size(); ++index, ++file) {
+      if (queue.failed(file)) {
+        missingFiles[job] += remoteFileLists[job][index]+"\n";
+      }
     }
   }
 }
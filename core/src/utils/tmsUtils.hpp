@@ -8,6 +8,7 @@
 #define TMSUTILS_HPP
 
 #include <string>
+#include <vector>
 #include "FMS_Data/CpFileOptions.hpp"
 #include "TMS_Data/LoadCriterion.hpp"
 #include "UMS_Data/Machine.hpp"
@@ -243,6 +244,27 @@ namespace vishnu
             std::string& missingFiles,
             const int& startPos);
 
+  /**
+   * \brief Function to copy the output files of a set of jobs to local
+   * directories, several files being copied at once
+   * \param sessionKey the session key
+   * \param sourceMachineId Id of the remote machine
+   * \param remoteFileLists The files of each job
+   * \param localDestinationDirs The destination directory of each job
+   * \param copts Copy option (false => non recursive, 0 => scp)
+   * \param missingFiles OUT, the files of each job that could not be copied
+   * \param startPos Position of the first file to copy in each list
+   * \return Throw exception on error
+   */
+  void
+  copyJobOutputs(const std::string& sessionKey,
+                 const std::string& sourceMachineId,
+                 const std::vector<std::vector<std::string> >& remoteFileLists,
+                 const std::vector<std::string>& localDestinationDirs,
+                 const FMS_Data::CpFileOptions& copts,
+                 std::vector<std::string>& missingFiles,
+                 const int& startPos);
+
   /**
  * \brief Function to copy a remote file to a local directory
  * \param sessionKey the session key
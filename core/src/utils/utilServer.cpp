@@ -6,6 +6,8 @@
  */
 
 #include "utilServer.hpp"
+#include "SessionCache.hpp"
+#include "ObjectIdGenerator.hpp"
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/scoped_ptr.hpp>
@@ -246,171 +248,17 @@ vishnu::getGeneratedName (const char* format, int cpt, IdType type,
   return res;
 }
 
-int
-vishnu::getVishnuCounter(std::string vishnuIdString, IdType type) {
-  DbFactory factory;
-  Database *databaseVishnu;
-  int ret;
-
-  std::string table;
-  std::string fields;
-  std::string val;
-  std::string primary;
-
-
-  bool insert=true;
-  switch(type) {
-  case MACHINE:
-    table="machine";
-    fields=" (vishnu_vishnuid) ";
-    val = " ("+vishnuIdString+") ";
-    primary="nummachineid";
-    break;
-  case USER:
-    table="users";
-    fields=" (vishnu_vishnuid,pwd,userid) ";
-    val = " ("+vishnuIdString+",'','') ";
-    primary="numuserid";
-    break;
-  case JOB:
-    table="job";
-    fields=" (job_owner_id, machine_id, workId, vsession_numsessionid) ";
-    val= " ((select max(numuserid) from users), (select max(nummachineid) from machine),"
-         "NULL, (select max(numsessionid) from vsession)) "; //FIXME insert invalid value then update it
-    primary="numjobid";
-    break;
-  case FILETRANSFERT:
-    table="filetransfer";
-    fields=" (vsession_numsessionid) ";
-    val= " ((select max(numsessionid) from vsession)) "; //FIXME insert invalid value then update it
-    primary="numfiletransferid";
-    break;
-  case AUTH:
-    table="authsystem";
-    fields=" (vishnu_vishnuid) ";
-    val = " ("+vishnuIdString+") ";
-    primary="numauthsystemid";
-    break;
-  case WORK:
-    //FIXME : no auto-increment field in work
-    fields = " (application_id"
-             ",date_created,done_ratio, identifier,"
-             "nbcpus, owner_id, "
-             "project_id, "
-             "status, subject, consolidated) ";
-    val = " ((select min(id) from application_version),"
-          " CURRENT_TIMESTAMP, 1, 't',"
-          " 1, (select min(numuserid) from users), "
-          "(select min(id) from project), "
-          "1,'toto', false) ";
-    table = "work";
-    primary="id";
-    break;
-  default:
-    fields = " (updatefreq, formatiduser, formatidjob, formatidfiletransfer, formatidmachine, formatidauth) ";
-    val = " (1, 't', 't', 't', 't', 't') ";
-    table = "vishnu";
-    insert=false;
-    primary="vishnu_vishnuid";
-    break;
-  }
-
-  databaseVishnu = factory.getDatabaseInstance();
-  int tid = databaseVishnu->startTransaction();
-  try {
-    ret = databaseVishnu->generateId(table, fields, val, tid, primary);
-  } catch (const std::exception& e) {
-    databaseVishnu->cancelTransaction(tid);
-    throw;
-  }
-
-  if (insert) {
-    databaseVishnu->endTransaction(tid);
-  } else {
-    databaseVishnu->cancelTransaction(tid);
-  }
-  return ret;
-}
-
-/**
- * \brief To set the objectId in the specified row in the database
- * \param key : the key to identify the reserved row
- * \param objectId : the objectId to set
- * \param type : the type of the object
- */
-void
-vishnu::reserveObjectId(int key, std::string &objectId, IdType type) {
-  std::string table;
-  std::string keyname;
-  std::string idname;
-  bool uniq = false;
-
-  switch(type) {
-  case MACHINE:
-    table="machine";
-    keyname="nummachineid";
-    idname="machineid";
-    break;
-  case USER:
-    table="users";
-    keyname="numuserid";
-    idname="userid";
-    break;
-  case JOB:
-    table="job";
-    keyname="numjobid";
-    idname="jobid";
-    break;
-  case FILETRANSFERT:
-    table="filetransfer";
-    keyname="numfiletransferid";
-    idname="transferid";
-    break;
-  case AUTH:
-    table="authsystem";
-    keyname="numauthsystemid";
-    idname="authsystemid";
-    break;
-  case WORK:
-    table="work";
-    keyname="id";
-    idname="identifier";
-    break;
-  default:
-    throw SystemException(ERRCODE_SYSTEM,"Cannot reserve Object id, type in unrecognized");
-    break;
-  }
-  while (!uniq){
-    uniq = checkObjectId(table, idname, objectId);
-    if (!uniq) {
-      objectId += convertToString(key);
-    }
-  }
-
-  DbFactory factory;
-  std::string sqlReserve="UPDATE "+table+" ";
-  sqlReserve+="set "+idname+"='"+factory.getDatabaseInstance()->escapeData(objectId)+"' ";
-  sqlReserve+="where "+keyname+"="+convertToString(key)+";";
-
-  try {
-    factory.getDatabaseInstance()->process(sqlReserve);
-  } catch (std::exception const & e) {
-    throw SystemException(ERRCODE_SYSTEM,
-                          boost::str(boost::format("Cannot reserve Object id: ")% e.what()));
-  }
-
-}
-
 bool
 vishnu::checkObjectId(std::string table,
                       std::string idname,
-                      std::string objectId){
+                      std::string objectId,
+                      int transacId){
   DbFactory factory;
   Database *mdatabase;
   mdatabase = factory.getDatabaseInstance();
   std::string request = "SELECT "+ idname + " FROM " + table + " WHERE " + idname + "='" + mdatabase->escapeData(objectId) +"';";
   try {
-    boost::scoped_ptr<DatabaseResult> result(mdatabase->getResult(request.c_str()));
+    boost::scoped_ptr<DatabaseResult> result(mdatabase->getResult(request.c_str(), transacId));
     if (result->getNbTuples() != 0) {
       return false;
     }
@@ -471,36 +319,27 @@ vishnu::getObjectId(int vishnuId,
                     std::string formatName,
                     IdType type,
                     std::string stringforgeneration) {
-  std::string idGenerated;
-
-  std::string vishnuIdString = convertToString(vishnuId);
-
-  pthread_mutex_t mutex;
-  pthread_mutex_init(&(mutex), NULL);
-  pthread_mutex_lock(&(mutex));
-
-  //To get the counter
-  int counter = getVishnuCounter(vishnuIdString,type);
-  //To get the formatiduser
-  std::string format = getAttrVishnu(formatName, vishnuIdString).c_str();
+  return ObjectIdGenerator::getInstance().getObjectId(vishnuId, formatName, type, stringforgeneration);
+}
 
-  if (! format.empty()) {
-    idGenerated = getGeneratedName(format.c_str(), counter, type, stringforgeneration);
-    if (! idGenerated.empty()) {
-    } else {
-      SystemException e (ERRCODE_SYSTEM, "There is a problem during the id generation with the format:"+ formatName);
-      pthread_mutex_unlock(&(mutex));
-      throw e;
-    }
-    // To set the idGenerated in the related row
-    reserveObjectId(counter,idGenerated,type);
-  } else {
-    pthread_mutex_unlock(&(mutex));
-    SystemException e (ERRCODE_SYSTEM, "The format "+ formatName +" is undefined");
-    throw e;
-  }
-  pthread_mutex_unlock(&(mutex));
-  return idGenerated;
+/**
+ * \brief Function to get a block of Ids generated by VISHNU, inserted in a
+ * single request
+ * \param vishnuId the vishnu Id
+ * \param formatName the name of the format
+ * \param type the type of the Ids generated
+ * \param stringforgeneration the string used for generation
+ * \param count the number of Ids
+ * \param ids OUT, the Ids generated are appended
+ */
+void
+vishnu::getObjectIds(int vishnuId,
+                     std::string formatName,
+                     IdType type,
+                     std::string stringforgeneration,
+                     int count,
+                     std::vector<std::string>& ids) {
+  ObjectIdGenerator::getInstance().getObjectIds(vishnuId, formatName, type, stringforgeneration, count, ids);
 }
 
 /**
@@ -516,25 +355,28 @@ vishnu::validateAuthKey(const std::string& authKey,
                         Database* database,
                         UserSessionInfo& info)
 {
-  std::string sqlQuery = (boost::format("SELECT vsession.numsessionid, machine.name, machine.nummachineid,"
-                                        "  users.numuserid, users.userid, users.privilege, "
-                                        "  account.aclogin, account.home"
-                                        " FROM vsession, users, account, machine"
-                                        " WHERE vsession.sessionkey='%1%'"
-                                        "  AND vsession.state=%2%"
-                                        "  AND users.numuserid=vsession.users_numuserid"
-                                        "  AND users.numuserid=account.users_numuserid"
-                                        "  AND account.status=%3%"
-                                        "  AND account.machine_nummachineid=machine.nummachineid"
-                                        "  AND machine.machineid='%4%';"
-                                        )
-                          % database->escapeData(authKey)
-                          % vishnu::SESSION_ACTIVE
-                          % vishnu::STATUS_ACTIVE
-                          % database->escapeData(machineId)
-                          ).str();
-
-  boost::scoped_ptr<DatabaseResult> sqlResult(database->getResult(sqlQuery));
+  if (SessionCache::getInstance().get(authKey, machineId, info)) {
+    return;
+  }
+  std::string sqlQuery = "SELECT vsession.numsessionid, machine.name, machine.nummachineid,"
+                         "  users.numuserid, users.userid, users.privilege, "
+                         "  account.aclogin, account.home"
+                         " FROM vsession, users, account, machine"
+                         " WHERE vsession.sessionkey=$1"
+                         "  AND vsession.state=$2"
+                         "  AND users.numuserid=vsession.users_numuserid"
+                         "  AND users.numuserid=account.users_numuserid"
+                         "  AND account.status=$3"
+                         "  AND account.machine_nummachineid=machine.nummachineid"
+                         "  AND machine.machineid=$4";
+  SqlParameters params;
+  params.add(authKey)
+    .add(vishnu::SESSION_ACTIVE)
+    .add(vishnu::STATUS_ACTIVE)
+    .add(machineId);
+
+  boost::scoped_ptr<DatabaseResult>
+    sqlResult(database->getPreparedResult("validate_auth_key_machine", sqlQuery, params));
   if (sqlResult->getNbTuples() < 1) {
     throw TMSVishnuException(ERRCODE_PERMISSION_DENIED,
                              "Can't get user information from the session token provided");
@@ -551,6 +393,7 @@ vishnu::validateAuthKey(const std::string& authKey,
   info.user_privilege = vishnu::convertToInt(*rowResultIter++);
   info.user_aclogin = *rowResultIter++;
   info.user_achome = *rowResultIter++;
+  SessionCache::getInstance().put(authKey, machineId, info);
 }
 
 
@@ -565,21 +408,24 @@ vishnu::validateAuthKey(const std::string& authKey,
                         Database* database,
                         UserSessionInfo& info)
 {
-  std::string sqlQuery = (boost::format("SELECT vsession.numsessionid, "
-                                        "  users.numuserid, users.userid, users.privilege, "
-                                        "  account.aclogin, account.home"
-                                        " FROM vsession, users, account, machine"
-                                        " WHERE vsession.sessionkey='%1%'"
-                                        "  AND vsession.state=%2%"
-                                        "  AND users.numuserid=vsession.users_numuserid"
-                                        "  AND users.numuserid=account.users_numuserid"
-                                        "  AND account.status=%3%"
-                                        )
-                          % database->escapeData(authKey)
-                          % vishnu::SESSION_ACTIVE
-                          % vishnu::STATUS_ACTIVE
-                          ).str();
-  boost::scoped_ptr<DatabaseResult> sqlResult(database->getResult(sqlQuery));
+  if (SessionCache::getInstance().get(authKey, "", info)) {
+    return;
+  }
+  std::string sqlQuery = "SELECT vsession.numsessionid, "
+                         "  users.numuserid, users.userid, users.privilege, "
+                         "  account.aclogin, account.home"
+                         " FROM vsession, users, account, machine"
+                         " WHERE vsession.sessionkey=$1"
+                         "  AND vsession.state=$2"
+                         "  AND users.numuserid=vsession.users_numuserid"
+                         "  AND users.numuserid=account.users_numuserid"
+                         "  AND account.status=$3";
+  SqlParameters params;
+  params.add(authKey)
+    .add(vishnu::SESSION_ACTIVE)
+    .add(vishnu::STATUS_ACTIVE);
+  boost::scoped_ptr<DatabaseResult>
+    sqlResult(database->getPreparedResult("validate_auth_key", sqlQuery, params));
   if (sqlResult->getNbTuples() < 1) {
     throw TMSVishnuException(ERRCODE_INVALID_PARAM,
                              "Can't get user local account. Check that:\n"
@@ -596,4 +442,5 @@ vishnu::validateAuthKey(const std::string& authKey,
   info.user_privilege = vishnu::convertToInt(*rowResultIter++);
   info.user_aclogin = *rowResultIter++;
   info.user_achome = *rowResultIter++;
+  SessionCache::getInstance().put(authKey, "", info);
 }
@@ -8,6 +8,8 @@
 #ifndef _UTILSERVER_H_
 #define _UTILSERVER_H_
 
+#include <string>
+#include <vector>
 #include "ecore.hpp" // Ecore metamodel
 #include "ecorecpp.hpp" // EMF4CPP utils
 #include "UMS_Data.hpp"
@@ -239,22 +241,15 @@ namespace vishnu {
    * \param table the name of the table
    * \param idname the name of the column
    * \param objectId the value to test if it already exists
+   * \param transacId the id of the transaction if one is used. -1 to ignore
    *\return True if the objectId is new, false if it already exists
    */
   bool
   checkObjectId(std::string table,
                 std::string idname,
-                std::string objectId);
-
+                std::string objectId,
+                int transacId = -1);
 
-  /**
-   * \brief Function to get a specific vishnu counter
-   * \param vishnuId the id of the vishnu configuration
-   * \param type : the type of id generated
-   * \return The int counter value
-   */
-  int
-  getVishnuCounter(std::string vishnuId, IdType type);
 
   /**
    * \brief Function to get information from the table vishnu
@@ -275,15 +270,6 @@ namespace vishnu {
   void
   incrementCpt(std::string cptName, int cpt, int transacId = -1);
 
-  /**
-   * \brief To set the objectId in the specified row in the database
-   * \param key : the key to identify the reserved row
-   * \param objectId : the objectId to set
-   * \param type : the type of the object
-   */
-  void
-  reserveObjectId(int key, std::string &objectId, IdType type);
-
   /**
   * \brief Function to get an Id generated by VISHNU
   * \param vishnuId the vishnu Id
@@ -298,6 +284,24 @@ namespace vishnu {
               IdType type,
               std::string stringforgeneration);
 
+  /**
+  * \brief Function to get a block of Ids generated by VISHNU, inserted in a
+  * single request
+  * \param vishnuId the vishnu Id
+  * \param formatName the name of the format
+  * \param type the type of the Ids generated
+  * \param stringforgeneration the string used for generation
+  * \param count the number of Ids
+  * \param ids OUT, the Ids generated are appended
+  */
+  void
+  getObjectIds(int vishnuId,
+               std::string formatName,
+               IdType type,
+               std::string stringforgeneration,
+               int count,
+               std::vector<std::string>& ids);
+
   /**
    * \brief Function to parse the EMF object
    * \param objectSerialized the EMF object serialized
@@ -378,7 +382,8 @@ namespace vishnu {
   int
   showVersion();
   /**
-   * @brief Validate session key and return details on the user and the session
+   * @brief Validate session key and return details on the user and the session.
+   * The validations are kept a short time in the SessionCache
    * @param authKey The authentication key
    * @param machineId The machine Id
    * @param databasePtr A pointer to a database instance
@@ -392,7 +397,8 @@ namespace vishnu {
 
 
   /**
-   * @brief Validate session key and return details on the user and the session
+   * @brief Validate session key and return details on the user and the session.
+   * The validations are kept a short time in the SessionCache
    * @param authKey The authentication key
    * @param databasePtr A pointer to a database instance
    * @param info The resulting information
@@ -38,6 +38,7 @@
 #include <iostream>
 #include <string>
 #include <cstring>
+#include <algorithm>
 #include <vector>
 #include <ctype.h>
 #include <sys/stat.h>
@@ -653,21 +654,78 @@ vishnu::validatePath(const std::string& path)
 bool
 vishnu::execSystemCommand(const std::string& command, std::string& msg)
 {
-  bool result = true;
   FILE* pipe = popen(command.c_str(), "r");
   if (! pipe) {
-    result = false;
-    msg = boost::str(boost::format("ERROR running command: ")% command);
+    msg = boost::str(boost::format("ERROR running command: %1%")% command);
+    return false;
   }
 
-  char buffer[255];
+  // the output may be binary, it is read by blocks
+  char buffer[65536];
+  size_t count;
+  while ((count = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+    msg.append(buffer, count);
+  }
+  pclose(pipe);
+
+  return true;
+}
 
-  while(! feof(pipe)) {
-    if(fgets(buffer, 128, pipe) != NULL) {
-      msg += buffer;
+
+std::string
+vishnu::encodeBase64(const std::string& data) {
+  static const char alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string encoded;
+  encoded.reserve(((data.size() + 2) / 3) * 4);
+  for (size_t i = 0; i < data.size(); i += 3) {
+    size_t count = std::min(data.size() - i, static_cast<size_t>(3));
+    unsigned long block = static_cast<unsigned char>(data[i]) << 16;
+    if (count > 1) {
+      block |= static_cast<unsigned char>(data[i + 1]) << 8;
     }
+    if (count > 2) {
+      block |= static_cast<unsigned char>(data[i + 2]);
+    }
+    encoded += alphabet[(block >> 18) & 0x3F];
+    encoded += alphabet[(block >> 12) & 0x3F];
+    encoded += (count > 1) ? alphabet[(block >> 6) & 0x3F] : '=';
+    encoded += (count > 2) ? alphabet[block & 0x3F] : '=';
   }
-  pclose(pipe);
+  return encoded;
+}
+
 
-  return result;
+std::string
+vishnu::decodeBase64(const std::string& encoded) {
+  std::string data;
+  data.reserve((encoded.size() / 4) * 3);
+  unsigned long block = 0;
+  int bits = 0;
+  for (size_t i = 0; i < encoded.size(); ++i) {
+    char c = encoded[i];
+    int value;
+    if (c >= 'A' && c <= 'Z') {
+      value = c - 'A';
+    } else if (c >= 'a' && c <= 'z') {
+      value = c - 'a' + 26;
+    } else if (c >= '0' && c <= '9') {
+      value = c - '0' + 52;
+    } else if (c == '+') {
+      value = 62;
+    } else if (c == '/') {
+      value = 63;
+    } else if (c == '=') {
+      break;
+    } else {
+      throw SystemException(ERRCODE_SYSTEM, "Invalid base64 data");
+    }
+    block = ((block << 6) | value) & 0xFFFFFF;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      data += static_cast<char>((block >> bits) & 0xFF);
+    }
+  }
+  return data;
 }
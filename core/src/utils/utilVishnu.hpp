@@ -311,5 +311,21 @@ validatePath(const std::string& path);
 bool
 execSystemCommand(const std::string& command, std::string& msg);
 
+/**
+ * @brief Encode binary data in base64, so it goes through a text protocol
+ * @param data The data
+ * @return The encoded data
+ */
+std::string
+encodeBase64(const std::string& data);
+
+/**
+ * @brief Decode base64 data
+ * @param encoded The encoded data
+ * @return The data
+ */
+std::string
+decodeBase64(const std::string& encoded);
+
 } //END NAMESPACE
 #endif // _UTILVISHNU_H_
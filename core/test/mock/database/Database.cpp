@@ -1,7 +1,50 @@
 #include "Database.hpp"
 
+#include <cctype>
+#include <cstdlib>
+#include "SystemException.hpp"
+
 Database:: Database(){};
 
 Database::~Database(){};
 
+int
+Database::processPrepared(const std::string& /*name*/, const std::string& request,
+                          const SqlParameters& params, int transacId) {
+  return process(expandParameters(request, params), transacId);
+}
+
+DatabaseResult*
+Database::getPreparedResult(const std::string& /*name*/, const std::string& request,
+                            const SqlParameters& params, int transacId) {
+  return getResult(expandParameters(request, params), transacId);
+}
 
+std::string
+Database::expandParameters(const std::string& request, const SqlParameters& params) {
+  std::string result;
+  size_t pos = 0;
+  while (pos < request.size()) {
+    size_t end = pos + 1;
+    while (request[pos] == '$'
+           && end < request.size()
+           && isdigit(static_cast<unsigned char>(request[end]))) {
+      ++end;
+    }
+    if (end == pos + 1) {
+      result += request[pos++];
+      continue;
+    }
+    size_t index = strtoul(request.substr(pos + 1, end - pos - 1).c_str(), NULL, 10);
+    if (index == 0 || index > params.size()) {
+      throw SystemException(ERRCODE_DBERR, "Invalid parameter in the request: " + request);
+    }
+    if (params.getType(index - 1) == SqlParameters::INTEGER) {
+      result += params.getValue(index - 1);
+    } else {
+      result += "'" + escapeData(params.getValue(index - 1)) + "'";
+    }
+    pos = end;
+  }
+  return result;
+}
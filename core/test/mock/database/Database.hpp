@@ -12,8 +12,16 @@
 #include <vector>
 #include "DatabaseResult.hpp"
 #include "DbConfiguration.hpp"
+#include "../../../src/database/SqlParameters.hpp"
 
 static const int SUCCESS =  0;
+
+/**
+ * \brief The number of statements kept prepared on a connection, the
+ * statements are all closed once it is reached
+ */
+static const size_t MAX_PREPARED_STATEMENTS = 128;
+
 /**
  * \class Database
  * \brief This class describes a database
@@ -97,6 +105,30 @@ virtual ~Database();
    */
   virtual std::string escapeData(const std::string& data) = 0;
 
+  /**
+   * \brief Function to process a prepared request in the database
+   * \param name The name of the statement, identifying the request
+   * \param request The request, the parameters are noted $1, $2...
+   * \param params The values of the parameters
+   * \param transacId the id of the transaction if one is used
+   * \return raises an exception on error
+   */
+  virtual int
+  processPrepared(const std::string& name, const std::string& request,
+                  const SqlParameters& params, int transacId = -1);
+
+  /**
+   * \brief To get the result of a prepared select request
+   * \param name The name of the statement, identifying the request
+   * \param request The request, the parameters are noted $1, $2...
+   * \param params The values of the parameters
+   * \param transacId the id of the transaction if one is used
+   * \return An object which encapsulates the database results
+   */
+  virtual DatabaseResult*
+  getPreparedResult(const std::string& name, const std::string& request,
+                    const SqlParameters& params, int transacId = -1);
+
 
 protected :
   /**
@@ -105,6 +137,15 @@ protected :
    */
   Database();
 
+  /**
+   * \brief To substitute the escaped values of the parameters in a request
+   * \param request The request, the parameters are noted $1, $2...
+   * \param params The values of the parameters
+   * \return the request to process
+   */
+  std::string
+  expandParameters(const std::string& request, const SqlParameters& params);
+
 private :
   /**
    * \brief To disconnect from the database
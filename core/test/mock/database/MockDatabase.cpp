@@ -6,8 +6,22 @@
  */
 #include "MockDatabase.hpp"
 
+#include <utility>
+
+namespace {
+  /**
+   * \brief The rows returned, by text of the request
+   */
+  std::vector<std::pair<std::string, std::vector<std::vector<std::string> > > > results;
+  /**
+   * \brief The requests processed
+   */
+  std::vector<std::string> processedRequests;
+}
+
 int
 MockDatabase::process(std::string request, int transacId){
+  processedRequests.push_back(request);
   return SUCCESS;
 }
 /**
@@ -53,6 +67,12 @@ DatabaseResult*
 MockDatabase::getResult(std::string request, int transacId) {
   std::vector<std::vector<std::string> > result;
   std::vector<std::string> param;
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (request.find(results[i].first) != std::string::npos) {
+      result = results[i].second;
+      break;
+    }
+  }
   return new DatabaseResult(result, param);
 }
 
@@ -84,3 +104,20 @@ MockDatabase::escapeData(const std::string& data) {
   return data;
 }
 
+
+void
+MockDatabase::setResult(const std::string& match,
+                        const std::vector<std::vector<std::string> >& rows) {
+  results.push_back(std::make_pair(match, rows));
+}
+
+const std::vector<std::string>&
+MockDatabase::getProcessedRequests() {
+  return processedRequests;
+}
+
+void
+MockDatabase::reset() {
+  results.clear();
+  processedRequests.clear();
+}
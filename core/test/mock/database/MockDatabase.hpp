@@ -8,6 +8,8 @@
 #ifndef _MOCKDATABASE_H_
 #define _MOCKDATABASE_H_
 
+#include <string>
+#include <vector>
 #include "Database.hpp"
 
 /**
@@ -99,6 +101,29 @@ public :
   virtual std::string
   escapeData(const std::string& data);
 
+  /**
+   * \brief Set the rows returned by the requests containing a text, the
+   * texts are matched in the order they were set
+   * \param match the text the request must contain
+   * \param rows the rows returned
+   */
+  static void
+  setResult(const std::string& match,
+            const std::vector<std::vector<std::string> >& rows);
+
+  /**
+   * \brief Get the requests processed since the last reset
+   * \return the requests
+   */
+  static const std::vector<std::string>&
+  getProcessedRequests();
+
+  /**
+   * \brief Drop the rows set and the requests processed
+   */
+  static void
+  reset();
+
 private :
   /////////////////////////////////
   // Attributes
@@ -0,0 +1,148 @@
+#include <boost/test/unit_test.hpp>
+#include <set>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include "ConnectionPool.hpp"
+#include "SystemException.hpp"
+
+// anonymous namespace
+namespace {
+  /**
+   * \brief Fake driver, the connections listed in dead fail their
+   * first check, and no connection is reopened while failing is set
+   */
+  class FakeDriver {
+  public:
+    FakeDriver() : reconnected(0), failing(false) {}
+
+    bool
+    check(int pos) {
+      boost::lock_guard<boost::mutex> lock(mutex);
+      return dead.erase(pos) == 0;
+    }
+
+    void
+    connect(int pos) {
+      if (failing) {
+        throw SystemException(ERRCODE_DBCONN, "database down");
+      }
+      boost::lock_guard<boost::mutex> lock(mutex);
+      ++reconnected;
+    }
+
+    std::set<int> dead;
+    int reconnected;
+    bool failing;
+    boost::mutex mutex;
+  };
+
+  void
+  releaseLater(ConnectionPool* pool, int pos) {
+    boost::this_thread::sleep(boost::posix_time::milliseconds(200));
+    pool->release(pos);
+  }
+}
+
+
+BOOST_AUTO_TEST_SUITE( ConnectionPool_unit_tests )
+
+
+BOOST_AUTO_TEST_CASE( test_acquire_release_n )
+{
+  FakeDriver driver;
+  ConnectionPool pool(2,
+                      boost::bind(&FakeDriver::check, &driver, _1),
+                      boost::bind(&FakeDriver::connect, &driver, _1));
+  int first = pool.acquire();
+  int second = pool.acquire();
+  BOOST_REQUIRE(first != second);
+  BOOST_REQUIRE_EQUAL(pool.getMetrics().inUse, 2);
+  pool.release(second);
+  // the connection used last is handed out first
+  BOOST_REQUIRE_EQUAL(pool.acquire(), second);
+  pool.release(first);
+  pool.release(second);
+  ConnectionPoolMetrics metrics = pool.getMetrics();
+  BOOST_REQUIRE_EQUAL(metrics.inUse, 0);
+  BOOST_REQUIRE_EQUAL(metrics.peakInUse, 2);
+  BOOST_REQUIRE_EQUAL(metrics.acquisitions, 3);
+}
+
+BOOST_AUTO_TEST_CASE( test_acquire_waits_n )
+{
+// A borrower is woken up as soon as a connection is given back
+  FakeDriver driver;
+  ConnectionPool pool(1,
+                      boost::bind(&FakeDriver::check, &driver, _1),
+                      boost::bind(&FakeDriver::connect, &driver, _1), 10);
+  int pos = pool.acquire();
+  boost::thread releaser(boost::bind(&releaseLater, &pool, pos));
+  BOOST_REQUIRE_EQUAL(pool.acquire(), pos);
+  releaser.join();
+  ConnectionPoolMetrics metrics = pool.getMetrics();
+  BOOST_REQUIRE_EQUAL(metrics.waits, 1);
+  BOOST_REQUIRE(metrics.maxWait < 5.);
+}
+
+BOOST_AUTO_TEST_CASE( test_acquire_timeout_b )
+{
+  FakeDriver driver;
+  ConnectionPool pool(1,
+                      boost::bind(&FakeDriver::check, &driver, _1),
+                      boost::bind(&FakeDriver::connect, &driver, _1), 1);
+  pool.acquire();
+  BOOST_REQUIRE_THROW(pool.acquire(), SystemException);
+  BOOST_REQUIRE_EQUAL(pool.getMetrics().timeouts, 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_broken_reconnected_n )
+{
+// A connection failing its check is skipped and reconnected in background
+  FakeDriver driver;
+  driver.dead.insert(0);
+  ConnectionPool pool(2,
+                      boost::bind(&FakeDriver::check, &driver, _1),
+                      boost::bind(&FakeDriver::connect, &driver, _1), 10);
+  BOOST_REQUIRE_EQUAL(pool.acquire(), 1);
+  BOOST_REQUIRE_EQUAL(pool.acquire(), 0);
+  BOOST_REQUIRE_EQUAL(pool.getMetrics().reconnections, 1);
+  BOOST_REQUIRE_EQUAL(driver.reconnected, 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_fork_reconnected_n )
+{
+// A forked process reconnects the connections broken in its parent
+  FakeDriver driver;
+  driver.dead.insert(0);
+  driver.failing = true;
+  ConnectionPool pool(2,
+                      boost::bind(&FakeDriver::check, &driver, _1),
+                      boost::bind(&FakeDriver::connect, &driver, _1), 10);
+  BOOST_REQUIRE_EQUAL(pool.acquire(), 1);
+  pool.release(1);
+
+  pid_t pid = fork();
+  BOOST_REQUIRE(pid >= 0);
+  if (pid == 0) {
+    driver.failing = false;
+    int exitCode = 1;
+    try {
+      pool.acquire();
+      if (pool.acquire() == 0 && pool.getMetrics().reconnections == 1) {
+        exitCode = 0;
+      }
+    } catch (...) {
+    }
+    _exit(exitCode);
+  }
+  int status = 0;
+  BOOST_REQUIRE_EQUAL(waitpid(pid, &status, 0), pid);
+  BOOST_REQUIRE(WIFEXITED(status));
+  BOOST_REQUIRE_EQUAL(WEXITSTATUS(status), 0);
+  // the parent keeps its own reconnection
+  BOOST_REQUIRE_EQUAL(pool.getMetrics().reconnections, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
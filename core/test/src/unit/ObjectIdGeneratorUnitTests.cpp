@@ -0,0 +1,83 @@
+#include <boost/test/unit_test.hpp>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include "ObjectIdGenerator.hpp"
+
+// anonymous namespace
+namespace {
+  const int TAKERS = 8;
+  const int TAKES = 10000;
+
+  /**
+   * \brief Take counters one by one until the block is exhausted
+   */
+  void
+  takeAll(volatile ObjectIdGenerator::CounterBlock* block, std::vector<int>* taken) {
+    int first;
+    while (ObjectIdGenerator::takeFromBlock(*block, 1, first)) {
+      taken->push_back(first);
+    }
+  }
+}
+
+
+BOOST_AUTO_TEST_SUITE( ObjectIdGenerator_unit_tests )
+
+
+BOOST_AUTO_TEST_CASE( test_takeFromBlock_n )
+{
+  // The counters are handed out in order until the end of the block
+  volatile ObjectIdGenerator::CounterBlock block = ObjectIdGenerator::makeBlock(10, 20);
+  int first = 0;
+  BOOST_REQUIRE(ObjectIdGenerator::takeFromBlock(block, 1, first));
+  BOOST_REQUIRE_EQUAL(first, 10);
+  BOOST_REQUIRE(ObjectIdGenerator::takeFromBlock(block, 4, first));
+  BOOST_REQUIRE_EQUAL(first, 11);
+  BOOST_REQUIRE(ObjectIdGenerator::takeFromBlock(block, 5, first));
+  BOOST_REQUIRE_EQUAL(first, 15);
+  BOOST_REQUIRE(! ObjectIdGenerator::takeFromBlock(block, 1, first));
+}
+
+BOOST_AUTO_TEST_CASE( test_takeFromBlock_b )
+{
+  // A request larger than what is left takes nothing
+  volatile ObjectIdGenerator::CounterBlock block = ObjectIdGenerator::makeBlock(1, 4);
+  int first = 0;
+  BOOST_REQUIRE(! ObjectIdGenerator::takeFromBlock(block, 4, first));
+  BOOST_REQUIRE(ObjectIdGenerator::takeFromBlock(block, 3, first));
+  BOOST_REQUIRE_EQUAL(first, 1);
+  // the empty block of a new generator holds nothing
+  volatile ObjectIdGenerator::CounterBlock empty = 0;
+  BOOST_REQUIRE(! ObjectIdGenerator::takeFromBlock(empty, 1, first));
+}
+
+BOOST_AUTO_TEST_CASE( test_takeFromBlock_concurrent_n )
+{
+  // The threads sharing a block never get the same counter and none is lost
+  volatile ObjectIdGenerator::CounterBlock block = ObjectIdGenerator::makeBlock(1, 1 + TAKERS * TAKES);
+  std::vector<std::vector<int> > taken(TAKERS);
+  boost::thread_group takers;
+  for (int i = 0; i < TAKERS; ++i) {
+    takers.create_thread(boost::bind(&takeAll, &block, &taken[i]));
+  }
+  takers.join_all();
+
+  std::vector<bool> seen(1 + TAKERS * TAKES, false);
+  int total = 0;
+  for (int i = 0; i < TAKERS; ++i) {
+    for (size_t j = 0; j < taken[i].size(); ++j) {
+      int counter = taken[i][j];
+      BOOST_REQUIRE(counter >= 1 && counter <= TAKERS * TAKES);
+      BOOST_REQUIRE(! seen[counter]);
+      seen[counter] = true;
+      ++total;
+    }
+  }
+  BOOST_REQUIRE_EQUAL(total, TAKERS * TAKES);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// THE END
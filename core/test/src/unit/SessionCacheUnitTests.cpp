@@ -0,0 +1,83 @@
+#include <boost/test/unit_test.hpp>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "SessionCache.hpp"
+
+// anonymous namespace
+namespace {
+  UserSessionInfo
+  makeInfo(int numUser) {
+    UserSessionInfo info;
+    info.num_session = 1;
+    info.num_user = numUser;
+    info.user_privilege = 0;
+    info.userid = "user";
+    info.user_aclogin = "login";
+    return info;
+  }
+}
+
+
+BOOST_AUTO_TEST_SUITE( SessionCache_unit_tests )
+
+
+BOOST_AUTO_TEST_CASE( test_hit_miss_n )
+{
+  SessionCache& cache = SessionCache::getInstance();
+  cache.setTtl(60);
+  unsigned long hits = cache.getHits();
+  unsigned long misses = cache.getMisses();
+  UserSessionInfo info;
+  BOOST_REQUIRE(!cache.get("key_1", "machine_1", info));
+  cache.put("key_1", "machine_1", makeInfo(3));
+  BOOST_REQUIRE(cache.get("key_1", "machine_1", info));
+  BOOST_REQUIRE_EQUAL(info.num_user, 3);
+  // the machine is part of the key
+  BOOST_REQUIRE(!cache.get("key_1", "", info));
+  BOOST_REQUIRE_EQUAL(cache.getHits(), hits + 1);
+  BOOST_REQUIRE_EQUAL(cache.getMisses(), misses + 2);
+}
+
+BOOST_AUTO_TEST_CASE( test_invalidate_n )
+{
+  SessionCache& cache = SessionCache::getInstance();
+  cache.setTtl(60);
+  UserSessionInfo info;
+  cache.put("key_2", "machine_1", makeInfo(4));
+  cache.put("key_2", "", makeInfo(4));
+  cache.put("key_3", "", makeInfo(5));
+  cache.invalidateSession("key_2");
+  BOOST_REQUIRE(!cache.get("key_2", "machine_1", info));
+  BOOST_REQUIRE(!cache.get("key_2", "", info));
+  BOOST_REQUIRE(cache.get("key_3", "", info));
+  cache.invalidateUser(5);
+  BOOST_REQUIRE(!cache.get("key_3", "", info));
+}
+
+BOOST_AUTO_TEST_CASE( test_disabled_n )
+{
+  SessionCache& cache = SessionCache::getInstance();
+  cache.setTtl(0);
+  UserSessionInfo info;
+  cache.put("key_4", "", makeInfo(6));
+  BOOST_REQUIRE(!cache.get("key_4", "", info));
+}
+
+BOOST_AUTO_TEST_CASE( test_invalidated_by_child_n )
+{
+// The sessions closed in a forked process are forgotten by the parent
+  SessionCache& cache = SessionCache::getInstance();
+  cache.setTtl(60);
+  UserSessionInfo info;
+  cache.put("key_5", "", makeInfo(7));
+  pid_t pid = fork();
+  if (pid == 0) {
+    SessionCache::getInstance().invalidateSession("key_6");
+    _exit(0);
+  }
+  BOOST_REQUIRE(pid > 0);
+  waitpid(pid, NULL, 0);
+  BOOST_REQUIRE(!cache.get("key_5", "", info));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,82 @@
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include "Database.hpp"
+#include "SystemException.hpp"
+
+// anonymous namespace
+namespace {
+  /**
+   * \brief Fake driver without prepared statements, keeping the last
+   * request processed
+   */
+  class FakeDatabase : public Database {
+  public:
+    int process(std::string request, int transacId = -1) {
+      last = request;
+      return SUCCESS;
+    }
+    int connect() { return SUCCESS; }
+    DatabaseResult* getResult(std::string request, int transacId = -1) { return NULL; }
+    DbConfiguration::db_type_t getDbType() { return DbConfiguration::POSTGRESQL; }
+    int startTransaction() { return 0; }
+    void endTransaction(int transactionID) {}
+    void cancelTransaction(int transactionID) {}
+    void flush(int transactionID) {}
+    int generateId(std::string table, std::string fields, std::string val,
+                   int tid, std::string primary) { return 0; }
+    std::string getRequest(const int key) { return ""; }
+    std::string escapeData(const std::string& data) {
+      std::string escaped;
+      for (size_t i = 0; i < data.size(); ++i) {
+        if (data[i] == '\'') {
+          escaped += '\'';
+        }
+        escaped += data[i];
+      }
+      return escaped;
+    }
+
+    std::string last;
+
+  private:
+    int disconnect() { return SUCCESS; }
+  };
+}
+
+
+BOOST_AUTO_TEST_SUITE( SqlParameters_unit_tests )
+
+
+BOOST_AUTO_TEST_CASE( test_bind_placeholders_n )
+{
+  SqlParameters params;
+  std::string request = "SELECT * FROM job WHERE owner=" + params.bind("user");
+  request += " AND status=" + params.bind(3LL);
+  BOOST_REQUIRE_EQUAL(request, "SELECT * FROM job WHERE owner=$1 AND status=$2");
+  BOOST_REQUIRE_EQUAL(params.size(), 2U);
+  BOOST_REQUIRE(params.getType(0) == SqlParameters::TEXT);
+  BOOST_REQUIRE(params.getType(1) == SqlParameters::INTEGER);
+  BOOST_REQUIRE_EQUAL(params.getValue(1), "3");
+  BOOST_REQUIRE_EQUAL(params.getInteger(1), 3);
+}
+
+BOOST_AUTO_TEST_CASE( test_expand_parameters_n )
+{
+// The drivers without prepared statements get the escaped values
+  FakeDatabase database;
+  SqlParameters params;
+  params.add("o'neil").add(12);
+  database.processPrepared("test", "UPDATE job SET owner=$1 WHERE status=$2 AND cost='$'", params);
+  BOOST_REQUIRE_EQUAL(database.last, "UPDATE job SET owner='o''neil' WHERE status=12 AND cost='$'");
+}
+
+BOOST_AUTO_TEST_CASE( test_expand_parameters_missing_b )
+{
+  FakeDatabase database;
+  SqlParameters params;
+  params.add(1);
+  BOOST_REQUIRE_THROW(database.processPrepared("test", "DELETE FROM job WHERE status=$2", params),
+                      SystemException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 #include <map>
 
 #include "UserException.hpp"
+#include "SystemException.hpp"
 #include "utilVishnu.hpp"
 
 BOOST_AUTO_TEST_SUITE( utilVishnu_unit_tests )
@@ -151,5 +152,25 @@ BOOST_AUTO_TEST_CASE( test_isNotIP_b )
   BOOST_REQUIRE(vishnu::isNotIP("127.0.a.b"));
 }
 
+BOOST_AUTO_TEST_CASE( test_base64_n )
+{
+  // Binary data, the NUL bytes included, is kept through the encoding
+  std::string data("a\0b\xff\n", 5);
+  std::string encoded = vishnu::encodeBase64(data);
+  BOOST_REQUIRE_EQUAL(encoded.find('\0'), std::string::npos);
+  BOOST_REQUIRE(vishnu::decodeBase64(encoded) == data);
+  BOOST_REQUIRE_EQUAL(vishnu::encodeBase64(""), "");
+  BOOST_REQUIRE_EQUAL(vishnu::encodeBase64("f"), "Zg==");
+  BOOST_REQUIRE_EQUAL(vishnu::encodeBase64("fo"), "Zm8=");
+  BOOST_REQUIRE_EQUAL(vishnu::encodeBase64("foo"), "Zm9v");
+  BOOST_REQUIRE_EQUAL(vishnu::decodeBase64("Zm9vYg=="), "foob");
+}
+
+BOOST_AUTO_TEST_CASE( test_base64_b )
+{
+  // Data which is not base64 is rejected
+  BOOST_REQUIRE_THROW(vishnu::decodeBase64("Zm9v!"), SystemException);
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()